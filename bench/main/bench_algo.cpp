@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "freertos/FreeRTOS.h"
+
+#include "benchmarks.h"
+#include "ocs_algo/crc_ops.h"
+#include "ocs_algo/uri_ops.h"
+#include "ocs_algo/uri_router.h"
+#include "ocs_bench/do_not_optimize.h"
+
+namespace ocs {
+namespace bench {
+
+namespace {
+
+const unsigned max_buffer_size = 256;
+
+uint8_t buffer[max_buffer_size];
+
+void add_crc8(Runner& runner, unsigned size, algo::CrcOps::BitOrder order) {
+    const std::string id = std::string("algo/crc8/")
+        + (order == algo::CrcOps::BitOrder::MSB ? "msb/" : "lsb/") + std::to_string(size);
+
+    configASSERT(runner.add(id.c_str(),
+                            [size, order]() {
+                                do_not_optimize(
+                                    algo::CrcOps::crc8(buffer, size, 0xFF, 0x31, order));
+                            })
+                 == status::StatusCode::OK);
+}
+
+struct RouteTable {
+    std::vector<std::string> patterns;
+    std::unique_ptr<algo::UriRouter> router;
+
+    //! Path matching the last registered route.
+    std::string path;
+};
+
+std::vector<std::unique_ptr<RouteTable>> route_tables;
+
+//! Routes resemble the HTTP API: half of them are literal, half of them have the path
+//! parameter.
+RouteTable& make_route_table(unsigned count) {
+    route_tables.emplace_back(new (std::nothrow) RouteTable());
+    configASSERT(route_tables.back());
+
+    auto& table = *route_tables.back();
+
+    table.router.reset(new (std::nothrow) algo::UriRouter());
+    configASSERT(table.router);
+
+    for (unsigned n = 0; n < count; ++n) {
+        const std::string prefix = "/api/v1/sensor/sensor_" + std::to_string(n);
+
+        table.patterns.push_back(n % 2 ? prefix + "/{sensor_id}/read" : prefix + "/read");
+        configASSERT(table.router->add(table.patterns.back().c_str(), n)
+                     == status::StatusCode::OK);
+
+        table.path = n % 2 ? prefix + "/soil_temp/read" : prefix + "/read";
+    }
+
+    return table;
+}
+
+void add_uri_router(Runner& runner, unsigned count) {
+    auto& table = make_route_table(count);
+
+    std::string id = "algo/uri/router/" + std::to_string(count);
+
+    configASSERT(runner.add(id.c_str(),
+                            [&table]() {
+                                unsigned id = 0;
+                                algo::UriRouter::Params params;
+
+                                do_not_optimize(table.router->match(table.path, id,
+                                                                    params));
+                                do_not_optimize(id);
+                            })
+                 == status::StatusCode::OK);
+
+    // Linear scan over the registered patterns with the exact comparison, it's the
+    // lower bound of matching the URI against each handler in turn.
+    id = "algo/uri/linear/" + std::to_string(count);
+
+    configASSERT(runner.add(id.c_str(),
+                            [&table]() {
+                                const auto it = std::find(table.patterns.begin(),
+                                                          table.patterns.end(),
+                                                          table.path);
+                                do_not_optimize(it);
+                            })
+                 == status::StatusCode::OK);
+}
+
+} // namespace
+
+void add_algo_benchmarks(Runner& runner) {
+    for (unsigned n = 0; n < max_buffer_size; ++n) {
+        buffer[n] = n * 31 + 7;
+    }
+
+    for (unsigned size : { 2, 64, 256 }) {
+        add_crc8(runner, size, algo::CrcOps::BitOrder::MSB);
+        add_crc8(runner, size, algo::CrcOps::BitOrder::LSB);
+    }
+
+    configASSERT(runner.add("algo/uri/parse_path",
+                            []() {
+                                const auto path = algo::UriOps::parse_path(
+                                    "/api/v1/sensor/ds18b20/configure?gpio=26&id=1");
+                                do_not_optimize(path);
+                            })
+                 == status::StatusCode::OK);
+
+    configASSERT(runner.add("algo/uri/parse_query/1",
+                            []() {
+                                const auto values = algo::UriOps::parse_query(
+                                    "/api/v1/system/report?a=1");
+                                do_not_optimize(values.size());
+                            })
+                 == status::StatusCode::OK);
+
+    configASSERT(
+        runner.add("algo/uri/parse_query/4",
+                   []() {
+                       const auto values = algo::UriOps::parse_query(
+                           "/api/v1/sensor/ds18b20/configure?gpio=26&serial_number="
+                           "28-00-00-0b-a2-c4-31&resolution=12&wait_interval=1000");
+                       do_not_optimize(values.size());
+                   })
+        == status::StatusCode::OK);
+
+    for (unsigned count : { 10, 50, 200 }) {
+        add_uri_router(runner, count);
+    }
+}
+
+} // namespace bench
+} // namespace ocs
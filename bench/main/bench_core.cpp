@@ -0,0 +1,298 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "benchmarks.h"
+#include "ocs_bench/do_not_optimize.h"
+#include "ocs_core/cond.h"
+#include "ocs_core/future.h"
+#include "ocs_core/iclock.h"
+#include "ocs_core/lock_guard.h"
+#include "ocs_core/noncopyable.h"
+#include "ocs_core/rate_limiter.h"
+#include "ocs_core/spmc_node.h"
+#include "ocs_core/static_func.h"
+#include "ocs_core/static_mutex.h"
+
+namespace ocs {
+namespace bench {
+
+namespace {
+
+struct Data {
+    uint32_t value { 0 };
+    uint32_t count { 0 };
+};
+
+//! Sensor data snapshot, too large for the lock-free std::atomic.
+struct Snapshot {
+    float values[4] { 0, 0, 0, 0 };
+    int64_t ts { 0 };
+    uint32_t seq { 0 };
+};
+
+//! Update the node continuously from the background thread.
+template <typename Node> class ContentionWriter : public core::NonCopyable<> {
+public:
+    explicit ContentionWriter(Node& node)
+        : node_(node) {
+    }
+
+    void start() {
+        stopped_.store(false, std::memory_order_relaxed);
+
+        thread_.reset(new (std::nothrow) std::thread([this]() {
+            Snapshot snapshot;
+
+            while (!stopped_.load(std::memory_order_relaxed)) {
+                ++snapshot.seq;
+                snapshot.ts = snapshot.seq;
+
+                node_.set(snapshot);
+            }
+        }));
+        configASSERT(thread_);
+    }
+
+    void stop() {
+        stopped_.store(true, std::memory_order_relaxed);
+
+        thread_->join();
+        thread_.reset();
+    }
+
+private:
+    Node& node_;
+
+    std::atomic<bool> stopped_ { false };
+    std::unique_ptr<std::thread> thread_;
+};
+
+template <typename Node>
+void add_snapshot_benchmarks(Runner& runner, const char* id, Node& node) {
+    static ContentionWriter<Node> writer(node);
+
+    const std::string get_id = std::string("core/spmc_node/snapshot/") + id + "/get";
+    const std::string contended_get_id = get_id + "/contended";
+    const std::string set_id = std::string("core/spmc_node/snapshot/") + id + "/set";
+
+    configASSERT(runner.add(get_id.c_str(),
+                            [&node]() {
+                                do_not_optimize(node.get());
+                            })
+                 == status::StatusCode::OK);
+
+    configASSERT(runner.add(
+                     contended_get_id.c_str(),
+                     [&node]() {
+                         do_not_optimize(node.get());
+                     },
+                     []() {
+                         writer.start();
+                     },
+                     []() {
+                         writer.stop();
+                     })
+                 == status::StatusCode::OK);
+
+    configASSERT(runner.add(set_id.c_str(),
+                            [&node]() {
+                                Snapshot snapshot;
+                                snapshot.seq = 1;
+                                node.set(snapshot);
+                            })
+                 == status::StatusCode::OK);
+}
+
+//! Respond to each request on the separate FreeRTOS task.
+class FutureResponder : public core::NonCopyable<> {
+public:
+    void start() {
+        stopped_ = false;
+        done_.reset();
+
+        configASSERT(xTaskCreate(run_, "bench_responder", 4096, this,
+                                 uxTaskPriorityGet(nullptr), nullptr)
+                     == pdPASS);
+    }
+
+    void stop() {
+        stopped_ = true;
+
+        configASSERT(request_.notify(status::StatusCode::OK) == status::StatusCode::OK);
+        configASSERT(done_.wait() == status::StatusCode::OK);
+    }
+
+    //! Notify the responder and wait for the response.
+    void round_trip() {
+        configASSERT(request_.notify(status::StatusCode::OK) == status::StatusCode::OK);
+        configASSERT(response_.wait() == status::StatusCode::OK);
+
+        response_.reset();
+    }
+
+private:
+    static void run_(void* arg) {
+        FutureResponder& self = *static_cast<FutureResponder*>(arg);
+
+        while (true) {
+            configASSERT(self.request_.wait() == status::StatusCode::OK);
+            self.request_.reset();
+
+            if (self.stopped_) {
+                break;
+            }
+
+            configASSERT(self.response_.notify(status::StatusCode::OK)
+                         == status::StatusCode::OK);
+        }
+
+        configASSERT(self.done_.notify(status::StatusCode::OK) == status::StatusCode::OK);
+        vTaskDelete(nullptr);
+    }
+
+    core::Future request_;
+    core::Future response_;
+    core::Future done_;
+
+    //! Written before the request is notified, read after it's received.
+    bool stopped_ { false };
+};
+
+class CounterClock : public core::IClock, public core::NonCopyable<> {
+public:
+    core::Time now() override {
+        return ++ts_;
+    }
+
+private:
+    core::Time ts_ { 0 };
+};
+
+core::SpmcNode<uint32_t> spmc_node_u32;
+core::SpmcNode<Data> spmc_node_data;
+
+// Sequence lock, selected for the large types.
+core::SpmcNode<Snapshot> spmc_node_seqlock;
+
+// Previous implementation, std::atomic backed by the libatomic lock table.
+core::SpmcNode<Snapshot, true> spmc_node_atomic;
+
+core::StaticMutex mutex;
+uint32_t mutex_value { 0 };
+
+FutureResponder future_responder;
+
+core::StaticMutex cond_mutex;
+core::Cond cond(cond_mutex);
+
+CounterClock clock;
+core::RateLimiter rate_limiter(clock, 100);
+
+} // namespace
+
+void add_core_benchmarks(Runner& runner) {
+    configASSERT(runner.add("core/spmc_node/u32/set",
+                            []() {
+                                spmc_node_u32.set(spmc_node_u32.get() + 1);
+                            })
+                 == status::StatusCode::OK);
+
+    configASSERT(runner.add("core/spmc_node/u32/get",
+                            []() {
+                                do_not_optimize(spmc_node_u32.get());
+                            })
+                 == status::StatusCode::OK);
+
+    configASSERT(runner.add("core/spmc_node/data/set",
+                            []() {
+                                auto data = spmc_node_data.get();
+                                ++data.count;
+                                spmc_node_data.set(data);
+                            })
+                 == status::StatusCode::OK);
+
+    configASSERT(runner.add("core/spmc_node/data/get",
+                            []() {
+                                do_not_optimize(spmc_node_data.get());
+                            })
+                 == status::StatusCode::OK);
+
+    add_snapshot_benchmarks(runner, "seqlock", spmc_node_seqlock);
+    add_snapshot_benchmarks(runner, "atomic", spmc_node_atomic);
+
+    configASSERT(runner.add("core/static_mutex/lock",
+                            []() {
+                                core::LockGuard lock(mutex);
+                                ++mutex_value;
+                            })
+                 == status::StatusCode::OK);
+
+    configASSERT(runner.add(
+                     "core/future/round_trip",
+                     []() {
+                         future_responder.round_trip();
+                     },
+                     []() {
+                         future_responder.start();
+                     },
+                     []() {
+                         future_responder.stop();
+                     })
+                 == status::StatusCode::OK);
+
+    configASSERT(runner.add("core/cond/wait_timeout",
+                            []() {
+                                core::LockGuard lock(cond_mutex);
+                                do_not_optimize(cond.wait(0));
+                            })
+                 == status::StatusCode::OK);
+
+    configASSERT(runner.add("core/rate_limiter/allow",
+                            []() {
+                                do_not_optimize(rate_limiter.allow());
+                            })
+                 == status::StatusCode::OK);
+
+    configASSERT(runner.add("core/static_func/construct_invoke",
+                            []() {
+                                uint32_t value = 0;
+                                uint32_t padding[3] { 1, 2, 3 };
+                                core::StaticFunc<void(), sizeof(void*) * 4> func =
+                                    [&value, padding]() {
+                                        value += padding[0];
+                                    };
+                                func();
+                                do_not_optimize(value);
+                            })
+                 == status::StatusCode::OK);
+
+    configASSERT(runner.add("core/std_function/construct_invoke",
+                            []() {
+                                uint32_t value = 0;
+                                uint32_t padding[3] { 1, 2, 3 };
+                                std::function<void()> func = [&value, padding]() {
+                                    value += padding[0];
+                                };
+                                func();
+                                do_not_optimize(value);
+                            })
+                 == status::StatusCode::OK);
+}
+
+} // namespace bench
+} // namespace ocs
@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "freertos/FreeRTOS.h"
+
+#include "benchmarks.h"
+#include "ocs_bench/do_not_optimize.h"
+#include "ocs_core/log.h"
+#include "ocs_core/istream_writer.h"
+#include "ocs_core/noncopyable.h"
+#include "ocs_fmt/json/cjson_builder.h"
+#include "ocs_fmt/json/cjson_object_formatter.h"
+#include "ocs_fmt/json/dynamic_formatter.h"
+#include "ocs_fmt/json/fanout_formatter.h"
+#include "ocs_fmt/json/func_formatter.h"
+#include "ocs_fmt/json/stream_writer.h"
+
+namespace ocs {
+namespace bench {
+
+namespace {
+
+const unsigned field_count = 16;
+
+class NullStreamWriter : public core::IStreamWriter, public core::NonCopyable<> {
+public:
+    status::StatusCode begin() override {
+        return status::StatusCode::OK;
+    }
+
+    status::StatusCode end() override {
+        return status::StatusCode::OK;
+    }
+
+    status::StatusCode cancel() override {
+        return status::StatusCode::OK;
+    }
+
+    status::StatusCode write(const void* data, unsigned size) override {
+        do_not_optimize(data);
+        return status::StatusCode::OK;
+    }
+};
+
+NullStreamWriter null_stream_writer;
+
+//! Count the written bytes.
+class CountStreamWriter : public core::IStreamWriter, public core::NonCopyable<> {
+public:
+    status::StatusCode begin() override {
+        return status::StatusCode::OK;
+    }
+
+    status::StatusCode end() override {
+        return status::StatusCode::OK;
+    }
+
+    status::StatusCode cancel() override {
+        return status::StatusCode::OK;
+    }
+
+    status::StatusCode write(const void*, unsigned size) override {
+        count += size;
+        return status::StatusCode::OK;
+    }
+
+    unsigned count { 0 };
+};
+
+//! Stock telemetry data, see docs/httpserver.md.
+struct TelemetryField {
+    const char* key { nullptr };
+    const char* str { nullptr };
+    double number { 0 };
+};
+
+const TelemetryField telemetry_fields[] = {
+    { "c_sys_lifetime", nullptr, 4293423 },
+    { "c_sys_uptime", nullptr, 78 },
+    { "outside_temp", nullptr, 26.25 },
+    { "sensor_bme280_humidity", nullptr, 27.54 },
+    { "sensor_bme280_pressure", nullptr, 1022.82 },
+    { "sensor_bme280_temperature", nullptr, 24.81 },
+    { "sensor_ldr_lightness", nullptr, 100 },
+    { "sensor_ldr_raw", nullptr, 977 },
+    { "sensor_ldr_voltage", nullptr, 3060 },
+    { "sensor_sht41_humidity", nullptr, 0 },
+    { "sensor_sht41_temperature", nullptr, 0 },
+    { "sensor_soil_curr_status", "Dry", 0 },
+    { "sensor_soil_curr_status_dur", nullptr, 78 },
+    { "sensor_soil_moisture", nullptr, 24 },
+    { "sensor_soil_prev_status", "Depletion", 0 },
+    { "sensor_soil_prev_status_dur", nullptr, 1 },
+    { "sensor_soil_raw", nullptr, 466 },
+    { "sensor_soil_status_len", nullptr, 75 },
+    { "sensor_soil_status_pos", nullptr, 1 },
+    { "sensor_soil_voltage", nullptr, 1653 },
+    { "sensor_soil_write_count", nullptr, 1854 },
+    { "soil_temp", nullptr, 23 },
+    { "system_memory_heap", nullptr, 186720 },
+    { "system_memory_heap_internal", nullptr, 186632 },
+    { "system_memory_heap_min", nullptr, 185844 },
+    { "system_reset_reason", "RST_SW", 0 },
+};
+
+status::StatusCode format_telemetry(core::IStreamWriter& stream_writer,
+                                    fmt::json::StreamWriter::Encoding encoding) {
+    char buf[128];
+    fmt::json::StreamWriter writer(stream_writer, buf, sizeof(buf), encoding);
+
+    writer.begin_object();
+    for (const auto& field : telemetry_fields) {
+        if (field.str) {
+            writer.add_string(field.key, field.str);
+        } else {
+            writer.add_number(field.key, field.number);
+        }
+    }
+    writer.end_object();
+
+    return writer.flush();
+}
+
+void add_telemetry(Runner& runner,
+                   const char* id,
+                   fmt::json::StreamWriter::Encoding encoding) {
+    CountStreamWriter count_writer;
+    configASSERT(format_telemetry(count_writer, encoding) == status::StatusCode::OK);
+
+    ocs_logi("bench_fmt", "telemetry size: id=%s bytes=%u", id, count_writer.count);
+
+    configASSERT(runner.add(id,
+                            [encoding]() {
+                                do_not_optimize(
+                                    format_telemetry(null_stream_writer, encoding));
+                            })
+                 == status::StatusCode::OK);
+}
+
+using FuncFormatterPtr = std::unique_ptr<fmt::json::FuncFormatter>;
+
+std::vector<std::string> keys;
+std::vector<FuncFormatterPtr> func_formatters;
+
+fmt::json::FanoutFormatter fanout_formatter;
+
+auto json = fmt::json::CjsonUniqueBuilder::make_nullptr();
+
+std::unique_ptr<fmt::json::DynamicFormatter> dynamic_formatter;
+
+} // namespace
+
+void add_fmt_benchmarks(Runner& runner) {
+    for (unsigned n = 0; n < field_count; ++n) {
+        keys.push_back("field_" + std::to_string(n));
+    }
+
+    for (unsigned n = 0; n < field_count; ++n) {
+        func_formatters.emplace_back(
+            new (std::nothrow) fmt::json::FuncFormatter([n](cJSON* json) {
+                fmt::json::CjsonObjectFormatter formatter(json);
+
+                if (!formatter.add_number_cs(keys[n].c_str(), n * 1000 + 0.5)) {
+                    return status::StatusCode::NoMem;
+                }
+
+                return status::StatusCode::OK;
+            }));
+        configASSERT(func_formatters.back());
+
+        fanout_formatter.add(*func_formatters.back());
+    }
+
+    json = fmt::json::CjsonUniqueBuilder::make_object();
+    configASSERT(json);
+    configASSERT(fanout_formatter.format(json.get()) == status::StatusCode::OK);
+
+    dynamic_formatter.reset(new (std::nothrow) fmt::json::DynamicFormatter(1024));
+    configASSERT(dynamic_formatter);
+
+    configASSERT(runner.add("fmt/fanout_formatter/16",
+                            []() {
+                                auto json = fmt::json::CjsonUniqueBuilder::make_object();
+                                configASSERT(json);
+
+                                do_not_optimize(fanout_formatter.format(json.get()));
+                            })
+                 == status::StatusCode::OK);
+
+    configASSERT(runner.add("fmt/dynamic_formatter/16",
+                            []() {
+                                do_not_optimize(dynamic_formatter->format(json.get()));
+                            })
+                 == status::StatusCode::OK);
+
+    configASSERT(runner.add("fmt/stream_writer/16",
+                            []() {
+                                char buf[128];
+                                fmt::json::StreamWriter writer(null_stream_writer, buf,
+                                                               sizeof(buf));
+
+                                writer.begin_object();
+                                for (unsigned n = 0; n < field_count; ++n) {
+                                    writer.add_number(keys[n].c_str(), n * 1000 + 0.5);
+                                }
+                                writer.end_object();
+
+                                do_not_optimize(writer.flush());
+                            })
+                 == status::StatusCode::OK);
+
+    add_telemetry(runner, "fmt/telemetry/json", fmt::json::StreamWriter::Encoding::Json);
+    add_telemetry(runner, "fmt/telemetry/cbor", fmt::json::StreamWriter::Encoding::Cbor);
+}
+
+} // namespace bench
+} // namespace ocs
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "freertos/FreeRTOS.h"
+
+#include "benchmarks.h"
+#include "ocs_bench/alloc_counter.h"
+#include "ocs_bench/report_formatter.h"
+#include "ocs_bench/runner.h"
+#include "ocs_core/log.h"
+#include "ocs_fmt/json/cjson_builder.h"
+#include "ocs_fmt/json/dynamic_formatter.h"
+#include "ocs_status/code_to_str.h"
+
+using namespace ocs;
+
+namespace {
+
+const char* log_tag = "bench_main";
+
+} // namespace
+
+extern "C" void app_main() {
+    auto code = bench::AllocCounter::check();
+    if (code != status::StatusCode::OK) {
+        ocs_loge(log_tag, "allocations aren't counted: code=%s",
+                 status::code_to_str(code));
+        exit(EXIT_FAILURE);
+    }
+
+    bench::Runner::Params params;
+    params.warmup_count = CONFIG_OCS_BENCH_WARMUP_COUNT;
+    params.sample_count = CONFIG_OCS_BENCH_SAMPLE_COUNT;
+    params.sample_duration =
+        core::Duration::millisecond * CONFIG_OCS_BENCH_SAMPLE_DURATION_MS;
+
+    bench::Runner runner(params);
+
+    bench::add_algo_benchmarks(runner);
+    bench::add_core_benchmarks(runner);
+    bench::add_fmt_benchmarks(runner);
+    bench::add_scheduler_benchmarks(runner);
+
+    code = runner.run(CONFIG_OCS_BENCH_PREFIX);
+    if (code != status::StatusCode::OK) {
+        ocs_loge(log_tag, "failed to run benchmarks: prefix=%s code=%s",
+                 CONFIG_OCS_BENCH_PREFIX, status::code_to_str(code));
+        exit(EXIT_FAILURE);
+    }
+
+    auto json = fmt::json::CjsonUniqueBuilder::make_object();
+    configASSERT(json);
+
+    bench::ReportFormatter report_formatter(runner);
+
+    code = report_formatter.format(json.get());
+    if (code != status::StatusCode::OK) {
+        ocs_loge(log_tag, "failed to format report: code=%s", status::code_to_str(code));
+        exit(EXIT_FAILURE);
+    }
+
+    fmt::json::DynamicFormatter json_formatter(CONFIG_OCS_BENCH_REPORT_SIZE);
+
+    code = json_formatter.format(json.get());
+    if (code != status::StatusCode::OK) {
+        ocs_loge(log_tag, "failed to format report: code=%s", status::code_to_str(code));
+        exit(EXIT_FAILURE);
+    }
+
+    printf("%s\n", json_formatter.c_str());
+    fflush(stdout);
+
+    exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "freertos/FreeRTOS.h"
+
+#include "benchmarks.h"
+#include "ocs_bench/do_not_optimize.h"
+#include "ocs_core/future.h"
+#include "ocs_core/lock_guard.h"
+#include "ocs_core/noncopyable.h"
+#include "ocs_core/static_recursive_mutex.h"
+#include "ocs_scheduler/async_func_scheduler.h"
+
+namespace ocs {
+namespace bench {
+
+namespace {
+
+const unsigned batch_size = 8;
+
+//! AsyncFuncScheduler as it was before add() was made allocation-free: functions are
+//! kept in the mutex-protected vectors, each add() allocates the future and the
+//! wrapping std::function. Used as the baseline for the AsyncFuncScheduler benchmarks.
+class LockedFuncScheduler : public core::NonCopyable<> {
+public:
+    using FuturePtr = std::shared_ptr<core::Future>;
+    using Func = std::function<status::StatusCode()>;
+
+    explicit LockedFuncScheduler(unsigned max_event_count)
+        : max_event_count_(max_event_count) {
+        read_queue_.reserve(max_event_count_);
+        write_queue_.reserve(max_event_count_);
+    }
+
+    void run() {
+        {
+            core::LockGuard lock(mu_);
+
+            if (!write_queue_.size()) {
+                return;
+            }
+
+            std::swap(write_queue_, read_queue_);
+        }
+
+        for (auto& fn : read_queue_) {
+            do_not_optimize(fn());
+        }
+
+        read_queue_.clear();
+    }
+
+    FuturePtr add(Func func) {
+        core::LockGuard lock(mu_);
+
+        if (write_queue_.size() == max_event_count_) {
+            return nullptr;
+        }
+
+        FuturePtr future(new (std::nothrow) core::Future());
+        if (!future) {
+            return nullptr;
+        }
+
+        write_queue_.push_back([func, future]() {
+            return future->notify(func());
+        });
+
+        return future;
+    }
+
+private:
+    const unsigned max_event_count_ { 0 };
+
+    core::StaticRecursiveMutex mu_;
+    std::vector<Func> read_queue_;
+    std::vector<Func> write_queue_;
+};
+
+std::unique_ptr<scheduler::AsyncFuncScheduler> func_scheduler;
+std::unique_ptr<LockedFuncScheduler> locked_func_scheduler;
+unsigned func_value { 0 };
+
+status::StatusCode increment() {
+    ++func_value;
+
+    return status::StatusCode::OK;
+}
+
+} // namespace
+
+void add_scheduler_benchmarks(Runner& runner) {
+    func_scheduler.reset(new (std::nothrow) scheduler::AsyncFuncScheduler(batch_size));
+    configASSERT(func_scheduler);
+
+    configASSERT(runner.add("scheduler/async_func_scheduler/add_run/1",
+                            []() {
+                                do_not_optimize(func_scheduler->add(increment));
+                                func_scheduler->run();
+                            })
+                 == status::StatusCode::OK);
+
+    configASSERT(runner.add("scheduler/async_func_scheduler/add_run/8",
+                            []() {
+                                for (unsigned n = 0; n < batch_size; ++n) {
+                                    do_not_optimize(func_scheduler->add(increment));
+                                }
+                                func_scheduler->run();
+                            })
+                 == status::StatusCode::OK);
+
+    locked_func_scheduler.reset(new (std::nothrow) LockedFuncScheduler(batch_size));
+    configASSERT(locked_func_scheduler);
+
+    configASSERT(runner.add("scheduler/async_func_scheduler/baseline/add_run/1",
+                            []() {
+                                do_not_optimize(locked_func_scheduler->add(increment));
+                                locked_func_scheduler->run();
+                            })
+                 == status::StatusCode::OK);
+
+    configASSERT(runner.add("scheduler/async_func_scheduler/baseline/add_run/8",
+                            []() {
+                                for (unsigned n = 0; n < batch_size; ++n) {
+                                    do_not_optimize(
+                                        locked_func_scheduler->add(increment));
+                                }
+                                locked_func_scheduler->run();
+                            })
+                 == status::StatusCode::OK);
+}
+
+} // namespace bench
+} // namespace ocs
@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "ocs_bench/runner.h"
+
+namespace ocs {
+namespace bench {
+
+//! Add benchmarks for the ocs_algo component.
+void add_algo_benchmarks(Runner& runner);
+
+//! Add benchmarks for the ocs_core component.
+void add_core_benchmarks(Runner& runner);
+
+//! Add benchmarks for the ocs_fmt component.
+void add_fmt_benchmarks(Runner& runner);
+
+//! Add benchmarks for the ocs_scheduler component.
+void add_scheduler_benchmarks(Runner& runner);
+
+} // namespace bench
+} // namespace ocs
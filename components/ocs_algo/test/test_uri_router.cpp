@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <string>
+
+#include "unity.h"
+
+#include "ocs_algo/uri_router.h"
+
+namespace ocs {
+namespace algo {
+
+TEST_CASE("URI router: invalid pattern", "[ocs_algo], [uri_router]") {
+    UriRouter router;
+
+    TEST_ASSERT_EQUAL(status::StatusCode::InvalidArg, router.add(nullptr, 0));
+    TEST_ASSERT_EQUAL(status::StatusCode::InvalidArg, router.add("", 0));
+    TEST_ASSERT_EQUAL(status::StatusCode::InvalidArg, router.add("foo", 0));
+    TEST_ASSERT_EQUAL(status::StatusCode::InvalidArg, router.add("/foo/*/bar", 0));
+    TEST_ASSERT_EQUAL(status::StatusCode::InvalidArg, router.add("/foo*", 0));
+    TEST_ASSERT_EQUAL(status::StatusCode::InvalidArg, router.add("/foo/{}", 0));
+    TEST_ASSERT_EQUAL(status::StatusCode::InvalidArg, router.add("/foo/{bar", 0));
+    TEST_ASSERT_EQUAL(status::StatusCode::InvalidArg,
+                      router.add("/{a}/{b}/{c}/{d}/{e}", 0));
+}
+
+TEST_CASE("URI router: duplicate pattern", "[ocs_algo], [uri_router]") {
+    UriRouter router;
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, router.add("/foo/bar", 0));
+    TEST_ASSERT_EQUAL(status::StatusCode::InvalidArg, router.add("/foo/bar", 1));
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, router.add("/foo/*", 2));
+    TEST_ASSERT_EQUAL(status::StatusCode::InvalidArg, router.add("/foo/*", 3));
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, router.add("/foo/{id}/baz", 4));
+    TEST_ASSERT_EQUAL(status::StatusCode::InvalidArg, router.add("/foo/{name}/bar", 5));
+}
+
+TEST_CASE("URI router: literal routes", "[ocs_algo], [uri_router]") {
+    UriRouter router;
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, router.add("/", 0));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, router.add("/dashboard", 1));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, router.add("/api/v1/telemetry", 2));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, router.add("/api/v1/registration", 3));
+
+    unsigned id = 0;
+    UriRouter::Params params;
+
+    TEST_ASSERT_TRUE(router.match("/", id, params));
+    TEST_ASSERT_EQUAL(0, id);
+
+    TEST_ASSERT_TRUE(router.match("/dashboard", id, params));
+    TEST_ASSERT_EQUAL(1, id);
+
+    TEST_ASSERT_TRUE(router.match("/api/v1/telemetry", id, params));
+    TEST_ASSERT_EQUAL(2, id);
+
+    TEST_ASSERT_TRUE(router.match("/api/v1/registration", id, params));
+    TEST_ASSERT_EQUAL(3, id);
+    TEST_ASSERT_EQUAL(0, params.size());
+
+    TEST_ASSERT_FALSE(router.match("", id, params));
+    TEST_ASSERT_FALSE(router.match("api", id, params));
+    TEST_ASSERT_FALSE(router.match("/api", id, params));
+    TEST_ASSERT_FALSE(router.match("/api/v1", id, params));
+    TEST_ASSERT_FALSE(router.match("/api/v1/telemetry/", id, params));
+    TEST_ASSERT_FALSE(router.match("/api/v1/telemetryx", id, params));
+    TEST_ASSERT_FALSE(router.match("/dashboard/foo", id, params));
+}
+
+TEST_CASE("URI router: path parameters", "[ocs_algo], [uri_router]") {
+    UriRouter router;
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK,
+                      router.add("/api/v1/sensor/ds18b20/{sensor_id}/read", 0));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK,
+                      router.add("/api/v1/sensor/ds18b20/{sensor_id}/write", 1));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK,
+                      router.add("/api/v1/sensor/ds18b20/scan", 2));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, router.add("/{a}/{b}", 3));
+
+    unsigned id = 0;
+    UriRouter::Params params;
+
+    TEST_ASSERT_TRUE(router.match("/api/v1/sensor/ds18b20/soil_temp/read", id, params));
+    TEST_ASSERT_EQUAL(0, id);
+    TEST_ASSERT_EQUAL(1, params.size());
+    TEST_ASSERT_TRUE(params.get("sensor_id") == "soil_temp");
+    TEST_ASSERT_TRUE(params.get("foo") == "");
+
+    TEST_ASSERT_TRUE(
+        router.match("/api/v1/sensor/ds18b20/outside_temp/write", id, params));
+    TEST_ASSERT_EQUAL(1, id);
+    TEST_ASSERT_TRUE(params.get("sensor_id") == "outside_temp");
+
+    // Literal segment takes precedence over the parameter.
+    TEST_ASSERT_TRUE(router.match("/api/v1/sensor/ds18b20/scan", id, params));
+    TEST_ASSERT_EQUAL(2, id);
+    TEST_ASSERT_EQUAL(0, params.size());
+
+    // Parameter is used if the literal segment doesn't lead to the route.
+    TEST_ASSERT_TRUE(router.match("/api/v1", id, params));
+    TEST_ASSERT_EQUAL(3, id);
+    TEST_ASSERT_EQUAL(2, params.size());
+    TEST_ASSERT_TRUE(params.get("a") == "api");
+    TEST_ASSERT_TRUE(params.get("b") == "v1");
+
+    // Parameter doesn't match an empty segment.
+    TEST_ASSERT_FALSE(router.match("/api/v1/sensor/ds18b20//read", id, params));
+    TEST_ASSERT_FALSE(router.match("/api/", id, params));
+}
+
+TEST_CASE("URI router: wildcard", "[ocs_algo], [uri_router]") {
+    UriRouter router;
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, router.add("/assets/*", 0));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, router.add("/assets/index.html", 1));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, router.add("/*", 2));
+
+    unsigned id = 0;
+    UriRouter::Params params;
+
+    TEST_ASSERT_TRUE(router.match("/assets/index.html", id, params));
+    TEST_ASSERT_EQUAL(1, id);
+
+    TEST_ASSERT_TRUE(router.match("/assets/js/main.js", id, params));
+    TEST_ASSERT_EQUAL(0, id);
+
+    TEST_ASSERT_TRUE(router.match("/assets/", id, params));
+    TEST_ASSERT_EQUAL(0, id);
+
+    // Wildcard requires the separator.
+    TEST_ASSERT_TRUE(router.match("/assets", id, params));
+    TEST_ASSERT_EQUAL(2, id);
+
+    TEST_ASSERT_TRUE(router.match("/foo/bar", id, params));
+    TEST_ASSERT_EQUAL(2, id);
+}
+
+TEST_CASE("URI router: many routes", "[ocs_algo], [uri_router]") {
+    const unsigned route_count = 200;
+
+    UriRouter router;
+
+    for (unsigned n = 0; n < route_count; ++n) {
+        const std::string pattern = "/api/v1/route_" + std::to_string(n) + "/get";
+        TEST_ASSERT_EQUAL(status::StatusCode::OK, router.add(pattern.c_str(), n));
+    }
+
+    for (unsigned n = 0; n < route_count; ++n) {
+        const std::string path = "/api/v1/route_" + std::to_string(n) + "/get";
+
+        unsigned id = 0;
+        UriRouter::Params params;
+
+        TEST_ASSERT_TRUE(router.match(path, id, params));
+        TEST_ASSERT_EQUAL(n, id);
+    }
+}
+
+} // namespace algo
+} // namespace ocs
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <algorithm>
+
+#include "freertos/FreeRTOSConfig.h"
+
+#include "ocs_algo/uri_router.h"
+
+namespace ocs {
+namespace algo {
+
+namespace {
+
+//! Split the first segment from @p path, which starts with '/'.
+std::string_view split_segment(std::string_view& path) {
+    path.remove_prefix(1);
+
+    const auto pos = path.find('/');
+    const auto segment = path.substr(0, pos);
+
+    path = pos == std::string_view::npos ? std::string_view() : path.substr(pos);
+
+    return segment;
+}
+
+} // namespace
+
+std::string_view UriRouter::Params::get(std::string_view name) const {
+    for (unsigned n = 0; n < size_; ++n) {
+        if (params_[n].name == name) {
+            return params_[n].value;
+        }
+    }
+
+    return std::string_view();
+}
+
+unsigned UriRouter::Params::size() const {
+    return size_;
+}
+
+UriRouter::UriRouter() {
+    root_.reset(new (std::nothrow) Node());
+    configASSERT(root_);
+}
+
+status::StatusCode UriRouter::add(const char* pattern, unsigned id) {
+    if (!pattern || *pattern != '/') {
+        return status::StatusCode::InvalidArg;
+    }
+
+    std::string_view path(pattern);
+
+    Node* node = root_.get();
+    unsigned param_count = 0;
+
+    while (!path.empty()) {
+        const auto segment = split_segment(path);
+
+        if (segment == "*") {
+            if (!path.empty() || node->wildcard) {
+                return status::StatusCode::InvalidArg;
+            }
+
+            node->wildcard = id;
+            return status::StatusCode::OK;
+        }
+
+        if (!segment.empty() && segment.front() == '{') {
+            if (segment.size() < 3 || segment.back() != '}') {
+                return status::StatusCode::InvalidArg;
+            }
+
+            if (++param_count > max_param_count) {
+                return status::StatusCode::InvalidArg;
+            }
+
+            const auto name = segment.substr(1, segment.size() - 2);
+
+            if (!node->param) {
+                node->param.reset(new (std::nothrow) Node());
+                configASSERT(node->param);
+
+                node->param->segment = name;
+            } else if (node->param->segment != name) {
+                return status::StatusCode::InvalidArg;
+            }
+
+            node = node->param.get();
+            continue;
+        }
+
+        if (segment.find_first_of("*{}") != std::string_view::npos) {
+            return status::StatusCode::InvalidArg;
+        }
+
+        node = &get_child_(*node, segment);
+    }
+
+    if (node->route) {
+        return status::StatusCode::InvalidArg;
+    }
+
+    node->route = id;
+
+    return status::StatusCode::OK;
+}
+
+bool UriRouter::match(std::string_view path, unsigned& id, Params& params) const {
+    params.size_ = 0;
+
+    if (path.empty() || path.front() != '/') {
+        return false;
+    }
+
+    return match_(*root_, path, id, params);
+}
+
+bool UriRouter::match_(const Node& node,
+                       std::string_view path,
+                       unsigned& id,
+                       Params& params) {
+    if (path.empty()) {
+        if (node.route) {
+            id = *node.route;
+            return true;
+        }
+
+        return false;
+    }
+
+    std::string_view rest = path;
+    const auto segment = split_segment(rest);
+
+    if (const auto child = find_child_(node, segment); child) {
+        if (match_(*child, rest, id, params)) {
+            return true;
+        }
+    }
+
+    if (node.param && !segment.empty() && params.size_ < max_param_count) {
+        params.params_[params.size_++] = Params::Param { node.param->segment, segment };
+
+        if (match_(*node.param, rest, id, params)) {
+            return true;
+        }
+
+        --params.size_;
+    }
+
+    if (node.wildcard) {
+        id = *node.wildcard;
+        return true;
+    }
+
+    return false;
+}
+
+const UriRouter::Node* UriRouter::find_child_(const Node& node,
+                                              std::string_view segment) {
+    const auto it =
+        std::lower_bound(node.children.begin(), node.children.end(), segment,
+                         [](const NodePtr& child, std::string_view segment) {
+                             return child->segment < segment;
+                         });
+
+    if (it == node.children.end() || (*it)->segment != segment) {
+        return nullptr;
+    }
+
+    return it->get();
+}
+
+UriRouter::Node& UriRouter::get_child_(Node& node, std::string_view segment) {
+    auto it = std::lower_bound(node.children.begin(), node.children.end(), segment,
+                               [](const NodePtr& child, std::string_view segment) {
+                                   return child->segment < segment;
+                               });
+
+    if (it != node.children.end() && (*it)->segment == segment) {
+        return **it;
+    }
+
+    NodePtr child(new (std::nothrow) Node());
+    configASSERT(child);
+
+    child->segment = segment;
+
+    return **node.children.insert(it, std::move(child));
+}
+
+} // namespace algo
+} // namespace ocs
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ocs_core/noncopyable.h"
+#include "ocs_status/code.h"
+
+namespace ocs {
+namespace algo {
+
+//! Resolve URI paths into the registered routes.
+//!
+//! @notes
+//!  Route pattern consists of segments separated by '/', each segment is either:
+//!   - literal, matches the same path segment, e.g. "sensor";
+//!   - parameter, matches any non-empty path segment, e.g. "{sensor_id}";
+//!   - wildcard, the last segment only, matches the rest of the path, e.g. "*".
+//!
+//!  Literal segments take precedence over parameters, and parameters take precedence
+//!  over wildcards. Patterns are stored in a trie of segments, with the literal
+//!  children sorted, so the lookup time depends on the path length, and not on the
+//!  number of routes.
+//!
+//! @example
+//!  UriRouter router;
+//!  router.add("/api/v1/sensor/{sensor_id}/read", 0);
+//!  router.add("/assets/*", 1);
+//!
+//!  unsigned id = 0;
+//!  UriRouter::Params params;
+//!  if (router.match("/api/v1/sensor/soil_temp/read", id, params)) {
+//!      // id is 0, params.get("sensor_id") is "soil_temp".
+//!  }
+class UriRouter : public core::NonCopyable<> {
+public:
+    //! Maximum number of parameters in a single route.
+    static constexpr unsigned max_param_count = 4;
+
+    //! Path parameters of the matched route.
+    //!
+    //! @remarks
+    //!  Values refer to the matched path, and the names refer to the router, both
+    //!  should be valid while the parameters are being used.
+    class Params {
+    public:
+        //! Return the value of the parameter @p name, or empty string if it's missing.
+        std::string_view get(std::string_view name) const;
+
+        //! Return the number of parameters.
+        unsigned size() const;
+
+    private:
+        friend class UriRouter;
+
+        struct Param {
+            std::string_view name;
+            std::string_view value;
+        };
+
+        Param params_[max_param_count];
+        unsigned size_ { 0 };
+    };
+
+    //! Initialize.
+    UriRouter();
+
+    //! Register route @p pattern with @p id.
+    //!
+    //! @remarks
+    //!  InvalidArg is returned if the pattern is malformed, is already registered, or
+    //!  conflicts with the parameter name of another pattern.
+    status::StatusCode add(const char* pattern, unsigned id);
+
+    //! Find the route matching @p path.
+    //!
+    //! @returns
+    //!  True if the route is found, its identifier is stored in @p id, and path
+    //!  parameters are stored in @p params.
+    bool match(std::string_view path, unsigned& id, Params& params) const;
+
+private:
+    struct Node;
+
+    using NodePtr = std::unique_ptr<Node>;
+
+    struct Node {
+        std::string segment;
+
+        //! Literal children, sorted by the segment.
+        std::vector<NodePtr> children;
+
+        //! Parameter child, segment holds the parameter name.
+        NodePtr param;
+
+        std::optional<unsigned> route;
+        std::optional<unsigned> wildcard;
+    };
+
+    static bool
+    match_(const Node& node, std::string_view path, unsigned& id, Params& params);
+
+    static const Node* find_child_(const Node& node, std::string_view segment);
+
+    static Node& get_child_(Node& node, std::string_view segment);
+
+    NodePtr root_;
+};
+
+} // namespace algo
+} // namespace ocs
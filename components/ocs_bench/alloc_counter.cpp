@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+#include "cJSON.h"
+
+#include "ocs_bench/alloc_counter.h"
+#include "ocs_bench/do_not_optimize.h"
+
+extern "C" {
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+
+} // extern "C"
+
+namespace ocs {
+namespace bench {
+
+namespace {
+
+std::atomic<uint64_t> alloc_count { 0 };
+std::atomic<uint64_t> alloc_bytes { 0 };
+
+void count_allocation(std::size_t size) {
+    alloc_count.fetch_add(1, std::memory_order_relaxed);
+    alloc_bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+// Counted by the malloc() wrapper.
+void* allocate(std::size_t size) {
+    return malloc(size ? size : 1);
+}
+
+} // namespace
+
+uint64_t AllocCounter::count() {
+    return alloc_count.load(std::memory_order_relaxed);
+}
+
+uint64_t AllocCounter::bytes() {
+    return alloc_bytes.load(std::memory_order_relaxed);
+}
+
+status::StatusCode AllocCounter::check() {
+    auto count = AllocCounter::count();
+    auto bytes = AllocCounter::bytes();
+
+    std::unique_ptr<uint32_t> value(new (std::nothrow) uint32_t(0));
+    if (!value) {
+        return status::StatusCode::NoMem;
+    }
+    do_not_optimize(value.get());
+
+    if (AllocCounter::count() - count != 1
+        || AllocCounter::bytes() - bytes != sizeof(uint32_t)) {
+        return status::StatusCode::Error;
+    }
+
+    count = AllocCounter::count();
+    bytes = AllocCounter::bytes();
+
+    // cJSON allocates memory with malloc().
+    cJSON* json = cJSON_CreateObject();
+    if (!json) {
+        return status::StatusCode::NoMem;
+    }
+    cJSON_Delete(json);
+
+    if (AllocCounter::count() - count != 1
+        || AllocCounter::bytes() - bytes != sizeof(cJSON)) {
+        return status::StatusCode::Error;
+    }
+
+    return status::StatusCode::OK;
+}
+
+} // namespace bench
+} // namespace ocs
+
+extern "C" {
+
+void* __wrap_malloc(size_t size) {
+    ocs::bench::count_allocation(size);
+
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+    ocs::bench::count_allocation(count * size);
+
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+    if (size) {
+        ocs::bench::count_allocation(size);
+    }
+
+    return __real_realloc(ptr, size);
+}
+
+} // extern "C"
+
+void* operator new(std::size_t size) {
+    void* ptr = ocs::bench::allocate(size);
+    if (!ptr) {
+        abort();
+    }
+
+    return ptr;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return ocs::bench::allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return ocs::bench::allocate(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    free(ptr);
+}
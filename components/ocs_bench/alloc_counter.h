@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "ocs_status/code.h"
+
+namespace ocs {
+namespace bench {
+
+//! Count heap allocations.
+//!
+//! @notes
+//!  Linking ocs_bench wraps malloc(), calloc() and realloc() with the linker, and
+//!  replaces the global operator new, so the allocations of both C and C++ code are
+//!  counted, e.g. cJSON items. Each realloc() call with the non-zero size is counted
+//!  as an allocation. Allocations made inside the C library itself aren't counted.
+struct AllocCounter {
+    //! Return the total number of allocations.
+    static uint64_t count();
+
+    //! Return the total number of allocated bytes.
+    static uint64_t bytes();
+
+    //! Check that the allocations made with operator new and with malloc() are counted.
+    //!
+    //! @remarks
+    //!  Fails if the heap functions weren't wrapped when the application was linked.
+    static status::StatusCode check();
+};
+
+} // namespace bench
+} // namespace ocs
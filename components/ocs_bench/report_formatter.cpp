@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "ocs_bench/report_formatter.h"
+#include "ocs_fmt/json/cjson_builder.h"
+#include "ocs_fmt/json/cjson_object_formatter.h"
+
+namespace ocs {
+namespace bench {
+
+namespace {
+
+status::StatusCode format_result(cJSON* json, const Runner::Result& result) {
+    fmt::json::CjsonObjectFormatter formatter(json);
+
+    if (!formatter.add_string_cs("id", result.id.c_str())) {
+        return status::StatusCode::NoMem;
+    }
+
+    if (!formatter.add_number_cs("batch", result.batch)) {
+        return status::StatusCode::NoMem;
+    }
+
+    if (!formatter.add_number_cs("samples", result.sample_count)) {
+        return status::StatusCode::NoMem;
+    }
+
+    if (!formatter.add_number_cs("ops", result.op_count)) {
+        return status::StatusCode::NoMem;
+    }
+
+    if (!formatter.add_number_cs("min", result.time_min)) {
+        return status::StatusCode::NoMem;
+    }
+
+    if (!formatter.add_number_cs("p50", result.time_p50)) {
+        return status::StatusCode::NoMem;
+    }
+
+    if (!formatter.add_number_cs("p90", result.time_p90)) {
+        return status::StatusCode::NoMem;
+    }
+
+    if (!formatter.add_number_cs("p99", result.time_p99)) {
+        return status::StatusCode::NoMem;
+    }
+
+    if (!formatter.add_number_cs("max", result.time_max)) {
+        return status::StatusCode::NoMem;
+    }
+
+    if (!formatter.add_number_cs("mean", result.time_mean)) {
+        return status::StatusCode::NoMem;
+    }
+
+    if (!formatter.add_number_cs("allocs_per_op", result.allocs_per_op)) {
+        return status::StatusCode::NoMem;
+    }
+
+    if (!formatter.add_number_cs("bytes_per_op", result.bytes_per_op)) {
+        return status::StatusCode::NoMem;
+    }
+
+    return status::StatusCode::OK;
+}
+
+} // namespace
+
+ReportFormatter::ReportFormatter(const Runner& runner)
+    : runner_(runner) {
+}
+
+status::StatusCode ReportFormatter::format(cJSON* json) {
+    auto array = cJSON_AddArrayToObject(json, "benchmarks");
+    if (!array) {
+        return status::StatusCode::NoMem;
+    }
+
+    for (const auto& result : runner_.results()) {
+        auto json = fmt::json::CjsonUniqueBuilder::make_object();
+        if (!json) {
+            return status::StatusCode::NoMem;
+        }
+
+        const auto code = format_result(json.get(), result);
+        if (code != status::StatusCode::OK) {
+            return code;
+        }
+
+        if (!cJSON_AddItemToArray(array, json.get())) {
+            return status::StatusCode::NoMem;
+        }
+        json.release();
+    }
+
+    return status::StatusCode::OK;
+}
+
+} // namespace bench
+} // namespace ocs
@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "ocs_bench/runner.h"
+#include "ocs_core/noncopyable.h"
+#include "ocs_fmt/json/iformatter.h"
+
+namespace ocs {
+namespace bench {
+
+//! Format benchmark statistics into JSON.
+//!
+//! @notes
+//!  The report has the following structure:
+//!  {"benchmarks": [{"id": "algo/crc8/64", "p50": 120.5, ...}, ...]}
+class ReportFormatter : public fmt::json::IFormatter, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    explicit ReportFormatter(const Runner& runner);
+
+    //! Format the statistics of the run benchmarks.
+    status::StatusCode format(cJSON* json) override;
+
+private:
+    const Runner& runner_;
+};
+
+} // namespace bench
+} // namespace ocs
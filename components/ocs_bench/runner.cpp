@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+#include "freertos/FreeRTOS.h"
+
+#include "ocs_bench/alloc_counter.h"
+#include "ocs_bench/runner.h"
+#include "ocs_core/log.h"
+
+namespace ocs {
+namespace bench {
+
+namespace {
+
+const char* log_tag = "bench_runner";
+
+//! Nearest-rank percentile of the sorted samples.
+double percentile(const std::vector<double>& samples, double p) {
+    const auto rank = static_cast<unsigned>(std::ceil(p * samples.size()));
+
+    return samples[std::clamp<unsigned>(rank, 1, samples.size()) - 1];
+}
+
+} // namespace
+
+Runner::Runner(Params params)
+    : params_(params) {
+    configASSERT(params_.sample_count);
+    configASSERT(params_.sample_duration > 0);
+}
+
+status::StatusCode Runner::add(const char* id, Func func) {
+    return add(id, std::move(func), nullptr, nullptr);
+}
+
+status::StatusCode Runner::add(const char* id, Func func, Func setup, Func teardown) {
+    configASSERT(id);
+    configASSERT(func);
+
+    for (const auto& benchmark : benchmarks_) {
+        if (benchmark.id == id) {
+            return status::StatusCode::InvalidArg;
+        }
+    }
+
+    benchmarks_.push_back(
+        Benchmark { id, std::move(func), std::move(setup), std::move(teardown) });
+
+    return status::StatusCode::OK;
+}
+
+status::StatusCode Runner::run(const char* prefix) {
+    configASSERT(prefix);
+
+    results_.clear();
+
+    for (auto& benchmark : benchmarks_) {
+        if (strncmp(benchmark.id.c_str(), prefix, strlen(prefix)) != 0) {
+            continue;
+        }
+
+        const auto result = run_(benchmark);
+
+        ocs_logi(log_tag,
+                 "%s: batch=%u p50=%.1f(ns) p90=%.1f(ns) p99=%.1f(ns) min=%.1f(ns) "
+                 "max=%.1f(ns) allocs=%.2f bytes=%.1f",
+                 result.id.c_str(), result.batch, result.time_p50, result.time_p90,
+                 result.time_p99, result.time_min, result.time_max, result.allocs_per_op,
+                 result.bytes_per_op);
+
+        results_.push_back(result);
+    }
+
+    return results_.size() ? status::StatusCode::OK : status::StatusCode::InvalidArg;
+}
+
+const Runner::ResultList& Runner::results() const {
+    return results_;
+}
+
+int64_t Runner::now_ns_() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+unsigned Runner::calibrate_(Func& func) {
+    const int64_t sample_ns = params_.sample_duration * 1000;
+
+    unsigned batch = 1;
+
+    while (true) {
+        const auto start_ns = now_ns_();
+
+        for (unsigned n = 0; n < batch; ++n) {
+            func();
+        }
+
+        if (now_ns_() - start_ns >= sample_ns || batch >= (1u << 30)) {
+            return batch;
+        }
+
+        batch *= 2;
+    }
+}
+
+Runner::Result Runner::run_(Benchmark& benchmark) {
+    if (benchmark.setup) {
+        benchmark.setup();
+    }
+
+    for (unsigned n = 0; n < params_.warmup_count; ++n) {
+        benchmark.func();
+    }
+
+    Result result;
+    result.id = benchmark.id;
+    result.batch = calibrate_(benchmark.func);
+    result.sample_count = params_.sample_count;
+    result.op_count = uint64_t(result.batch) * result.sample_count;
+
+    std::vector<double> samples;
+    samples.reserve(params_.sample_count);
+
+    const auto alloc_count = AllocCounter::count();
+    const auto alloc_bytes = AllocCounter::bytes();
+
+    for (unsigned s = 0; s < params_.sample_count; ++s) {
+        const auto start_ns = now_ns_();
+
+        for (unsigned n = 0; n < result.batch; ++n) {
+            benchmark.func();
+        }
+
+        samples.push_back(double(now_ns_() - start_ns) / result.batch);
+    }
+
+    // Samples vector is reserved in advance, so it doesn't affect the counters.
+    result.allocs_per_op = double(AllocCounter::count() - alloc_count) / result.op_count;
+    result.bytes_per_op = double(AllocCounter::bytes() - alloc_bytes) / result.op_count;
+
+    if (benchmark.teardown) {
+        benchmark.teardown();
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    result.time_min = samples.front();
+    result.time_max = samples.back();
+    result.time_p50 = percentile(samples, 0.5);
+    result.time_p90 = percentile(samples, 0.9);
+    result.time_p99 = percentile(samples, 0.99);
+
+    double sum = 0;
+    for (const auto& sample : samples) {
+        sum += sample;
+    }
+    result.time_mean = sum / samples.size();
+
+    return result;
+}
+
+} // namespace bench
+} // namespace ocs
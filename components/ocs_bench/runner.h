@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "ocs_core/noncopyable.h"
+#include "ocs_core/time.h"
+#include "ocs_status/code.h"
+
+namespace ocs {
+namespace bench {
+
+//! Run micro-benchmarks and collect their statistics.
+//!
+//! @notes
+//!  Each benchmark is warmed up, then the number of operations per sample (batch) is
+//!  calibrated, so a sample takes at least the configured duration. The samples are
+//!  sorted to calculate the percentiles. The median is the most stable metric when
+//!  comparing the results of different runs.
+class Runner : public core::NonCopyable<> {
+public:
+    //! Operation to be measured.
+    using Func = std::function<void()>;
+
+    struct Params {
+        //! Number of operations run before the measurement.
+        unsigned warmup_count { 1000 };
+
+        //! Number of samples.
+        unsigned sample_count { 50 };
+
+        //! Minimum duration of a single sample.
+        core::Time sample_duration { core::Duration::millisecond * 2 };
+    };
+
+    //! Benchmark statistics, time is in nanoseconds per operation.
+    struct Result {
+        std::string id;
+        unsigned batch { 0 };
+        unsigned sample_count { 0 };
+        uint64_t op_count { 0 };
+        double time_min { 0 };
+        double time_p50 { 0 };
+        double time_p90 { 0 };
+        double time_p99 { 0 };
+        double time_max { 0 };
+        double time_mean { 0 };
+        double allocs_per_op { 0 };
+        double bytes_per_op { 0 };
+    };
+
+    using ResultList = std::vector<Result>;
+
+    //! Initialize.
+    explicit Runner(Params params);
+
+    //! Add benchmark.
+    //!
+    //! @params
+    //!  - @p id - unique benchmark identifier, e.g. "algo/crc8/64".
+    //!  - @p func - operation to be measured.
+    status::StatusCode add(const char* id, Func func);
+
+    //! Add benchmark with the fixture.
+    //!
+    //! @params
+    //!  - @p id - unique benchmark identifier.
+    //!  - @p func - operation to be measured.
+    //!  - @p setup - called before the warmup, e.g. to start the background load.
+    //!  - @p teardown - called after the measurement.
+    status::StatusCode add(const char* id, Func func, Func setup, Func teardown);
+
+    //! Run benchmarks, which identifiers start with @p prefix.
+    //!
+    //! @remarks
+    //!  Empty prefix matches all benchmarks.
+    status::StatusCode run(const char* prefix = "");
+
+    //! Return statistics of the run benchmarks.
+    const ResultList& results() const;
+
+private:
+    struct Benchmark {
+        std::string id;
+        Func func;
+        Func setup;
+        Func teardown;
+    };
+
+    static int64_t now_ns_();
+
+    unsigned calibrate_(Func& func);
+    Result run_(Benchmark& benchmark);
+
+    const Params params_;
+
+    std::vector<Benchmark> benchmarks_;
+    ResultList results_;
+};
+
+} // namespace bench
+} // namespace ocs
@@ -9,6 +9,7 @@
 #include "freertos/FreeRTOSConfig.h"
 
 #include "ocs_control/fsm_block.h"
+#include "ocs_control/fsm_block_record.h"
 #include "ocs_core/log.h"
 #include "ocs_status/code_to_str.h"
 #include "ocs_status/macros.h"
@@ -118,25 +119,93 @@ void FsmBlock::set_next(State state) {
 status::StatusCode FsmBlock::write_() {
     ++write_count_;
 
-    OCS_STATUS_RETURN_ON_ERROR(
-        storage_.write("write_count", &write_count_, sizeof(write_count_)));
+    return write_record_();
+}
 
-    OCS_STATUS_RETURN_ON_ERROR(
-        storage_.write("prev_state", &prev_state_, sizeof(prev_state_)));
+status::StatusCode FsmBlock::write_record_() {
+    FsmBlockRecord record;
+    record.prev_state = prev_state_;
+    record.curr_state = curr_state_;
+    record.prev_state_dur = prev_state_dur_;
+    record.curr_state_dur = curr_state_dur_;
+    record.write_count = write_count_;
+    record.seal();
 
-    OCS_STATUS_RETURN_ON_ERROR(
-        storage_.write("prev_state_dur", &prev_state_dur_, sizeof(prev_state_dur_)));
+    return storage_.write(FsmBlockRecord::key, &record, sizeof(record));
+}
 
-    OCS_STATUS_RETURN_ON_ERROR(
-        storage_.write("curr_state", &curr_state_, sizeof(curr_state_)));
+status::StatusCode FsmBlock::read_() {
+    size_t size = 0;
+
+    const auto code = storage_.probe(FsmBlockRecord::key, size);
+    if (code == status::StatusCode::NoData) {
+        return migrate_();
+    }
+    if (code != status::StatusCode::OK) {
+        return code;
+    }
+
+    if (size != sizeof(FsmBlockRecord)) {
+        ocs_loge(log_tag_.c_str(), "unsupported record: size=%u",
+                 static_cast<unsigned>(size));
+
+        return status::StatusCode::InvalidState;
+    }
+
+    FsmBlockRecord record;
 
     OCS_STATUS_RETURN_ON_ERROR(
-        storage_.write("curr_state_dur", &curr_state_dur_, sizeof(curr_state_dur_)));
+        storage_.read(FsmBlockRecord::key, &record, sizeof(record)));
+
+    if (record.version != FsmBlockRecord::current_version) {
+        ocs_loge(log_tag_.c_str(), "unsupported record: version=%u", record.version);
+
+        return status::StatusCode::InvalidState;
+    }
+
+    if (!record.valid()) {
+        ocs_loge(log_tag_.c_str(), "corrupted record: crc=%lu",
+                 static_cast<unsigned long>(record.crc));
+
+        return status::StatusCode::InvalidState;
+    }
+
+    prev_state_ = record.prev_state;
+    curr_state_ = record.curr_state;
+    prev_state_dur_ = record.prev_state_dur;
+    curr_state_dur_ = record.curr_state_dur;
+    write_count_ = record.write_count;
 
     return status::StatusCode::OK;
 }
 
-status::StatusCode FsmBlock::read_() {
+status::StatusCode FsmBlock::migrate_() {
+    OCS_STATUS_RETURN_ON_ERROR(read_legacy_());
+
+    auto code = write_record_();
+    if (code != status::StatusCode::OK) {
+        // Legacy keys are kept, the migration is repeated on the next startup.
+        ocs_loge(log_tag_.c_str(), "failed to migrate block: %s",
+                 status::code_to_str(code));
+
+        return status::StatusCode::OK;
+    }
+
+    for (const char* key : legacy_keys_) {
+        code = storage_.erase(key);
+        if (code != status::StatusCode::OK && code != status::StatusCode::NoData) {
+            ocs_loge(log_tag_.c_str(), "failed to erase legacy key: key=%s code=%s", key,
+                     status::code_to_str(code));
+        }
+    }
+
+    ocs_logi(log_tag_.c_str(), "block migrated to record: version=%u",
+             FsmBlockRecord::current_version);
+
+    return status::StatusCode::OK;
+}
+
+status::StatusCode FsmBlock::read_legacy_() {
     OCS_STATUS_RETURN_ON_ERROR(
         storage_.read("write_count", &write_count_, sizeof(write_count_)));
 
@@ -20,6 +20,11 @@ namespace ocs {
 namespace control {
 
 //! FSM state.
+//!
+//! @notes
+//!  The block state is persisted as a single CRC-protected record, see FsmBlockRecord.
+//!  The state persisted by the previous firmware versions, as separate keys, is
+//!  migrated to the record at startup.
 class FsmBlock : public system::IRebootHandler,
                  public scheduler::ITask,
                  public core::NonCopyable<> {
@@ -85,7 +90,15 @@ public:
 
 private:
     status::StatusCode read_();
+    status::StatusCode read_legacy_();
+    status::StatusCode migrate_();
     status::StatusCode write_();
+    status::StatusCode write_record_();
+
+    //! Keys used by the previous firmware versions to persist the block state.
+    static const constexpr char* legacy_keys_[] = {
+        "write_count", "prev_state", "prev_state_dur", "curr_state", "curr_state_dur",
+    };
 
     const std::string log_tag_;
     const core::Time resolution_ { 0 };
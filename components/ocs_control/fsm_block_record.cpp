@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <cstddef>
+
+#include "esp_rom_crc.h"
+
+#include "ocs_control/fsm_block_record.h"
+
+namespace ocs {
+namespace control {
+
+void FsmBlockRecord::seal() {
+    version = current_version;
+    crc = calculate_crc_();
+}
+
+bool FsmBlockRecord::valid() const {
+    return crc == calculate_crc_();
+}
+
+uint32_t FsmBlockRecord::calculate_crc_() const {
+    return esp_rom_crc32_le(0, reinterpret_cast<const uint8_t*>(this),
+                            offsetof(FsmBlockRecord, crc));
+}
+
+} // namespace control
+} // namespace ocs
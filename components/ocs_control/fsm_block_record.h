@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "ocs_core/macros.h"
+
+namespace ocs {
+namespace control {
+
+//! FSM block state, persisted in the storage as a single value.
+//!
+//! @notes
+//!  The layout is versioned, new fields should be added at the end, before the checksum,
+//!  and the version should be incremented.
+struct OCS_ATTR_PACKED FsmBlockRecord {
+    //! Storage key of the record.
+    static const constexpr char* key = "block";
+
+    //! Current version of the layout.
+    static const uint8_t current_version = 1;
+
+    //! Layout version.
+    uint8_t version { 0 };
+
+    //! Previous machine state.
+    uint16_t prev_state { 0 };
+
+    //! Current machine state.
+    uint16_t curr_state { 0 };
+
+    //! Time spend in the previous machine state.
+    int64_t prev_state_dur { 0 };
+
+    //! Time spend in the current machine state.
+    int64_t curr_state_dur { 0 };
+
+    //! Number of time a block was saved to the storage.
+    uint64_t write_count { 0 };
+
+    //! CRC-32 of all preceding fields.
+    uint32_t crc { 0 };
+
+    //! Set the current version and the checksum.
+    void seal();
+
+    //! Return true if the checksum matches the fields.
+    bool valid() const;
+
+private:
+    uint32_t calculate_crc_() const;
+};
+static_assert(sizeof(FsmBlockRecord) == 33);
+
+} // namespace control
+} // namespace ocs
@@ -283,5 +283,83 @@ TEST_CASE("FSM block: update current state duration", "[ocs_control], [fsm_block
     TEST_ASSERT_EQUAL(1, block.current_state_duration());
 }
 
+TEST_CASE("FSM block: initialization: migrate legacy persistent state",
+          "[ocs_control], [fsm_block]") {
+    TestFsmBlockStorage storage;
+    storage.legacy = true;
+    storage.prev_state = static_cast<FsmBlock::State>(State::First);
+    storage.curr_state = static_cast<FsmBlock::State>(State::Second);
+    storage.prev_state_duration = core::Duration::second;
+    storage.curr_state_duration = core::Duration::hour;
+    storage.write_count = 10;
+
+    test::TestClock clock;
+
+    const core::Time resolution = core::Duration::second;
+    const char* id = "block_id";
+
+    FsmBlock block(clock, storage, resolution, id);
+
+    TEST_ASSERT_EQUAL(static_cast<FsmBlock::State>(State::First), block.previous_state());
+    TEST_ASSERT_EQUAL(static_cast<FsmBlock::State>(State::Second), block.current_state());
+    TEST_ASSERT_EQUAL_INT64(core::Duration::second, block.previous_state_duration());
+    TEST_ASSERT_EQUAL_INT64(core::Duration::hour, block.current_state_duration());
+    TEST_ASSERT_EQUAL_UINT64(10, block.write_count());
+
+    // State is written as a single record, legacy keys are erased.
+    TEST_ASSERT_FALSE(storage.legacy);
+    TEST_ASSERT_EQUAL(5, storage.erase_count);
+
+    TEST_ASSERT_EQUAL(static_cast<FsmBlock::State>(State::First), storage.prev_state);
+    TEST_ASSERT_EQUAL(static_cast<FsmBlock::State>(State::Second), storage.curr_state);
+    TEST_ASSERT_EQUAL_INT64(core::Duration::second, storage.prev_state_duration);
+    TEST_ASSERT_EQUAL_INT64(core::Duration::hour, storage.curr_state_duration);
+    TEST_ASSERT_EQUAL_UINT64(10, storage.write_count);
+}
+
+TEST_CASE("FSM block: initialization: failed to migrate legacy persistent state",
+          "[ocs_control], [fsm_block]") {
+    TestFsmBlockStorage storage(status::StatusCode::OK, status::StatusCode::Error);
+    storage.legacy = true;
+    storage.curr_state = static_cast<FsmBlock::State>(State::Second);
+    storage.curr_state_duration = core::Duration::hour;
+
+    test::TestClock clock;
+
+    const core::Time resolution = core::Duration::second;
+    const char* id = "block_id";
+
+    FsmBlock block(clock, storage, resolution, id);
+
+    // State is restored, legacy keys are kept to repeat the migration.
+    TEST_ASSERT_EQUAL(static_cast<FsmBlock::State>(State::Second), block.current_state());
+    TEST_ASSERT_EQUAL_INT64(core::Duration::hour, block.current_state_duration());
+
+    TEST_ASSERT_TRUE(storage.legacy);
+    TEST_ASSERT_EQUAL(0, storage.erase_count);
+}
+
+TEST_CASE("FSM block: initialization: corrupted persistent state",
+          "[ocs_control], [fsm_block]") {
+    TestFsmBlockStorage storage;
+    storage.corrupted = true;
+    storage.prev_state = static_cast<FsmBlock::State>(State::First);
+    storage.curr_state = static_cast<FsmBlock::State>(State::Second);
+    storage.curr_state_duration = core::Duration::hour;
+    storage.write_count = 10;
+
+    test::TestClock clock;
+
+    const core::Time resolution = core::Duration::second;
+    const char* id = "block_id";
+
+    FsmBlock block(clock, storage, resolution, id);
+
+    TEST_ASSERT_EQUAL(0, block.previous_state());
+    TEST_ASSERT_EQUAL(0, block.current_state());
+    TEST_ASSERT_EQUAL_INT64(0, block.current_state_duration());
+    TEST_ASSERT_EQUAL_UINT64(0, block.write_count());
+}
+
 } // namespace control
 } // namespace ocs
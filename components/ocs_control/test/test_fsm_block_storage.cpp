@@ -10,6 +10,7 @@
 
 #include "unity.h"
 
+#include "ocs_control/fsm_block_record.h"
 #include "ocs_control/test/test_fsm_block_storage.h"
 
 namespace ocs {
@@ -24,7 +25,21 @@ TestFsmBlockStorage::TestFsmBlockStorage(status::StatusCode read_status,
 }
 
 status::StatusCode TestFsmBlockStorage::probe(const char* key, unsigned& size) {
-    return status::StatusCode::Error;
+    if (read_status != status::StatusCode::OK) {
+        return read_status;
+    }
+
+    if (strcmp(key, FsmBlockRecord::key) != 0) {
+        return status::StatusCode::Error;
+    }
+
+    if (legacy) {
+        return status::StatusCode::NoData;
+    }
+
+    size = sizeof(FsmBlockRecord);
+
+    return status::StatusCode::OK;
 }
 
 status::StatusCode TestFsmBlockStorage::read(const char* key, void* data, unsigned size) {
@@ -32,6 +47,34 @@ status::StatusCode TestFsmBlockStorage::read(const char* key, void* data, unsign
         return read_status;
     }
 
+    if (strcmp(key, FsmBlockRecord::key) == 0) {
+        if (legacy) {
+            return status::StatusCode::NoData;
+        }
+
+        TEST_ASSERT_EQUAL(sizeof(FsmBlockRecord), size);
+
+        FsmBlockRecord record;
+        record.prev_state = prev_state;
+        record.curr_state = curr_state;
+        record.prev_state_dur = prev_state_duration;
+        record.curr_state_dur = curr_state_duration;
+        record.write_count = write_count;
+        record.seal();
+
+        if (corrupted) {
+            record.crc = ~record.crc;
+        }
+
+        memcpy(data, &record, sizeof(record));
+
+        return status::StatusCode::OK;
+    }
+
+    if (!legacy) {
+        return status::StatusCode::NoData;
+    }
+
     if (strcmp(key, "prev_state") == 0) {
         TEST_ASSERT_EQUAL(sizeof(prev_state), size);
         *static_cast<FsmBlock::State*>(data) = prev_state;
@@ -60,25 +103,27 @@ TestFsmBlockStorage::write(const char* key, const void* data, unsigned size) {
         return write_status;
     }
 
-    if (strcmp(key, "prev_state") == 0) {
-        TEST_ASSERT_EQUAL(sizeof(prev_state), size);
-        prev_state = *static_cast<const FsmBlock::State*>(data);
-    } else if (strcmp(key, "curr_state") == 0) {
-        TEST_ASSERT_EQUAL(sizeof(curr_state), size);
-        curr_state = *static_cast<const FsmBlock::State*>(data);
-    } else if (strcmp(key, "prev_state_dur") == 0) {
-        TEST_ASSERT_EQUAL(sizeof(prev_state_duration), size);
-        prev_state_duration = *static_cast<const core::Time*>(data);
-    } else if (strcmp(key, "curr_state_dur") == 0) {
-        TEST_ASSERT_EQUAL(sizeof(curr_state_duration), size);
-        curr_state_duration = *static_cast<const core::Time*>(data);
-    } else if (strcmp(key, "write_count") == 0) {
-        TEST_ASSERT_EQUAL(sizeof(write_count), size);
-        write_count = *static_cast<const decltype(write_count)*>(data);
-    } else {
+    if (strcmp(key, FsmBlockRecord::key) != 0) {
         return status::StatusCode::Error;
     }
 
+    TEST_ASSERT_EQUAL(sizeof(FsmBlockRecord), size);
+
+    FsmBlockRecord record;
+    memcpy(&record, data, sizeof(record));
+
+    TEST_ASSERT_EQUAL(FsmBlockRecord::current_version, record.version);
+    TEST_ASSERT_TRUE(record.valid());
+
+    prev_state = record.prev_state;
+    curr_state = record.curr_state;
+    prev_state_duration = record.prev_state_dur;
+    curr_state_duration = record.curr_state_dur;
+    write_count = record.write_count;
+
+    legacy = false;
+    corrupted = false;
+
     return status::StatusCode::OK;
 }
 
@@ -87,6 +132,12 @@ status::StatusCode TestFsmBlockStorage::erase(const char* key) {
         return erase_status;
     }
 
+    ++erase_count;
+
+    if (!legacy) {
+        return status::StatusCode::NoData;
+    }
+
     if (strcmp(key, "prev_state") == 0) {
         prev_state = 0;
     } else if (strcmp(key, "curr_state") == 0) {
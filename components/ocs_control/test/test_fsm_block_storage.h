@@ -30,6 +30,14 @@ public:
     core::Time curr_state_duration { 0 };
     uint64_t write_count { 0 };
 
+    //! Block state is stored as separate keys, as by the previous firmware versions.
+    bool legacy { false };
+
+    //! Stored record has invalid checksum.
+    bool corrupted { false };
+
+    unsigned erase_count { 0 };
+
     status::StatusCode read_status { status::StatusCode::OK };
     status::StatusCode write_status { status::StatusCode::OK };
     status::StatusCode erase_status { status::StatusCode::OK };
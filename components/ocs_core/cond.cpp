@@ -18,19 +18,40 @@ Cond::Cond(ILocker& locker)
 }
 
 status::StatusCode Cond::wait(TickType_t wait) {
-    append_task_();
+    Waiter waiter;
+    waiter.task = xTaskGetCurrentTaskHandle();
+
+    push_(waiter);
+
+    const auto code = locker_.unlock();
+    if (code != status::StatusCode::OK) {
+        remove_(waiter);
+        return code;
+    }
+
+    const bool notified = ulTaskNotifyTake(pdTRUE, wait) != 0;
+
+    // The waiter should never remain in the list once the function returns. It's still
+    // in the list on timeout, or if the task was notified by someone else.
+    const bool removed = remove_(waiter);
+
+    if (!notified && !removed) {
+        // Signaled after the timeout, consume the notification, so it doesn't wake
+        // the next wait.
+        ulTaskNotifyTake(pdTRUE, 0);
+    }
+
+    const bool signaled = notified || !removed;
 
-    OCS_STATUS_RETURN_ON_ERROR(locker_.unlock());
-    const auto count = ulTaskNotifyTake(pdTRUE, wait);
     OCS_STATUS_RETURN_ON_ERROR(locker_.lock());
 
-    return count != 0 ? status::StatusCode::OK : status::StatusCode::Error;
+    return signaled ? status::StatusCode::OK : status::StatusCode::Error;
 }
 
 status::StatusCode Cond::signal() {
     core::LockGuard lock(mu_);
 
-    if (!tasks_.empty()) {
+    if (head_) {
         return signal_();
     }
 
@@ -40,22 +61,62 @@ status::StatusCode Cond::signal() {
 status::StatusCode Cond::broadcast() {
     core::LockGuard lock(mu_);
 
-    while (!tasks_.empty()) {
+    while (head_) {
         OCS_STATUS_RETURN_ON_ERROR(signal_());
     }
 
     return status::StatusCode::OK;
 }
 
-void Cond::append_task_() {
+void Cond::push_(Waiter& waiter) {
     core::LockGuard lock(mu_);
 
-    tasks_.push_back(xTaskGetCurrentTaskHandle());
+    if (tail_) {
+        tail_->next = &waiter;
+    } else {
+        head_ = &waiter;
+    }
+
+    tail_ = &waiter;
+}
+
+bool Cond::remove_(Waiter& waiter) {
+    core::LockGuard lock(mu_);
+
+    Waiter* prev = nullptr;
+
+    for (auto node = head_; node; prev = node, node = node->next) {
+        if (node != &waiter) {
+            continue;
+        }
+
+        if (prev) {
+            prev->next = node->next;
+        } else {
+            head_ = node->next;
+        }
+
+        if (tail_ == node) {
+            tail_ = prev;
+        }
+
+        return true;
+    }
+
+    return false;
 }
 
 status::StatusCode Cond::signal_() {
-    auto task = tasks_.front();
-    tasks_.pop_front();
+    auto waiter = head_;
+
+    head_ = waiter->next;
+    if (!head_) {
+        tail_ = nullptr;
+    }
+
+    // The waiter can leave its stack frame once it's notified, so the task handle should
+    // be copied before.
+    auto task = waiter->task;
 
     OCS_STATUS_RETURN_ON_FALSE(xTaskNotifyGive(task) == pdTRUE,
                                status::StatusCode::Error);
@@ -8,8 +8,6 @@
 
 #pragma once
 
-#include <deque>
-
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
@@ -21,6 +19,10 @@ namespace ocs {
 namespace core {
 
 //! FreeRTOS condition variable.
+//!
+//! @notes
+//!  Waiting tasks are kept in the intrusive list, the list nodes are allocated on the
+//!  stack of the waiting tasks, so neither wait() nor signal() allocate memory.
 class Cond : public NonCopyable<> {
 public:
     //! Initialize.
@@ -39,6 +41,9 @@ public:
     //!
     //!  - Multiple tasks can wait on the same condition variable.
     //!
+    //!  - The waiting task should not be deleted, it's still referenced by the
+    //!    condition variable.
+    //!
     //! @example
     //!    Mutex mutex;
     //!    Cond cond(mutex);
@@ -63,14 +68,23 @@ public:
     status::StatusCode broadcast();
 
 private:
-    void append_task_();
+    struct Waiter {
+        TaskHandle_t task { nullptr };
+        Waiter* next { nullptr };
+    };
+
+    void push_(Waiter& waiter);
+
+    //! Return false if @p waiter has already been signaled.
+    bool remove_(Waiter& waiter);
 
     status::StatusCode signal_();
 
     ILocker& locker_;
 
     core::StaticMutex mu_;
-    std::deque<TaskHandle_t> tasks_;
+    Waiter* head_ { nullptr };
+    Waiter* tail_ { nullptr };
 };
 
 } // namespace core
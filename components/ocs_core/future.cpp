@@ -34,6 +34,12 @@ status::StatusCode Future::wait(TickType_t wait) {
     return status::StatusCode::OK;
 }
 
+void Future::reset() {
+    core::LockGuard lock(mu_);
+
+    code_ = status::StatusCode::Last;
+}
+
 status::StatusCode Future::code() const {
     core::LockGuard lock(mu_);
 
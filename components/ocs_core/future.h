@@ -32,6 +32,9 @@ public:
     //! Wait @p wait for the asynchronous execution to be finish.
     status::StatusCode wait(TickType_t wait = portMAX_DELAY);
 
+    //! Reset to the initial state, so the future can be reused.
+    void reset();
+
 private:
     mutable StaticMutex mu_;
     Cond cond_;
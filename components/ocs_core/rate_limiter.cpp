@@ -33,5 +33,9 @@ bool RateLimiter::allow() {
     return true;
 }
 
+core::Time RateLimiter::deadline() const {
+    return start_ ? start_ + interval_ : 0;
+}
+
 } // namespace core
 } // namespace ocs
@@ -27,6 +27,12 @@ public:
     //! Retur true if an operation can be performed.
     bool allow();
 
+    //! Return the point in time when the next operation can be performed.
+    //!
+    //! @remarks
+    //!  Zero is returned if no operations have been performed yet.
+    core::Time deadline() const;
+
 private:
     const Time interval_ { 0 };
 
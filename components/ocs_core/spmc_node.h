@@ -9,6 +9,9 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
 
 #include "ocs_core/noncopyable.h"
 
@@ -26,7 +29,12 @@ namespace core {
 //! The consumer acquires the data with the read atomic operation, so it should
 //! use the acquire memory order. The producer only performs an atomic write
 //! operation, so it should use the release memory order.
-template <typename T> class SpmcNode : public NonCopyable<> {
+//!
+//! If std::atomic<T> isn't lock-free, e.g. for the multi-field structures, it falls
+//! back to the global lock table of libatomic, and the consumers contend with the
+//! producer. The sequence lock is used for such types instead, see below.
+template <typename T, bool LockFree = std::atomic<T>::is_always_lock_free>
+class SpmcNode : public NonCopyable<> {
 public:
     //! Get the underlying data.
     T get() const {
@@ -36,10 +44,110 @@ public:
     //! Set the underlying data.
     void set(const T& data) {
         data_.store(data, std::memory_order_release);
+
+        // Only the producer changes the generation, no read-modify-write is required.
+        generation_.store(generation_.load(std::memory_order_relaxed) + 1,
+                          std::memory_order_release);
+    }
+
+    //! Return the number of set() calls.
+    uint32_t generation() const {
+        return generation_.load(std::memory_order_acquire);
     }
 
 private:
     std::atomic<T> data_;
+    std::atomic<uint32_t> generation_ { 0 };
+};
+
+//! Sequence lock with two copies of the data (latch).
+//!
+//! @notes
+//!  The producer is wait-free: it switches the consumers to the second copy, updates
+//!  the first copy, switches the consumers back to the first copy, and updates the
+//!  second copy. The consumer is lock-free: it reads the copy selected by the sequence
+//!  number, and retries only if the sequence number has changed during the read.
+//!  Since the consumers never read the copy being updated, an ISR preempting the
+//!  producer on the same core never retries.
+//!
+//!  The data is copied word by word with relaxed atomic operations, so there are no
+//!  data races, and the fences order the data with the sequence number.
+template <typename T> class SpmcNode<T, false> : public NonCopyable<> {
+public:
+    //! Initialize.
+    SpmcNode() {
+        // Checked here rather than in the class scope, since the nested data type of
+        // the enclosing class isn't default constructible until that class is complete.
+        static_assert(std::is_trivially_copyable_v<T>,
+                      "data should be trivially copyable");
+        static_assert(std::is_default_constructible_v<T>,
+                      "data should be default constructible");
+
+        set(T());
+    }
+
+    //! Get the underlying data.
+    T get() const {
+        uint32_t words[word_count];
+
+        while (true) {
+            const auto seq = seq_.load(std::memory_order_acquire);
+            const auto& copy = copies_[seq & 1];
+
+            for (unsigned n = 0; n < word_count; ++n) {
+                words[n] = copy[n].load(std::memory_order_relaxed);
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (seq_.load(std::memory_order_relaxed) == seq) {
+                break;
+            }
+        }
+
+        T data;
+        memcpy(&data, words, sizeof(T));
+
+        return data;
+    }
+
+    //! Set the underlying data.
+    void set(const T& data) {
+        uint32_t words[word_count] {};
+        memcpy(words, &data, sizeof(T));
+
+        const auto seq = seq_.load(std::memory_order_relaxed);
+
+        seq_.store(seq + 1, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_release);
+        store_(copies_[seq & 1], words);
+
+        seq_.store(seq + 2, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_release);
+        store_(copies_[(seq + 1) & 1], words);
+    }
+
+    //! Return the number of set() calls.
+    uint32_t generation() const {
+        // Each set() call increments the sequence number twice, the initial data is
+        // set on construction.
+        return seq_.load(std::memory_order_acquire) / 2 - 1;
+    }
+
+private:
+    static constexpr unsigned word_count = (sizeof(T) + sizeof(uint32_t) - 1)
+        / sizeof(uint32_t);
+
+    using Copy = std::atomic<uint32_t>[word_count];
+
+    static void store_(Copy& copy, const uint32_t* words) {
+        for (unsigned n = 0; n < word_count; ++n) {
+            copy[n].store(words[n], std::memory_order_relaxed);
+        }
+    }
+
+    std::atomic<uint32_t> seq_ { 0 };
+    Copy copies_[2];
 };
 
 } // namespace core
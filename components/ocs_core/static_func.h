@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace ocs {
+namespace core {
+
+template <typename Signature, unsigned Capacity> class StaticFunc;
+
+//! Callable wrapper that never allocates memory on the heap.
+//!
+//! @notes
+//!  Unlike std::function, the callable object is always stored in the internal buffer.
+//!  Callable objects larger than @p Capacity are rejected at compile time.
+template <typename R, typename... Args, unsigned Capacity>
+class StaticFunc<R(Args...), Capacity> {
+public:
+    //! Initialize empty function.
+    StaticFunc() = default;
+
+    //! Initialize empty function.
+    StaticFunc(std::nullptr_t) {
+    }
+
+    //! Store @p func in the internal buffer.
+    template <typename F,
+              typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, StaticFunc>>>
+    StaticFunc(F&& func) {
+        using T = std::decay_t<F>;
+
+        static_assert(sizeof(T) <= Capacity, "callable doesn't fit into the buffer");
+        static_assert(alignof(T) <= alignof(std::max_align_t),
+                      "callable alignment isn't supported");
+        static_assert(std::is_invocable_r_v<R, T&, Args...>,
+                      "callable signature doesn't match");
+
+        new (buf_) T(std::forward<F>(func));
+        ops_ = &ops_for_<T>;
+    }
+
+    //! Copy.
+    StaticFunc(const StaticFunc& other) {
+        if (other.ops_) {
+            other.ops_->copy(buf_, other.buf_);
+            ops_ = other.ops_;
+        }
+    }
+
+    //! Move.
+    StaticFunc(StaticFunc&& other) {
+        if (other.ops_) {
+            other.ops_->move(buf_, other.buf_);
+            ops_ = other.ops_;
+            other.reset_();
+        }
+    }
+
+    //! Destroy.
+    ~StaticFunc() {
+        reset_();
+    }
+
+    //! Copy.
+    StaticFunc& operator=(const StaticFunc& other) {
+        if (this != &other) {
+            reset_();
+
+            if (other.ops_) {
+                other.ops_->copy(buf_, other.buf_);
+                ops_ = other.ops_;
+            }
+        }
+
+        return *this;
+    }
+
+    //! Move.
+    StaticFunc& operator=(StaticFunc&& other) {
+        if (this != &other) {
+            reset_();
+
+            if (other.ops_) {
+                other.ops_->move(buf_, other.buf_);
+                ops_ = other.ops_;
+                other.reset_();
+            }
+        }
+
+        return *this;
+    }
+
+    //! Destroy the stored callable.
+    StaticFunc& operator=(std::nullptr_t) {
+        reset_();
+        return *this;
+    }
+
+    //! Return true if the callable is stored.
+    explicit operator bool() const {
+        return ops_ != nullptr;
+    }
+
+    //! Invoke the stored callable.
+    //!
+    //! @remarks
+    //!  The function should not be empty.
+    R operator()(Args... args) {
+        return ops_->invoke(buf_, std::forward<Args>(args)...);
+    }
+
+private:
+    struct Ops {
+        R (*invoke)(void* buf, Args&&... args);
+        void (*copy)(void* dst, const void* src);
+        void (*move)(void* dst, void* src);
+        void (*destroy)(void* buf);
+    };
+
+    template <typename T> static R invoke_(void* buf, Args&&... args) {
+        return (*static_cast<T*>(buf))(std::forward<Args>(args)...);
+    }
+
+    template <typename T> static void copy_(void* dst, const void* src) {
+        new (dst) T(*static_cast<const T*>(src));
+    }
+
+    template <typename T> static void move_(void* dst, void* src) {
+        new (dst) T(std::move(*static_cast<T*>(src)));
+    }
+
+    template <typename T> static void destroy_(void* buf) {
+        static_cast<T*>(buf)->~T();
+    }
+
+    template <typename T>
+    static constexpr Ops ops_for_ { &invoke_<T>, &copy_<T>, &move_<T>, &destroy_<T> };
+
+    void reset_() {
+        if (ops_) {
+            ops_->destroy(buf_);
+            ops_ = nullptr;
+        }
+    }
+
+    const Ops* ops_ { nullptr };
+
+    alignas(std::max_align_t) unsigned char buf_[Capacity];
+};
+
+} // namespace core
+} // namespace ocs
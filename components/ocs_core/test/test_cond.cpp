@@ -130,5 +130,20 @@ TEST_CASE("Condition variable: wait multiple tasks", "[ocs_core], [cond]") {
     }
 }
 
+TEST_CASE("Condition variable: wait timeout", "[ocs_core], [cond]") {
+    StaticMutex mutex;
+    Cond cond(mutex);
+
+    LockGuard lock(mutex);
+
+    TEST_ASSERT_EQUAL(status::StatusCode::Error, cond.wait(pdMS_TO_TICKS(10)));
+
+    // The timed out task is no longer waiting, so it isn't notified.
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, cond.signal());
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, cond.broadcast());
+
+    TEST_ASSERT_EQUAL(status::StatusCode::Error, cond.wait(pdMS_TO_TICKS(10)));
+}
+
 } // namespace core
 } // namespace ocs
@@ -38,5 +38,22 @@ TEST_CASE("Rate limiter: allow operation to be performed", "[ocs_core], [rate_li
     TEST_ASSERT_FALSE(limiter.allow());
 }
 
+TEST_CASE("Rate limiter: deadline", "[ocs_core], [rate_limiter]") {
+    const Time interval = Duration::second;
+
+    test::TestClock clock;
+    clock.value = 42;
+
+    RateLimiter limiter(clock, interval);
+    TEST_ASSERT_EQUAL_INT64(0, limiter.deadline());
+
+    TEST_ASSERT_TRUE(limiter.allow());
+    TEST_ASSERT_EQUAL_INT64(42 + interval, limiter.deadline());
+
+    clock.value += interval;
+    TEST_ASSERT_TRUE(limiter.allow());
+    TEST_ASSERT_EQUAL_INT64(42 + interval * 2, limiter.deadline());
+}
+
 } // namespace core
 } // namespace ocs
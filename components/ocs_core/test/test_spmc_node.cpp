@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <atomic>
+#include <cstdint>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "unity.h"
+
+#include "ocs_core/noncopyable.h"
+#include "ocs_core/spmc_node.h"
+
+namespace ocs {
+namespace core {
+
+namespace {
+
+struct Data {
+    uint32_t seq { 0 };
+    float values[4] { 0, 0, 0, 0 };
+    int64_t ts { 0 };
+    uint8_t flag { 0 };
+};
+
+class Writer : public NonCopyable<> {
+public:
+    Writer(SpmcNode<Data>& node, unsigned count)
+        : count_(count)
+        , node_(node) {
+    }
+
+    bool start() {
+        const BaseType_t core = portNUM_PROCESSORS > 1 ? 1 : tskNO_AFFINITY;
+
+        return xTaskCreatePinnedToCore(run_, "spmc_writer", 4096, this,
+                                       tskIDLE_PRIORITY + 1, nullptr, core)
+            == pdPASS;
+    }
+
+    bool done() const {
+        return done_.load(std::memory_order_acquire);
+    }
+
+private:
+    static void run_(void* arg) {
+        Writer& self = *static_cast<Writer*>(arg);
+
+        for (unsigned n = 1; n <= self.count_; ++n) {
+            Data data;
+            data.seq = n;
+            for (auto& value : data.values) {
+                value = n;
+            }
+            data.ts = n;
+            data.flag = n;
+
+            self.node_.set(data);
+
+            if (n % 1000 == 0) {
+                vTaskDelay(1);
+            }
+        }
+
+        self.done_.store(true, std::memory_order_release);
+        vTaskDelete(nullptr);
+    }
+
+    const unsigned count_ { 0 };
+
+    SpmcNode<Data>& node_;
+    std::atomic<bool> done_ { false };
+};
+
+} // namespace
+
+TEST_CASE("SPMC node: lock-free type", "[ocs_core], [spmc_node]") {
+    SpmcNode<uint32_t> node;
+    TEST_ASSERT_EQUAL(0, node.generation());
+
+    node.set(42);
+    TEST_ASSERT_EQUAL(42, node.get());
+    TEST_ASSERT_EQUAL(1, node.generation());
+}
+
+TEST_CASE("SPMC node: large type", "[ocs_core], [spmc_node]") {
+    static_assert(!std::atomic<Data>::is_always_lock_free);
+
+    SpmcNode<Data> node;
+    TEST_ASSERT_EQUAL(0, node.generation());
+
+    auto data = node.get();
+    TEST_ASSERT_EQUAL(0, data.seq);
+    TEST_ASSERT_EQUAL(0, data.ts);
+
+    data.seq = 1;
+    data.values[3] = 3.5;
+    data.ts = INT64_MAX;
+    data.flag = 0xFF;
+    node.set(data);
+
+    data = node.get();
+    TEST_ASSERT_EQUAL(1, data.seq);
+    TEST_ASSERT_EQUAL_FLOAT(3.5, data.values[3]);
+    TEST_ASSERT_TRUE(data.ts == INT64_MAX);
+    TEST_ASSERT_EQUAL(0xFF, data.flag);
+    TEST_ASSERT_EQUAL(1, node.generation());
+}
+
+TEST_CASE("SPMC node: concurrent reader", "[ocs_core], [spmc_node]") {
+    SpmcNode<Data> node;
+
+    Writer writer(node, 100 * 1000);
+    TEST_ASSERT_TRUE(writer.start());
+
+    uint32_t last_seq = 0;
+    unsigned read_count = 0;
+
+    while (!writer.done()) {
+        const auto data = node.get();
+
+        // Data is never torn and never goes backwards.
+        TEST_ASSERT_TRUE(data.seq >= last_seq);
+        for (const auto& value : data.values) {
+            TEST_ASSERT_EQUAL_FLOAT(data.seq, value);
+        }
+        TEST_ASSERT_TRUE(data.ts == data.seq);
+        TEST_ASSERT_EQUAL(uint8_t(data.seq), data.flag);
+
+        last_seq = data.seq;
+
+        // Let the writer run, if there is a single core.
+        if (++read_count % 1000 == 0) {
+            vTaskDelay(1);
+        }
+    }
+
+    TEST_ASSERT_EQUAL(100 * 1000, node.get().seq);
+    TEST_ASSERT_TRUE(read_count > 0);
+}
+
+} // namespace core
+} // namespace ocs
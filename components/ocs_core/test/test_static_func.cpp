@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <memory>
+
+#include "unity.h"
+
+#include "ocs_core/static_func.h"
+
+namespace ocs {
+namespace core {
+
+namespace {
+
+using TestFunc = StaticFunc<int(int), sizeof(void*) * 4>;
+
+} // namespace
+
+TEST_CASE("Static func: empty", "[ocs_core], [static_func]") {
+    TestFunc func;
+    TEST_ASSERT_FALSE(func);
+
+    TestFunc null_func(nullptr);
+    TEST_ASSERT_FALSE(null_func);
+}
+
+TEST_CASE("Static func: invoke", "[ocs_core], [static_func]") {
+    int base = 40;
+
+    TestFunc func([&base](int value) {
+        return base + value;
+    });
+    TEST_ASSERT_TRUE(func);
+    TEST_ASSERT_EQUAL(42, func(2));
+
+    base = 10;
+    TEST_ASSERT_EQUAL(12, func(2));
+
+    func = nullptr;
+    TEST_ASSERT_FALSE(func);
+}
+
+TEST_CASE("Static func: copy and move", "[ocs_core], [static_func]") {
+    auto counter = std::make_shared<int>(0);
+
+    TestFunc func([counter](int value) {
+        *counter += value;
+        return *counter;
+    });
+    TEST_ASSERT_EQUAL(2, counter.use_count());
+
+    TestFunc copied(func);
+    TEST_ASSERT_EQUAL(3, counter.use_count());
+    TEST_ASSERT_EQUAL(1, copied(1));
+    TEST_ASSERT_EQUAL(3, func(2));
+
+    TestFunc moved(std::move(copied));
+    TEST_ASSERT_FALSE(copied);
+    TEST_ASSERT_EQUAL(3, counter.use_count());
+    TEST_ASSERT_EQUAL(6, moved(3));
+
+    func = std::move(moved);
+    TEST_ASSERT_FALSE(moved);
+    TEST_ASSERT_EQUAL(2, counter.use_count());
+
+    func = nullptr;
+    TEST_ASSERT_EQUAL(1, counter.use_count());
+}
+
+} // namespace core
+} // namespace ocs
@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "freertos/FreeRTOSConfig.h"
+
+#include "ocs_diagnostic/func_counter.h"
+
+namespace ocs {
+namespace diagnostic {
+
+FuncCounter::FuncCounter(const char* id, FuncCounter::Func func)
+    : BasicCounter(id)
+    , func_(func) {
+    configASSERT(func_);
+}
+
+ICounter::Value FuncCounter::get() const {
+    return func_();
+}
+
+} // namespace diagnostic
+} // namespace ocs
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <functional>
+
+#include "ocs_core/noncopyable.h"
+#include "ocs_diagnostic/basic_counter.h"
+
+namespace ocs {
+namespace diagnostic {
+
+//! Read the counter value with the provided function.
+class FuncCounter : public BasicCounter, public core::NonCopyable<> {
+public:
+    using Func = std::function<ICounter::Value()>;
+
+    //! Initialize.
+    //!
+    //! @params
+    //!  - @p id - counter identifier.
+    //!  - @p func to read the counter value.
+    FuncCounter(const char* id, Func func);
+
+    //! Return the value returned by the underlying function.
+    ICounter::Value get() const override;
+
+private:
+    Func func_;
+};
+
+} // namespace diagnostic
+} // namespace ocs
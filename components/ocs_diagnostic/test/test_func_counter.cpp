@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "unity.h"
+
+#include "ocs_diagnostic/func_counter.h"
+
+namespace ocs {
+namespace diagnostic {
+
+TEST_CASE("Func counter: read value", "[ocs_diagnostic], [func_counter]") {
+    ICounter::Value value = 0;
+
+    FuncCounter counter("counter", [&value]() {
+        return value;
+    });
+
+    TEST_ASSERT_EQUAL_STRING("counter", counter.id());
+    TEST_ASSERT_EQUAL(0, counter.get());
+
+    value = 42;
+    TEST_ASSERT_EQUAL(42, counter.get());
+}
+
+} // namespace diagnostic
+} // namespace ocs
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <cstdlib>
+#include <new>
+
+#include "cJSON.h"
+#include "freertos/FreeRTOSConfig.h"
+
+#include "ocs_fmt/json/cjson_arena.h"
+
+namespace ocs {
+namespace fmt {
+namespace json {
+
+namespace {
+
+//! Arena entered last by the calling task.
+thread_local CjsonArena* current_arena = nullptr;
+
+unsigned align_size(unsigned size) {
+    const unsigned alignment = alignof(std::max_align_t);
+
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+CjsonArena::CjsonArena(unsigned size)
+    : size_(align_size(size)) {
+    configASSERT(size_);
+
+    buf_.reset(new (std::nothrow) std::max_align_t[(size_ + sizeof(std::max_align_t) - 1)
+                                                   / sizeof(std::max_align_t)]);
+    configASSERT(buf_);
+
+    // Function-local static is initialized exactly once, even if arenas are created
+    // concurrently.
+    static const bool hooks_installed = []() {
+        cJSON_Hooks hooks;
+        hooks.malloc_fn = malloc_;
+        hooks.free_fn = free_;
+
+        cJSON_InitHooks(&hooks);
+
+        return true;
+    }();
+    configASSERT(hooks_installed);
+}
+
+unsigned CjsonArena::high_water_mark() const {
+    return high_water_mark_.load(std::memory_order_relaxed);
+}
+
+unsigned CjsonArena::fallback_count() const {
+    return fallback_count_.load(std::memory_order_relaxed);
+}
+
+void* CjsonArena::malloc_(size_t size) {
+    if (CjsonArena* arena = current_arena; arena) {
+        if (void* ptr = arena->allocate_(size); ptr) {
+            return ptr;
+        }
+
+        arena->fallback_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    return malloc(size);
+}
+
+void CjsonArena::free_(void* ptr) {
+    for (const CjsonArena* arena = current_arena; arena; arena = arena->prev_) {
+        if (arena->owns_(ptr)) {
+            return;
+        }
+    }
+
+    free(ptr);
+}
+
+void* CjsonArena::allocate_(size_t size) {
+    if (size > size_ - pos_) {
+        return nullptr;
+    }
+
+    const unsigned aligned_size = align_size(size);
+    if (aligned_size > size_ - pos_) {
+        return nullptr;
+    }
+
+    void* ptr = reinterpret_cast<char*>(buf_.get()) + pos_;
+    pos_ += aligned_size;
+
+    if (pos_ > high_water_mark_.load(std::memory_order_relaxed)) {
+        high_water_mark_.store(pos_, std::memory_order_relaxed);
+    }
+
+    return ptr;
+}
+
+bool CjsonArena::owns_(const void* ptr) const {
+    const char* begin = reinterpret_cast<const char*>(buf_.get());
+
+    return ptr >= begin && ptr < begin + size_;
+}
+
+void CjsonArena::reset_() {
+    pos_ = 0;
+}
+
+CjsonArenaScope::CjsonArenaScope(CjsonArena* arena) {
+    if (!arena || arena->active_.exchange(true)) {
+        return;
+    }
+
+    arena_ = arena;
+    arena_->prev_ = current_arena;
+
+    current_arena = arena_;
+}
+
+CjsonArenaScope::~CjsonArenaScope() {
+    if (!arena_) {
+        return;
+    }
+
+    current_arena = arena_->prev_;
+
+    arena_->prev_ = nullptr;
+    arena_->reset_();
+    arena_->active_.store(false);
+}
+
+} // namespace json
+} // namespace fmt
+} // namespace ocs
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+#include "ocs_core/noncopyable.h"
+
+namespace ocs {
+namespace fmt {
+namespace json {
+
+//! Bump allocator for the short-lived cJSON trees.
+//!
+//! @notes
+//!  The memory is allocated once, on construction. While the arena is entered with
+//!  CjsonArenaScope, cJSON allocations of the calling task are served from the arena,
+//!  and freeing them is a no-op. The whole arena is released at once, when the scope
+//!  is left. If the arena is exhausted, the allocations fall back to the heap.
+//!
+//!  The cJSON allocation hooks are installed when the first arena is created, and are
+//!  global. Allocations of the tasks that haven't entered any arena go to the heap, as
+//!  before.
+class CjsonArena : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //!
+    //! @params
+    //!  - @p size - arena size, in bytes.
+    explicit CjsonArena(unsigned size);
+
+    //! Return the maximum number of bytes allocated from the arena within one scope.
+    unsigned high_water_mark() const;
+
+    //! Return the number of allocations that didn't fit into the arena.
+    unsigned fallback_count() const;
+
+private:
+    friend class CjsonArenaScope;
+
+    static void* malloc_(size_t size);
+    static void free_(void* ptr);
+
+    void* allocate_(size_t size);
+    bool owns_(const void* ptr) const;
+    void reset_();
+
+    const unsigned size_ { 0 };
+    std::unique_ptr<std::max_align_t[]> buf_;
+
+    unsigned pos_ { 0 };
+    std::atomic<bool> active_ { false };
+
+    //! Arena entered before this one by the same task.
+    CjsonArena* prev_ { nullptr };
+
+    std::atomic<unsigned> high_water_mark_ { 0 };
+    std::atomic<unsigned> fallback_count_ { 0 };
+};
+
+//! Serve cJSON allocations of the calling task from the arena, until the scope is left.
+//!
+//! @remarks
+//!  cJSON items allocated within the scope should be deleted within the same scope, by
+//!  the same task, so the scope should be declared before the items.
+//!
+//! @example
+//!  CjsonArenaScope scope(arena);
+//!  auto json = CjsonUniqueBuilder::make_object();
+class CjsonArenaScope : public core::NonCopyable<> {
+public:
+    //! Enter @p arena.
+    //!
+    //! @remarks
+    //!  Nothing is done if @p arena is null, or is already entered by any task, the
+    //!  allocations are served from the previous arena or from the heap then.
+    explicit CjsonArenaScope(CjsonArena* arena);
+
+    //! Release all memory allocated from the arena, and leave it.
+    ~CjsonArenaScope();
+
+private:
+    CjsonArena* arena_ { nullptr };
+};
+
+} // namespace json
+} // namespace fmt
+} // namespace ocs
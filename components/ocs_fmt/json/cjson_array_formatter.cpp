@@ -34,6 +34,20 @@ bool CjsonArrayFormatter::append_uint16(uint16_t value) {
     return true;
 }
 
+bool CjsonArrayFormatter::append_uint32(uint32_t value) {
+    auto item = CjsonUniqueBuilder::make_number(value);
+    if (!item) {
+        return false;
+    }
+
+    if (!cJSON_AddItemToArray(json_, item.get())) {
+        return false;
+    }
+
+    item.release();
+    return true;
+}
+
 bool CjsonArrayFormatter::append_string(const char* str) {
     auto item = CjsonUniqueBuilder::make_string(str);
     if (!item) {
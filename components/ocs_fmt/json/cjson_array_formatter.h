@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <cstdint>
+
 #include "cJSON.h"
 
 #include "ocs_core/noncopyable.h"
@@ -27,6 +29,9 @@ public:
     //! Append 16-bit number stored to json.
     bool append_uint16(uint16_t value);
 
+    //! Append 32-bit number stored to json.
+    bool append_uint32(uint32_t value);
+
     //! Append a string to json.
     bool append_string(const char* str);
 
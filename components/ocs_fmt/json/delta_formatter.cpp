@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "freertos/FreeRTOSConfig.h"
+
+#include "ocs_core/istream_writer.h"
+#include "ocs_fmt/json/delta_formatter.h"
+
+namespace ocs {
+namespace fmt {
+namespace json {
+
+namespace {
+
+//! Append the data to the vector.
+class VectorStreamWriter : public core::IStreamWriter, public core::NonCopyable<> {
+public:
+    explicit VectorStreamWriter(std::vector<char>& data)
+        : data_(data) {
+    }
+
+    status::StatusCode begin() override {
+        return status::StatusCode::OK;
+    }
+
+    status::StatusCode end() override {
+        return status::StatusCode::OK;
+    }
+
+    status::StatusCode cancel() override {
+        data_.clear();
+
+        return status::StatusCode::OK;
+    }
+
+    status::StatusCode write(const void* data, unsigned size) override {
+        const char* bytes = static_cast<const char*>(data);
+        data_.insert(data_.end(), bytes, bytes + size);
+
+        return status::StatusCode::OK;
+    }
+
+private:
+    std::vector<char>& data_;
+};
+
+} // namespace
+
+DeltaFormatter::DeltaFormatter(FanoutFormatter& formatter, uint32_t epoch)
+    : epoch_(epoch)
+    , formatter_(formatter) {
+    configASSERT(epoch_);
+}
+
+status::StatusCode
+DeltaFormatter::format(StreamWriter& writer, uint32_t epoch, uint32_t since) {
+    if (const auto code = update_(); code != status::StatusCode::OK) {
+        return code;
+    }
+
+    // Sequence of the previous boot can be less than the current one.
+    if (epoch != epoch_ || since > sequence_) {
+        since = 0;
+    }
+
+    for (const auto& field : fields_) {
+        if (field.sequence <= since) {
+            continue;
+        }
+
+        writer.key(field.key.c_str());
+        writer.value(field.value.get());
+    }
+
+    writer.add_number("epoch", epoch_);
+
+    return writer.add_number("seq", sequence_);
+}
+
+uint32_t DeltaFormatter::epoch() const {
+    return epoch_;
+}
+
+uint32_t DeltaFormatter::sequence() const {
+    return sequence_;
+}
+
+status::StatusCode DeltaFormatter::update_() {
+    const uint32_t sequence = sequence_ + 1;
+    bool changed = false;
+
+    sources_.resize(formatter_.count());
+
+    for (unsigned n = 0; n < sources_.size(); ++n) {
+        const auto code = update_source_(n, sequence, changed);
+        if (code != status::StatusCode::OK) {
+            return code;
+        }
+    }
+
+    if (changed) {
+        sequence_ = sequence;
+    }
+
+    return status::StatusCode::OK;
+}
+
+status::StatusCode
+DeltaFormatter::update_source_(unsigned index, uint32_t sequence, bool& changed) {
+    auto& source = sources_[index];
+    auto& formatter = formatter_.get(index);
+
+    // Generation is read before the data is formatted, so the update which happens
+    // during the formatting is detected on the next call.
+    const auto generation = formatter.generation();
+    if (source.formatted && generation && generation == source.generation) {
+        return status::StatusCode::OK;
+    }
+
+    // Data is serialized without building the cJSON tree, which is only required when
+    // the data is changed.
+    next_snapshot_.clear();
+
+    VectorStreamWriter snapshot_writer(next_snapshot_);
+
+    char buf[64];
+    StreamWriter writer(snapshot_writer, buf, sizeof(buf));
+
+    writer.begin_object();
+
+    if (const auto code = formatter.format(writer); code != status::StatusCode::OK) {
+        return code;
+    }
+
+    writer.end_object();
+
+    if (const auto code = writer.flush(); code != status::StatusCode::OK) {
+        return code;
+    }
+
+    // Source without the generation is unchanged, if the same data is serialized.
+    if (!generation && source.formatted && next_snapshot_ == source.snapshot) {
+        return status::StatusCode::OK;
+    }
+
+    // The tree is parsed from the same data, so the snapshot always matches the fields.
+    CjsonPtr json(cJSON_ParseWithLength(next_snapshot_.data(), next_snapshot_.size()),
+                  cJSON_Delete);
+    if (!json) {
+        return status::StatusCode::NoMem;
+    }
+
+    // Source formats its fields in the same order, so the next field is usually found
+    // at the position following the previous one.
+    unsigned position = 0;
+
+    while (json->child) {
+        CjsonPtr value(cJSON_DetachItemViaPointer(json.get(), json->child),
+                       cJSON_Delete);
+
+        update_field_(std::move(value), sequence, position, changed);
+    }
+
+    if (generation) {
+        source.snapshot.clear();
+    } else {
+        source.snapshot.swap(next_snapshot_);
+    }
+
+    source.formatted = true;
+    source.generation = generation;
+
+    return status::StatusCode::OK;
+}
+
+void DeltaFormatter::update_field_(CjsonPtr value,
+                                   uint32_t sequence,
+                                   unsigned& position,
+                                   bool& changed) {
+    if (position >= fields_.size() || fields_[position].key != value->string) {
+        position = 0;
+
+        while (position < fields_.size() && fields_[position].key != value->string) {
+            ++position;
+        }
+    }
+
+    if (position == fields_.size()) {
+        Field field;
+        field.key = value->string;
+        field.value = std::move(value);
+        field.sequence = sequence;
+
+        fields_.emplace_back(std::move(field));
+        ++position;
+        changed = true;
+
+        return;
+    }
+
+    auto& field = fields_[position++];
+
+    if (cJSON_Compare(field.value.get(), value.get(), true)) {
+        return;
+    }
+
+    field.value = std::move(value);
+    field.sequence = sequence;
+    changed = true;
+}
+
+} // namespace json
+} // namespace fmt
+} // namespace ocs
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "ocs_core/noncopyable.h"
+#include "ocs_fmt/json/cjson_builder.h"
+#include "ocs_fmt/json/fanout_formatter.h"
+#include "ocs_fmt/json/stream_writer.h"
+
+namespace ocs {
+namespace fmt {
+namespace json {
+
+//! Format only the fields changed since the given sequence number.
+//!
+//! @notes
+//!  The last value of each top-level field is kept with the sequence number of its last
+//!  change. The sequence is incremented each time any field is changed. Formatters
+//!  tracking the generation of their data are re-formatted only when the generation is
+//!  changed. Other formatters are serialized on each call, and the result is compared
+//!  with the previous one, so the fields of the unchanged source aren't parsed and
+//!  compared.
+//!
+//!  The sequence starts from scratch after reboot, so it's qualified with the epoch,
+//!  which should be unique for each boot. If the requested epoch doesn't match the
+//!  current one, or the requested sequence number is greater than the current one, all
+//!  fields are formatted.
+//!
+//!  The kept values are allocated on the heap, the formatter shouldn't be used within
+//!  CjsonArenaScope.
+class DeltaFormatter : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //!
+    //! @params
+    //!  - @p formatter to format the data, formatters can be added to it at any time.
+    //!  - @p epoch - non-zero value, unique for each boot, e.g. random number.
+    DeltaFormatter(FanoutFormatter& formatter, uint32_t epoch);
+
+    //! Format the fields changed after @p since, the epoch and the current sequence
+    //! number.
+    //!
+    //! @remarks
+    //!  All fields are formatted if @p epoch doesn't match the current one, or if
+    //!  @p since is zero. Zero @p epoch never matches.
+    status::StatusCode format(StreamWriter& writer, uint32_t epoch, uint32_t since);
+
+    //! Return the epoch of the sequence.
+    uint32_t epoch() const;
+
+    //! Return the current sequence number.
+    uint32_t sequence() const;
+
+private:
+    using CjsonPtr = CjsonUniqueBuilder::Ptr;
+
+    struct Source {
+        bool formatted { false };
+        std::optional<uint32_t> generation;
+
+        //! Serialized data of the source which doesn't track the generation.
+        std::vector<char> snapshot;
+    };
+
+    struct Field {
+        std::string key;
+        CjsonPtr value { CjsonUniqueBuilder::make_nullptr() };
+        uint32_t sequence { 0 };
+    };
+
+    status::StatusCode update_();
+    status::StatusCode update_source_(unsigned index, uint32_t sequence, bool& changed);
+    void
+    update_field_(CjsonPtr value, uint32_t sequence, unsigned& position, bool& changed);
+
+    const uint32_t epoch_ { 0 };
+
+    FanoutFormatter& formatter_;
+
+    std::vector<Source> sources_;
+    std::vector<char> next_snapshot_;
+    std::vector<Field> fields_;
+    uint32_t sequence_ { 0 };
+};
+
+} // namespace json
+} // namespace fmt
+} // namespace ocs
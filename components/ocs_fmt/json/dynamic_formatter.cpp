@@ -6,6 +6,7 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 
+#include <algorithm>
 #include <cstring>
 
 #include "freertos/FreeRTOSConfig.h"
@@ -17,20 +18,54 @@ namespace fmt {
 namespace json {
 
 DynamicFormatter::DynamicFormatter(unsigned size)
-    : size_(size) {
-    configASSERT(size_);
+    : DynamicFormatter(Params { size, size, 0 }) {
+}
+
+DynamicFormatter::DynamicFormatter(Params params)
+    : params_(params) {
+    configASSERT(params_.size);
 
-    buf_.reset(new (std::nothrow) char[size]);
+    buf_.reset(new (std::nothrow) char[params_.size]);
     configASSERT(buf_);
+
+    size_ = params_.size;
 }
 
 status::StatusCode DynamicFormatter::format(cJSON* json) {
-    clear_();
+    // The buffer is shrunk before formatting, since the previous output may still be
+    // in use until the next call.
+    if (shrink_) {
+        shrink_ = false;
 
-    if (!cJSON_PrintPreallocated(json, buf_.get(), size_, false)) {
-        return status::StatusCode::NoMem;
+        const auto code = resize_(std::max(params_.size, size_ / 2));
+        if (code != status::StatusCode::OK) {
+            return code;
+        }
     }
 
+    while (true) {
+        clear_();
+
+        if (cJSON_PrintPreallocated(json, buf_.get(), size_, false)) {
+            break;
+        }
+
+        if (size_ >= params_.max_size) {
+            ++failure_count_;
+
+            return status::StatusCode::NoMem;
+        }
+
+        const auto code = resize_(std::min(params_.max_size, size_ * 2));
+        if (code != status::StatusCode::OK) {
+            ++failure_count_;
+
+            return code;
+        }
+    }
+
+    update_(strlen(buf_.get()));
+
     return status::StatusCode::OK;
 }
 
@@ -38,6 +73,52 @@ const char* DynamicFormatter::c_str() const {
     return buf_.get();
 }
 
+unsigned DynamicFormatter::size() const {
+    return size_;
+}
+
+unsigned DynamicFormatter::max_len() const {
+    return max_len_;
+}
+
+unsigned DynamicFormatter::failure_count() const {
+    return failure_count_;
+}
+
+status::StatusCode DynamicFormatter::resize_(unsigned size) {
+    // Previous buffer is kept if the allocation fails.
+    std::unique_ptr<char[]> buf(new (std::nothrow) char[size]);
+    if (!buf) {
+        return status::StatusCode::NoMem;
+    }
+
+    buf_ = std::move(buf);
+    size_ = size;
+    shrink_count_ = 0;
+
+    return status::StatusCode::OK;
+}
+
+void DynamicFormatter::update_(unsigned len) {
+    if (len > max_len_) {
+        max_len_ = len;
+    }
+
+    if (!params_.shrink_after || size_ <= params_.size) {
+        return;
+    }
+
+    if (len + 1 > size_ / 4) {
+        shrink_count_ = 0;
+        return;
+    }
+
+    if (++shrink_count_ == params_.shrink_after) {
+        shrink_count_ = 0;
+        shrink_ = true;
+    }
+}
+
 void DynamicFormatter::clear_() {
     memset(buf_.get(), 0, size_);
 }
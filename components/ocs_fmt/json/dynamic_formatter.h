@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 
 #include "ocs_core/noncopyable.h"
@@ -17,26 +18,67 @@ namespace ocs {
 namespace fmt {
 namespace json {
 
+//! Format JSON into the buffer allocated on the heap.
+//!
+//! @notes
+//!  If the maximum size is greater than the initial size, the buffer is doubled each
+//!  time the JSON doesn't fit into it, until the maximum size is reached. The buffer is
+//!  halved, but never below the initial size, once the configured number of
+//!  consecutive outputs fits into a quarter of it.
 class DynamicFormatter : public IFormatter, public core::NonCopyable<> {
 public:
-    //! Initialize.
+    struct Params {
+        //! Initial buffer size, in bytes.
+        unsigned size { 0 };
+
+        //! Maximum buffer size, in bytes. The buffer is never grown if the maximum
+        //! size isn't greater than the initial size.
+        unsigned max_size { 0 };
+
+        //! Number of consecutive outputs that fit into a quarter of the buffer, after
+        //! which the buffer is shrunk. The buffer is never shrunk if zero.
+        unsigned shrink_after { 0 };
+    };
+
+    //! Initialize the formatter with the fixed buffer size.
     //!
     //! @params
     //!  - @p size - underlying buffer size, in bytes, allocated on the heap.
     explicit DynamicFormatter(unsigned size);
 
+    //! Initialize the formatter with the buffer resized on demand.
+    explicit DynamicFormatter(Params params);
+
     //! Format @p json into the underlying buffer.
     status::StatusCode format(cJSON* json) override;
 
     //! Return the underlying buffer.
     const char* c_str() const;
 
+    //! Return the current buffer size, in bytes.
+    unsigned size() const;
+
+    //! Return the maximum length of the formatted JSON, in bytes.
+    unsigned max_len() const;
+
+    //! Return the number of times the JSON didn't fit into the buffer of maximum size.
+    unsigned failure_count() const;
+
 private:
+    status::StatusCode resize_(unsigned size);
+    void update_(unsigned len);
     void clear_();
 
-    const unsigned size_ { 0 };
+    const Params params_;
 
     std::unique_ptr<char[]> buf_;
+    std::atomic<unsigned> size_ { 0 };
+
+    bool shrink_ { false };
+    unsigned shrink_count_ { 0 };
+
+    std::atomic<unsigned> max_len_ { 0 };
+    std::atomic<unsigned> failure_count_ { 0 };
 };
 
 } // namespace json
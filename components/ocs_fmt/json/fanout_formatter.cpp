@@ -23,10 +23,46 @@ status::StatusCode FanoutFormatter::format(cJSON* json) {
     return status::StatusCode::OK;
 }
 
+status::StatusCode FanoutFormatter::format(StreamWriter& writer) {
+    for (auto& formatter : formatters_) {
+        const auto code = formatter->format(writer);
+        if (code != status::StatusCode::OK) {
+            return code;
+        }
+    }
+
+    return status::StatusCode::OK;
+}
+
+std::optional<uint32_t> FanoutFormatter::generation() const {
+    uint32_t generation = 0;
+
+    // The sum is changed each time any of the underlying generations is changed, or a
+    // new formatter is added.
+    for (const auto& formatter : formatters_) {
+        const auto value = formatter->generation();
+        if (!value) {
+            return std::nullopt;
+        }
+
+        generation += *value;
+    }
+
+    return generation + formatters_.size();
+}
+
 void FanoutFormatter::add(IFormatter& formatter) {
     formatters_.emplace_back(&formatter);
 }
 
+unsigned FanoutFormatter::count() const {
+    return formatters_.size();
+}
+
+IFormatter& FanoutFormatter::get(unsigned index) {
+    return *formatters_[index];
+}
+
 } // namespace json
 } // namespace fmt
 } // namespace ocs
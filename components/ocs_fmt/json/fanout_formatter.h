@@ -22,9 +22,21 @@ public:
     //! Propogate the call to the underlying formatters.
     status::StatusCode format(cJSON* json) override;
 
+    //! Propogate the call to the underlying formatters.
+    status::StatusCode format(StreamWriter& writer) override;
+
+    //! Return the combined generation of the underlying formatters.
+    std::optional<uint32_t> generation() const override;
+
     //! Add @p formatter to be notified when format is called.
     void add(IFormatter& formatter);
 
+    //! Return the number of the underlying formatters.
+    unsigned count() const;
+
+    //! Return the underlying formatter at @p index.
+    IFormatter& get(unsigned index);
+
 private:
     std::vector<IFormatter*> formatters_;
 };
@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "ocs_fmt/json/iformatter.h"
+#include "ocs_fmt/json/cjson_builder.h"
+
+namespace ocs {
+namespace fmt {
+namespace json {
+
+status::StatusCode IFormatter::format(StreamWriter& writer) {
+    auto json = CjsonUniqueBuilder::make_object();
+    if (!json) {
+        return status::StatusCode::NoMem;
+    }
+
+    const auto code = format(json.get());
+    if (code != status::StatusCode::OK) {
+        return code;
+    }
+
+    return writer.add_fields(json.get());
+}
+
+std::optional<uint32_t> IFormatter::generation() const {
+    return std::nullopt;
+}
+
+} // namespace json
+} // namespace fmt
+} // namespace ocs
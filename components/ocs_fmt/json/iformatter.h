@@ -8,8 +8,12 @@
 
 #pragma once
 
+#include <cstdint>
+#include <optional>
+
 #include "cJSON.h"
 
+#include "ocs_fmt/json/stream_writer.h"
 #include "ocs_status/code.h"
 
 namespace ocs {
@@ -23,6 +27,22 @@ public:
 
     //! Format JSON.
     virtual status::StatusCode format(cJSON* json) = 0;
+
+    //! Format JSON directly into @p writer, as the fields of the current object.
+    //!
+    //! @remarks
+    //!  The default implementation formats the data into the temporary cJSON object,
+    //!  and then writes it into @p writer. Formatters should override it to avoid heap
+    //!  allocations.
+    virtual status::StatusCode format(StreamWriter& writer);
+
+    //! Return the generation of the formatted data.
+    //!
+    //! @remarks
+    //!  The generation should be changed each time the formatted data is changed, so the
+    //!  formatted data can be cached until then. The default implementation returns
+    //!  nothing, which means the data can be changed at any time.
+    virtual std::optional<uint32_t> generation() const;
 };
 
 } // namespace json
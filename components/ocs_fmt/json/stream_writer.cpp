@@ -0,0 +1,608 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "freertos/FreeRTOSConfig.h"
+
+#include "ocs_fmt/json/stream_writer.h"
+
+namespace ocs {
+namespace fmt {
+namespace json {
+
+namespace {
+
+// CBOR major types.
+const uint8_t cbor_major_unsigned = 0;
+const uint8_t cbor_major_negative = 1;
+const uint8_t cbor_major_text = 3;
+
+// CBOR initial bytes.
+const uint8_t cbor_array_begin = 0x9F;
+const uint8_t cbor_map_begin = 0xBF;
+const uint8_t cbor_break = 0xFF;
+const uint8_t cbor_false = 0xF4;
+const uint8_t cbor_true = 0xF5;
+const uint8_t cbor_null = 0xF6;
+const uint8_t cbor_float32 = 0xFA;
+const uint8_t cbor_float64 = 0xFB;
+
+} // namespace
+
+StreamWriter::StreamWriter(core::IStreamWriter& writer,
+                           char* buf,
+                           unsigned size,
+                           Encoding encoding)
+    : writer_(writer)
+    , buf_(buf)
+    , size_(size)
+    , encoding_(encoding) {
+    configASSERT(buf_);
+    configASSERT(size_);
+}
+
+StreamWriter::Encoding StreamWriter::encoding() const {
+    return encoding_;
+}
+
+status::StatusCode StreamWriter::begin_object() {
+    return begin_container_(true);
+}
+
+status::StatusCode StreamWriter::end_object() {
+    return end_container_(true);
+}
+
+status::StatusCode StreamWriter::begin_array() {
+    return begin_container_(false);
+}
+
+status::StatusCode StreamWriter::end_array() {
+    return end_container_(false);
+}
+
+status::StatusCode StreamWriter::key(const char* key) {
+    if (code_ != status::StatusCode::OK) {
+        return code_;
+    }
+
+    if (!depth_ || key_) {
+        return fail_(status::StatusCode::InvalidState);
+    }
+
+    const uint32_t bit = 1u << (depth_ - 1);
+
+    if (!(objects_ & bit)) {
+        return fail_(status::StatusCode::InvalidState);
+    }
+
+    if (encoding_ == Encoding::Cbor) {
+        key_ = true;
+
+        return write_string_cbor_(key);
+    }
+
+    if (non_empty_ & bit) {
+        if (const auto code = write_(','); code != status::StatusCode::OK) {
+            return code;
+        }
+    }
+
+    non_empty_ |= bit;
+
+    if (const auto code = write_escaped_(key); code != status::StatusCode::OK) {
+        return code;
+    }
+
+    key_ = true;
+
+    return write_(':');
+}
+
+status::StatusCode StreamWriter::string(const char* value) {
+    if (const auto code = begin_value_(); code != status::StatusCode::OK) {
+        return code;
+    }
+
+    if (encoding_ == Encoding::Cbor) {
+        return write_string_cbor_(value);
+    }
+
+    return write_escaped_(value);
+}
+
+status::StatusCode StreamWriter::number(double value) {
+    if (const auto code = begin_value_(); code != status::StatusCode::OK) {
+        return code;
+    }
+
+    if (encoding_ == Encoding::Cbor) {
+        return write_number_cbor_(value);
+    }
+
+    return write_number_json_(value);
+}
+
+status::StatusCode StreamWriter::write_number_json_(double value) {
+    // Same as print_number() in cJSON.
+    char buf[26];
+    int len = 0;
+
+    if (std::isnan(value) || std::isinf(value)) {
+        len = snprintf(buf, sizeof(buf), "null");
+    } else if (value >= INT_MIN && value <= INT_MAX
+               && value == static_cast<double>(static_cast<int>(value))) {
+        len = snprintf(buf, sizeof(buf), "%d", static_cast<int>(value));
+    } else {
+        len = snprintf(buf, sizeof(buf), "%1.15g", value);
+
+        if (strtod(buf, nullptr) != value) {
+            len = snprintf(buf, sizeof(buf), "%1.17g", value);
+        }
+    }
+
+    if (len < 0 || len >= static_cast<int>(sizeof(buf))) {
+        return fail_(status::StatusCode::Error);
+    }
+
+    return write_(buf, len);
+}
+
+status::StatusCode StreamWriter::boolean(bool value) {
+    if (const auto code = begin_value_(); code != status::StatusCode::OK) {
+        return code;
+    }
+
+    if (encoding_ == Encoding::Cbor) {
+        return write_(value ? cbor_true : cbor_false);
+    }
+
+    return value ? write_("true", 4) : write_("false", 5);
+}
+
+status::StatusCode StreamWriter::null() {
+    if (const auto code = begin_value_(); code != status::StatusCode::OK) {
+        return code;
+    }
+
+    if (encoding_ == Encoding::Cbor) {
+        return write_(cbor_null);
+    }
+
+    return write_("null", 4);
+}
+
+status::StatusCode StreamWriter::value(const cJSON* json) {
+    if (code_ != status::StatusCode::OK) {
+        return code_;
+    }
+
+    if (!json) {
+        return fail_(status::StatusCode::InvalidArg);
+    }
+
+    switch (json->type & 0xFF) {
+    case cJSON_False:
+        return boolean(false);
+
+    case cJSON_True:
+        return boolean(true);
+
+    case cJSON_NULL:
+        return null();
+
+    case cJSON_Number:
+        return number(json->valuedouble);
+
+    case cJSON_String:
+        return string(json->valuestring);
+
+    case cJSON_Raw: {
+        if (!json->valuestring || encoding_ == Encoding::Cbor) {
+            return fail_(status::StatusCode::InvalidArg);
+        }
+
+        if (const auto code = begin_value_(); code != status::StatusCode::OK) {
+            return code;
+        }
+
+        return write_(json->valuestring, strlen(json->valuestring));
+    }
+
+    case cJSON_Array: {
+        if (const auto code = begin_array(); code != status::StatusCode::OK) {
+            return code;
+        }
+
+        for (const cJSON* item = json->child; item; item = item->next) {
+            if (const auto code = value(item); code != status::StatusCode::OK) {
+                return code;
+            }
+        }
+
+        return end_array();
+    }
+
+    case cJSON_Object: {
+        if (const auto code = begin_object(); code != status::StatusCode::OK) {
+            return code;
+        }
+
+        if (const auto code = add_fields(json); code != status::StatusCode::OK) {
+            return code;
+        }
+
+        return end_object();
+    }
+
+    default:
+        break;
+    }
+
+    return fail_(status::StatusCode::InvalidArg);
+}
+
+status::StatusCode StreamWriter::add_string(const char* key, const char* value) {
+    if (const auto code = this->key(key); code != status::StatusCode::OK) {
+        return code;
+    }
+
+    return string(value);
+}
+
+status::StatusCode StreamWriter::add_number(const char* key, double value) {
+    if (const auto code = this->key(key); code != status::StatusCode::OK) {
+        return code;
+    }
+
+    return number(value);
+}
+
+status::StatusCode StreamWriter::add_bool(const char* key, bool value) {
+    if (const auto code = this->key(key); code != status::StatusCode::OK) {
+        return code;
+    }
+
+    return boolean(value);
+}
+
+status::StatusCode StreamWriter::add_fields(const cJSON* json) {
+    if (code_ != status::StatusCode::OK) {
+        return code_;
+    }
+
+    if (!json || !cJSON_IsObject(json)) {
+        return fail_(status::StatusCode::InvalidArg);
+    }
+
+    for (const cJSON* item = json->child; item; item = item->next) {
+        if (const auto code = key(item->string); code != status::StatusCode::OK) {
+            return code;
+        }
+
+        if (const auto code = value(item); code != status::StatusCode::OK) {
+            return code;
+        }
+    }
+
+    return status::StatusCode::OK;
+}
+
+status::StatusCode StreamWriter::flush() {
+    if (code_ != status::StatusCode::OK) {
+        return code_;
+    }
+
+    if (!pos_) {
+        return status::StatusCode::OK;
+    }
+
+    const auto code = writer_.write(buf_, pos_);
+    if (code != status::StatusCode::OK) {
+        return fail_(code);
+    }
+
+    flushed_ += pos_;
+    pos_ = 0;
+
+    return status::StatusCode::OK;
+}
+
+status::StatusCode StreamWriter::code() const {
+    return code_;
+}
+
+unsigned StreamWriter::flushed() const {
+    return flushed_;
+}
+
+status::StatusCode StreamWriter::begin_value_() {
+    if (code_ != status::StatusCode::OK) {
+        return code_;
+    }
+
+    if (key_) {
+        key_ = false;
+        return status::StatusCode::OK;
+    }
+
+    if (!depth_) {
+        return status::StatusCode::OK;
+    }
+
+    const uint32_t bit = 1u << (depth_ - 1);
+
+    // Object value should be preceded by the key.
+    if (objects_ & bit) {
+        return fail_(status::StatusCode::InvalidState);
+    }
+
+    if (encoding_ == Encoding::Cbor) {
+        return status::StatusCode::OK;
+    }
+
+    if (non_empty_ & bit) {
+        if (const auto code = write_(','); code != status::StatusCode::OK) {
+            return code;
+        }
+    }
+
+    non_empty_ |= bit;
+
+    return status::StatusCode::OK;
+}
+
+status::StatusCode StreamWriter::begin_container_(bool object) {
+    if (const auto code = begin_value_(); code != status::StatusCode::OK) {
+        return code;
+    }
+
+    if (depth_ == max_depth) {
+        return fail_(status::StatusCode::InvalidState);
+    }
+
+    const uint32_t bit = 1u << depth_;
+
+    if (object) {
+        objects_ |= bit;
+    } else {
+        objects_ &= ~bit;
+    }
+
+    non_empty_ &= ~bit;
+    ++depth_;
+
+    if (encoding_ == Encoding::Cbor) {
+        return write_(object ? cbor_map_begin : cbor_array_begin);
+    }
+
+    return write_(object ? '{' : '[');
+}
+
+status::StatusCode StreamWriter::end_container_(bool object) {
+    if (code_ != status::StatusCode::OK) {
+        return code_;
+    }
+
+    if (!depth_ || key_) {
+        return fail_(status::StatusCode::InvalidState);
+    }
+
+    const bool is_object = objects_ & (1u << (depth_ - 1));
+    if (is_object != object) {
+        return fail_(status::StatusCode::InvalidState);
+    }
+
+    --depth_;
+
+    if (encoding_ == Encoding::Cbor) {
+        return write_(cbor_break);
+    }
+
+    return write_(object ? '}' : ']');
+}
+
+status::StatusCode StreamWriter::write_(const char* data, unsigned size) {
+    while (size) {
+        if (pos_ == size_) {
+            if (const auto code = flush(); code != status::StatusCode::OK) {
+                return code;
+            }
+        }
+
+        const unsigned len = std::min(size, size_ - pos_);
+
+        memcpy(buf_ + pos_, data, len);
+
+        pos_ += len;
+        data += len;
+        size -= len;
+    }
+
+    return status::StatusCode::OK;
+}
+
+status::StatusCode StreamWriter::write_(char c) {
+    return write_(&c, 1);
+}
+
+status::StatusCode StreamWriter::write_escaped_(const char* str) {
+    if (const auto code = write_('"'); code != status::StatusCode::OK) {
+        return code;
+    }
+
+    // cJSON prints NULL string as an empty string.
+    if (!str) {
+        return write_('"');
+    }
+
+    const char* begin = str;
+
+    for (; *str; ++str) {
+        const auto c = static_cast<unsigned char>(*str);
+        if (c >= 32 && c != '"' && c != '\\') {
+            continue;
+        }
+
+        const auto code = write_(begin, str - begin);
+        if (code != status::StatusCode::OK) {
+            return code;
+        }
+
+        begin = str + 1;
+
+        char buf[7];
+        unsigned len = 2;
+
+        buf[0] = '\\';
+
+        switch (c) {
+        case '"':
+            buf[1] = '"';
+            break;
+        case '\\':
+            buf[1] = '\\';
+            break;
+        case '\b':
+            buf[1] = 'b';
+            break;
+        case '\f':
+            buf[1] = 'f';
+            break;
+        case '\n':
+            buf[1] = 'n';
+            break;
+        case '\r':
+            buf[1] = 'r';
+            break;
+        case '\t':
+            buf[1] = 't';
+            break;
+        default:
+            len = snprintf(buf, sizeof(buf), "\\u%04x", c);
+            break;
+        }
+
+        if (const auto code = write_(buf, len); code != status::StatusCode::OK) {
+            return code;
+        }
+    }
+
+    if (const auto code = write_(begin, str - begin); code != status::StatusCode::OK) {
+        return code;
+    }
+
+    return write_('"');
+}
+
+status::StatusCode StreamWriter::write_number_cbor_(double value) {
+    // Same data model as the JSON encoding.
+    if (std::isnan(value) || std::isinf(value)) {
+        return write_(cbor_null);
+    }
+
+    // 2^64, the CBOR integer magnitude is limited to 64 bits.
+    const double integer_limit = 18446744073709551616.0;
+
+    if (std::trunc(value) == value && std::fabs(value) < integer_limit) {
+        if (value >= 0) {
+            return write_head_cbor_(cbor_major_unsigned, static_cast<uint64_t>(value));
+        }
+
+        // Negative integer N is encoded as -1 - N.
+        return write_head_cbor_(cbor_major_negative,
+                                static_cast<uint64_t>(-value) - 1);
+    }
+
+    uint8_t buf[9];
+    unsigned len = 0;
+
+    const float single = static_cast<float>(value);
+
+    if (static_cast<double>(single) == value) {
+        uint32_t bits = 0;
+        memcpy(&bits, &single, sizeof(bits));
+
+        buf[len++] = cbor_float32;
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            buf[len++] = bits >> shift;
+        }
+    } else {
+        uint64_t bits = 0;
+        memcpy(&bits, &value, sizeof(bits));
+
+        buf[len++] = cbor_float64;
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            buf[len++] = bits >> shift;
+        }
+    }
+
+    return write_(reinterpret_cast<const char*>(buf), len);
+}
+
+status::StatusCode StreamWriter::write_string_cbor_(const char* str) {
+    // cJSON prints NULL string as an empty string.
+    const unsigned len = str ? strlen(str) : 0;
+
+    if (const auto code = write_head_cbor_(cbor_major_text, len);
+        code != status::StatusCode::OK) {
+        return code;
+    }
+
+    return write_(str, len);
+}
+
+status::StatusCode StreamWriter::write_head_cbor_(uint8_t major, uint64_t value) {
+    uint8_t buf[9];
+    unsigned len = 0;
+
+    major <<= 5;
+
+    if (value < 24) {
+        buf[len++] = major | value;
+    } else {
+        unsigned size = 8;
+        uint8_t info = 27;
+
+        if (value <= UINT8_MAX) {
+            size = 1;
+            info = 24;
+        } else if (value <= UINT16_MAX) {
+            size = 2;
+            info = 25;
+        } else if (value <= UINT32_MAX) {
+            size = 4;
+            info = 26;
+        }
+
+        buf[len++] = major | info;
+        for (int shift = (size - 1) * 8; shift >= 0; shift -= 8) {
+            buf[len++] = value >> shift;
+        }
+    }
+
+    return write_(reinterpret_cast<const char*>(buf), len);
+}
+
+status::StatusCode StreamWriter::fail_(status::StatusCode code) {
+    if (code_ == status::StatusCode::OK) {
+        code_ = code;
+    }
+
+    return code_;
+}
+
+} // namespace json
+} // namespace fmt
+} // namespace ocs
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "cJSON.h"
+
+#include "ocs_core/istream_writer.h"
+#include "ocs_core/noncopyable.h"
+#include "ocs_status/code.h"
+
+namespace ocs {
+namespace fmt {
+namespace json {
+
+//! Serialize JSON directly into the stream, without building the cJSON tree.
+//!
+//! @notes
+//!  The data is accumulated in the scratch buffer provided by the caller, and is written
+//!  to the underlying stream each time the buffer becomes full, and on flush(). Commas
+//!  and colons are placed automatically, based on the current nesting level.
+//!
+//!  The same data model can be encoded as CBOR (RFC 8949): objects and arrays are
+//!  encoded as indefinite-length maps and arrays, so they can be streamed, integral
+//!  numbers are encoded as integers, other numbers as the shortest float that holds
+//!  the exact value. cJSON raw values can't be encoded as CBOR.
+//!
+//!  The first error is remembered, all subsequent calls return it without writing
+//!  anything, so the caller can check the result only once, at the end.
+//!
+//! @example
+//!  StreamWriter writer(stream, buf, sizeof(buf));
+//!  writer.begin_object();
+//!  writer.add_number("temperature", 21.5);
+//!  writer.add_string("status", "ok");
+//!  writer.end_object();
+//!  const auto code = writer.flush();
+class StreamWriter : public core::NonCopyable<> {
+public:
+    //! Maximum nesting level of objects and arrays.
+    static constexpr unsigned max_depth = 32;
+
+    enum class Encoding {
+        //! Text JSON, formatted in the same way as cJSON does.
+        Json,
+
+        //! Binary CBOR.
+        Cbor,
+    };
+
+    //! Initialize.
+    //!
+    //! @params
+    //!  - @p writer to write the serialized data.
+    //!  - @p buf - scratch buffer, should be alive during the writer lifetime.
+    //!  - @p size - scratch buffer size, in bytes.
+    //!  - @p encoding - how the data is serialized.
+    StreamWriter(core::IStreamWriter& writer,
+                 char* buf,
+                 unsigned size,
+                 Encoding encoding = Encoding::Json);
+
+    //! Return the encoding of the serialized data.
+    Encoding encoding() const;
+
+    //! Begin JSON object.
+    status::StatusCode begin_object();
+
+    //! End JSON object.
+    status::StatusCode end_object();
+
+    //! Begin JSON array.
+    status::StatusCode begin_array();
+
+    //! End JSON array.
+    status::StatusCode end_array();
+
+    //! Write object key, should be followed by the value.
+    status::StatusCode key(const char* key);
+
+    //! Write escaped string value.
+    status::StatusCode string(const char* value);
+
+    //! Write number value.
+    status::StatusCode number(double value);
+
+    //! Write boolean value.
+    status::StatusCode boolean(bool value);
+
+    //! Write null value.
+    status::StatusCode null();
+
+    //! Write cJSON item as a value.
+    status::StatusCode value(const cJSON* json);
+
+    //! Write @p key with string @p value.
+    status::StatusCode add_string(const char* key, const char* value);
+
+    //! Write @p key with number @p value.
+    status::StatusCode add_number(const char* key, double value);
+
+    //! Write @p key with boolean @p value.
+    status::StatusCode add_bool(const char* key, bool value);
+
+    //! Write all items of cJSON object @p json as the fields of the current object.
+    status::StatusCode add_fields(const cJSON* json);
+
+    //! Write the buffered data to the underlying stream.
+    status::StatusCode flush();
+
+    //! Return the first error occurred during the writing.
+    status::StatusCode code() const;
+
+    //! Return the number of bytes written to the underlying stream.
+    unsigned flushed() const;
+
+private:
+    status::StatusCode begin_value_();
+    status::StatusCode begin_container_(bool object);
+    status::StatusCode end_container_(bool object);
+
+    status::StatusCode write_(const char* data, unsigned size);
+    status::StatusCode write_(char c);
+    status::StatusCode write_escaped_(const char* str);
+
+    status::StatusCode write_number_json_(double value);
+    status::StatusCode write_number_cbor_(double value);
+    status::StatusCode write_string_cbor_(const char* str);
+    status::StatusCode write_head_cbor_(uint8_t major, uint64_t value);
+
+    status::StatusCode fail_(status::StatusCode code);
+
+    core::IStreamWriter& writer_;
+
+    char* const buf_ { nullptr };
+    const unsigned size_ { 0 };
+    const Encoding encoding_ { Encoding::Json };
+
+    unsigned pos_ { 0 };
+    unsigned flushed_ { 0 };
+
+    unsigned depth_ { 0 };
+
+    //! Bit N is set if the container on level N is an object.
+    uint32_t objects_ { 0 };
+
+    //! Bit N is set if the container on level N has at least one value.
+    uint32_t non_empty_ { 0 };
+
+    //! Key is written, value is expected.
+    bool key_ { false };
+
+    status::StatusCode code_ { status::StatusCode::OK };
+};
+
+} // namespace json
+} // namespace fmt
+} // namespace ocs
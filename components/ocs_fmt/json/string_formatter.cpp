@@ -25,8 +25,24 @@ status::StatusCode StringFormatter::format(cJSON* json) {
     return status::StatusCode::OK;
 }
 
+status::StatusCode StringFormatter::format(StreamWriter& writer) {
+    for (const auto& [key, val] : values_) {
+        const auto code = writer.add_string(key.c_str(), val.c_str());
+        if (code != status::StatusCode::OK) {
+            return code;
+        }
+    }
+
+    return status::StatusCode::OK;
+}
+
+std::optional<uint32_t> StringFormatter::generation() const {
+    return generation_;
+}
+
 void StringFormatter::add(const char* key, const char* val) {
     values_[key] = val;
+    ++generation_;
 }
 
 } // namespace json
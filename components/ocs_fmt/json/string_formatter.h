@@ -27,10 +27,17 @@ public:
     //! Format key-value pairs into @p json.
     status::StatusCode format(cJSON* json) override;
 
+    //! Format key-value pairs into @p writer.
+    status::StatusCode format(StreamWriter& writer) override;
+
+    //! Return the number of add() calls.
+    std::optional<uint32_t> generation() const override;
+
     //! Add key-value pair to be added to the result json when format() is called.
     void add(const char* key, const char* value);
 
 private:
+    uint32_t generation_ { 0 };
     std::unordered_map<std::string, std::string> values_;
 };
 
@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "cJSON.h"
+#include "unity.h"
+
+#include "ocs_fmt/json/cjson_arena.h"
+
+namespace ocs {
+namespace fmt {
+namespace json {
+
+TEST_CASE("cJSON arena: allocate outside scope", "[ocs_fmt], [cjson_arena]") {
+    CjsonArena arena(256);
+
+    void* ptr = cJSON_malloc(16);
+    TEST_ASSERT_NOT_NULL(ptr);
+
+    TEST_ASSERT_EQUAL(0, arena.high_water_mark());
+    TEST_ASSERT_EQUAL(0, arena.fallback_count());
+
+    cJSON_free(ptr);
+}
+
+TEST_CASE("cJSON arena: allocate within scope", "[ocs_fmt], [cjson_arena]") {
+    CjsonArena arena(256);
+
+    {
+        CjsonArenaScope scope(&arena);
+
+        void* ptr1 = cJSON_malloc(16);
+        TEST_ASSERT_NOT_NULL(ptr1);
+
+        void* ptr2 = cJSON_malloc(16);
+        TEST_ASSERT_NOT_NULL(ptr2);
+        TEST_ASSERT_TRUE(ptr1 != ptr2);
+
+        TEST_ASSERT_TRUE(arena.high_water_mark() >= 32);
+        TEST_ASSERT_EQUAL(0, arena.fallback_count());
+
+        // No-op for the arena memory.
+        cJSON_free(ptr1);
+        cJSON_free(ptr2);
+    }
+
+    // Allocations go to the heap once the scope is left.
+    const unsigned high_water_mark = arena.high_water_mark();
+
+    void* ptr = cJSON_malloc(16);
+    TEST_ASSERT_NOT_NULL(ptr);
+    TEST_ASSERT_EQUAL(high_water_mark, arena.high_water_mark());
+
+    cJSON_free(ptr);
+}
+
+TEST_CASE("cJSON arena: reset on scope exit", "[ocs_fmt], [cjson_arena]") {
+    CjsonArena arena(256);
+
+    void* first_ptr = nullptr;
+
+    {
+        CjsonArenaScope scope(&arena);
+
+        first_ptr = cJSON_malloc(64);
+        TEST_ASSERT_NOT_NULL(first_ptr);
+    }
+
+    const unsigned high_water_mark = arena.high_water_mark();
+    TEST_ASSERT_TRUE(high_water_mark >= 64);
+
+    // The whole arena is available again, starting from the beginning.
+    for (unsigned n = 0; n < 10; ++n) {
+        CjsonArenaScope scope(&arena);
+
+        void* ptr = cJSON_malloc(64);
+        TEST_ASSERT_EQUAL_PTR(first_ptr, ptr);
+    }
+
+    TEST_ASSERT_EQUAL(high_water_mark, arena.high_water_mark());
+    TEST_ASSERT_EQUAL(0, arena.fallback_count());
+}
+
+TEST_CASE("cJSON arena: fall back to heap when exhausted", "[ocs_fmt], [cjson_arena]") {
+    CjsonArena arena(64);
+
+    {
+        CjsonArenaScope scope(&arena);
+
+        void* arena_ptr = cJSON_malloc(48);
+        TEST_ASSERT_NOT_NULL(arena_ptr);
+        TEST_ASSERT_EQUAL(0, arena.fallback_count());
+
+        // Doesn't fit into the rest of the arena.
+        char* heap_ptr = static_cast<char*>(cJSON_malloc(48));
+        TEST_ASSERT_NOT_NULL(heap_ptr);
+        TEST_ASSERT_EQUAL(1, arena.fallback_count());
+
+        // Larger than the whole arena.
+        char* large_ptr = static_cast<char*>(cJSON_malloc(1024));
+        TEST_ASSERT_NOT_NULL(large_ptr);
+        TEST_ASSERT_EQUAL(2, arena.fallback_count());
+
+        // Heap memory is usable and is released to the heap within the scope.
+        heap_ptr[0] = heap_ptr[47] = 'x';
+        large_ptr[0] = large_ptr[1023] = 'x';
+
+        cJSON_free(heap_ptr);
+        cJSON_free(large_ptr);
+        cJSON_free(arena_ptr);
+    }
+
+    TEST_ASSERT_TRUE(arena.high_water_mark() <= 64);
+}
+
+TEST_CASE("cJSON arena: build tree when exhausted", "[ocs_fmt], [cjson_arena]") {
+    CjsonArena arena(128);
+
+    {
+        CjsonArenaScope scope(&arena);
+
+        cJSON* json = cJSON_CreateObject();
+        TEST_ASSERT_NOT_NULL(json);
+
+        for (unsigned n = 0; n < 16; ++n) {
+            TEST_ASSERT_NOT_NULL(cJSON_AddNumberToObject(json, "value", n));
+        }
+
+        TEST_ASSERT_EQUAL(16, cJSON_GetArraySize(json));
+        TEST_ASSERT_TRUE(arena.fallback_count() > 0);
+
+        // Items are freed from both the arena and the heap.
+        cJSON_Delete(json);
+    }
+}
+
+TEST_CASE("cJSON arena: nested scopes", "[ocs_fmt], [cjson_arena]") {
+    CjsonArena outer(256);
+    CjsonArena inner(256);
+
+    {
+        CjsonArenaScope outer_scope(&outer);
+
+        char* outer_ptr1 = static_cast<char*>(cJSON_malloc(16));
+        TEST_ASSERT_NOT_NULL(outer_ptr1);
+
+        const unsigned outer_high_water_mark = outer.high_water_mark();
+
+        {
+            CjsonArenaScope inner_scope(&inner);
+
+            void* inner_ptr = cJSON_malloc(32);
+            TEST_ASSERT_NOT_NULL(inner_ptr);
+
+            TEST_ASSERT_TRUE(inner.high_water_mark() >= 32);
+            TEST_ASSERT_EQUAL(outer_high_water_mark, outer.high_water_mark());
+
+            // Memory of the outer arena isn't released to the heap.
+            cJSON_free(outer_ptr1);
+
+            {
+                // Already entered, allocations are still served from the inner arena.
+                CjsonArenaScope outer_scope_again(&outer);
+                CjsonArenaScope inner_scope_again(&inner);
+
+                void* ptr = cJSON_malloc(32);
+                TEST_ASSERT_NOT_NULL(ptr);
+                TEST_ASSERT_TRUE(inner.high_water_mark() >= 64);
+                TEST_ASSERT_EQUAL(outer_high_water_mark, outer.high_water_mark());
+            }
+
+            // Inner arena is still entered.
+            TEST_ASSERT_NOT_NULL(cJSON_malloc(32));
+            TEST_ASSERT_TRUE(inner.high_water_mark() >= 96);
+        }
+
+        // Back to the outer arena, which isn't reset by the inner scope.
+        char* outer_ptr2 = static_cast<char*>(cJSON_malloc(16));
+        TEST_ASSERT_NOT_NULL(outer_ptr2);
+        TEST_ASSERT_TRUE(outer_ptr2 >= outer_ptr1 + 16);
+        TEST_ASSERT_TRUE(outer.high_water_mark() > outer_high_water_mark);
+    }
+
+    TEST_ASSERT_EQUAL(0, outer.fallback_count());
+    TEST_ASSERT_EQUAL(0, inner.fallback_count());
+
+    // Inner arena is reset on its scope exit.
+    {
+        CjsonArenaScope scope(&inner);
+
+        const unsigned high_water_mark = inner.high_water_mark();
+        TEST_ASSERT_NOT_NULL(cJSON_malloc(32));
+        TEST_ASSERT_EQUAL(high_water_mark, inner.high_water_mark());
+    }
+}
+
+TEST_CASE("cJSON arena: null arena", "[ocs_fmt], [cjson_arena]") {
+    CjsonArena arena(256);
+
+    {
+        CjsonArenaScope scope(nullptr);
+
+        void* ptr = cJSON_malloc(16);
+        TEST_ASSERT_NOT_NULL(ptr);
+        TEST_ASSERT_EQUAL(0, arena.high_water_mark());
+
+        cJSON_free(ptr);
+    }
+}
+
+} // namespace json
+} // namespace fmt
+} // namespace ocs
@@ -0,0 +1,322 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "unity.h"
+
+#include "ocs_fmt/json/delta_formatter.h"
+#include "ocs_fmt/json/fanout_formatter.h"
+#include "ocs_test/test_stream_writer.h"
+
+namespace ocs {
+namespace fmt {
+namespace json {
+
+namespace {
+
+const uint32_t test_epoch = 42;
+
+struct TestFormatter : public IFormatter {
+    status::StatusCode format(cJSON* json) override {
+        ++format_count;
+
+        if (code != status::StatusCode::OK) {
+            return code;
+        }
+
+        for (const auto& [key, value] : fields) {
+            if (!cJSON_AddNumberToObject(json, key.c_str(), value)) {
+                return status::StatusCode::NoMem;
+            }
+        }
+
+        return status::StatusCode::OK;
+    }
+
+    std::optional<uint32_t> generation() const override {
+        return gen;
+    }
+
+    std::vector<std::pair<std::string, double>> fields;
+    std::optional<uint32_t> gen;
+    unsigned format_count { 0 };
+    status::StatusCode code { status::StatusCode::OK };
+};
+
+std::string
+format_delta(DeltaFormatter& formatter, uint32_t since, uint32_t epoch = test_epoch) {
+    test::TestStreamWriter stream;
+
+    char buf[128];
+    StreamWriter writer(stream, buf, sizeof(buf));
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.begin_object());
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, formatter.format(writer, epoch, since));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.end_object());
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.flush());
+
+    return stream.str();
+}
+
+} // namespace
+
+TEST_CASE("Delta formatter: format all since zero", "[ocs_fmt], [delta_formatter]") {
+    TestFormatter tracked;
+    tracked.fields = { { "a", 1 }, { "b", 2 } };
+    tracked.gen = 1;
+
+    TestFormatter untracked;
+    untracked.fields = { { "c", 3 } };
+
+    FanoutFormatter fanout_formatter;
+    fanout_formatter.add(tracked);
+    fanout_formatter.add(untracked);
+
+    DeltaFormatter formatter(fanout_formatter, test_epoch);
+    TEST_ASSERT_EQUAL(0, formatter.sequence());
+
+    TEST_ASSERT_EQUAL_STRING("{\"a\":1,\"b\":2,\"c\":3,\"epoch\":42,\"seq\":1}",
+                             format_delta(formatter, 0).c_str());
+    TEST_ASSERT_EQUAL(1, formatter.sequence());
+
+    TEST_ASSERT_EQUAL_STRING("{\"a\":1,\"b\":2,\"c\":3,\"epoch\":42,\"seq\":1}",
+                             format_delta(formatter, 0).c_str());
+    TEST_ASSERT_EQUAL(1, formatter.sequence());
+
+    // Sequence from before reboot.
+    TEST_ASSERT_EQUAL_STRING("{\"a\":1,\"b\":2,\"c\":3,\"epoch\":42,\"seq\":1}",
+                             format_delta(formatter, 100).c_str());
+    TEST_ASSERT_EQUAL(1, formatter.sequence());
+}
+
+TEST_CASE("Delta formatter: omit unchanged fields", "[ocs_fmt], [delta_formatter]") {
+    TestFormatter tracked;
+    tracked.fields = { { "a", 1 }, { "b", 2 } };
+    tracked.gen = 1;
+
+    FanoutFormatter fanout_formatter;
+    fanout_formatter.add(tracked);
+
+    DeltaFormatter formatter(fanout_formatter, test_epoch);
+
+    TEST_ASSERT_EQUAL_STRING("{\"a\":1,\"b\":2,\"epoch\":42,\"seq\":1}",
+                             format_delta(formatter, 0).c_str());
+    TEST_ASSERT_EQUAL(1, tracked.format_count);
+
+    // Generation isn't changed, the data isn't re-formatted.
+    for (unsigned n = 0; n < 10; ++n) {
+        TEST_ASSERT_EQUAL_STRING("{\"epoch\":42,\"seq\":1}",
+                                 format_delta(formatter, 1).c_str());
+    }
+
+    TEST_ASSERT_EQUAL(1, tracked.format_count);
+    TEST_ASSERT_EQUAL(1, formatter.sequence());
+
+    // Generation is changed, but the data isn't.
+    tracked.gen = 2;
+
+    TEST_ASSERT_EQUAL_STRING("{\"epoch\":42,\"seq\":1}",
+                             format_delta(formatter, 1).c_str());
+    TEST_ASSERT_EQUAL(2, tracked.format_count);
+    TEST_ASSERT_EQUAL(1, formatter.sequence());
+}
+
+TEST_CASE("Delta formatter: bump sequence on change", "[ocs_fmt], [delta_formatter]") {
+    TestFormatter tracked;
+    tracked.fields = { { "a", 1 }, { "b", 2 } };
+    tracked.gen = 1;
+
+    FanoutFormatter fanout_formatter;
+    fanout_formatter.add(tracked);
+
+    DeltaFormatter formatter(fanout_formatter, test_epoch);
+
+    TEST_ASSERT_EQUAL_STRING("{\"a\":1,\"b\":2,\"epoch\":42,\"seq\":1}",
+                             format_delta(formatter, 0).c_str());
+
+    // Change isn't noticed until the generation is changed.
+    tracked.fields = { { "a", 1 }, { "b", 5 } };
+
+    TEST_ASSERT_EQUAL_STRING("{\"epoch\":42,\"seq\":1}",
+                             format_delta(formatter, 1).c_str());
+
+    tracked.gen = 2;
+
+    TEST_ASSERT_EQUAL_STRING("{\"b\":5,\"epoch\":42,\"seq\":2}",
+                             format_delta(formatter, 1).c_str());
+    TEST_ASSERT_EQUAL(2, formatter.sequence());
+
+    TEST_ASSERT_EQUAL_STRING("{\"epoch\":42,\"seq\":2}",
+                             format_delta(formatter, 2).c_str());
+    TEST_ASSERT_EQUAL_STRING("{\"a\":1,\"b\":5,\"epoch\":42,\"seq\":2}",
+                             format_delta(formatter, 0).c_str());
+
+    // New field.
+    tracked.fields = { { "a", 1 }, { "b", 5 }, { "c", 7 } };
+    tracked.gen = 3;
+
+    TEST_ASSERT_EQUAL_STRING("{\"c\":7,\"epoch\":42,\"seq\":3}",
+                             format_delta(formatter, 2).c_str());
+
+    // Client which missed several changes.
+    TEST_ASSERT_EQUAL_STRING("{\"b\":5,\"c\":7,\"epoch\":42,\"seq\":3}",
+                             format_delta(formatter, 1).c_str());
+    TEST_ASSERT_EQUAL(3, formatter.sequence());
+}
+
+TEST_CASE("Delta formatter: untracked sources", "[ocs_fmt], [delta_formatter]") {
+    TestFormatter tracked;
+    tracked.fields = { { "a", 1 } };
+    tracked.gen = 1;
+
+    TestFormatter untracked;
+    untracked.fields = { { "b", 2 } };
+
+    FanoutFormatter fanout_formatter;
+    fanout_formatter.add(tracked);
+    fanout_formatter.add(untracked);
+
+    DeltaFormatter formatter(fanout_formatter, test_epoch);
+
+    TEST_ASSERT_EQUAL_STRING("{\"a\":1,\"b\":2,\"epoch\":42,\"seq\":1}",
+                             format_delta(formatter, 0).c_str());
+
+    // Serialized each time, but unchanged fields are still omitted.
+    for (unsigned n = 0; n < 10; ++n) {
+        TEST_ASSERT_EQUAL_STRING("{\"epoch\":42,\"seq\":1}",
+                                 format_delta(formatter, 1).c_str());
+    }
+
+    TEST_ASSERT_EQUAL(1, tracked.format_count);
+    TEST_ASSERT_EQUAL(11, untracked.format_count);
+    TEST_ASSERT_EQUAL(1, formatter.sequence());
+
+    // Change is noticed without the generation.
+    untracked.fields = { { "b", 3 } };
+
+    TEST_ASSERT_EQUAL_STRING("{\"b\":3,\"epoch\":42,\"seq\":2}",
+                             format_delta(formatter, 1).c_str());
+    TEST_ASSERT_EQUAL_STRING("{\"epoch\":42,\"seq\":2}",
+                             format_delta(formatter, 2).c_str());
+    TEST_ASSERT_EQUAL(1, tracked.format_count);
+    TEST_ASSERT_EQUAL(2, formatter.sequence());
+}
+
+TEST_CASE("Delta formatter: epoch mismatch", "[ocs_fmt], [delta_formatter]") {
+    TestFormatter tracked;
+    tracked.fields = { { "a", 1 }, { "b", 2 } };
+    tracked.gen = 1;
+
+    FanoutFormatter fanout_formatter;
+    fanout_formatter.add(tracked);
+
+    DeltaFormatter formatter(fanout_formatter, test_epoch);
+    TEST_ASSERT_EQUAL(test_epoch, formatter.epoch());
+
+    TEST_ASSERT_EQUAL_STRING("{\"a\":1,\"b\":2,\"epoch\":42,\"seq\":1}",
+                             format_delta(formatter, 0).c_str());
+
+    for (uint32_t gen = 2; gen <= 4; ++gen) {
+        tracked.fields = { { "a", 1 }, { "b", double(gen + 1) } };
+        tracked.gen = gen;
+
+        format_delta(formatter, 0);
+    }
+
+    TEST_ASSERT_EQUAL(4, formatter.sequence());
+
+    TEST_ASSERT_EQUAL_STRING("{\"epoch\":42,\"seq\":4}",
+                             format_delta(formatter, 4).c_str());
+
+    // Sequence from before reboot, which is less than the current one.
+    TEST_ASSERT_EQUAL_STRING("{\"a\":1,\"b\":5,\"epoch\":42,\"seq\":4}",
+                             format_delta(formatter, 3, 7).c_str());
+
+    // Sequence without epoch.
+    TEST_ASSERT_EQUAL_STRING("{\"a\":1,\"b\":5,\"epoch\":42,\"seq\":4}",
+                             format_delta(formatter, 4, 0).c_str());
+}
+
+TEST_CASE("Delta formatter: untracked source changes fields",
+          "[ocs_fmt], [delta_formatter]") {
+    TestFormatter untracked;
+    untracked.fields = { { "a", 1 }, { "b", 2 }, { "c", 3 } };
+
+    FanoutFormatter fanout_formatter;
+    fanout_formatter.add(untracked);
+
+    DeltaFormatter formatter(fanout_formatter, test_epoch);
+
+    TEST_ASSERT_EQUAL_STRING("{\"a\":1,\"b\":2,\"c\":3,\"epoch\":42,\"seq\":1}",
+                             format_delta(formatter, 0).c_str());
+
+    // Same fields in the different order.
+    untracked.fields = { { "c", 3 }, { "a", 1 }, { "b", 2 } };
+
+    TEST_ASSERT_EQUAL_STRING("{\"epoch\":42,\"seq\":1}",
+                             format_delta(formatter, 1).c_str());
+
+    // New field in the middle.
+    untracked.fields = { { "a", 1 }, { "d", 4 }, { "b", 2 }, { "c", 3 } };
+
+    TEST_ASSERT_EQUAL_STRING("{\"d\":4,\"epoch\":42,\"seq\":2}",
+                             format_delta(formatter, 1).c_str());
+
+    // Removed field keeps its last value.
+    untracked.fields = { { "a", 5 }, { "c", 3 } };
+
+    TEST_ASSERT_EQUAL_STRING("{\"a\":5,\"epoch\":42,\"seq\":3}",
+                             format_delta(formatter, 2).c_str());
+    TEST_ASSERT_EQUAL_STRING("{\"a\":5,\"b\":2,\"c\":3,\"d\":4,\"epoch\":42,\"seq\":3}",
+                             format_delta(formatter, 0).c_str());
+    TEST_ASSERT_EQUAL(5, untracked.format_count);
+}
+
+TEST_CASE("Delta formatter: formatting error", "[ocs_fmt], [delta_formatter]") {
+    TestFormatter tracked;
+    tracked.fields = { { "a", 1 } };
+    tracked.gen = 1;
+
+    TestFormatter untracked;
+    untracked.fields = { { "b", 2 } };
+
+    FanoutFormatter fanout_formatter;
+    fanout_formatter.add(tracked);
+    fanout_formatter.add(untracked);
+
+    DeltaFormatter formatter(fanout_formatter, test_epoch);
+
+    TEST_ASSERT_EQUAL_STRING("{\"a\":1,\"b\":2,\"epoch\":42,\"seq\":1}",
+                             format_delta(formatter, 0).c_str());
+
+    untracked.code = status::StatusCode::Error;
+
+    test::TestStreamWriter stream;
+
+    char buf[128];
+    StreamWriter writer(stream, buf, sizeof(buf));
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.begin_object());
+    TEST_ASSERT_EQUAL(status::StatusCode::Error, formatter.format(writer, test_epoch, 0));
+    TEST_ASSERT_EQUAL(1, formatter.sequence());
+
+    // Recovered on the next call.
+    untracked.code = status::StatusCode::OK;
+    untracked.fields = { { "b", 4 } };
+
+    TEST_ASSERT_EQUAL_STRING("{\"b\":4,\"epoch\":42,\"seq\":2}",
+                             format_delta(formatter, 1).c_str());
+}
+
+} // namespace json
+} // namespace fmt
+} // namespace ocs
@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <cstring>
+#include <string>
+
+#include "cJSON.h"
+#include "unity.h"
+
+#include "ocs_fmt/json/dynamic_formatter.h"
+
+namespace ocs {
+namespace fmt {
+namespace json {
+
+namespace {
+
+// Format JSON string of @p len characters, formatted length is @p len + 2.
+status::StatusCode format_string(DynamicFormatter& formatter, unsigned len) {
+    const std::string value(len, 'x');
+
+    cJSON* json = cJSON_CreateString(value.c_str());
+    TEST_ASSERT_NOT_NULL(json);
+
+    const auto code = formatter.format(json);
+    if (code == status::StatusCode::OK) {
+        TEST_ASSERT_EQUAL(len + 2, strlen(formatter.c_str()));
+        TEST_ASSERT_EQUAL('"', formatter.c_str()[0]);
+        TEST_ASSERT_EQUAL('x', formatter.c_str()[len]);
+    }
+
+    cJSON_Delete(json);
+
+    return code;
+}
+
+} // namespace
+
+TEST_CASE("Dynamic formatter: fixed size", "[ocs_fmt], [dynamic_formatter]") {
+    DynamicFormatter formatter(64);
+    TEST_ASSERT_EQUAL(64, formatter.size());
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, format_string(formatter, 16));
+    TEST_ASSERT_EQUAL(64, formatter.size());
+    TEST_ASSERT_EQUAL(18, formatter.max_len());
+    TEST_ASSERT_EQUAL(0, formatter.failure_count());
+
+    TEST_ASSERT_EQUAL(status::StatusCode::NoMem, format_string(formatter, 100));
+    TEST_ASSERT_EQUAL(64, formatter.size());
+    TEST_ASSERT_EQUAL(18, formatter.max_len());
+    TEST_ASSERT_EQUAL(1, formatter.failure_count());
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, format_string(formatter, 16));
+    TEST_ASSERT_EQUAL(64, formatter.size());
+    TEST_ASSERT_EQUAL(1, formatter.failure_count());
+}
+
+TEST_CASE("Dynamic formatter: grow up to max size", "[ocs_fmt], [dynamic_formatter]") {
+    DynamicFormatter formatter(DynamicFormatter::Params {
+        .size = 64,
+        .max_size = 512,
+        .shrink_after = 0,
+    });
+    TEST_ASSERT_EQUAL(64, formatter.size());
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, format_string(formatter, 16));
+    TEST_ASSERT_EQUAL(64, formatter.size());
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, format_string(formatter, 100));
+    TEST_ASSERT_EQUAL(128, formatter.size());
+    TEST_ASSERT_EQUAL(102, formatter.max_len());
+
+    // Doubled twice within a single call.
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, format_string(formatter, 400));
+    TEST_ASSERT_EQUAL(512, formatter.size());
+    TEST_ASSERT_EQUAL(402, formatter.max_len());
+    TEST_ASSERT_EQUAL(0, formatter.failure_count());
+
+    // Never shrunk.
+    for (unsigned n = 0; n < 10; ++n) {
+        TEST_ASSERT_EQUAL(status::StatusCode::OK, format_string(formatter, 16));
+        TEST_ASSERT_EQUAL(512, formatter.size());
+    }
+
+    TEST_ASSERT_EQUAL(402, formatter.max_len());
+}
+
+TEST_CASE("Dynamic formatter: grow up to max size which isn't power of two",
+          "[ocs_fmt], [dynamic_formatter]") {
+    DynamicFormatter formatter(DynamicFormatter::Params {
+        .size = 64,
+        .max_size = 100,
+        .shrink_after = 0,
+    });
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, format_string(formatter, 80));
+    TEST_ASSERT_EQUAL(100, formatter.size());
+
+    TEST_ASSERT_EQUAL(status::StatusCode::NoMem, format_string(formatter, 100));
+    TEST_ASSERT_EQUAL(100, formatter.size());
+    TEST_ASSERT_EQUAL(1, formatter.failure_count());
+}
+
+TEST_CASE("Dynamic formatter: fail at max size", "[ocs_fmt], [dynamic_formatter]") {
+    DynamicFormatter formatter(DynamicFormatter::Params {
+        .size = 64,
+        .max_size = 256,
+        .shrink_after = 1,
+    });
+
+    // Grown to the maximum size before failing.
+    TEST_ASSERT_EQUAL(status::StatusCode::NoMem, format_string(formatter, 1000));
+    TEST_ASSERT_EQUAL(256, formatter.size());
+    TEST_ASSERT_EQUAL(1, formatter.failure_count());
+    TEST_ASSERT_EQUAL(0, formatter.max_len());
+
+    TEST_ASSERT_EQUAL(status::StatusCode::NoMem, format_string(formatter, 1000));
+    TEST_ASSERT_EQUAL(256, formatter.size());
+    TEST_ASSERT_EQUAL(2, formatter.failure_count());
+
+    // Failures aren't counted as small outputs.
+    TEST_ASSERT_EQUAL(status::StatusCode::NoMem, format_string(formatter, 1000));
+    TEST_ASSERT_EQUAL(256, formatter.size());
+    TEST_ASSERT_EQUAL(3, formatter.failure_count());
+
+    // The output fits into the buffer of maximum size.
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, format_string(formatter, 200));
+    TEST_ASSERT_EQUAL(256, formatter.size());
+    TEST_ASSERT_EQUAL(202, formatter.max_len());
+    TEST_ASSERT_EQUAL(3, formatter.failure_count());
+}
+
+TEST_CASE("Dynamic formatter: shrink after small outputs",
+          "[ocs_fmt], [dynamic_formatter]") {
+    DynamicFormatter formatter(DynamicFormatter::Params {
+        .size = 64,
+        .max_size = 512,
+        .shrink_after = 3,
+    });
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, format_string(formatter, 400));
+    TEST_ASSERT_EQUAL(512, formatter.size());
+
+    // The buffer is halved on the call following the configured number of small
+    // outputs, but never below the initial size.
+    const unsigned sizes[] = {
+        512, 512, 512, 256, 256, 256, 128, 128, 128, 64, 64, 64, 64, 64, 64,
+    };
+
+    for (const auto size : sizes) {
+        TEST_ASSERT_EQUAL(status::StatusCode::OK, format_string(formatter, 4));
+        TEST_ASSERT_EQUAL(size, formatter.size());
+    }
+
+    TEST_ASSERT_EQUAL(402, formatter.max_len());
+    TEST_ASSERT_EQUAL(0, formatter.failure_count());
+
+    // Grown again on demand.
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, format_string(formatter, 200));
+    TEST_ASSERT_EQUAL(256, formatter.size());
+}
+
+TEST_CASE("Dynamic formatter: shrink below quarter of buffer",
+          "[ocs_fmt], [dynamic_formatter]") {
+    DynamicFormatter formatter(DynamicFormatter::Params {
+        .size = 64,
+        .max_size = 512,
+        .shrink_after = 2,
+    });
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, format_string(formatter, 400));
+    TEST_ASSERT_EQUAL(512, formatter.size());
+
+    // 126 + 2 characters and the terminating null exceed the quarter of 512 bytes.
+    for (unsigned n = 0; n < 10; ++n) {
+        TEST_ASSERT_EQUAL(status::StatusCode::OK, format_string(formatter, 126));
+        TEST_ASSERT_EQUAL(512, formatter.size());
+    }
+
+    // Larger output resets the number of consecutive small outputs.
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, format_string(formatter, 125));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, format_string(formatter, 126));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, format_string(formatter, 125));
+    TEST_ASSERT_EQUAL(512, formatter.size());
+
+    // 125 + 2 characters and the terminating null fit exactly into the quarter.
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, format_string(formatter, 125));
+    TEST_ASSERT_EQUAL(512, formatter.size());
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, format_string(formatter, 125));
+    TEST_ASSERT_EQUAL(256, formatter.size());
+
+    // Doesn't fit into the quarter of 256 bytes.
+    for (unsigned n = 0; n < 10; ++n) {
+        TEST_ASSERT_EQUAL(status::StatusCode::OK, format_string(formatter, 125));
+        TEST_ASSERT_EQUAL(256, formatter.size());
+    }
+}
+
+} // namespace json
+} // namespace fmt
+} // namespace ocs
@@ -0,0 +1,516 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "unity.h"
+
+#include "ocs_fmt/json/stream_writer.h"
+#include "ocs_test/test_stream_writer.h"
+
+namespace ocs {
+namespace fmt {
+namespace json {
+
+namespace {
+
+using Bytes = std::vector<uint8_t>;
+
+struct TestVector {
+    double value { 0 };
+    Bytes want;
+};
+
+Bytes encode_cbor_number(double value) {
+    test::TestStreamWriter stream;
+
+    char buf[16];
+    StreamWriter writer(stream, buf, sizeof(buf), StreamWriter::Encoding::Cbor);
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.number(value));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.flush());
+
+    return stream.data;
+}
+
+Bytes encode_cbor_string(const char* value) {
+    test::TestStreamWriter stream;
+
+    char buf[64];
+    StreamWriter writer(stream, buf, sizeof(buf), StreamWriter::Encoding::Cbor);
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.string(value));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.flush());
+
+    return stream.data;
+}
+
+void check_cbor_numbers(const std::vector<TestVector>& vectors) {
+    for (const auto& vector : vectors) {
+        const auto got = encode_cbor_number(vector.value);
+
+        TEST_ASSERT_EQUAL(vector.want.size(), got.size());
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(vector.want.data(), got.data(), got.size());
+    }
+}
+
+} // namespace
+
+TEST_CASE("Stream writer: JSON: escape strings", "[ocs_fmt], [stream_writer]") {
+    test::TestStreamWriter stream;
+
+    char buf[64];
+    StreamWriter writer(stream, buf, sizeof(buf));
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.begin_array());
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.string("plain"));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.string("say \"hi\""));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.string("C:\\dir"));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.string("\b\f\n\r\t"));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.string("\x01\x1f"));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.string("21.5\xc2\xb0"
+                                                           "C"));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.string(""));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.string(nullptr));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.end_array());
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.flush());
+
+    TEST_ASSERT_EQUAL_STRING("[\"plain\",\"say \\\"hi\\\"\",\"C:\\\\dir\","
+                             "\"\\b\\f\\n\\r\\t\",\"\\u0001\\u001f\","
+                             "\"21.5\xc2\xb0"
+                             "C\",\"\",\"\"]",
+                             stream.str().c_str());
+}
+
+TEST_CASE("Stream writer: JSON: escape keys", "[ocs_fmt], [stream_writer]") {
+    test::TestStreamWriter stream;
+
+    char buf[64];
+    StreamWriter writer(stream, buf, sizeof(buf));
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.begin_object());
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.add_bool("\"key\"\n", true));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.end_object());
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.flush());
+
+    TEST_ASSERT_EQUAL_STRING("{\"\\\"key\\\"\\n\":true}", stream.str().c_str());
+}
+
+TEST_CASE("Stream writer: JSON: numbers", "[ocs_fmt], [stream_writer]") {
+    test::TestStreamWriter stream;
+
+    char buf[128];
+    StreamWriter writer(stream, buf, sizeof(buf));
+
+    const double values[] = {
+        0,
+        42,
+        -7,
+        2147483647,
+        -2147483648.0,
+        3000000000.0,
+        21.5,
+        0.1,
+        -0.25,
+        1.0 / 3,
+        1e300,
+        NAN,
+        INFINITY,
+        -INFINITY,
+    };
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.begin_array());
+
+    for (const auto value : values) {
+        TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.number(value));
+    }
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.end_array());
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.flush());
+
+    // Same as cJSON_PrintUnformatted().
+    TEST_ASSERT_EQUAL_STRING("[0,42,-7,2147483647,-2147483648,3000000000,21.5,0.1,-0.25,"
+                             "0.33333333333333331,1e+300,null,null,null]",
+                             stream.str().c_str());
+}
+
+TEST_CASE("Stream writer: JSON: nested containers", "[ocs_fmt], [stream_writer]") {
+    test::TestStreamWriter stream;
+
+    char buf[128];
+    StreamWriter writer(stream, buf, sizeof(buf));
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.begin_object());
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.add_number("a", 1));
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.key("b"));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.begin_array());
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.number(1));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.begin_object());
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.end_object());
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.begin_array());
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.end_array());
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.null());
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.end_array());
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.key("c"));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.begin_object());
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.add_bool("d", false));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.key("e"));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.begin_object());
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.add_string("f", "x"));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.end_object());
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.add_number("g", 2));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.end_object());
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.end_object());
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.flush());
+
+    TEST_ASSERT_EQUAL_STRING("{\"a\":1,\"b\":[1,{},[],null],"
+                             "\"c\":{\"d\":false,\"e\":{\"f\":\"x\"},\"g\":2}}",
+                             stream.str().c_str());
+}
+
+TEST_CASE("Stream writer: JSON: cJSON values", "[ocs_fmt], [stream_writer]") {
+    test::TestStreamWriter stream;
+
+    char buf[128];
+    StreamWriter writer(stream, buf, sizeof(buf));
+
+    cJSON* json = cJSON_CreateObject();
+    TEST_ASSERT_NOT_NULL(json);
+
+    cJSON_AddNumberToObject(json, "a", 1);
+    cJSON* array = cJSON_AddArrayToObject(json, "b");
+    cJSON_AddItemToArray(array, cJSON_CreateString("x"));
+    cJSON_AddItemToArray(array, cJSON_CreateTrue());
+    cJSON_AddRawToObject(json, "c", "[1,2]");
+
+    char* expected = cJSON_PrintUnformatted(json);
+    TEST_ASSERT_NOT_NULL(expected);
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.value(json));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.flush());
+
+    TEST_ASSERT_EQUAL_STRING(expected, stream.str().c_str());
+
+    cJSON_free(expected);
+    cJSON_Delete(json);
+}
+
+TEST_CASE("Stream writer: JSON: invalid state is sticky", "[ocs_fmt], [stream_writer]") {
+    test::TestStreamWriter stream;
+
+    char buf[64];
+    StreamWriter writer(stream, buf, sizeof(buf));
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.begin_object());
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.add_number("a", 1));
+
+    // Object value without the key.
+    TEST_ASSERT_EQUAL(status::StatusCode::InvalidState, writer.number(2));
+    TEST_ASSERT_EQUAL(status::StatusCode::InvalidState, writer.code());
+
+    // Valid calls return the first error, and don't write anything.
+    TEST_ASSERT_EQUAL(status::StatusCode::InvalidState, writer.add_number("b", 2));
+    TEST_ASSERT_EQUAL(status::StatusCode::InvalidState, writer.end_object());
+    TEST_ASSERT_EQUAL(status::StatusCode::InvalidState, writer.flush());
+
+    TEST_ASSERT_EQUAL(0, writer.flushed());
+    TEST_ASSERT_EQUAL(0, stream.write_count);
+    TEST_ASSERT_TRUE(stream.data.empty());
+}
+
+TEST_CASE("Stream writer: JSON: mismatched containers", "[ocs_fmt], [stream_writer]") {
+    test::TestStreamWriter stream;
+
+    char buf[64];
+
+    {
+        StreamWriter writer(stream, buf, sizeof(buf));
+        TEST_ASSERT_EQUAL(status::StatusCode::InvalidState, writer.end_object());
+    }
+    {
+        StreamWriter writer(stream, buf, sizeof(buf));
+        TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.begin_array());
+        TEST_ASSERT_EQUAL(status::StatusCode::InvalidState, writer.end_object());
+    }
+    {
+        StreamWriter writer(stream, buf, sizeof(buf));
+        TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.begin_array());
+        TEST_ASSERT_EQUAL(status::StatusCode::InvalidState, writer.key("a"));
+    }
+    {
+        StreamWriter writer(stream, buf, sizeof(buf));
+        TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.begin_object());
+        TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.key("a"));
+        TEST_ASSERT_EQUAL(status::StatusCode::InvalidState, writer.end_object());
+    }
+    {
+        StreamWriter writer(stream, buf, sizeof(buf));
+
+        for (unsigned n = 0; n < StreamWriter::max_depth; ++n) {
+            TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.begin_array());
+        }
+
+        TEST_ASSERT_EQUAL(status::StatusCode::InvalidState, writer.begin_array());
+    }
+
+    TEST_ASSERT_EQUAL(0, stream.write_count);
+}
+
+TEST_CASE("Stream writer: JSON: write error is sticky", "[ocs_fmt], [stream_writer]") {
+    test::TestStreamWriter stream;
+    stream.code = status::StatusCode::Timeout;
+
+    char buf[4];
+    StreamWriter writer(stream, buf, sizeof(buf));
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.begin_object());
+
+    // The scratch buffer becomes full and is flushed to the failing stream.
+    TEST_ASSERT_EQUAL(status::StatusCode::Timeout, writer.add_string("key", "value"));
+    TEST_ASSERT_EQUAL(status::StatusCode::Timeout, writer.code());
+    TEST_ASSERT_EQUAL(1, stream.write_count);
+
+    // Stream is recovered, but the writer remembers the error.
+    stream.code = status::StatusCode::OK;
+
+    TEST_ASSERT_EQUAL(status::StatusCode::Timeout, writer.end_object());
+    TEST_ASSERT_EQUAL(status::StatusCode::Timeout, writer.flush());
+
+    TEST_ASSERT_EQUAL(0, writer.flushed());
+    TEST_ASSERT_EQUAL(1, stream.write_count);
+    TEST_ASSERT_TRUE(stream.data.empty());
+}
+
+TEST_CASE("Stream writer: JSON: data larger than buffer", "[ocs_fmt], [stream_writer]") {
+    test::TestStreamWriter stream;
+
+    char buf[5];
+    StreamWriter writer(stream, buf, sizeof(buf));
+
+    const std::string value(23, 'x');
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.begin_object());
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.add_string("key", value.c_str()));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.end_object());
+
+    // Only the full buffers are written, the rest is written on flush.
+    const std::string expected = "{\"key\":\"" + value + "\"}";
+
+    TEST_ASSERT_EQUAL(expected.size() / sizeof(buf) * sizeof(buf), writer.flushed());
+    TEST_ASSERT_EQUAL(writer.flushed(), stream.data.size());
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.flush());
+    TEST_ASSERT_EQUAL(expected.size(), writer.flushed());
+    TEST_ASSERT_EQUAL((expected.size() + sizeof(buf) - 1) / sizeof(buf),
+                      stream.write_count);
+
+    TEST_ASSERT_EQUAL_STRING(expected.c_str(), stream.str().c_str());
+
+    // Nothing to flush.
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.flush());
+    TEST_ASSERT_EQUAL((expected.size() + sizeof(buf) - 1) / sizeof(buf),
+                      stream.write_count);
+}
+
+TEST_CASE("Stream writer: JSON: stream overflow", "[ocs_fmt], [stream_writer]") {
+    test::TestStreamWriter stream(8);
+
+    char buf[4];
+    StreamWriter writer(stream, buf, sizeof(buf));
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.begin_object());
+    TEST_ASSERT_EQUAL(status::StatusCode::Error,
+                      writer.add_string("key", "long enough value"));
+    TEST_ASSERT_EQUAL(status::StatusCode::Error, writer.flush());
+
+    // Data written before the overflow is reported as flushed.
+    TEST_ASSERT_EQUAL(8, writer.flushed());
+    TEST_ASSERT_EQUAL_STRING("{\"key\":\"", stream.str().c_str());
+}
+
+// Test vectors are from RFC 8949, Appendix A.
+TEST_CASE("Stream writer: CBOR: unsigned integers", "[ocs_fmt], [stream_writer]") {
+    check_cbor_numbers({
+        { 0, { 0x00 } },
+        { 1, { 0x01 } },
+        { 10, { 0x0a } },
+        { 23, { 0x17 } },
+        { 24, { 0x18, 0x18 } },
+        { 25, { 0x18, 0x19 } },
+        { 100, { 0x18, 0x64 } },
+        { 255, { 0x18, 0xff } },
+        { 256, { 0x19, 0x01, 0x00 } },
+        { 1000, { 0x19, 0x03, 0xe8 } },
+        { 65535, { 0x19, 0xff, 0xff } },
+        { 65536, { 0x1a, 0x00, 0x01, 0x00, 0x00 } },
+        { 1000000, { 0x1a, 0x00, 0x0f, 0x42, 0x40 } },
+        { 4294967295.0, { 0x1a, 0xff, 0xff, 0xff, 0xff } },
+        { 4294967296.0, { 0x1b, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00 } },
+        { 1000000000000.0, { 0x1b, 0x00, 0x00, 0x00, 0xe8, 0xd4, 0xa5, 0x10, 0x00 } },
+    });
+}
+
+TEST_CASE("Stream writer: CBOR: negative integers", "[ocs_fmt], [stream_writer]") {
+    check_cbor_numbers({
+        { -1, { 0x20 } },
+        { -10, { 0x29 } },
+        { -24, { 0x37 } },
+        { -25, { 0x38, 0x18 } },
+        { -100, { 0x38, 0x63 } },
+        { -256, { 0x38, 0xff } },
+        { -257, { 0x39, 0x01, 0x00 } },
+        { -1000, { 0x39, 0x03, 0xe7 } },
+        { -65536, { 0x39, 0xff, 0xff } },
+        { -65537, { 0x3a, 0x00, 0x01, 0x00, 0x00 } },
+        { -4294967296.0, { 0x3a, 0xff, 0xff, 0xff, 0xff } },
+        { -4294967297.0, { 0x3b, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00 } },
+    });
+}
+
+TEST_CASE("Stream writer: CBOR: floats", "[ocs_fmt], [stream_writer]") {
+    check_cbor_numbers({
+        // Exactly representable as float32.
+        { 0.5, { 0xfa, 0x3f, 0x00, 0x00, 0x00 } },
+        { 1.5, { 0xfa, 0x3f, 0xc0, 0x00, 0x00 } },
+        { 21.5, { 0xfa, 0x41, 0xac, 0x00, 0x00 } },
+        { -0.25, { 0xfa, 0xbe, 0x80, 0x00, 0x00 } },
+        { 5.960464477539063e-8, { 0xfa, 0x33, 0x80, 0x00, 0x00 } },
+        { 3.4028234663852886e+38, { 0xfa, 0x7f, 0x7f, 0xff, 0xff } },
+
+        // Require float64.
+        { 0.1, { 0xfb, 0x3f, 0xb9, 0x99, 0x99, 0x99, 0x99, 0x99, 0x9a } },
+        { 1.1, { 0xfb, 0x3f, 0xf1, 0x99, 0x99, 0x99, 0x99, 0x99, 0x9a } },
+        { -4.1, { 0xfb, 0xc0, 0x10, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66 } },
+        { 1.0e+300, { 0xfb, 0x7e, 0x37, 0xe4, 0x3c, 0x88, 0x00, 0x75, 0x9c } },
+
+        // Same as JSON, non-finite numbers are encoded as null.
+        { NAN, { 0xf6 } },
+        { INFINITY, { 0xf6 } },
+        { -INFINITY, { 0xf6 } },
+    });
+}
+
+TEST_CASE("Stream writer: CBOR: text strings", "[ocs_fmt], [stream_writer]") {
+    const std::vector<std::pair<const char*, Bytes>> vectors = {
+        { "", { 0x60 } },
+        { nullptr, { 0x60 } },
+        { "a", { 0x61, 0x61 } },
+        { "IETF", { 0x64, 0x49, 0x45, 0x54, 0x46 } },
+        { "\"\\", { 0x62, 0x22, 0x5c } },
+        { "\xc3\xbc", { 0x62, 0xc3, 0xbc } },
+        { "\xe6\xb0\xb4", { 0x63, 0xe6, 0xb0, 0xb4 } },
+    };
+
+    for (const auto& [value, want] : vectors) {
+        const auto got = encode_cbor_string(value);
+
+        TEST_ASSERT_EQUAL(want.size(), got.size());
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(want.data(), got.data(), got.size());
+    }
+}
+
+TEST_CASE("Stream writer: CBOR: text string length", "[ocs_fmt], [stream_writer]") {
+    const std::vector<std::pair<unsigned, Bytes>> vectors = {
+        { 23, { 0x77 } },
+        { 24, { 0x78, 0x18 } },
+        { 255, { 0x78, 0xff } },
+        { 256, { 0x79, 0x01, 0x00 } },
+        { 65535, { 0x79, 0xff, 0xff } },
+        { 65536, { 0x7a, 0x00, 0x01, 0x00, 0x00 } },
+    };
+
+    for (const auto& [len, head] : vectors) {
+        const std::string value(len, 'x');
+        const auto got = encode_cbor_string(value.c_str());
+
+        TEST_ASSERT_EQUAL(head.size() + len, got.size());
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(head.data(), got.data(), head.size());
+        TEST_ASSERT_EQUAL('x', got.back());
+    }
+}
+
+TEST_CASE("Stream writer: CBOR: indefinite-length containers",
+          "[ocs_fmt], [stream_writer]") {
+    test::TestStreamWriter stream;
+
+    char buf[8];
+    StreamWriter writer(stream, buf, sizeof(buf), StreamWriter::Encoding::Cbor);
+
+    // {_ "a": 1, "b": [_ 2, 3], "c": {_ }, "d": [_ ], "e": true, "f": false, "g": null}
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.begin_object());
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.add_number("a", 1));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.key("b"));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.begin_array());
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.number(2));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.number(3));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.end_array());
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.key("c"));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.begin_object());
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.end_object());
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.key("d"));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.begin_array());
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.end_array());
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.add_bool("e", true));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.add_bool("f", false));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.key("g"));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.null());
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.end_object());
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.flush());
+
+    const Bytes want = {
+        0xbf, 0x61, 0x61, 0x01, 0x61, 0x62, 0x9f, 0x02, 0x03, 0xff, 0x61, 0x63, 0xbf,
+        0xff, 0x61, 0x64, 0x9f, 0xff, 0x61, 0x65, 0xf5, 0x61, 0x66, 0xf4, 0x61, 0x67,
+        0xf6, 0xff,
+    };
+
+    TEST_ASSERT_EQUAL(want.size(), stream.data.size());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(want.data(), stream.data.data(), want.size());
+}
+
+TEST_CASE("Stream writer: CBOR: cJSON values", "[ocs_fmt], [stream_writer]") {
+    test::TestStreamWriter stream;
+
+    char buf[64];
+    StreamWriter writer(stream, buf, sizeof(buf), StreamWriter::Encoding::Cbor);
+
+    cJSON* json = cJSON_CreateObject();
+    TEST_ASSERT_NOT_NULL(json);
+
+    // {_ "Fun": true, "Amt": -2}
+    cJSON_AddItemToObject(json, "Fun", cJSON_CreateTrue());
+    cJSON_AddNumberToObject(json, "Amt", -2);
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.value(json));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, writer.flush());
+
+    const Bytes want = {
+        0xbf, 0x63, 0x46, 0x75, 0x6e, 0xf5, 0x63, 0x41, 0x6d, 0x74, 0x21, 0xff,
+    };
+
+    TEST_ASSERT_EQUAL(want.size(), stream.data.size());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(want.data(), stream.data.data(), want.size());
+
+    // Raw JSON can't be encoded as CBOR.
+    cJSON_AddRawToObject(json, "raw", "[1]");
+
+    StreamWriter raw_writer(stream, buf, sizeof(buf), StreamWriter::Encoding::Cbor);
+    TEST_ASSERT_EQUAL(status::StatusCode::InvalidArg, raw_writer.value(json));
+
+    cJSON_Delete(json);
+}
+
+} // namespace json
+} // namespace fmt
+} // namespace ocs
@@ -35,7 +35,20 @@ status::StatusCode ChunkStreamWriter::end() {
 }
 
 status::StatusCode ChunkStreamWriter::cancel() {
-    return end();
+    if (!sent_ || closed_) {
+        return status::StatusCode::OK;
+    }
+
+    const auto err = httpd_sess_trigger_close(req_->handle, httpd_req_to_sockfd(req_));
+    if (err != ESP_OK) {
+        ocs_loge(log_tag, "httpd_sess_trigger_close(): %s", esp_err_to_name(err));
+
+        return status::StatusCode::Error;
+    }
+
+    closed_ = true;
+
+    return status::StatusCode::OK;
 }
 
 status::StatusCode ChunkStreamWriter::write(const void* data, unsigned size) {
@@ -43,6 +56,9 @@ status::StatusCode ChunkStreamWriter::write(const void* data, unsigned size) {
 }
 
 status::StatusCode ChunkStreamWriter::send_(const void* data, unsigned size) {
+    // Headers can be sent even if the chunk isn't.
+    sent_ = true;
+
     const auto err = httpd_resp_send_chunk(req_, static_cast<const char*>(data), size);
     if (err != ESP_OK) {
         ocs_loge(log_tag, "httpd_resp_send_chunk(): %s", esp_err_to_name(err));
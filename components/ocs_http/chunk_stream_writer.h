@@ -29,6 +29,11 @@ public:
     status::StatusCode end() override;
 
     //! Cancel stream writing.
+    //!
+    //! @remarks
+    //!  If nothing has been sent yet, the handler can still send the error response.
+    //!  Otherwise the connection is closed without the terminating chunk, so the client
+    //!  doesn't take the truncated response as complete.
     status::StatusCode cancel() override;
 
     //! Write @p size bytes of @p data.
@@ -38,6 +43,9 @@ private:
     status::StatusCode send_(const void* data, unsigned size);
 
     httpd_req_t* req_ { nullptr };
+
+    bool sent_ { false };
+    bool closed_ { false };
 };
 
 } // namespace http
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <algorithm>
+
+#include "ocs_core/lock_guard.h"
+#include "ocs_http/route_profiler.h"
+
+namespace ocs {
+namespace http {
+
+RouteProfiler::RouteProfiler(const char* path)
+    : path_(path) {
+}
+
+const char* RouteProfiler::path() const {
+    return path_.c_str();
+}
+
+void RouteProfiler::begin() {
+    core::LockGuard lock(mu_);
+
+    ++profile_.request_count;
+    ++profile_.in_flight;
+
+    status_ = 0;
+}
+
+void RouteProfiler::end(core::Time duration, status::StatusCode code) {
+    duration = std::max<core::Time>(duration, 0);
+
+    core::LockGuard lock(mu_);
+
+    if (profile_.in_flight) {
+        --profile_.in_flight;
+    }
+
+    int http_status = status_;
+
+    if (!http_status) {
+        switch (code) {
+        case status::StatusCode::OK:
+            http_status = 200;
+            break;
+
+        case status::StatusCode::InvalidArg:
+            http_status = 400;
+            break;
+
+        default:
+            http_status = 500;
+            break;
+        }
+    } else if (code != status::StatusCode::OK && http_status < 400) {
+        // Response is aborted after the successful status was sent.
+        http_status = 500;
+    }
+
+    if (http_status < 300) {
+        ++profile_.status_2xx;
+    } else if (http_status < 400) {
+        ++profile_.status_3xx;
+    } else if (http_status < 500) {
+        ++profile_.status_4xx;
+    } else {
+        ++profile_.status_5xx;
+    }
+
+    profile_.time_last = duration;
+    profile_.time_max = std::max(profile_.time_max, duration);
+
+    ++profile_.histogram[get_bucket_(duration)];
+}
+
+void RouteProfiler::record_status(int status) {
+    core::LockGuard lock(mu_);
+
+    if (!status_) {
+        status_ = status;
+    }
+}
+
+void RouteProfiler::record_send(int size) {
+    core::LockGuard lock(mu_);
+
+    if (size < 0) {
+        ++profile_.send_failure_count;
+    } else {
+        profile_.bytes_sent += size;
+    }
+}
+
+RouteProfiler::Profile RouteProfiler::get() const {
+    core::LockGuard lock(mu_);
+
+    return profile_;
+}
+
+unsigned RouteProfiler::get_bucket_(core::Time duration) {
+    unsigned bucket = 0;
+
+    while (duration > 1 && bucket < histogram_size - 1) {
+        duration >>= 1;
+        ++bucket;
+    }
+
+    return bucket;
+}
+
+} // namespace http
+} // namespace ocs
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include "ocs_core/noncopyable.h"
+#include "ocs_core/static_mutex.h"
+#include "ocs_core/time.h"
+#include "ocs_status/code.h"
+
+namespace ocs {
+namespace http {
+
+//! Collect statistics of the requests handled by a single route.
+//!
+//! @remarks
+//!  Statistics are recorded by the HTTP server task and can be read from any FreeRTOS
+//!  task. Recording doesn't allocate memory.
+class RouteProfiler : public core::NonCopyable<> {
+public:
+    //! Number of buckets in the handler latency histogram.
+    static constexpr unsigned histogram_size = 20;
+
+    //! All durations are in microseconds.
+    struct Profile {
+        //! Number of received requests.
+        uint32_t request_count { 0 };
+
+        //! Number of requests being handled.
+        uint32_t in_flight { 0 };
+
+        //! Number of requests answered with 2xx status.
+        uint32_t status_2xx { 0 };
+
+        //! Number of requests answered with 3xx status, e.g. 304 Not Modified.
+        uint32_t status_3xx { 0 };
+
+        //! Number of requests answered with 4xx status, e.g. rejected as invalid, or
+        //! sent to the unknown route.
+        uint32_t status_4xx { 0 };
+
+        //! Number of requests answered with 5xx status, or failed after the status was
+        //! sent, including the failures to send the response.
+        uint32_t status_5xx { 0 };
+
+        //! Number of failed socket writes.
+        uint32_t send_failure_count { 0 };
+
+        //! Number of bytes written to the socket, including headers.
+        uint32_t bytes_sent { 0 };
+
+        core::Time time_last { 0 };
+        core::Time time_max { 0 };
+
+        //! Bucket N counts requests that took [2^N, 2^(N+1)) microseconds. The first
+        //! bucket also counts instant requests, the last bucket also counts all longer
+        //! requests.
+        std::array<uint32_t, histogram_size> histogram {};
+    };
+
+    //! Initialize.
+    //!
+    //! @params
+    //!  - @p path - route path pattern.
+    explicit RouteProfiler(const char* path);
+
+    //! Return route path pattern.
+    const char* path() const;
+
+    //! Record the start of the request handling.
+    void begin();
+
+    //! Record the end of the request handling.
+    //!
+    //! @params
+    //!  - @p duration - how long the request was handled.
+    //!  - @p code - handler result.
+    //!
+    //! @remarks
+    //!  The request is counted by the recorded HTTP status. If no status is recorded,
+    //!  it's derived from @p code in the same way as the server does it.
+    void end(core::Time duration, status::StatusCode code);
+
+    //! Record the HTTP status of the response, e.g. 200.
+    //!
+    //! @remarks
+    //!  Only the first status of the request is recorded.
+    void record_status(int status);
+
+    //! Record the socket write.
+    //!
+    //! @params
+    //!  - @p size - number of bytes written, negative if the write has failed.
+    void record_send(int size);
+
+    //! Return the recorded statistics.
+    Profile get() const;
+
+private:
+    static unsigned get_bucket_(core::Time duration);
+
+    const std::string path_;
+
+    mutable core::StaticMutex mu_;
+
+    Profile profile_;
+
+    //! HTTP status of the request being handled, the requests are handled one at a time.
+    int status_ { 0 };
+};
+
+} // namespace http
+} // namespace ocs
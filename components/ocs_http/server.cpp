@@ -6,7 +6,12 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 
+#include <cerrno>
 #include <cstring>
+#include <sys/socket.h>
+
+#include "esp_timer.h"
+#include "freertos/FreeRTOSConfig.h"
 
 #include "ocs_algo/uri_ops.h"
 #include "ocs_core/log.h"
@@ -20,6 +25,9 @@ namespace {
 
 const char* log_tag = "http_server";
 
+//! Profiler of the request being handled by the HTTP server task.
+thread_local RouteProfiler* current_profiler = nullptr;
+
 httpd_err_code_t status_code_to_http_code(status::StatusCode code) {
     switch (code) {
     case status::StatusCode::InvalidArg:
@@ -32,6 +40,29 @@ httpd_err_code_t status_code_to_http_code(status::StatusCode code) {
     return HTTPD_500_INTERNAL_SERVER_ERROR;
 }
 
+//! Return the status code of the HTTP status line at the beginning of @p buf, zero if
+//! there is no status line.
+int parse_status_line(const char* buf, size_t len) {
+    const char* prefix = "HTTP/1.1 ";
+    const size_t prefix_len = strlen(prefix);
+
+    if (len < prefix_len + 3 || memcmp(buf, prefix, prefix_len)) {
+        return 0;
+    }
+
+    int status = 0;
+
+    for (size_t n = prefix_len; n < prefix_len + 3; ++n) {
+        if (buf[n] < '0' || buf[n] > '9') {
+            return 0;
+        }
+
+        status = status * 10 + (buf[n] - '0');
+    }
+
+    return status;
+}
+
 } // namespace
 
 Server::Server(const Params& params) {
@@ -39,6 +70,12 @@ Server::Server(const Params& params) {
     config_.server_port = params.server_port;
     config_.max_uri_handlers = params.max_uri_handlers;
     config_.uri_match_fn = httpd_uri_match_wildcard;
+    config_.open_fn = handle_open_;
+
+    unknown_route_profiler_.reset(new (std::nothrow) RouteProfiler("unknown"));
+    configASSERT(unknown_route_profiler_);
+
+    profilers_.push_back(unknown_route_profiler_.get());
 }
 
 Server::~Server() {
@@ -48,10 +85,30 @@ Server::~Server() {
 }
 
 void Server::add_GET(const char* path, Server::HandlerFunc func) {
-    endpoints_get_.push_back(std::make_pair(path, func));
+    add_GET(path, [func](httpd_req_t* req, const PathParams&) {
+        return func(req);
+    });
+}
+
+void Server::add_GET(const char* path, Server::RouteFunc func) {
+    std::unique_ptr<RouteProfiler> profiler(new (std::nothrow) RouteProfiler(path));
+    configASSERT(profiler);
+
+    // Profiler of the unknown routes is kept last.
+    profilers_.insert(profilers_.end() - 1, profiler.get());
+
+    endpoints_get_.push_back(Endpoint { path, func, std::move(profiler) });
+}
+
+const Server::ProfilerList& Server::profilers() const {
+    return profilers_;
 }
 
 status::StatusCode Server::start() {
+    if (const auto code = build_router_(); code != status::StatusCode::OK) {
+        return code;
+    }
+
     const auto err = httpd_start(&handle_, &config_);
     if (err != ESP_OK) {
         ocs_loge(log_tag, "httpd_start(): %s", esp_err_to_name(err));
@@ -61,19 +118,45 @@ status::StatusCode Server::start() {
     return register_uris_();
 }
 
-status::StatusCode Server::register_uris_() {
-    for (const auto& [path, _] : endpoints_get_) {
-        httpd_uri_t uri;
-        memset(&uri, 0, sizeof(uri));
+status::StatusCode Server::build_router_() {
+    std::unique_ptr<algo::UriRouter> router(new (std::nothrow) algo::UriRouter());
+    if (!router) {
+        return status::StatusCode::NoMem;
+    }
+
+    for (unsigned n = 0; n < endpoints_get_.size(); ++n) {
+        const auto& path = endpoints_get_[n].path;
+
+        const auto code = router->add(path.c_str(), n);
+        if (code != status::StatusCode::OK) {
+            ocs_loge(log_tag, "failed to add route: path=%s code=%s", path.c_str(),
+                     status::code_to_str(code));
+
+            return code;
+        }
+    }
+
+    router_get_ = std::move(router);
 
-        uri.method = HTTP_GET;
-        uri.handler = handle_request_;
-        uri.user_ctx = this;
-        uri.uri = path.c_str();
+    return status::StatusCode::OK;
+}
 
-        ESP_ERROR_CHECK(httpd_register_uri_handler(handle_, &uri));
+status::StatusCode Server::register_uris_() {
+    if (endpoints_get_.empty()) {
+        return status::StatusCode::OK;
     }
 
+    // All GET requests are dispatched by the router.
+    httpd_uri_t uri;
+    memset(&uri, 0, sizeof(uri));
+
+    uri.method = HTTP_GET;
+    uri.handler = handle_request_;
+    uri.user_ctx = this;
+    uri.uri = "/*";
+
+    ESP_ERROR_CHECK(httpd_register_uri_handler(handle_, &uri));
+
     return status::StatusCode::OK;
 }
 
@@ -93,34 +176,61 @@ esp_err_t Server::handle_request_(httpd_req_t* req) {
     return ESP_OK;
 }
 
-void Server::handle_request_get_(httpd_req_t* req) {
-    const auto path = algo::UriOps::parse_path(req->uri);
+esp_err_t Server::handle_open_(httpd_handle_t handle, int sockfd) {
+    return httpd_sess_set_send_override(handle, sockfd, handle_send_);
+}
 
-    const auto endpoint =
-        std::find_if(endpoints_get_.begin(), endpoints_get_.end(),
-                     [&path, this](const auto& endpoint) {
-                         if (config_.uri_match_fn) {
-                             return config_.uri_match_fn(endpoint.first.c_str(),
-                                                         path.data(), path.size());
-                         }
-
-                         return endpoint.first == path;
-                     });
-    if (endpoint == endpoints_get_.end()) {
-        ocs_loge(log_tag, "unknown URI: %s", req->uri);
-
-        const auto ret = httpd_resp_send_err(
-            req, status_code_to_http_code(status::StatusCode::InvalidArg),
-            status::code_to_str(status::StatusCode::InvalidArg));
-        if (ret != ESP_OK) {
-            ocs_loge(log_tag, "httpd_resp_send_err(): URI=%s err=%s", req->uri,
-                     esp_err_to_name(ret));
+int Server::handle_send_(httpd_handle_t handle,
+                         int sockfd,
+                         const char* buf,
+                         size_t len,
+                         int flags) {
+    if (!buf) {
+        return HTTPD_SOCK_ERR_INVALID;
+    }
+
+    const int ret = send(sockfd, buf, len, flags);
+
+    if (current_profiler) {
+        // The status line starts the response headers, which are sent at once.
+        if (ret > 0) {
+            if (const int http_status = parse_status_line(buf, len); http_status) {
+                current_profiler->record_status(http_status);
+            }
         }
 
-        return;
+        current_profiler->record_send(ret);
     }
 
-    const auto code = endpoint->second(req);
+    if (ret >= 0) {
+        return ret;
+    }
+
+    // Same error mapping as the default send function of the HTTP server.
+    switch (errno) {
+    case EAGAIN:
+    case EINTR:
+        return HTTPD_SOCK_ERR_TIMEOUT;
+
+    case EINVAL:
+    case EBADF:
+    case EFAULT:
+    case ENOTSOCK:
+        return HTTPD_SOCK_ERR_INVALID;
+
+    default:
+        break;
+    }
+
+    return HTTPD_SOCK_ERR_FAIL;
+}
+
+void Server::handle_request_get_(httpd_req_t* req) {
+    const auto start_ts = esp_timer_get_time();
+
+    RouteProfiler* profiler = nullptr;
+
+    const auto code = handle_route_get_(req, profiler);
     if (code != status::StatusCode::OK) {
         ocs_loge(log_tag, "failed to handle request: URI=%s code=%s", req->uri,
                  status::code_to_str(code));
@@ -132,6 +242,36 @@ void Server::handle_request_get_(httpd_req_t* req) {
                      esp_err_to_name(ret));
         }
     }
+
+    current_profiler = nullptr;
+
+    profiler->end(esp_timer_get_time() - start_ts, code);
+}
+
+status::StatusCode Server::handle_route_get_(httpd_req_t* req,
+                                             RouteProfiler*& profiler) {
+    const auto path = algo::UriOps::parse_path(req->uri);
+
+    unsigned id = 0;
+    PathParams params;
+
+    if (!router_get_->match(path, id, params)) {
+        profiler = unknown_route_profiler_.get();
+        profiler->begin();
+
+        current_profiler = profiler;
+
+        return status::StatusCode::InvalidArg;
+    }
+
+    auto& endpoint = endpoints_get_[id];
+
+    profiler = endpoint.profiler.get();
+    profiler->begin();
+
+    current_profiler = profiler;
+
+    return endpoint.func(req, params);
 }
 
 } // namespace http
@@ -9,27 +9,50 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "esp_http_server.h"
 
+#include "ocs_algo/uri_router.h"
 #include "ocs_core/noncopyable.h"
+#include "ocs_http/route_profiler.h"
 #include "ocs_status/code.h"
 
 namespace ocs {
 namespace http {
 
+//! HTTP server dispatching requests through the compiled URI router.
+//!
+//! @notes
+//!  Each route is instrumented with RouteProfiler. Bytes sent are counted for the
+//!  responses written by the HTTP server task, responses written by the detached
+//!  requests from other tasks aren't counted.
 class Server : public core::NonCopyable<> {
 public:
+    //! Profilers of all routes.
+    using ProfilerList = std::vector<const RouteProfiler*>;
+
     //! Handler to process an HTTP request.
     using HandlerFunc = std::function<status::StatusCode(httpd_req_t* req)>;
 
+    //! Path parameters of the matched route.
+    using PathParams = algo::UriRouter::Params;
+
+    //! Handler to process an HTTP request with path parameters.
+    using RouteFunc =
+        std::function<status::StatusCode(httpd_req_t* req, const PathParams& params)>;
+
     struct Params {
         //! TCP port to accept incoming connections.
         unsigned server_port { 80 };
 
         //! Maximum allowed URI handlers.
+        //!
+        //! @remarks
+        //!  Requests are dispatched by the internal router, so only one URI handler per
+        //!  HTTP method is registered.
         unsigned max_uri_handlers { 32 };
     };
 
@@ -40,6 +63,9 @@ public:
     ~Server();
 
     //! Start HTTP server.
+    //!
+    //! @remarks
+    //!  Registered paths are compiled into the router.
     status::StatusCode start();
 
     //! Stop HTTP server.
@@ -49,22 +75,50 @@ public:
     status::StatusCode stop();
 
     //! Register HTTP handler for a GET request.
+    //!
+    //! @remarks
+    //!  See algo::UriRouter for the supported @p path patterns.
     void add_GET(const char* path, HandlerFunc func);
 
+    //! Register HTTP handler for a GET request with path parameters, e.g.
+    //! "/api/v1/sensor/{sensor_id}/read".
+    void add_GET(const char* path, RouteFunc func);
+
+    //! Return profilers of all routes, the last profiler counts requests to the unknown
+    //! routes.
+    const ProfilerList& profilers() const;
+
 private:
-    using Endpoint = std::pair<std::string, HandlerFunc>;
+    struct Endpoint {
+        std::string path;
+        RouteFunc func;
+        std::unique_ptr<RouteProfiler> profiler;
+    };
+
     using EndpointList = std::vector<Endpoint>;
 
     static esp_err_t handle_request_(httpd_req_t* req);
-
+    static esp_err_t handle_open_(httpd_handle_t handle, int sockfd);
+    static int handle_send_(httpd_handle_t handle,
+                            int sockfd,
+                            const char* buf,
+                            size_t len,
+                            int flags);
+
+    status::StatusCode build_router_();
     status::StatusCode register_uris_();
 
     void handle_request_get_(httpd_req_t* req);
+    status::StatusCode handle_route_get_(httpd_req_t* req, RouteProfiler*& profiler);
 
     httpd_handle_t handle_ { nullptr };
     httpd_config_t config_;
 
     EndpointList endpoints_get_;
+    std::unique_ptr<algo::UriRouter> router_get_;
+
+    std::unique_ptr<RouteProfiler> unknown_route_profiler_;
+    ProfilerList profilers_;
 };
 
 } // namespace http
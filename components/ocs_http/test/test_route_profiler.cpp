@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "unity.h"
+
+#include "ocs_http/route_profiler.h"
+
+namespace ocs {
+namespace http {
+
+TEST_CASE("Route profiler: no requests", "[ocs_http], [route_profiler]") {
+    RouteProfiler profiler("/api/v1/telemetry");
+
+    TEST_ASSERT_EQUAL_STRING("/api/v1/telemetry", profiler.path());
+
+    const auto profile = profiler.get();
+    TEST_ASSERT_EQUAL(0, profile.request_count);
+    TEST_ASSERT_EQUAL(0, profile.in_flight);
+    TEST_ASSERT_EQUAL(0, profile.bytes_sent);
+    TEST_ASSERT_EQUAL_INT64(0, profile.time_max);
+
+    for (const auto& count : profile.histogram) {
+        TEST_ASSERT_EQUAL(0, count);
+    }
+}
+
+TEST_CASE("Route profiler: status classes", "[ocs_http], [route_profiler]") {
+    RouteProfiler profiler("/api/v1/telemetry");
+
+    profiler.begin();
+    TEST_ASSERT_EQUAL(1, profiler.get().in_flight);
+
+    profiler.end(10, status::StatusCode::OK);
+    TEST_ASSERT_EQUAL(0, profiler.get().in_flight);
+
+    profiler.begin();
+    profiler.end(30, status::StatusCode::InvalidArg);
+
+    profiler.begin();
+    profiler.end(20, status::StatusCode::NoMem);
+
+    profiler.begin();
+    profiler.end(20, status::StatusCode::Error);
+
+    const auto profile = profiler.get();
+    TEST_ASSERT_EQUAL(4, profile.request_count);
+    TEST_ASSERT_EQUAL(0, profile.in_flight);
+    TEST_ASSERT_EQUAL(1, profile.status_2xx);
+    TEST_ASSERT_EQUAL(0, profile.status_3xx);
+    TEST_ASSERT_EQUAL(1, profile.status_4xx);
+    TEST_ASSERT_EQUAL(2, profile.status_5xx);
+    TEST_ASSERT_EQUAL_INT64(20, profile.time_last);
+    TEST_ASSERT_EQUAL_INT64(30, profile.time_max);
+}
+
+TEST_CASE("Route profiler: status sent", "[ocs_http], [route_profiler]") {
+    RouteProfiler profiler("/api/v1/telemetry");
+
+    profiler.begin();
+    profiler.record_status(200);
+    profiler.end(10, status::StatusCode::OK);
+
+    // Not modified.
+    profiler.begin();
+    profiler.record_status(304);
+    profiler.end(10, status::StatusCode::OK);
+
+    // Error is sent by the handler itself.
+    profiler.begin();
+    profiler.record_status(404);
+    profiler.end(10, status::StatusCode::OK);
+
+    profiler.begin();
+    profiler.record_status(503);
+    profiler.end(10, status::StatusCode::OK);
+
+    // Only the first status is recorded.
+    profiler.begin();
+    profiler.record_status(400);
+    profiler.record_status(500);
+    profiler.end(10, status::StatusCode::InvalidArg);
+
+    // Response is aborted after the status was sent.
+    profiler.begin();
+    profiler.record_status(200);
+    profiler.end(10, status::StatusCode::Error);
+
+    // Status isn't carried over to the next request.
+    profiler.begin();
+    profiler.end(10, status::StatusCode::OK);
+
+    const auto profile = profiler.get();
+    TEST_ASSERT_EQUAL(7, profile.request_count);
+    TEST_ASSERT_EQUAL(2, profile.status_2xx);
+    TEST_ASSERT_EQUAL(1, profile.status_3xx);
+    TEST_ASSERT_EQUAL(2, profile.status_4xx);
+    TEST_ASSERT_EQUAL(2, profile.status_5xx);
+}
+
+TEST_CASE("Route profiler: histogram", "[ocs_http], [route_profiler]") {
+    RouteProfiler profiler("/api/v1/telemetry");
+
+    // [0, 2) microseconds.
+    profiler.begin();
+    profiler.end(0, status::StatusCode::OK);
+    profiler.begin();
+    profiler.end(1, status::StatusCode::OK);
+
+    // [1024, 2048) microseconds.
+    profiler.begin();
+    profiler.end(1500, status::StatusCode::OK);
+
+    // Longer than the last bucket.
+    profiler.begin();
+    profiler.end(core::Duration::hour, status::StatusCode::OK);
+
+    const auto profile = profiler.get();
+    TEST_ASSERT_EQUAL(2, profile.histogram[0]);
+    TEST_ASSERT_EQUAL(1, profile.histogram[10]);
+    TEST_ASSERT_EQUAL(1, profile.histogram[RouteProfiler::histogram_size - 1]);
+}
+
+TEST_CASE("Route profiler: bytes sent", "[ocs_http], [route_profiler]") {
+    RouteProfiler profiler("/api/v1/telemetry");
+
+    profiler.record_send(100);
+    profiler.record_send(0);
+    profiler.record_send(-1);
+    profiler.record_send(28);
+
+    const auto profile = profiler.get();
+    TEST_ASSERT_EQUAL(128, profile.bytes_sent);
+    TEST_ASSERT_EQUAL(1, profile.send_failure_count);
+}
+
+} // namespace http
+} // namespace ocs
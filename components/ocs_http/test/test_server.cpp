@@ -9,6 +9,7 @@
 #include <algorithm>
 #include <cstring>
 #include <string>
+#include <utility>
 
 #include "unity.h"
 
@@ -222,6 +223,94 @@ TEST_CASE("Start HTTP server: chunked response", "[ocs_http], [server]") {
     TEST_ASSERT_EQUAL(status::StatusCode::OK, server.stop());
     TEST_ASSERT_EQUAL(status::StatusCode::OK, network.stop());
 }
+
+TEST_CASE("Start HTTP server: count responses by status", "[ocs_http], [server]") {
+    Server server(Server::Params {
+        .server_port = 80,
+    });
+
+    server.add_GET("/cached", [](httpd_req_t* req) {
+        auto err = httpd_resp_set_status(req, "304 Not Modified");
+        if (err == ESP_OK) {
+            err = httpd_resp_send(req, nullptr, 0);
+        }
+        if (err != ESP_OK) {
+            return status::StatusCode::Error;
+        }
+
+        return status::StatusCode::OK;
+    });
+
+    // Handler sends the error itself, and reports the success.
+    server.add_GET("/missing", [](httpd_req_t* req) {
+        if (httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, nullptr) != ESP_OK) {
+            return status::StatusCode::Error;
+        }
+
+        return status::StatusCode::OK;
+    });
+
+    storage::FlashInitializer flash_initializer;
+    net::FanoutNetworkHandler handler;
+
+    net::StaNetwork network(handler,
+                            net::StaNetwork::Params {
+                                .max_retry_count = 1,
+                                .ssid = CONFIG_OCS_TEST_UNIT_WIFI_STA_SSID,
+                                .password = CONFIG_OCS_TEST_UNIT_WIFI_STA_PASSWORD,
+                            });
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, network.start());
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, network.wait());
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, server.start());
+
+    const auto info = network.get_info();
+
+    net::ip_addr_to_str ip_addr_str(info.ip_addr);
+
+    const std::pair<const char*, int> requests[] = {
+        { "/cached", 304 },
+        { "/missing", 404 },
+        { "/unknown", 400 },
+    };
+
+    for (const auto& [path, want_status] : requests) {
+        ClientReader reader(ClientReader::Params {
+            .host = ip_addr_str.c_str(),
+            .path = path,
+        });
+        TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_perform(reader.client()));
+        TEST_ASSERT_EQUAL(want_status, esp_http_client_get_status_code(reader.client()));
+    }
+
+    const auto find_profile = [&server](const char* path) {
+        const auto& profilers = server.profilers();
+
+        const auto it = std::find_if(profilers.begin(), profilers.end(),
+                                     [path](const RouteProfiler* profiler) {
+                                         return !strcmp(profiler->path(), path);
+                                     });
+        TEST_ASSERT_TRUE(it != profilers.end());
+
+        return (*it)->get();
+    };
+
+    const auto cached = find_profile("/cached");
+    TEST_ASSERT_EQUAL(1, cached.request_count);
+    TEST_ASSERT_EQUAL(0, cached.status_2xx);
+    TEST_ASSERT_EQUAL(1, cached.status_3xx);
+
+    const auto missing = find_profile("/missing");
+    TEST_ASSERT_EQUAL(1, missing.request_count);
+    TEST_ASSERT_EQUAL(0, missing.status_2xx);
+    TEST_ASSERT_EQUAL(1, missing.status_4xx);
+
+    const auto unknown = find_profile("unknown");
+    TEST_ASSERT_EQUAL(1, unknown.request_count);
+    TEST_ASSERT_EQUAL(1, unknown.status_4xx);
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, server.stop());
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, network.stop());
+}
 #endif // CONFIG_OCS_TEST_UNIT_WIFI_STA_ENABLED
 
 } // namespace http
@@ -9,8 +9,11 @@
 #include "freertos/FreeRTOSConfig.h"
 
 #include "ocs_pipeline/basic/system_pipeline.h"
+#include "ocs_scheduler/adaptive_delay_estimator.h"
 #include "ocs_scheduler/async_func.h"
 #include "ocs_scheduler/constant_delay_estimator.h"
+#include "ocs_scheduler/deadline_task_scheduler.h"
+#include "ocs_scheduler/multicore_task_scheduler.h"
 #include "ocs_scheduler/periodic_task_scheduler.h"
 #include "ocs_status/code_to_str.h"
 #include "ocs_system/default_clock.h"
@@ -34,12 +37,30 @@ SystemPipeline::SystemPipeline(SystemPipeline::Params params) {
     default_clock_.reset(new (std::nothrow) system::DefaultClock());
     configASSERT(default_clock_);
 
-    delay_estimator_.reset(new (std::nothrow) scheduler::ConstantDelayEstimator(
-        params.task_scheduler.delay));
+    if (params.task_scheduler.adaptive_delay) {
+        adaptive_delay_estimator_ = new (std::nothrow) scheduler::AdaptiveDelayEstimator(
+            *default_clock_, params.task_scheduler.delay);
+        delay_estimator_.reset(adaptive_delay_estimator_);
+    } else {
+        delay_estimator_.reset(new (std::nothrow) scheduler::ConstantDelayEstimator(
+            params.task_scheduler.delay));
+    }
     configASSERT(delay_estimator_);
 
-    task_scheduler_.reset(new (std::nothrow) scheduler::PeriodicTaskScheduler(
-        *default_clock_, *delay_estimator_, "system_pipeline_scheduler", 16));
+    if (params.task_scheduler.worker_count) {
+        scheduler::MulticoreTaskScheduler::Params scheduler_params;
+        scheduler_params.worker_count = params.task_scheduler.worker_count;
+
+        task_scheduler_.reset(new (std::nothrow) scheduler::MulticoreTaskScheduler(
+            *default_clock_, *delay_estimator_, "system_pipeline_scheduler", 16,
+            scheduler_params));
+    } else if (params.task_scheduler.deadline_ordered) {
+        task_scheduler_.reset(new (std::nothrow) scheduler::DeadlineTaskScheduler(
+            *default_clock_, *delay_estimator_, "system_pipeline_scheduler", 16));
+    } else {
+        task_scheduler_.reset(new (std::nothrow) scheduler::PeriodicTaskScheduler(
+            *default_clock_, *delay_estimator_, "system_pipeline_scheduler", 16));
+    }
     configASSERT(task_scheduler_);
 
     func_scheduler_.reset(new (std::nothrow) scheduler::AsyncFuncScheduler(16));
@@ -49,6 +70,8 @@ SystemPipeline::SystemPipeline(SystemPipeline::Params params) {
                                       core::Duration::second)
                  == status::StatusCode::OK);
 
+    func_scheduler_->set_waker(*task_scheduler_, "system_async_func_scheduler");
+
     fanout_reboot_handler_.reset(new (std::nothrow) system::FanoutRebootHandler());
     configASSERT(fanout_reboot_handler_);
 
@@ -63,8 +86,9 @@ SystemPipeline::SystemPipeline(SystemPipeline::Params params) {
     reboot_task_.reset(new (std::nothrow) system::RebootTask(*delay_rebooter_));
     configASSERT(reboot_task_);
 
-    reboot_task_async_.reset(new (std::nothrow)
-                                 scheduler::AsyncFunc(*func_scheduler_, *reboot_task_));
+    reboot_task_async_.reset(new (std::nothrow) scheduler::AsyncFunc(
+        *func_scheduler_, *reboot_task_, portMAX_DELAY,
+        scheduler::AsyncFuncScheduler::Priority::High));
     configASSERT(reboot_task_async_);
 
     fanout_suspender_.reset(new (std::nothrow) system::FanoutSuspender());
@@ -102,6 +126,11 @@ scheduler::ITaskScheduler& SystemPipeline::get_task_scheduler() {
     return *task_scheduler_;
 }
 
+const scheduler::AdaptiveDelayEstimator*
+SystemPipeline::get_adaptive_delay_estimator() const {
+    return adaptive_delay_estimator_;
+}
+
 scheduler::ITask& SystemPipeline::get_reboot_task() {
     return *reboot_task_async_;
 }
@@ -12,6 +12,7 @@
 
 #include "ocs_core/iclock.h"
 #include "ocs_core/noncopyable.h"
+#include "ocs_scheduler/adaptive_delay_estimator.h"
 #include "ocs_scheduler/async_func_scheduler.h"
 #include "ocs_scheduler/idelay_estimator.h"
 #include "ocs_scheduler/itask_scheduler.h"
@@ -32,7 +33,23 @@ public:
     struct Params {
         struct TaskScheduler {
             //! Delay after all tasks have been run.
+            //!
+            //! @remarks
+            //!  When tasks are deadline-ordered or the adaptive delay is enabled, it's
+            //!  the maximum delay between rounds.
             TickType_t delay { 0 };
+
+            //! Run tasks in order of their deadlines and sleep until the earliest one.
+            bool deadline_ordered { false };
+
+            //! Sleep until the earliest task deadline, but no longer than the delay.
+            bool adaptive_delay { false };
+
+            //! Run tasks on the pool of workers distributed over the cores, if non-zero.
+            //!
+            //! @remarks
+            //!  Takes precedence over deadline_ordered.
+            unsigned worker_count { 0 };
         } task_scheduler;
     };
 
@@ -51,6 +68,11 @@ public:
     storage::StorageBuilder& get_storage_builder();
     scheduler::AsyncFuncScheduler& get_func_scheduler();
     scheduler::ITaskScheduler& get_task_scheduler();
+
+    //! Return the delay estimator of the task scheduler, or null if the adaptive delay
+    //! is disabled.
+    const scheduler::AdaptiveDelayEstimator* get_adaptive_delay_estimator() const;
+
     scheduler::ITask& get_reboot_task();
     system::FanoutRebootHandler& get_reboot_handler();
     system::FanoutSuspender& get_suspender();
@@ -62,6 +84,7 @@ private:
     std::unique_ptr<core::IClock> default_clock_;
 
     std::unique_ptr<scheduler::IDelayEstimator> delay_estimator_;
+    scheduler::AdaptiveDelayEstimator* adaptive_delay_estimator_ { nullptr };
     std::unique_ptr<scheduler::ITaskScheduler> task_scheduler_;
     std::unique_ptr<scheduler::AsyncFuncScheduler> func_scheduler_;
 
@@ -6,55 +6,425 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 
-#include "ocs_pipeline/httpserver/data_handler.h"
+#include <charconv>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+
+#include "esp_random.h"
+#include "freertos/FreeRTOSConfig.h"
+
+#include "ocs_algo/uri_ops.h"
+#include "ocs_core/istream_writer.h"
 #include "ocs_core/log.h"
-#include "ocs_fmt/json/cjson_builder.h"
+#include "ocs_fmt/json/stream_writer.h"
+#include "ocs_http/chunk_stream_writer.h"
+#include "ocs_pipeline/httpserver/data_handler.h"
+#include "ocs_status/code_to_str.h"
 
 namespace ocs {
 namespace pipeline {
 namespace httpserver {
 
-DataHandler::DataHandler(http::Server& server,
-                         fmt::json::IFormatter& formatter,
-                         const char* path,
-                         const char* id,
-                         unsigned buffer_size) {
-    fanout_formatter_.reset(new (std::nothrow) fmt::json::FanoutFormatter());
-    configASSERT(fanout_formatter_);
+namespace {
+
+//! Write the data to the underlying writer and copy it into the cache.
+class CacheStreamWriter : public core::IStreamWriter, public core::NonCopyable<> {
+public:
+    CacheStreamWriter(core::IStreamWriter& writer, std::vector<char>& cache)
+        : writer_(writer)
+        , cache_(cache) {
+    }
+
+    status::StatusCode begin() override {
+        cache_.clear();
+
+        return writer_.begin();
+    }
+
+    status::StatusCode end() override {
+        return writer_.end();
+    }
+
+    status::StatusCode cancel() override {
+        cache_.clear();
+
+        return writer_.cancel();
+    }
+
+    status::StatusCode write(const void* data, unsigned size) override {
+        const char* bytes = static_cast<const char*>(data);
+        cache_.insert(cache_.end(), bytes, bytes + size);
 
-    fanout_formatter_->add(formatter);
+        return writer_.write(data, size);
+    }
 
-    json_formatter_.reset(new (std::nothrow) fmt::json::DynamicFormatter(buffer_size));
-    configASSERT(json_formatter_);
+private:
+    core::IStreamWriter& writer_;
+    std::vector<char>& cache_;
+};
 
-    fanout_formatter_->add(*json_formatter_);
+//! Set the ETag header right before the first part of the response is written, so the
+//! error response, which is sent if the data can't be formatted, doesn't have it.
+class EtagStreamWriter : public core::IStreamWriter, public core::NonCopyable<> {
+public:
+    EtagStreamWriter(core::IStreamWriter& writer, httpd_req_t* req, const char* etag)
+        : etag_(etag)
+        , req_(req)
+        , writer_(writer) {
+    }
 
-    server.add_GET(path, [this, path, id](httpd_req_t* req) {
-        auto json = fmt::json::CjsonUniqueBuilder::make_object();
-        if (!json) {
-            return status::StatusCode::NoMem;
+    status::StatusCode begin() override {
+        return writer_.begin();
+    }
+
+    status::StatusCode end() override {
+        if (const auto code = set_etag_(); code != status::StatusCode::OK) {
+            return code;
         }
 
-        const auto code = fanout_formatter_->format(json.get());
-        if (code != status::StatusCode::OK) {
+        return writer_.end();
+    }
+
+    status::StatusCode cancel() override {
+        return writer_.cancel();
+    }
+
+    status::StatusCode write(const void* data, unsigned size) override {
+        if (const auto code = set_etag_(); code != status::StatusCode::OK) {
             return code;
         }
 
-        auto err = httpd_resp_set_type(req, HTTPD_TYPE_JSON);
-        if (err != ESP_OK) {
-            return status::StatusCode::Error;
+        return writer_.write(data, size);
+    }
+
+private:
+    status::StatusCode set_etag_() {
+        if (etag_set_) {
+            return status::StatusCode::OK;
         }
 
-        err = httpd_resp_send(req, json_formatter_->c_str(), HTTPD_RESP_USE_STRLEN);
-        if (err != ESP_OK) {
-            ocs_loge(id, "httpd_resp_send(): %s", esp_err_to_name(err));
+        if (httpd_resp_set_hdr(req_, "ETag", etag_) != ESP_OK) {
             return status::StatusCode::Error;
         }
 
+        etag_set_ = true;
+
         return status::StatusCode::OK;
+    }
+
+    const char* etag_ { nullptr };
+    httpd_req_t* req_ { nullptr };
+
+    core::IStreamWriter& writer_;
+
+    bool etag_set_ { false };
+};
+
+const char* cbor_content_type = "application/cbor";
+
+const char* get_content_type(fmt::json::StreamWriter::Encoding encoding) {
+    return encoding == fmt::json::StreamWriter::Encoding::Cbor ? cbor_content_type
+                                                               : HTTPD_TYPE_JSON;
+}
+
+bool parse_number(std::string_view str, uint32_t& value) {
+    const char* end = str.data() + str.size();
+
+    const auto [ptr, ec] = std::from_chars(str.data(), end, value);
+
+    return ec == std::errc() && ptr == end;
+}
+
+//! Parse "<epoch>-<sequence>" token, the epoch is zero if only the sequence is given.
+bool parse_since(std::string_view str, uint32_t& epoch, uint32_t& since) {
+    epoch = 0;
+
+    if (const auto pos = str.find('-'); pos != std::string_view::npos) {
+        if (!parse_number(str.substr(0, pos), epoch)) {
+            return false;
+        }
+
+        str.remove_prefix(pos + 1);
+    }
+
+    return parse_number(str, since);
+}
+
+} // namespace
+
+DataHandler::DataHandler(http::Server& server,
+                         core::IClock& clock,
+                         fmt::json::IFormatter& formatter,
+                         const char* path,
+                         const char* id,
+                         unsigned buffer_size,
+                         core::Time cache_interval,
+                         fmt::json::DeltaFormatter* delta_formatter)
+    : id_(id)
+    , buffer_size_(buffer_size)
+    , cache_interval_(cache_interval)
+    , clock_(clock)
+    , formatter_(formatter)
+    , delta_formatter_(delta_formatter)
+    , boot_id_(esp_random()) {
+    buffer_.reset(new (std::nothrow) char[buffer_size_]);
+    configASSERT(buffer_);
+
+    memset(etag_, 0, sizeof(etag_));
+    memset(next_etag_, 0, sizeof(next_etag_));
+
+    server.add_GET(path, [this](httpd_req_t* req) {
+        return handle_(req);
     });
 }
 
+unsigned DataHandler::coalesced_count() const {
+    return coalesced_count_;
+}
+
+bool DataHandler::cache_valid_(std::optional<uint32_t> generation, Encoding encoding) {
+    if (!cached_ || generation != cache_generation_ || encoding != cache_encoding_) {
+        return false;
+    }
+
+    if (generation) {
+        return true;
+    }
+
+    return clock_.now() - cache_ts_ < cache_interval_;
+}
+
+status::StatusCode DataHandler::handle_(httpd_req_t* req) {
+    // Generation is read before the data is formatted, so the update which happens
+    // during the formatting invalidates the cache on the next request.
+    const auto generation = formatter_.generation();
+    const auto encoding = parse_encoding_(req);
+
+    // Response depends on the Accept header, caches should take it into account.
+    if (httpd_resp_set_hdr(req, "Vary", "Accept") != ESP_OK) {
+        return status::StatusCode::Error;
+    }
+
+    if (delta_formatter_) {
+        const auto values = algo::UriOps::parse_query(req->uri);
+
+        if (const auto it = values.find("since"); it != values.end()) {
+            uint32_t epoch = 0;
+            uint32_t since = 0;
+
+            if (!parse_since(it->second, epoch, since)) {
+                return status::StatusCode::InvalidArg;
+            }
+
+            return send_delta_(req, epoch, since, encoding);
+        }
+    }
+
+    if (cache_valid_(generation, encoding)) {
+        ++coalesced_count_;
+
+        if (etag_match_(req)) {
+            return send_not_modified_(req);
+        }
+
+        return send_cached_(req);
+    }
+
+    return send_formatted_(req, generation, encoding);
+}
+
+status::StatusCode DataHandler::send_cached_(httpd_req_t* req) {
+    auto err = httpd_resp_set_type(req, get_content_type(cache_encoding_));
+    if (err != ESP_OK) {
+        return status::StatusCode::Error;
+    }
+
+    err = httpd_resp_set_hdr(req, "ETag", etag_);
+    if (err != ESP_OK) {
+        return status::StatusCode::Error;
+    }
+
+    err = httpd_resp_send(req, cache_.data(), cache_.size());
+    if (err != ESP_OK) {
+        ocs_loge(id_, "httpd_resp_send(): %s", esp_err_to_name(err));
+        return status::StatusCode::Error;
+    }
+
+    return status::StatusCode::OK;
+}
+
+status::StatusCode DataHandler::send_formatted_(httpd_req_t* req,
+                                                std::optional<uint32_t> generation,
+                                                Encoding encoding) {
+    cached_ = false;
+
+    const bool cacheable = generation || cache_interval_ > 0;
+
+    auto err = httpd_resp_set_type(req, get_content_type(encoding));
+    if (err != ESP_OK) {
+        return status::StatusCode::Error;
+    }
+
+    // The header value should be valid until the response is sent.
+    if (cacheable) {
+        snprintf(next_etag_, sizeof(next_etag_), "\"%08" PRIx32 "-%08" PRIx32 "\"",
+                 boot_id_, serial_ + 1);
+    }
+
+    http::ChunkStreamWriter chunk_writer(req);
+    EtagStreamWriter etag_writer(chunk_writer, req, next_etag_);
+    CacheStreamWriter cache_writer(etag_writer, cache_);
+
+    core::IStreamWriter& stream_writer =
+        cacheable ? static_cast<core::IStreamWriter&>(cache_writer) : chunk_writer;
+
+    if (const auto code = stream_writer.begin(); code != status::StatusCode::OK) {
+        return code;
+    }
+
+    fmt::json::StreamWriter json_writer(stream_writer, buffer_.get(), buffer_size_,
+                                        encoding);
+
+    json_writer.begin_object();
+
+    if (const auto code = formatter_.format(json_writer);
+        code != status::StatusCode::OK) {
+        ocs_loge(id_, "failed to format response: code=%s", status::code_to_str(code));
+
+        return cancel_(stream_writer, json_writer, code);
+    }
+
+    json_writer.end_object();
+
+    if (const auto code = write_(stream_writer, json_writer);
+        code != status::StatusCode::OK) {
+        return code;
+    }
+
+    if (cacheable) {
+        ++serial_;
+        memcpy(etag_, next_etag_, sizeof(etag_));
+
+        cached_ = true;
+        cache_generation_ = generation;
+        cache_encoding_ = encoding;
+        cache_ts_ = clock_.now();
+    }
+
+    return status::StatusCode::OK;
+}
+
+status::StatusCode DataHandler::send_delta_(httpd_req_t* req,
+                                            uint32_t epoch,
+                                            uint32_t since,
+                                            Encoding encoding) {
+    auto err = httpd_resp_set_type(req, get_content_type(encoding));
+    if (err != ESP_OK) {
+        return status::StatusCode::Error;
+    }
+
+    // Response depends on the client state, it shouldn't be reused.
+    err = httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+    if (err != ESP_OK) {
+        return status::StatusCode::Error;
+    }
+
+    http::ChunkStreamWriter chunk_writer(req);
+
+    if (const auto code = chunk_writer.begin(); code != status::StatusCode::OK) {
+        return code;
+    }
+
+    fmt::json::StreamWriter json_writer(chunk_writer, buffer_.get(), buffer_size_,
+                                        encoding);
+
+    json_writer.begin_object();
+
+    if (const auto code = delta_formatter_->format(json_writer, epoch, since);
+        code != status::StatusCode::OK) {
+        ocs_loge(id_,
+                 "failed to format delta: epoch=%" PRIu32 " since=%" PRIu32 " code=%s",
+                 epoch, since, status::code_to_str(code));
+
+        return cancel_(chunk_writer, json_writer, code);
+    }
+
+    json_writer.end_object();
+
+    return write_(chunk_writer, json_writer);
+}
+
+status::StatusCode DataHandler::send_not_modified_(httpd_req_t* req) {
+    auto err = httpd_resp_set_status(req, "304 Not Modified");
+    if (err != ESP_OK) {
+        return status::StatusCode::Error;
+    }
+
+    err = httpd_resp_set_hdr(req, "ETag", etag_);
+    if (err != ESP_OK) {
+        return status::StatusCode::Error;
+    }
+
+    err = httpd_resp_send(req, nullptr, 0);
+    if (err != ESP_OK) {
+        ocs_loge(id_, "httpd_resp_send(): %s", esp_err_to_name(err));
+        return status::StatusCode::Error;
+    }
+
+    return status::StatusCode::OK;
+}
+
+status::StatusCode DataHandler::write_(core::IStreamWriter& stream_writer,
+                                       fmt::json::StreamWriter& json_writer) {
+    const auto code = json_writer.flush();
+    if (code != status::StatusCode::OK) {
+        ocs_loge(id_, "failed to stream response: code=%s", status::code_to_str(code));
+
+        return cancel_(stream_writer, json_writer, code);
+    }
+
+    return stream_writer.end();
+}
+
+status::StatusCode DataHandler::cancel_(core::IStreamWriter& stream_writer,
+                                        fmt::json::StreamWriter& json_writer,
+                                        status::StatusCode code) {
+    // Nothing has been sent yet, the error response can be sent instead.
+    if (!json_writer.flushed()) {
+        return code;
+    }
+
+    // Part of the response has been sent, the only option is to abort the connection,
+    // so the client doesn't take the truncated response as complete.
+    return stream_writer.cancel();
+}
+
+bool DataHandler::etag_match_(httpd_req_t* req) {
+    char buf[64];
+
+    // Header can contain multiple weak or strong ETags, compare them as opaque strings.
+    // Truncated header isn't matched, which only causes the full response to be sent.
+    if (httpd_req_get_hdr_value_str(req, "If-None-Match", buf, sizeof(buf)) != ESP_OK) {
+        return false;
+    }
+
+    return strstr(buf, etag_) || !strcmp(buf, "*");
+}
+
+DataHandler::Encoding DataHandler::parse_encoding_(httpd_req_t* req) {
+    char buf[128];
+
+    // JSON is used if the header is missing, truncated, or doesn't list CBOR. Quality
+    // values aren't taken into account: CBOR is only sent to the clients that ask for it.
+    if (httpd_req_get_hdr_value_str(req, "Accept", buf, sizeof(buf)) != ESP_OK) {
+        return Encoding::Json;
+    }
+
+    return strstr(buf, cbor_content_type) ? Encoding::Cbor : Encoding::Json;
+}
+
 } // namespace httpserver
 } // namespace pipeline
 } // namespace ocs
@@ -8,36 +8,123 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <optional>
+#include <vector>
 
+#include "ocs_core/iclock.h"
 #include "ocs_core/noncopyable.h"
-#include "ocs_fmt/json/dynamic_formatter.h"
-#include "ocs_fmt/json/fanout_formatter.h"
+#include "ocs_core/time.h"
+#include "ocs_fmt/json/delta_formatter.h"
+#include "ocs_fmt/json/iformatter.h"
+#include "ocs_fmt/json/stream_writer.h"
 #include "ocs_http/server.h"
 
 namespace ocs {
 namespace pipeline {
 namespace httpserver {
 
+//! Serve the formatted JSON data.
+//!
+//! @notes
+//!  The data is streamed directly into the HTTP response with chunked encoding, through
+//!  the fixed scratch buffer. Formatters supporting fmt::json::StreamWriter don't
+//!  allocate memory per request.
+//!
+//!  The last response is cached with the generation of the formatted data, and is
+//!  served until the generation is changed. If the generation isn't tracked, the
+//!  response is served from the cache during the configured interval. Cached responses
+//!  are sent with ETag, requests with the matching If-None-Match are answered with
+//!  304 Not Modified.
+//!
+//!  The data is encoded as CBOR if the client lists application/cbor in the Accept
+//!  header, and as JSON otherwise.
+//!
+//!  If the delta formatter is provided, requests with the "since" query parameter are
+//!  answered with the fields changed after the given sequence number, and the current
+//!  epoch and sequence number in the "epoch" and "seq" fields. The parameter is given
+//!  as "<epoch>-<seq>", all fields are sent if the epoch doesn't match the current one
+//!  or is omitted. Such responses aren't cached.
+//!
+//! @example
+//!  curl "bonsai-firmware.local/api/v1/telemetry?since=2780392310-42"
 class DataHandler : public core::NonCopyable<> {
 public:
     //! Initialize.
     //!
     //! @params
     //!  - @p server to register the HTTP endpoint.
+    //!  - @p clock to check if the cached response has expired.
     //!  - @p formatter to format the data.
     //!  - @p path - URI path.
     //!  - @p id - unique data ID, to distinguish one data from another.
-    //!  - @p buffer_size to hold the formatted JSON data, in bytes.
+    //!  - @p buffer_size to hold the formatted JSON data before it's sent, in bytes.
+    //!  - @p cache_interval - how long the response can be served from the cache, if
+    //!    the generation of the formatted data isn't tracked. Zero disables caching
+    //!    of such data.
+    //!  - @p delta_formatter to format the changed data, optional.
     DataHandler(http::Server& server,
+                core::IClock& clock,
                 fmt::json::IFormatter& formatter,
                 const char* path,
                 const char* id,
-                unsigned buffer_size);
+                unsigned buffer_size,
+                core::Time cache_interval,
+                fmt::json::DeltaFormatter* delta_formatter = nullptr);
+
+    //! Return the number of requests answered with the previously formatted response.
+    unsigned coalesced_count() const;
 
 private:
-    std::unique_ptr<fmt::json::FanoutFormatter> fanout_formatter_;
-    std::unique_ptr<fmt::json::DynamicFormatter> json_formatter_;
+    using Encoding = fmt::json::StreamWriter::Encoding;
+
+    bool cache_valid_(std::optional<uint32_t> generation, Encoding encoding);
+
+    status::StatusCode handle_(httpd_req_t* req);
+    status::StatusCode send_cached_(httpd_req_t* req);
+    status::StatusCode send_formatted_(httpd_req_t* req,
+                                       std::optional<uint32_t> generation,
+                                       Encoding encoding);
+    status::StatusCode
+    send_delta_(httpd_req_t* req, uint32_t epoch, uint32_t since, Encoding encoding);
+    status::StatusCode send_not_modified_(httpd_req_t* req);
+
+    status::StatusCode write_(core::IStreamWriter& stream_writer,
+                              fmt::json::StreamWriter& json_writer);
+    status::StatusCode cancel_(core::IStreamWriter& stream_writer,
+                               fmt::json::StreamWriter& json_writer,
+                               status::StatusCode code);
+
+    bool etag_match_(httpd_req_t* req);
+
+    static Encoding parse_encoding_(httpd_req_t* req);
+
+    const char* id_ { nullptr };
+    const unsigned buffer_size_ { 0 };
+    const core::Time cache_interval_ { 0 };
+
+    core::IClock& clock_;
+    fmt::json::IFormatter& formatter_;
+    fmt::json::DeltaFormatter* delta_formatter_ { nullptr };
+    std::unique_ptr<char[]> buffer_;
+
+    //! ETag is unique across reboots, since the generation starts from scratch.
+    const uint32_t boot_id_ { 0 };
+    uint32_t serial_ { 0 };
+    char etag_[24];
+
+    //! ETag of the response being formatted, becomes current once it's sent.
+    char next_etag_[24];
+
+    bool cached_ { false };
+    std::optional<uint32_t> cache_generation_;
+    Encoding cache_encoding_ { Encoding::Json };
+    core::Time cache_ts_ { 0 };
+    std::vector<char> cache_;
+
+    std::atomic<unsigned> coalesced_count_ { 0 };
 };
 
 } // namespace httpserver
@@ -111,27 +111,38 @@ status::StatusCode find_rom_code(onewire::Bus& bus,
 
 DS18B20Handler::DS18B20Handler(http::Server& server,
                                system::ISuspender& suspender,
-                               sensor::ds18b20::Store& store)
+                               sensor::ds18b20::Store& store,
+                               fmt::json::CjsonArena* arena)
     : suspender_(suspender)
-    , store_(store) {
+    , store_(store)
+    , arena_(arena) {
     server.add_GET("/api/v1/sensor/ds18b20/scan", [this](httpd_req_t* req) {
+        fmt::json::CjsonArenaScope scope(arena_);
+
         return handle_scan_(req);
     });
-    server.add_GET("/api/v1/sensor/ds18b20/read_configuration", [this](httpd_req_t* req) {
-        return handle_configuration_(
-            req, read_wait_interval_, read_response_buffer_size_,
-            [this](cJSON* json, sensor::ds18b20::Sensor& sensor) {
-                return read_configuration_(json, sensor);
-            });
-    });
-    server.add_GET("/api/v1/sensor/ds18b20/write_configuration",
-                   [this](httpd_req_t* req) {
-                       return handle_write_configuration_(req);
+    server.add_GET("/api/v1/sensor/ds18b20/{sensor_id}/read_configuration",
+                   [this](httpd_req_t* req, const http::Server::PathParams& params) {
+                       fmt::json::CjsonArenaScope scope(arena_);
+
+                       return handle_configuration_(
+                           req, params, read_wait_interval_, read_response_buffer_size_,
+                           [this](cJSON* json, sensor::ds18b20::Sensor& sensor) {
+                               return read_configuration_(json, sensor);
+                           });
+                   });
+    server.add_GET("/api/v1/sensor/ds18b20/{sensor_id}/write_configuration",
+                   [this](httpd_req_t* req, const http::Server::PathParams& params) {
+                       fmt::json::CjsonArenaScope scope(arena_);
+
+                       return handle_write_configuration_(req, params);
                    });
-    server.add_GET("/api/v1/sensor/ds18b20/erase_configuration",
-                   [this](httpd_req_t* req) {
+    server.add_GET("/api/v1/sensor/ds18b20/{sensor_id}/erase_configuration",
+                   [this](httpd_req_t* req, const http::Server::PathParams& params) {
+                       fmt::json::CjsonArenaScope scope(arena_);
+
                        return handle_configuration_(
-                           req, erase_wait_interval_, erase_response_buffer_size_,
+                           req, params, erase_wait_interval_, erase_response_buffer_size_,
                            [this](cJSON* json, sensor::ds18b20::Sensor& sensor) {
                                return erase_configuration_(json, sensor);
                            });
@@ -266,6 +277,7 @@ status::StatusCode DS18B20Handler::format_sensor_(cJSON* array,
 
 status::StatusCode
 DS18B20Handler::handle_configuration_(httpd_req_t* req,
+                                      const http::Server::PathParams& params,
                                       unsigned wait_interval,
                                       unsigned response_size,
                                       DS18B20Handler::HandleConfigurationFunc func) {
@@ -284,8 +296,8 @@ DS18B20Handler::handle_configuration_(httpd_req_t* req,
         return status::StatusCode::InvalidArg;
     }
 
-    const auto sensor_id = values.find("sensor_id");
-    if (sensor_id == values.end()) {
+    const auto sensor_id = params.get("sensor_id");
+    if (sensor_id.empty()) {
         return status::StatusCode::InvalidArg;
     }
 
@@ -300,7 +312,7 @@ DS18B20Handler::handle_configuration_(httpd_req_t* req,
         static_cast<io::gpio::Gpio>(gpio),
         [this, &json, &sensor_id, func](onewire::Bus& bus,
                                         sensor::ds18b20::Store::SensorList& sensors) {
-            auto sensor = get_sensor(sensor_id->second, sensors);
+            auto sensor = get_sensor(sensor_id, sensors);
             if (!sensor) {
                 return status::StatusCode::InvalidArg;
             }
@@ -336,7 +348,9 @@ status::StatusCode DS18B20Handler::read_configuration_(cJSON* json,
     return status::StatusCode::OK;
 }
 
-status::StatusCode DS18B20Handler::handle_write_configuration_(httpd_req_t* req) {
+status::StatusCode
+DS18B20Handler::handle_write_configuration_(httpd_req_t* req,
+                                            const http::Server::PathParams& params) {
     const auto values = algo::UriOps::parse_query(req->uri);
 
     const auto gpio_it = values.find("gpio");
@@ -352,8 +366,8 @@ status::StatusCode DS18B20Handler::handle_write_configuration_(httpd_req_t* req)
         return status::StatusCode::InvalidArg;
     }
 
-    const auto sensor_id = values.find("sensor_id");
-    if (sensor_id == values.end()) {
+    const auto sensor_id = params.get("sensor_id");
+    if (sensor_id.empty()) {
         return status::StatusCode::InvalidArg;
     }
 
@@ -379,7 +393,7 @@ status::StatusCode DS18B20Handler::handle_write_configuration_(httpd_req_t* req)
         [this, &json, &sensor_id, &serial_number,
          &resolution](onewire::Bus& bus, sensor::ds18b20::Store::SensorList& sensors) {
             return write_configuration_(json.get(), bus,
-                                        get_sensor(sensor_id->second, sensors),
+                                        get_sensor(sensor_id, sensors),
                                         serial_number->second, resolution->second);
         });
     if (!future) {
@@ -11,6 +11,7 @@
 #include <functional>
 
 #include "ocs_core/noncopyable.h"
+#include "ocs_fmt/json/cjson_arena.h"
 #include "ocs_fmt/json/cjson_builder.h"
 #include "ocs_http/server.h"
 #include "ocs_sensor/ds18b20/store.h"
@@ -28,9 +29,11 @@ public:
     //!  - @p server to register endpoints.
     //!  - @p suspender to suspend the system during sensors operations.
     //!  - @p store to perform operations on sensors.
+    //!  - @p arena to allocate the JSON responses, optional.
     DS18B20Handler(http::Server& server,
                    system::ISuspender& suspender,
-                   sensor::ds18b20::Store& store);
+                   sensor::ds18b20::Store& store,
+                   fmt::json::CjsonArena* arena = nullptr);
 
 private:
     using HandleConfigurationFunc =
@@ -64,13 +67,15 @@ private:
                                       const sensor::ds18b20::Sensor& sensors);
 
     status::StatusCode handle_configuration_(httpd_req_t* req,
+                                             const http::Server::PathParams& params,
                                              unsigned wait_interval,
                                              unsigned response_size,
                                              HandleConfigurationFunc func);
 
     status::StatusCode read_configuration_(cJSON* json, sensor::ds18b20::Sensor&);
 
-    status::StatusCode handle_write_configuration_(httpd_req_t* req);
+    status::StatusCode
+    handle_write_configuration_(httpd_req_t* req, const http::Server::PathParams& params);
 
     status::StatusCode write_configuration_(cJSON* json,
                                             onewire::Bus& bus,
@@ -89,6 +94,7 @@ private:
 
     system::ISuspender& suspender_;
     sensor::ds18b20::Store& store_;
+    fmt::json::CjsonArena* arena_ { nullptr };
 };
 
 } // namespace httpserver
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+
+#include "esp_heap_caps.h"
+#include "esp_rom_crc.h"
+#include "freertos/FreeRTOSConfig.h"
+
+#include "ocs_pipeline/httpserver/file_cache.h"
+
+namespace ocs {
+namespace pipeline {
+namespace httpserver {
+
+namespace {
+
+//! Read the data from @p reader in chunks of @p size bytes, and pass each chunk to
+//! @p func.
+template <typename Func>
+status::StatusCode
+read_stream(core::IStreamReader& reader, uint8_t* buf, unsigned size, Func func) {
+    if (const auto code = reader.begin(); code != status::StatusCode::OK) {
+        return code;
+    }
+
+    while (true) {
+        unsigned len = size;
+
+        const auto code = reader.read(buf, len);
+        if (code != status::StatusCode::OK) {
+            if (code != status::StatusCode::NoData) {
+                return code;
+            }
+
+            break;
+        }
+
+        if (const auto code = func(buf, len); code != status::StatusCode::OK) {
+            return code;
+        }
+    }
+
+    return reader.end();
+}
+
+} // namespace
+
+void FileCache::HeapDeleter::operator()(char* data) const {
+    heap_caps_free(data);
+}
+
+FileCache::FileCache(FileCache::Params params, std::vector<uint8_t>& buffer)
+    : params_(params)
+    , buffer_(buffer) {
+    configASSERT(buffer_.size());
+}
+
+status::StatusCode
+FileCache::add(const char* path, core::IStreamReader& reader, bool immutable) {
+    configASSERT(path);
+
+    File file;
+    file.path = path;
+    file.immutable = immutable;
+
+    uint32_t crc = 0;
+
+    const auto code = read_stream(reader, buffer_.data(), buffer_.size(),
+                                  [&file, &crc](const uint8_t* buf, unsigned size) {
+                                      crc = esp_rom_crc32_le(crc, buf, size);
+                                      file.size += size;
+
+                                      return status::StatusCode::OK;
+                                  });
+    if (code != status::StatusCode::OK) {
+        return code;
+    }
+
+    snprintf(file.etag, sizeof(file.etag), "\"%08" PRIx32 "-%x\"", crc, file.size);
+
+    const auto it = std::lower_bound(files_.begin(), files_.end(), file.path,
+                                     [](const File& file, const std::string& path) {
+                                         return file.path < path;
+                                     });
+    if (it != files_.end() && it->path == file.path) {
+        return status::StatusCode::InvalidArg;
+    }
+
+    files_.insert(it, std::move(file));
+
+    return status::StatusCode::OK;
+}
+
+FileCache::File* FileCache::use(std::string_view path) {
+    const auto it = std::lower_bound(files_.begin(), files_.end(), path,
+                                     [](const File& file, std::string_view path) {
+                                         return file.path < path;
+                                     });
+
+    if (it == files_.end() || it->path != path) {
+        return nullptr;
+    }
+
+    it->last_use = ++use_counter_;
+
+    return &*it;
+}
+
+bool FileCache::cacheable(const File& file) const {
+    return !file.data && file.size && file.size <= params_.max_file_size
+        && file.size <= params_.cache_size;
+}
+
+status::StatusCode FileCache::load(File& file, core::IStreamReader& reader) {
+    configASSERT(cacheable(file));
+
+    evict_(file.size);
+
+    HeapPtr data(static_cast<char*>(heap_caps_malloc_prefer(
+        file.size, 2, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT, MALLOC_CAP_DEFAULT)));
+    if (!data) {
+        return status::StatusCode::NoMem;
+    }
+
+    unsigned offset = 0;
+
+    const auto code = read_stream(
+        reader, buffer_.data(), buffer_.size(),
+        [&file, &data, &offset](const uint8_t* buf, unsigned size) {
+            // File has been changed since it was added.
+            if (offset + size > file.size) {
+                return status::StatusCode::InvalidState;
+            }
+
+            memcpy(data.get() + offset, buf, size);
+            offset += size;
+
+            return status::StatusCode::OK;
+        });
+    if (code != status::StatusCode::OK) {
+        return code;
+    }
+
+    if (offset != file.size) {
+        return status::StatusCode::InvalidState;
+    }
+
+    file.data = std::move(data);
+    cached_size_ += file.size;
+
+    return status::StatusCode::OK;
+}
+
+unsigned FileCache::cached_size() const {
+    return cached_size_;
+}
+
+bool FileCache::etag_match(const File& file, const char* if_none_match) {
+    return strstr(if_none_match, file.etag) || !strcmp(if_none_match, "*");
+}
+
+void FileCache::evict_(unsigned size) {
+    // Number of files is small, linear search is cheaper than maintaining the list.
+    while (cached_size_ + size > params_.cache_size) {
+        File* lru = nullptr;
+
+        for (auto& file : files_) {
+            if (file.data && (!lru || file.last_use < lru->last_use)) {
+                lru = &file;
+            }
+        }
+
+        configASSERT(lru);
+
+        lru->data = nullptr;
+        cached_size_ -= lru->size;
+    }
+}
+
+} // namespace httpserver
+} // namespace pipeline
+} // namespace ocs
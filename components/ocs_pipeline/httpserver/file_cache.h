@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ocs_core/istream_reader.h"
+#include "ocs_core/noncopyable.h"
+#include "ocs_status/code.h"
+
+namespace ocs {
+namespace pipeline {
+namespace httpserver {
+
+//! Table of the static files, which keeps the recently used files in RAM.
+//!
+//! @notes
+//!  The ETag of each file is derived from its CRC32 and size. PSRAM is preferred for
+//!  the file contents if available. When the cache is full, the least recently used
+//!  files are evicted. Files larger than the configured limit are never cached.
+class FileCache : public core::NonCopyable<> {
+public:
+    struct Params {
+        //! Maximum total size of the files kept in RAM, in bytes.
+        unsigned cache_size { 64 * 1024 };
+
+        //! Maximum size of a single file kept in RAM, in bytes.
+        unsigned max_file_size { 16 * 1024 };
+    };
+
+    struct HeapDeleter {
+        void operator()(char* data) const;
+    };
+
+    using HeapPtr = std::unique_ptr<char[], HeapDeleter>;
+
+    struct File {
+        //! Path used to find the file.
+        std::string path;
+
+        unsigned size { 0 };
+        char etag[24];
+        bool immutable { false };
+
+        //! Cached content, null if the file isn't cached.
+        HeapPtr data;
+
+        //! Value of the use counter when the file was last used.
+        uint32_t last_use { 0 };
+    };
+
+    //! Initialize.
+    //!
+    //! @params
+    //!  - @p params to configure the cache.
+    //!  - @p buffer to read the files, can be shared with the other users.
+    FileCache(Params params, std::vector<uint8_t>& buffer);
+
+    //! Add file with @p path, read from @p reader to calculate its ETag.
+    //!
+    //! @params
+    //!  - @p path - path used to find the file.
+    //!  - @p reader to read the file content.
+    //!  - @p immutable - file content never changes for the same path.
+    status::StatusCode add(const char* path, core::IStreamReader& reader, bool immutable);
+
+    //! Return the file with @p path, null if the file doesn't exist.
+    //!
+    //! @remarks
+    //!  The file is marked as the most recently used one.
+    File* use(std::string_view path);
+
+    //! Return true if @p file should be loaded into RAM.
+    bool cacheable(const File& file) const;
+
+    //! Load @p file content from @p reader into RAM, evict the least recently used
+    //! files if required.
+    status::StatusCode load(File& file, core::IStreamReader& reader);
+
+    //! Return the total size of the files kept in RAM.
+    unsigned cached_size() const;
+
+    //! Return true if @p if_none_match header value contains the ETag of @p file.
+    //!
+    //! @remarks
+    //!  The header can contain multiple weak or strong ETags, they're compared as
+    //!  opaque strings.
+    static bool etag_match(const File& file, const char* if_none_match);
+
+private:
+    void evict_(unsigned size);
+
+    const Params params_;
+
+    std::vector<uint8_t>& buffer_;
+
+    //! Sorted by path.
+    std::vector<File> files_;
+
+    unsigned cached_size_ { 0 };
+    uint32_t use_counter_ { 0 };
+};
+
+} // namespace httpserver
+} // namespace pipeline
+} // namespace ocs
@@ -6,9 +6,15 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 
+#include <algorithm>
+
+#include "esp_random.h"
+
 #include "ocs_pipeline/httpserver/http_pipeline.h"
 #include "ocs_core/log.h"
+#include "ocs_diagnostic/func_counter.h"
 #include "ocs_status/code_to_str.h"
+#include "ocs_system/default_clock.h"
 
 namespace ocs {
 namespace pipeline {
@@ -21,10 +27,13 @@ const char* log_tag = "http_pipeline";
 } // namespace
 
 HttpPipeline::HttpPipeline(scheduler::ITask& reboot_task,
+                           scheduler::ITaskScheduler& task_scheduler,
+                           scheduler::AsyncFuncScheduler& func_scheduler,
+                           diagnostic::BasicCounterHolder& counter_holder,
                            system::FanoutSuspender& suspender,
                            net::FanoutNetworkHandler& network_handler,
                            net::IMdnsDriver& mdns_driver,
-                           fmt::json::IFormatter& telemetry_formatter,
+                           fmt::json::FanoutFormatter& telemetry_formatter,
                            fmt::json::FanoutFormatter& registration_formatter,
                            Params params)
     : mdns_driver_(mdns_driver) {
@@ -50,22 +59,101 @@ HttpPipeline::HttpPipeline(scheduler::ITask& reboot_task,
 
     configASSERT(suspender.add(*this, "http_pipeline") == status::StatusCode::OK);
 
+    clock_.reset(new (std::nothrow) system::DefaultClock());
+    configASSERT(clock_);
+
+    if (params.cjson_arena_size) {
+        cjson_arena_.reset(new (std::nothrow)
+                               fmt::json::CjsonArena(params.cjson_arena_size));
+        configASSERT(cjson_arena_);
+
+        cjson_arena_hwm_counter_.reset(
+            new (std::nothrow) diagnostic::FuncCounter("c_http_arena_hw", [this]() {
+                return cjson_arena_->high_water_mark();
+            }));
+        configASSERT(cjson_arena_hwm_counter_);
+
+        cjson_arena_fallback_counter_.reset(
+            new (std::nothrow) diagnostic::FuncCounter("c_http_arena_fb", [this]() {
+                return cjson_arena_->fallback_count();
+            }));
+        configASSERT(cjson_arena_fallback_counter_);
+
+        counter_holder.add(*cjson_arena_hwm_counter_);
+        counter_holder.add(*cjson_arena_fallback_counter_);
+    }
+
+    // Epoch distinguishes the sequence from the one of the previous boot.
+    telemetry_delta_formatter_.reset(new (std::nothrow) fmt::json::DeltaFormatter(
+        telemetry_formatter, std::max<uint32_t>(esp_random(), 1)));
+    configASSERT(telemetry_delta_formatter_);
+
     telemetry_handler_.reset(new (std::nothrow) DataHandler(
-        *http_server_, telemetry_formatter, "/api/v1/telemetry", "http_telemetry_handler",
-        params.telemetry.buffer_size));
+        *http_server_, *clock_, telemetry_formatter, "/api/v1/telemetry",
+        "http_telemetry_handler", params.telemetry.buffer_size,
+        params.telemetry.cache_interval, telemetry_delta_formatter_.get()));
     configASSERT(telemetry_handler_);
 
+    telemetry_coalesced_counter_.reset(
+        new (std::nothrow) diagnostic::FuncCounter("c_http_tel_coal", [this]() {
+            return telemetry_handler_->coalesced_count();
+        }));
+    configASSERT(telemetry_coalesced_counter_);
+
+    counter_holder.add(*telemetry_coalesced_counter_);
+
+    if (params.telemetry_stream.buffer_size) {
+        telemetry_stream_handler_.reset(new (std::nothrow) StreamHandler(
+            *http_server_, *clock_, telemetry_formatter, "/api/v1/telemetry/stream",
+            "http_telemetry_stream_handler", params.telemetry_stream.buffer_size,
+            params.telemetry_stream.stream));
+        configASSERT(telemetry_stream_handler_);
+
+        configASSERT(task_scheduler.add(*telemetry_stream_handler_,
+                                        "http_telemetry_stream_task",
+                                        params.telemetry_stream.poll_interval)
+                     == status::StatusCode::OK);
+    }
+
     registration_handler_.reset(new (std::nothrow) DataHandler(
-        *http_server_, registration_formatter, "/api/v1/registration",
-        "http_registration_handler", params.registration.buffer_size));
+        *http_server_, *clock_, registration_formatter, "/api/v1/registration",
+        "http_registration_handler", params.registration.buffer_size,
+        params.registration.cache_interval));
     configASSERT(registration_handler_);
 
     system_handler_.reset(new (std::nothrow) SystemHandler(*http_server_, reboot_task));
     configASSERT(system_handler_);
 
+    scheduler_formatter_.reset(new (std::nothrow) jsonfmt::TaskSchedulerFormatter());
+    configASSERT(scheduler_formatter_);
+
+    scheduler_formatter_->add(task_scheduler, "system");
+    scheduler_formatter_->add(func_scheduler, "system_func");
+
+    if (params.scheduler.buffer_size) {
+        scheduler_handler_.reset(new (std::nothrow) DataHandler(
+            *http_server_, *clock_, *scheduler_formatter_, "/api/v1/system/scheduler",
+            "http_scheduler_handler", params.scheduler.buffer_size,
+            params.scheduler.cache_interval));
+        configASSERT(scheduler_handler_);
+    }
+
+    if (params.http_server.buffer_size) {
+        http_server_formatter_.reset(new (std::nothrow)
+                                         jsonfmt::HttpServerFormatter(*http_server_));
+        configASSERT(http_server_formatter_);
+
+        http_server_handler_.reset(new (std::nothrow) DataHandler(
+            *http_server_, *clock_, *http_server_formatter_, "/api/v1/system/http",
+            "http_server_handler", params.http_server.buffer_size,
+            params.http_server.cache_interval));
+        configASSERT(http_server_handler_);
+    }
+
 #ifdef CONFIG_FREERTOS_USE_TRACE_FACILITY
-    system_state_handler_.reset(new (std::nothrow)
-                                    SystemStateHandler(*http_server_, 1024 * 2));
+    system_state_handler_.reset(new (std::nothrow) SystemStateHandler(
+        *http_server_, *clock_, counter_holder, params.system_state,
+        params.system_state_coalesce_interval, cjson_arena_.get()));
     configASSERT(system_state_handler_);
 #endif // CONFIG_FREERTOS_USE_TRACE_FACILITY
 }
@@ -79,6 +167,11 @@ void HttpPipeline::handle_connect() {
 }
 
 void HttpPipeline::handle_disconnect() {
+    // Detached requests should be completed before the server is stopped.
+    if (telemetry_stream_handler_) {
+        telemetry_stream_handler_->stop();
+    }
+
     const auto code = http_server_->stop();
     if (code != status::StatusCode::OK) {
         ocs_loge(log_tag,
@@ -99,6 +192,14 @@ http::Server& HttpPipeline::get_server() {
     return *http_server_;
 }
 
+jsonfmt::TaskSchedulerFormatter& HttpPipeline::get_scheduler_formatter() {
+    return *scheduler_formatter_;
+}
+
+fmt::json::CjsonArena* HttpPipeline::get_cjson_arena() {
+    return cjson_arena_.get();
+}
+
 } // namespace httpserver
 } // namespace pipeline
 } // namespace ocs
@@ -8,14 +8,25 @@
 
 #pragma once
 
+#include "ocs_core/iclock.h"
 #include "ocs_core/noncopyable.h"
+#include "ocs_core/time.h"
+#include "ocs_diagnostic/basic_counter_holder.h"
+#include "ocs_fmt/json/cjson_arena.h"
+#include "ocs_fmt/json/delta_formatter.h"
+#include "ocs_fmt/json/dynamic_formatter.h"
 #include "ocs_fmt/json/fanout_formatter.h"
 #include "ocs_http/server.h"
 #include "ocs_net/fanout_network_handler.h"
 #include "ocs_net/imdns_driver.h"
 #include "ocs_pipeline/httpserver/data_handler.h"
+#include "ocs_pipeline/httpserver/stream_handler.h"
 #include "ocs_pipeline/httpserver/system_handler.h"
+#include "ocs_pipeline/jsonfmt/http_server_formatter.h"
+#include "ocs_pipeline/jsonfmt/task_scheduler_formatter.h"
+#include "ocs_scheduler/async_func_scheduler.h"
 #include "ocs_scheduler/itask.h"
+#include "ocs_scheduler/itask_scheduler.h"
 #include "ocs_system/fanout_suspender.h"
 #include "ocs_system/isuspend_handler.h"
 
@@ -32,21 +43,60 @@ class HttpPipeline : public net::INetworkHandler,
                      public core::NonCopyable<> {
 public:
     struct DataParams {
-        //! Buffer size to hold the formatted JSON data, in bytes.
+        //! Buffer size to hold the formatted JSON data before it's sent, in bytes.
         unsigned buffer_size { 0 };
+
+        //! How long the formatted data can be served from the cache, if its generation
+        //! isn't tracked, e.g. the data contains the system metrics. Zero disables
+        //! caching of such data.
+        core::Time cache_interval { core::Duration::second };
+    };
+
+    struct StreamParams {
+        //! Buffer size used to format the data, the stream is disabled if it's zero.
+        unsigned buffer_size { 0 };
+
+        //! How often to check if the data should be sent to the subscribers.
+        core::Time poll_interval { core::Duration::millisecond * 250 };
+
+        StreamHandler::Params stream;
     };
 
     struct Params {
         DataParams telemetry;
+
+        //! Telemetry stream, available via /api/v1/telemetry/stream.
+        StreamParams telemetry_stream;
+
         DataParams registration;
+
+        //! Task scheduler statistics, disabled if the buffer size is zero.
+        DataParams scheduler;
+
+        //! HTTP server statistics, available via /api/v1/system/http, disabled if the
+        //! buffer size is zero.
+        DataParams http_server;
+
+        //! Buffer to format the system state, available via /api/v1/system/report.
+        fmt::json::DynamicFormatter::Params system_state { 1024 * 2, 1024 * 8, 16 };
+
+        //! How long the formatted system state is served to the subsequent requests.
+        core::Time system_state_coalesce_interval { core::Duration::second };
+
+        //! Size of the arena to allocate the cJSON responses in the HTTP server task,
+        //! in bytes. The arena is disabled if the size is zero.
+        unsigned cjson_arena_size { 1024 * 4 };
     };
 
     //! Initialize.
     HttpPipeline(scheduler::ITask& reboot_task,
+                 scheduler::ITaskScheduler& task_scheduler,
+                 scheduler::AsyncFuncScheduler& func_scheduler,
+                 diagnostic::BasicCounterHolder& counter_holder,
                  system::FanoutSuspender& suspender,
                  net::FanoutNetworkHandler& network_handler,
                  net::IMdnsDriver& mdns_driver,
-                 fmt::json::IFormatter& telemetry_formatter,
+                 fmt::json::FanoutFormatter& telemetry_formatter,
                  fmt::json::FanoutFormatter& registration_formatter,
                  Params params);
 
@@ -65,14 +115,42 @@ public:
     //! Return HTTP server.
     http::Server& get_server();
 
+    //! Return formatter to register task schedulers which statistics are available
+    //! via /api/v1/system/scheduler.
+    //!
+    //! @remarks
+    //!  The schedulers passed to the constructor are registered as "system" and
+    //!  "system_func".
+    jsonfmt::TaskSchedulerFormatter& get_scheduler_formatter();
+
+    //! Return arena to allocate the cJSON responses in the HTTP handlers, or null if
+    //! the arena is disabled.
+    fmt::json::CjsonArena* get_cjson_arena();
+
 private:
     net::IMdnsDriver& mdns_driver_;
 
+    std::unique_ptr<core::IClock> clock_;
+
+    std::unique_ptr<fmt::json::CjsonArena> cjson_arena_;
+    std::unique_ptr<diagnostic::ICounter> cjson_arena_hwm_counter_;
+    std::unique_ptr<diagnostic::ICounter> cjson_arena_fallback_counter_;
+
+    std::unique_ptr<fmt::json::DeltaFormatter> telemetry_delta_formatter_;
+
     std::unique_ptr<http::Server> http_server_;
     std::unique_ptr<DataHandler> telemetry_handler_;
+    std::unique_ptr<diagnostic::ICounter> telemetry_coalesced_counter_;
+    std::unique_ptr<StreamHandler> telemetry_stream_handler_;
     std::unique_ptr<DataHandler> registration_handler_;
     std::unique_ptr<SystemHandler> system_handler_;
 
+    std::unique_ptr<jsonfmt::TaskSchedulerFormatter> scheduler_formatter_;
+    std::unique_ptr<DataHandler> scheduler_handler_;
+
+    std::unique_ptr<jsonfmt::HttpServerFormatter> http_server_formatter_;
+    std::unique_ptr<DataHandler> http_server_handler_;
+
 #ifdef CONFIG_FREERTOS_USE_TRACE_FACILITY
     std::unique_ptr<SystemStateHandler> system_state_handler_;
 #endif // CONFIG_FREERTOS_USE_TRACE_FACILITY
@@ -32,9 +32,13 @@ SHT41Handler::SHT41Handler(scheduler::AsyncFuncScheduler& func_scheduler,
 status::StatusCode
 SHT41Handler::handle_operation_(httpd_req_t* req,
                                 SHT41Handler::HandleOperationFunc func) {
-    auto future = func_scheduler_.add([this, func]() {
-        return func(sensor_);
-    });
+    // Operation is requested by the user, so it shouldn't wait behind the housekeeping,
+    // and shouldn't be performed once the request has timed out.
+    auto future = func_scheduler_.add(
+        [this, func]() {
+            return func(sensor_);
+        },
+        scheduler::AsyncFuncScheduler::Priority::High, wait_op_interval_);
     if (!future) {
         return status::StatusCode::InvalidState;
     }
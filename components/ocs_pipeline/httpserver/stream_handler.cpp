@@ -0,0 +1,385 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <sys/socket.h>
+
+#include "freertos/FreeRTOSConfig.h"
+
+#include "ocs_algo/uri_ops.h"
+#include "ocs_core/istream_writer.h"
+#include "ocs_core/lock_guard.h"
+#include "ocs_core/log.h"
+#include "ocs_fmt/json/stream_writer.h"
+#include "ocs_pipeline/httpserver/stream_handler.h"
+#include "ocs_status/code_to_str.h"
+
+namespace ocs {
+namespace pipeline {
+namespace httpserver {
+
+namespace {
+
+//! Append the data to the event.
+class EventStreamWriter : public core::IStreamWriter, public core::NonCopyable<> {
+public:
+    explicit EventStreamWriter(std::vector<char>& event)
+        : event_(event) {
+    }
+
+    status::StatusCode begin() override {
+        return status::StatusCode::OK;
+    }
+
+    status::StatusCode end() override {
+        return status::StatusCode::OK;
+    }
+
+    status::StatusCode cancel() override {
+        event_.clear();
+
+        return status::StatusCode::OK;
+    }
+
+    status::StatusCode write(const void* data, unsigned size) override {
+        const char* bytes = static_cast<const char*>(data);
+        event_.insert(event_.end(), bytes, bytes + size);
+
+        return status::StatusCode::OK;
+    }
+
+private:
+    std::vector<char>& event_;
+};
+
+const char* event_prefix = "data: ";
+const char* event_suffix = "\n\n";
+const char* chunk_footer = "\r\n";
+
+//! Comment line, to detect the closed connections when there is nothing to send.
+const char* keepalive_event = ":\n\n";
+
+//! Interval after which the keepalive event is sent if there is nothing to send.
+const core::Time keepalive_interval = core::Duration::second * 15;
+
+} // namespace
+
+StreamHandler::StreamHandler(http::Server& server,
+                             core::IClock& clock,
+                             fmt::json::IFormatter& formatter,
+                             const char* path,
+                             const char* id,
+                             unsigned buffer_size,
+                             Params params)
+    : id_(id)
+    , buffer_size_(buffer_size)
+    , params_(params)
+    , clock_(clock)
+    , formatter_(formatter) {
+    configASSERT(params_.max_subscribers);
+
+    buffer_.reset(new (std::nothrow) char[buffer_size_]);
+    configASSERT(buffer_);
+
+    configASSERT(params_.send_timeout);
+
+    subscribers_.reserve(params_.max_subscribers);
+    ready_.reserve(params_.max_subscribers);
+
+    server.add_GET(path, [this](httpd_req_t* req) {
+        return handle_(req);
+    });
+}
+
+StreamHandler::~StreamHandler() {
+    stop();
+}
+
+status::StatusCode StreamHandler::run() {
+    core::LockGuard run_lock(run_mu_);
+
+    const auto now = clock_.now();
+
+    {
+        core::LockGuard lock(mu_);
+
+        for (const auto& subscriber : subscribers_) {
+            ready_.push_back(subscriber.get());
+        }
+    }
+
+    // The subscriber is ready for the next event once the pending one is sent.
+    bool ready = false;
+
+    for (auto* subscriber : ready_) {
+        flush_(*subscriber, now);
+
+        if (ready_to_send_(*subscriber, now)) {
+            ready = true;
+        }
+    }
+
+    auto code = status::StatusCode::OK;
+
+    // Tracked data is formatted only when it's changed, untracked data is formatted
+    // each time one of the subscribers is ready to receive it.
+    const auto generation = formatter_.generation();
+
+    if (ready && (!event_serial_ || !generation || generation != event_generation_)) {
+        // The event is skipped, the subscribers receive the data once it's formatted.
+        code = format_();
+        if (code == status::StatusCode::OK) {
+            event_generation_ = generation;
+        } else {
+            ocs_loge(id_, "failed to format event: code=%s", status::code_to_str(code));
+        }
+    }
+
+    if (ready && code == status::StatusCode::OK) {
+        for (auto* subscriber : ready_) {
+            if (ready_to_send_(*subscriber, now)) {
+                queue_(*subscriber, now);
+                flush_(*subscriber, now);
+            }
+        }
+    }
+
+    remove_closed_();
+
+    return code;
+}
+
+void StreamHandler::stop() {
+    core::LockGuard run_lock(run_mu_);
+    core::LockGuard lock(mu_);
+
+    for (auto& subscriber : subscribers_) {
+        close_(*subscriber);
+    }
+
+    subscribers_.clear();
+}
+
+unsigned StreamHandler::subscriber_count() const {
+    core::LockGuard lock(mu_);
+
+    return subscribers_.size();
+}
+
+status::StatusCode StreamHandler::handle_(httpd_req_t* req) {
+    core::Time interval = params_.interval;
+
+    const auto values = algo::UriOps::parse_query(req->uri);
+
+    if (const auto it = values.find("interval"); it != values.end()) {
+        unsigned interval_ms = 0;
+
+        const auto [_, ec] = std::from_chars(
+            it->second.data(), it->second.data() + it->second.size(), interval_ms);
+        if (ec != std::errc()) {
+            return status::StatusCode::InvalidArg;
+        }
+
+        interval =
+            std::max(params_.min_interval, core::Duration::millisecond * interval_ms);
+    }
+
+    // Subscribers are only added from the HTTP server task, so the limit can't be
+    // exceeded while the stream is being established.
+    if (subscriber_count() == params_.max_subscribers) {
+        auto err = httpd_resp_set_status(req, "503 Service Unavailable");
+        if (err != ESP_OK) {
+            return status::StatusCode::Error;
+        }
+
+        err = httpd_resp_send(req, nullptr, 0);
+        if (err != ESP_OK) {
+            return status::StatusCode::Error;
+        }
+
+        return status::StatusCode::OK;
+    }
+
+    std::unique_ptr<Subscriber> subscriber(new (std::nothrow) Subscriber());
+    if (!subscriber) {
+        return status::StatusCode::NoMem;
+    }
+
+    // Connection is detached from the HTTP server task, so it can handle other
+    // requests, while the events are sent from run().
+    httpd_req_t* async_req = nullptr;
+
+    auto err = httpd_req_async_handler_begin(req, &async_req);
+    if (err != ESP_OK) {
+        ocs_loge(id_, "httpd_req_async_handler_begin(): %s", esp_err_to_name(err));
+
+        return status::StatusCode::Error;
+    }
+
+    subscriber->req = async_req;
+    subscriber->sock = httpd_req_to_sockfd(async_req);
+    subscriber->interval = interval;
+
+    err = httpd_resp_set_type(async_req, "text/event-stream");
+    if (err == ESP_OK) {
+        err = httpd_resp_set_hdr(async_req, "Cache-Control", "no-cache");
+    }
+    if (err == ESP_OK) {
+        // Send headers immediately, so the client knows the stream is established.
+        err = httpd_resp_send_chunk(async_req, keepalive_event, strlen(keepalive_event));
+    }
+    if (err != ESP_OK) {
+        ocs_loge(id_, "failed to establish stream: err=%s", esp_err_to_name(err));
+
+        // Response is owned by the detached request, nothing can be sent to the client.
+        close_(*subscriber);
+
+        return status::StatusCode::OK;
+    }
+
+    core::LockGuard lock(mu_);
+    subscribers_.push_back(std::move(subscriber));
+
+    return status::StatusCode::OK;
+}
+
+status::StatusCode StreamHandler::format_() {
+    // The last event is kept until the new one is formatted successfully, it's sent
+    // to the subscribers that haven't received it yet.
+    next_event_.clear();
+    next_event_.insert(next_event_.end(), event_prefix,
+                       event_prefix + strlen(event_prefix));
+
+    EventStreamWriter event_writer(next_event_);
+    fmt::json::StreamWriter json_writer(event_writer, buffer_.get(), buffer_size_);
+
+    json_writer.begin_object();
+
+    if (const auto code = formatter_.format(json_writer);
+        code != status::StatusCode::OK) {
+        return code;
+    }
+
+    json_writer.end_object();
+
+    if (const auto code = json_writer.flush(); code != status::StatusCode::OK) {
+        return code;
+    }
+
+    next_event_.insert(next_event_.end(), event_suffix,
+                       event_suffix + strlen(event_suffix));
+
+    event_.swap(next_event_);
+    ++event_serial_;
+
+    return status::StatusCode::OK;
+}
+
+bool StreamHandler::ready_to_send_(const Subscriber& subscriber, core::Time now) const {
+    return !subscriber.closed && subscriber.pending.empty()
+        && now - subscriber.sent_ts >= subscriber.interval;
+}
+
+void StreamHandler::queue_(Subscriber& subscriber, core::Time now) {
+    const auto elapsed = now - subscriber.sent_ts;
+    const bool keepalive = subscriber.serial == event_serial_;
+
+    if (keepalive && elapsed < keepalive_interval) {
+        return;
+    }
+
+    const char* data = keepalive ? keepalive_event : event_.data();
+    const size_t size = keepalive ? strlen(keepalive_event) : event_.size();
+
+    // The response headers are sent with httpd_resp_send_chunk(), so the events are
+    // framed as the chunks of the same response.
+    char chunk_header[16];
+    const int header_len = snprintf(chunk_header, sizeof(chunk_header), "%x\r\n",
+                                    static_cast<unsigned>(size));
+
+    auto& pending = subscriber.pending;
+
+    pending.insert(pending.end(), chunk_header, chunk_header + header_len);
+    pending.insert(pending.end(), data, data + size);
+    pending.insert(pending.end(), chunk_footer, chunk_footer + strlen(chunk_footer));
+
+    subscriber.pending_offset = 0;
+    subscriber.serial = event_serial_;
+    subscriber.sent_ts = now;
+}
+
+void StreamHandler::flush_(Subscriber& subscriber, core::Time now) {
+    auto& pending = subscriber.pending;
+
+    while (!subscriber.closed && subscriber.pending_offset < pending.size()) {
+        const int ret = httpd_socket_send(
+            subscriber.req->handle, subscriber.sock,
+            pending.data() + subscriber.pending_offset,
+            pending.size() - subscriber.pending_offset, MSG_DONTWAIT);
+
+        if (ret == HTTPD_SOCK_ERR_TIMEOUT || ret == 0) {
+            // Socket buffer is full, the rest is sent on the next run().
+            if (now - subscriber.sent_ts >= params_.send_timeout) {
+                const unsigned size = pending.size() - subscriber.pending_offset;
+                ocs_logw(id_, "subscriber is too slow: pending=%u", size);
+
+                subscriber.closed = true;
+            }
+
+            return;
+        }
+
+        if (ret < 0) {
+            ocs_logw(id_, "subscriber disconnected: ret=%d", ret);
+
+            subscriber.closed = true;
+
+            return;
+        }
+
+        subscriber.pending_offset += ret;
+    }
+
+    pending.clear();
+    subscriber.pending_offset = 0;
+}
+
+void StreamHandler::remove_closed_() {
+    // Only run() and stop() remove the subscribers, and they don't run concurrently.
+    for (auto* subscriber : ready_) {
+        if (subscriber->closed) {
+            close_(*subscriber);
+        }
+    }
+
+    ready_.clear();
+
+    core::LockGuard lock(mu_);
+
+    subscribers_.erase(std::remove_if(subscribers_.begin(), subscribers_.end(),
+                                      [](const std::unique_ptr<Subscriber>& subscriber) {
+                                          return subscriber->closed;
+                                      }),
+                       subscribers_.end());
+}
+
+void StreamHandler::close_(Subscriber& subscriber) {
+    const auto err = httpd_req_async_handler_complete(subscriber.req);
+    if (err != ESP_OK) {
+        ocs_loge(id_, "httpd_req_async_handler_complete(): %s", esp_err_to_name(err));
+    }
+
+    subscriber.req = nullptr;
+}
+
+} // namespace httpserver
+} // namespace pipeline
+} // namespace ocs
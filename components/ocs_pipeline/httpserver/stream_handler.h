@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "ocs_core/iclock.h"
+#include "ocs_core/noncopyable.h"
+#include "ocs_core/static_mutex.h"
+#include "ocs_core/time.h"
+#include "ocs_fmt/json/iformatter.h"
+#include "ocs_http/server.h"
+#include "ocs_scheduler/itask.h"
+
+namespace ocs {
+namespace pipeline {
+namespace httpserver {
+
+//! Stream the formatted JSON data as Server-Sent Events.
+//!
+//! @notes
+//!  Each request is detached from the HTTP server task with the async request API, and
+//!  the connection is kept open. The data is pushed from run(), which should be called
+//!  periodically: a new event is sent when the generation of the formatted data
+//!  changes, but not more often than the interval requested by the client with the
+//!  "interval" query parameter, in milliseconds. If the generation isn't tracked, the
+//!  event is sent once per interval.
+//!
+//!  The data is formatted once per update and shared between all subscribers. Events
+//!  are sent with the non-blocking socket API, so a slow client never blocks the task
+//!  that calls run(): the part of the event which doesn't fit into the socket buffer is
+//!  kept per subscriber and is sent on the next run(). The following events are dropped
+//!  for that subscriber until the pending one is sent, and it receives the latest data
+//!  afterwards. The subscriber is disconnected if the pending event isn't sent within
+//!  the configured timeout. Sensor tasks are never blocked, since they only update the
+//!  data that is read by the formatter.
+//!
+//!  The send override of the session, e.g. the TLS one, should honor MSG_DONTWAIT.
+//!
+//! @example
+//!  curl "bonsai-firmware.local/api/v1/telemetry/stream?interval=2000"
+class StreamHandler : public scheduler::ITask, public core::NonCopyable<> {
+public:
+    struct Params {
+        //! Maximum number of simultaneously connected clients.
+        unsigned max_subscribers { 2 };
+
+        //! Default interval between events.
+        core::Time interval { core::Duration::second * 5 };
+
+        //! Minimum interval between events the client can request.
+        core::Time min_interval { core::Duration::millisecond * 500 };
+
+        //! Subscriber is disconnected if the event isn't sent within this time.
+        core::Time send_timeout { core::Duration::second * 30 };
+    };
+
+    //! Initialize.
+    //!
+    //! @params
+    //!  - @p server to register the HTTP endpoint.
+    //!  - @p clock to schedule the events.
+    //!  - @p formatter to format the data.
+    //!  - @p path - URI path.
+    //!  - @p id - unique stream ID, to distinguish one stream from another.
+    //!  - @p buffer_size - scratch buffer size used for formatting, in bytes.
+    //!  - @p params to configure the stream.
+    StreamHandler(http::Server& server,
+                  core::IClock& clock,
+                  fmt::json::IFormatter& formatter,
+                  const char* path,
+                  const char* id,
+                  unsigned buffer_size,
+                  Params params);
+
+    //! Close all connections.
+    ~StreamHandler();
+
+    //! Send the data to the subscribers.
+    status::StatusCode run() override;
+
+    //! Close all connections.
+    //!
+    //! @remarks
+    //!  Should be called before the HTTP server is stopped.
+    void stop();
+
+    //! Return the number of connected clients.
+    unsigned subscriber_count() const;
+
+private:
+    struct Subscriber {
+        httpd_req_t* req { nullptr };
+        int sock { -1 };
+        core::Time interval { 0 };
+
+        //! Time when the last event was queued.
+        core::Time sent_ts { 0 };
+
+        //! Serial number of the last queued event.
+        uint32_t serial { 0 };
+
+        //! Chunk of the last queued event, which isn't sent yet.
+        std::vector<char> pending;
+        unsigned pending_offset { 0 };
+
+        //! Connection is lost, the subscriber should be removed.
+        bool closed { false };
+    };
+
+    status::StatusCode handle_(httpd_req_t* req);
+    status::StatusCode format_();
+
+    bool ready_to_send_(const Subscriber& subscriber, core::Time now) const;
+    void queue_(Subscriber& subscriber, core::Time now);
+    void flush_(Subscriber& subscriber, core::Time now);
+    void remove_closed_();
+
+    void close_(Subscriber& subscriber);
+
+    const char* id_ { nullptr };
+    const unsigned buffer_size_ { 0 };
+    const Params params_;
+
+    core::IClock& clock_;
+    fmt::json::IFormatter& formatter_;
+    std::unique_ptr<char[]> buffer_;
+
+    //! Serializes sending the events and removing the subscribers.
+    core::StaticMutex run_mu_;
+
+    //! Protects the list of subscribers. The HTTP server task only adds them, so the
+    //! subscribers can be used from run() without holding the lock.
+    mutable core::StaticMutex mu_;
+    std::vector<std::unique_ptr<Subscriber>> subscribers_;
+
+    //! Subscribers processed by run().
+    std::vector<Subscriber*> ready_;
+
+    //! Last formatted event, shared between all subscribers.
+    std::vector<char> event_;
+    std::vector<char> next_event_;
+    uint32_t event_serial_ { 0 };
+    std::optional<uint32_t> event_generation_;
+};
+
+} // namespace httpserver
+} // namespace pipeline
+} // namespace ocs
@@ -6,6 +6,9 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 
+#include "freertos/FreeRTOSConfig.h"
+
+#include "ocs_diagnostic/func_counter.h"
 #include "ocs_pipeline/httpserver/system_state_handler.h"
 #include "ocs_fmt/json/cjson_builder.h"
 #include "ocs_pipeline/jsonfmt/system_state_formatter.h"
@@ -14,27 +17,57 @@ namespace ocs {
 namespace pipeline {
 namespace httpserver {
 
-SystemStateHandler::SystemStateHandler(http::Server& server, unsigned response_size) {
+SystemStateHandler::SystemStateHandler(http::Server& server,
+                                       core::IClock& clock,
+                                       diagnostic::BasicCounterHolder& counter_holder,
+                                       fmt::json::DynamicFormatter::Params params,
+                                       core::Time coalesce_interval,
+                                       fmt::json::CjsonArena* arena)
+    : coalesce_interval_(coalesce_interval)
+    , clock_(clock) {
     state_json_formatter_.reset(new (std::nothrow) jsonfmt::SystemStateFormatter());
     configASSERT(state_json_formatter_);
 
-    json_formatter_.reset(new (std::nothrow) fmt::json::DynamicFormatter(response_size));
+    json_formatter_.reset(new (std::nothrow) fmt::json::DynamicFormatter(params));
     configASSERT(json_formatter_);
 
-    server.add_GET("/api/v1/system/report", [this](httpd_req_t* req) {
-        auto json = fmt::json::CjsonUniqueBuilder::make_object();
-        if (!json) {
-            return status::StatusCode::NoMem;
-        }
+    max_len_counter_.reset(
+        new (std::nothrow) diagnostic::FuncCounter("c_http_sys_len", [this]() {
+            return json_formatter_->max_len();
+        }));
+    configASSERT(max_len_counter_);
 
-        auto code = state_json_formatter_->format(json.get());
-        if (code != status::StatusCode::OK) {
-            return code;
-        }
+    size_counter_.reset(
+        new (std::nothrow) diagnostic::FuncCounter("c_http_sys_size", [this]() {
+            return json_formatter_->size();
+        }));
+    configASSERT(size_counter_);
+
+    failure_counter_.reset(
+        new (std::nothrow) diagnostic::FuncCounter("c_http_sys_fail", [this]() {
+            return json_formatter_->failure_count();
+        }));
+    configASSERT(failure_counter_);
 
-        code = json_formatter_->format(json.get());
-        if (code != status::StatusCode::OK) {
-            return code;
+    coalesced_counter_.reset(
+        new (std::nothrow) diagnostic::FuncCounter("c_http_sys_coal", [this]() {
+            return coalesced_count_.load();
+        }));
+    configASSERT(coalesced_counter_);
+
+    counter_holder.add(*max_len_counter_);
+    counter_holder.add(*size_counter_);
+    counter_holder.add(*failure_counter_);
+    counter_holder.add(*coalesced_counter_);
+
+    server.add_GET("/api/v1/system/report", [this, arena](httpd_req_t* req) {
+        if (formatted_ && clock_.now() - format_ts_ < coalesce_interval_) {
+            ++coalesced_count_;
+        } else {
+            const auto code = format_(arena);
+            if (code != status::StatusCode::OK) {
+                return code;
+            }
         }
 
         auto err = httpd_resp_set_type(req, HTTPD_TYPE_JSON);
@@ -51,6 +84,32 @@ SystemStateHandler::SystemStateHandler(http::Server& server, unsigned response_s
     });
 }
 
+status::StatusCode SystemStateHandler::format_(fmt::json::CjsonArena* arena) {
+    formatted_ = false;
+
+    fmt::json::CjsonArenaScope scope(arena);
+
+    auto json = fmt::json::CjsonUniqueBuilder::make_object();
+    if (!json) {
+        return status::StatusCode::NoMem;
+    }
+
+    auto code = state_json_formatter_->format(json.get());
+    if (code != status::StatusCode::OK) {
+        return code;
+    }
+
+    code = json_formatter_->format(json.get());
+    if (code != status::StatusCode::OK) {
+        return code;
+    }
+
+    formatted_ = true;
+    format_ts_ = clock_.now();
+
+    return status::StatusCode::OK;
+}
+
 } // namespace httpserver
 } // namespace pipeline
 } // namespace ocs
@@ -8,9 +8,14 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 
+#include "ocs_core/iclock.h"
 #include "ocs_core/noncopyable.h"
+#include "ocs_core/time.h"
+#include "ocs_diagnostic/basic_counter_holder.h"
+#include "ocs_fmt/json/cjson_arena.h"
 #include "ocs_fmt/json/dynamic_formatter.h"
 #include "ocs_http/server.h"
 
@@ -18,18 +23,49 @@ namespace ocs {
 namespace pipeline {
 namespace httpserver {
 
+//! Serve the state of all FreeRTOS tasks.
+//!
+//! @notes
+//!  Collecting the state of all tasks is expensive, so requests received within the
+//!  coalesce interval after the response is formatted are answered with the same
+//!  response. The number of such requests is counted.
 class SystemStateHandler : public core::NonCopyable<> {
 public:
     //! Initialize.
     //!
     //! @params
     //!  - @p server to register endpoint to receive system statistics.
-    //!  - @p response_size - system state response size, in bytes.
-    SystemStateHandler(http::Server& server, unsigned response_size);
+    //!  - @p clock to check if the formatted response can be reused.
+    //!  - @p counter_holder to register counters for the response size.
+    //!  - @p params to configure the response buffer.
+    //!  - @p coalesce_interval - how long the formatted response is reused, zero
+    //!    disables reusing.
+    //!  - @p arena to allocate the JSON response, optional.
+    SystemStateHandler(http::Server& server,
+                       core::IClock& clock,
+                       diagnostic::BasicCounterHolder& counter_holder,
+                       fmt::json::DynamicFormatter::Params params,
+                       core::Time coalesce_interval,
+                       fmt::json::CjsonArena* arena);
 
 private:
+    status::StatusCode format_(fmt::json::CjsonArena* arena);
+
+    const core::Time coalesce_interval_ { 0 };
+
+    core::IClock& clock_;
+
+    bool formatted_ { false };
+    core::Time format_ts_ { 0 };
+    std::atomic<unsigned> coalesced_count_ { 0 };
+
     std::unique_ptr<fmt::json::IFormatter> state_json_formatter_;
     std::unique_ptr<fmt::json::DynamicFormatter> json_formatter_;
+
+    std::unique_ptr<diagnostic::ICounter> max_len_counter_;
+    std::unique_ptr<diagnostic::ICounter> size_counter_;
+    std::unique_ptr<diagnostic::ICounter> failure_counter_;
+    std::unique_ptr<diagnostic::ICounter> coalesced_counter_;
 };
 
 } // namespace httpserver
@@ -7,14 +7,18 @@
  */
 
 #include <cstring>
+#include <dirent.h>
+#include <string>
 #include <string_view>
 
 #include "esp_spiffs.h"
+#include "freertos/FreeRTOSConfig.h"
 
 #include "ocs_core/file_stream_reader.h"
 #include "ocs_core/log.h"
 #include "ocs_http/chunk_stream_writer.h"
 #include "ocs_pipeline/httpserver/web_gui_pipeline.h"
+#include "ocs_status/code_to_str.h"
 
 namespace ocs {
 namespace pipeline {
@@ -54,14 +58,30 @@ const char* parse_content_type(const char* filepath) {
     return "text/plain";
 }
 
+const char* gzip_extension = ".gz";
+
 const char* log_tag = "web_gui_pipeline";
 
 } // namespace
 
-WebGuiPipeline::WebGuiPipeline(http::Server& server) {
+WebGuiPipeline::WebGuiPipeline(http::Server& server)
+    : WebGuiPipeline(server, Params()) {
+}
+
+WebGuiPipeline::WebGuiPipeline(http::Server& server, Params params)
+    : params_(params) {
     buffer_.resize(buffer_size_);
 
+    file_cache_.reset(new (std::nothrow) FileCache(
+        FileCache::Params {
+            .cache_size = params_.cache_size,
+            .max_file_size = params_.max_file_size,
+        },
+        buffer_));
+    configASSERT(file_cache_);
+
     initialize_fs_();
+    initialize_files_();
 
     server.add_GET("/", [this](httpd_req_t* req) {
         return handle_root_(req);
@@ -142,10 +162,140 @@ status::StatusCode WebGuiPipeline::handle_file_(httpd_req_t* req, const char* fi
         return status::StatusCode::InvalidState;
     }
 
-    std::string file_path = mount_point_;
-    file_path += filename;
+    std::string_view path(filename);
+    path = path.substr(0, path.find('?'));
+
+    File* file = file_cache_->use(path);
+    if (!file) {
+        const auto err = httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, nullptr);
+        if (err != ESP_OK) {
+            ocs_loge(log_tag, "httpd_resp_send_err(): %s", esp_err_to_name(err));
+
+            return status::StatusCode::Error;
+        }
+
+        return status::StatusCode::OK;
+    }
+
+    if (etag_match_(req, *file)) {
+        return send_not_modified_(req, *file);
+    }
+
+    if (file_cache_->cacheable(*file)) {
+        std::string file_path = mount_point_;
+        file_path += file->path;
+        file_path += gzip_extension;
+
+        core::FileStreamReader reader(file_path.c_str());
+
+        const auto code = file_cache_->load(*file, reader);
+        if (code != status::StatusCode::OK) {
+            ocs_logw(log_tag, "failed to cache file: path=%s code=%s",
+                     file->path.c_str(), status::code_to_str(code));
+        }
+    }
+
+    if (file->data) {
+        return send_cached_(req, *file);
+    }
+
+    return send_streamed_(req, *file);
+}
+
+void WebGuiPipeline::initialize_files_() {
+    if (!valid_) {
+        return;
+    }
+
+    DIR* dir = opendir(mount_point_);
+    if (!dir) {
+        ocs_loge(log_tag, "opendir(): mount_point=%s", mount_point_);
+
+        return;
+    }
+
+    unsigned file_count = 0;
+
+    // SPIFFS is flat, file names contain the full path without the leading slash.
+    while (const dirent* entry = readdir(dir)) {
+        const std::string_view name(entry->d_name);
+        if (!name.ends_with(gzip_extension)) {
+            continue;
+        }
+
+        std::string path = "/";
+        path += name.substr(0, name.size() - strlen(gzip_extension));
+
+        const bool immutable =
+            params_.immutable_prefix && path.starts_with(params_.immutable_prefix);
+
+        std::string file_path = mount_point_;
+        file_path += "/";
+        file_path += name;
+
+        core::FileStreamReader reader(file_path.c_str());
+
+        const auto code = file_cache_->add(path.c_str(), reader, immutable);
+        if (code != status::StatusCode::OK) {
+            ocs_loge(log_tag, "failed to add file: path=%s code=%s", file_path.c_str(),
+                     status::code_to_str(code));
+
+            continue;
+        }
+
+        ++file_count;
+    }
 
-    auto err = httpd_resp_set_type(req, parse_content_type(file_path.c_str()));
+    closedir(dir);
+
+    ocs_logi(log_tag, "files found: count=%u", file_count);
+}
+
+status::StatusCode WebGuiPipeline::set_headers_(httpd_req_t* req, const File& file) {
+    auto err = httpd_resp_set_hdr(req, "ETag", file.etag);
+    if (err != ESP_OK) {
+        ocs_loge(log_tag, "httpd_resp_set_hdr(): %s", esp_err_to_name(err));
+
+        return status::StatusCode::Error;
+    }
+
+    err = httpd_resp_set_hdr(req, "Cache-Control",
+                             file.immutable ? "public, max-age=31536000, immutable"
+                                            : "no-cache");
+    if (err != ESP_OK) {
+        ocs_loge(log_tag, "httpd_resp_set_hdr(): %s", esp_err_to_name(err));
+
+        return status::StatusCode::Error;
+    }
+
+    return status::StatusCode::OK;
+}
+
+status::StatusCode WebGuiPipeline::send_not_modified_(httpd_req_t* req,
+                                                      const File& file) {
+    auto err = httpd_resp_set_status(req, "304 Not Modified");
+    if (err != ESP_OK) {
+        ocs_loge(log_tag, "httpd_resp_set_status(): %s", esp_err_to_name(err));
+
+        return status::StatusCode::Error;
+    }
+
+    if (const auto code = set_headers_(req, file); code != status::StatusCode::OK) {
+        return code;
+    }
+
+    err = httpd_resp_send(req, nullptr, 0);
+    if (err != ESP_OK) {
+        ocs_loge(log_tag, "httpd_resp_send(): %s", esp_err_to_name(err));
+
+        return status::StatusCode::Error;
+    }
+
+    return status::StatusCode::OK;
+}
+
+status::StatusCode WebGuiPipeline::send_cached_(httpd_req_t* req, const File& file) {
+    auto err = httpd_resp_set_type(req, parse_content_type(file.path.c_str()));
     if (err != ESP_OK) {
         ocs_loge(log_tag, "httpd_resp_set_type(): %s", esp_err_to_name(err));
 
@@ -159,7 +309,42 @@ status::StatusCode WebGuiPipeline::handle_file_(httpd_req_t* req, const char* fi
         return status::StatusCode::Error;
     }
 
-    file_path += ".gz";
+    if (const auto code = set_headers_(req, file); code != status::StatusCode::OK) {
+        return code;
+    }
+
+    err = httpd_resp_send(req, file.data.get(), file.size);
+    if (err != ESP_OK) {
+        ocs_loge(log_tag, "httpd_resp_send(): %s", esp_err_to_name(err));
+
+        return status::StatusCode::Error;
+    }
+
+    return status::StatusCode::OK;
+}
+
+status::StatusCode WebGuiPipeline::send_streamed_(httpd_req_t* req, const File& file) {
+    auto err = httpd_resp_set_type(req, parse_content_type(file.path.c_str()));
+    if (err != ESP_OK) {
+        ocs_loge(log_tag, "httpd_resp_set_type(): %s", esp_err_to_name(err));
+
+        return status::StatusCode::Error;
+    }
+
+    err = httpd_resp_set_hdr(req, "Content-Encoding", "gzip");
+    if (err != ESP_OK) {
+        ocs_loge(log_tag, "httpd_resp_set_hdr(): %s", esp_err_to_name(err));
+
+        return status::StatusCode::Error;
+    }
+
+    if (const auto code = set_headers_(req, file); code != status::StatusCode::OK) {
+        return code;
+    }
+
+    std::string file_path = mount_point_;
+    file_path += file.path;
+    file_path += gzip_extension;
 
     core::FileStreamReader reader(file_path.c_str());
     http::ChunkStreamWriter writer(req);
@@ -168,6 +353,17 @@ status::StatusCode WebGuiPipeline::handle_file_(httpd_req_t* req, const char* fi
     return transceiver.transceive();
 }
 
+bool WebGuiPipeline::etag_match_(httpd_req_t* req, const File& file) {
+    char buf[64];
+
+    // Truncated header isn't matched, which only causes the full response to be sent.
+    if (httpd_req_get_hdr_value_str(req, "If-None-Match", buf, sizeof(buf)) != ESP_OK) {
+        return false;
+    }
+
+    return FileCache::etag_match(file, buf);
+}
+
 } // namespace httpserver
 } // namespace pipeline
 } // namespace ocs
@@ -8,34 +8,78 @@
 
 #pragma once
 
-#include <vector>
+#include <memory>
 
 #include "ocs_core/noncopyable.h"
 #include "ocs_core/stream_transceiver.h"
 #include "ocs_http/server.h"
+#include "ocs_pipeline/httpserver/file_cache.h"
 
 namespace ocs {
 namespace pipeline {
 namespace httpserver {
 
+//! Serve the Web GUI files from SPIFFS.
+//!
+//! @notes
+//!  Files are enumerated once the filesystem is mounted, see FileCache for the ETag
+//!  and the caching of the files in RAM. Requests with the matching If-None-Match are
+//!  answered with 304 Not Modified. Files with the immutable path prefix are sent with
+//!  the immutable Cache-Control, other files should be revalidated by the browser on
+//!  each use. Files which aren't cached are streamed from the filesystem.
 class WebGuiPipeline : public core::NonCopyable<> {
 public:
+    struct Params {
+        //! Maximum total size of the files kept in RAM, in bytes.
+        unsigned cache_size { 64 * 1024 };
+
+        //! Maximum size of a single file kept in RAM, in bytes.
+        unsigned max_file_size { 16 * 1024 };
+
+        //! Path prefix of the files which never change for the same path.
+        //!
+        //! @remarks
+        //!  The Web GUI build puts the content hash into the names of the files in
+        //!  /assets, so the browser can keep them for a year without revalidation.
+        //!  Null means all files are revalidated on each use.
+        const char* immutable_prefix { "/assets/" };
+    };
+
+    //! Initialize with the default parameters.
+    explicit WebGuiPipeline(http::Server& server);
+
     //! Initialize.
     //!
     //! @params
     //!  - @p server to register endpoints to serve the Web GUI files.
-    explicit WebGuiPipeline(http::Server& server);
+    //!  - @p params to configure the file cache.
+    WebGuiPipeline(http::Server& server, Params params);
 
 private:
+    using File = FileCache::File;
+
     void initialize_fs_();
+    void initialize_files_();
+
     status::StatusCode handle_root_(httpd_req_t* req);
     status::StatusCode handle_file_(httpd_req_t* req, const char* filename);
 
+    status::StatusCode set_headers_(httpd_req_t* req, const File& file);
+    status::StatusCode send_not_modified_(httpd_req_t* req, const File& file);
+    status::StatusCode send_cached_(httpd_req_t* req, const File& file);
+    status::StatusCode send_streamed_(httpd_req_t* req, const File& file);
+
+    static bool etag_match_(httpd_req_t* req, const File& file);
+
     static const constexpr char* mount_point_ = "/web_gui";
     static const size_t buffer_size_ = 1024;
 
+    const Params params_;
+
     bool valid_ { false };
     core::StreamTransceiver::Buffer buffer_;
+
+    std::unique_ptr<FileCache> file_cache_;
 };
 
 } // namespace httpserver
@@ -49,6 +49,26 @@ status::StatusCode BME280SensorFormatter::format(cJSON* json) {
     return status::StatusCode::OK;
 }
 
+status::StatusCode BME280SensorFormatter::format(fmt::json::StreamWriter& writer) {
+    const auto data = sensor_.get_data();
+
+    if (flat_formatting_) {
+        writer.add_number("sensor_bme280_pressure", data.pressure);
+        writer.add_number("sensor_bme280_temperature", data.temperature);
+        writer.add_number("sensor_bme280_humidity", data.humidity);
+    } else {
+        writer.add_number("pressure", data.pressure);
+        writer.add_number("temperature", data.temperature);
+        writer.add_number("humidity", data.humidity);
+    }
+
+    return writer.code();
+}
+
+std::optional<uint32_t> BME280SensorFormatter::generation() const {
+    return sensor_.get_generation();
+}
+
 } // namespace jsonfmt
 } // namespace pipeline
 } // namespace ocs
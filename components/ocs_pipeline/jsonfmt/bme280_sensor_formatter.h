@@ -25,6 +25,12 @@ public:
     //! Format bme280 sensor data into @p json.
     status::StatusCode format(cJSON* json) override;
 
+    //! Format bme280 sensor data into @p writer.
+    status::StatusCode format(fmt::json::StreamWriter& writer) override;
+
+    //! Return the generation of the bme280 sensor data.
+    std::optional<uint32_t> generation() const override;
+
 private:
     sensor::bme280::Sensor& sensor_;
 };
@@ -20,7 +20,9 @@ ConsolePipeline::ConsolePipeline(scheduler::ITaskScheduler& task_scheduler,
                                  fmt::json::IFormatter& registration_formatter,
                                  Params params) {
     telemetry_task_.reset(new (std::nothrow) ConsoleTask(
-        telemetry_formatter, "console_telemetry_task", params.telemetry.buffer_size));
+        telemetry_formatter, "console_telemetry_task", params.telemetry.buffer_size,
+        params.telemetry.encoding, params.telemetry.arena_size,
+        params.telemetry.max_buffer_size));
     configASSERT(telemetry_task_);
 
     configASSERT(task_scheduler.add(*telemetry_task_, "console_telemetry",
@@ -29,7 +31,8 @@ ConsolePipeline::ConsolePipeline(scheduler::ITaskScheduler& task_scheduler,
 
     registration_task_.reset(new (std::nothrow) ConsoleTask(
         registration_formatter, "console_registration_task",
-        params.registration.buffer_size));
+        params.registration.buffer_size, params.registration.encoding,
+        params.registration.arena_size, params.registration.max_buffer_size));
     configASSERT(registration_task_);
 
     configASSERT(task_scheduler.add(*registration_task_, "console_registration",
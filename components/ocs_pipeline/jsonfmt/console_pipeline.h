@@ -13,6 +13,7 @@
 #include "ocs_core/noncopyable.h"
 #include "ocs_core/time.h"
 #include "ocs_fmt/json/iformatter.h"
+#include "ocs_fmt/json/stream_writer.h"
 #include "ocs_scheduler/itask_scheduler.h"
 
 namespace ocs {
@@ -28,6 +29,19 @@ public:
 
         //! Buffer size to hold the formatted JSON data, in bytes.
         unsigned buffer_size { 0 };
+
+        //! Maximum size the JSON buffer can grow to, in bytes. The buffer isn't grown
+        //! if the maximum size isn't greater than the buffer size.
+        unsigned max_buffer_size { 0 };
+
+        //! Size of the arena to allocate the cJSON data, in bytes. The data is allocated
+        //! on the heap if the size is zero.
+        unsigned arena_size { 0 };
+
+        //! How to encode the data, CBOR is printed as a hex string.
+        fmt::json::StreamWriter::Encoding encoding {
+            fmt::json::StreamWriter::Encoding::Json
+        };
     };
 
     struct Params {
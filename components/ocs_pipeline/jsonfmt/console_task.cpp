@@ -6,23 +6,93 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 
-#include "ocs_pipeline/jsonfmt/console_task.h"
+#include "ocs_core/istream_writer.h"
 #include "ocs_core/log.h"
+#include "ocs_pipeline/jsonfmt/console_task.h"
 
 namespace ocs {
 namespace pipeline {
 namespace jsonfmt {
 
+namespace {
+
+//! Append the data to the string as hex digits.
+class HexStreamWriter : public core::IStreamWriter, public core::NonCopyable<> {
+public:
+    explicit HexStreamWriter(std::string& str)
+        : str_(str) {
+    }
+
+    status::StatusCode begin() override {
+        str_.clear();
+
+        return status::StatusCode::OK;
+    }
+
+    status::StatusCode end() override {
+        return status::StatusCode::OK;
+    }
+
+    status::StatusCode cancel() override {
+        str_.clear();
+
+        return status::StatusCode::OK;
+    }
+
+    status::StatusCode write(const void* data, unsigned size) override {
+        const char* digits = "0123456789abcdef";
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+
+        for (unsigned n = 0; n < size; ++n) {
+            str_ += digits[bytes[n] >> 4];
+            str_ += digits[bytes[n] & 0xF];
+        }
+
+        return status::StatusCode::OK;
+    }
+
+private:
+    std::string& str_;
+};
+
+} // namespace
+
 ConsoleTask::ConsoleTask(fmt::json::IFormatter& formatter,
                          const char* log_tag,
-                         unsigned buffer_size)
+                         unsigned buffer_size,
+                         fmt::json::StreamWriter::Encoding encoding,
+                         unsigned arena_size,
+                         unsigned max_buffer_size)
     : log_tag_(log_tag)
+    , buffer_size_(buffer_size)
+    , encoding_(encoding)
     , formatter_(formatter) {
-    json_formatter_.reset(new (std::nothrow) fmt::json::DynamicFormatter(buffer_size));
-    configASSERT(json_formatter_);
+    if (encoding_ == fmt::json::StreamWriter::Encoding::Cbor) {
+        buffer_.reset(new (std::nothrow) char[buffer_size_]);
+        configASSERT(buffer_);
+    } else {
+        fmt::json::DynamicFormatter::Params params;
+        params.size = buffer_size_;
+        params.max_size = max_buffer_size;
+        params.shrink_after = 16;
+
+        json_formatter_.reset(new (std::nothrow) fmt::json::DynamicFormatter(params));
+        configASSERT(json_formatter_);
+    }
+
+    if (arena_size) {
+        arena_.reset(new (std::nothrow) fmt::json::CjsonArena(arena_size));
+        configASSERT(arena_);
+    }
 }
 
 status::StatusCode ConsoleTask::run() {
+    if (encoding_ == fmt::json::StreamWriter::Encoding::Cbor) {
+        return run_cbor_();
+    }
+
+    fmt::json::CjsonArenaScope scope(arena_.get());
+
     auto json = fmt::json::CjsonUniqueBuilder::make_object();
     if (!json) {
         return status::StatusCode::NoMem;
@@ -35,6 +105,9 @@ status::StatusCode ConsoleTask::run() {
 
     code = json_formatter_->format(json.get());
     if (code != status::StatusCode::OK) {
+        ocs_logw(log_tag_.c_str(), "failed to format data: size=%u max_len=%u",
+                 json_formatter_->size(), json_formatter_->max_len());
+
         return code;
     }
 
@@ -43,6 +116,33 @@ status::StatusCode ConsoleTask::run() {
     return status::StatusCode::OK;
 }
 
+status::StatusCode ConsoleTask::run_cbor_() {
+    HexStreamWriter hex_writer(hex_);
+
+    if (const auto code = hex_writer.begin(); code != status::StatusCode::OK) {
+        return code;
+    }
+
+    fmt::json::StreamWriter writer(hex_writer, buffer_.get(), buffer_size_,
+                                   fmt::json::StreamWriter::Encoding::Cbor);
+
+    writer.begin_object();
+
+    if (const auto code = formatter_.format(writer); code != status::StatusCode::OK) {
+        return code;
+    }
+
+    writer.end_object();
+
+    if (const auto code = writer.flush(); code != status::StatusCode::OK) {
+        return code;
+    }
+
+    ocs_logi(log_tag_.c_str(), "%s", hex_.c_str());
+
+    return status::StatusCode::OK;
+}
+
 } // namespace jsonfmt
 } // namespace pipeline
 } // namespace ocs
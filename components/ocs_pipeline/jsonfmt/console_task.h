@@ -14,9 +14,11 @@
 #include "freertos/FreeRTOSConfig.h"
 
 #include "ocs_core/noncopyable.h"
+#include "ocs_fmt/json/cjson_arena.h"
 #include "ocs_fmt/json/cjson_builder.h"
 #include "ocs_fmt/json/dynamic_formatter.h"
 #include "ocs_fmt/json/iformatter.h"
+#include "ocs_fmt/json/stream_writer.h"
 #include "ocs_scheduler/itask.h"
 
 namespace ocs {
@@ -32,19 +34,37 @@ public:
     //!  - @p formatter to format an actual data.
     //!  - @p log_tag to distinguish one console task from another.
     //!  - @p buffer_size to hold the formatted JSON data, in bytes.
+    //!  - @p encoding - how to encode the data, CBOR is printed as a hex string.
+    //!  - @p arena_size - size of the arena to allocate the cJSON data, in bytes, the
+    //!    data is allocated on the heap if it's zero.
+    //!  - @p max_buffer_size - maximum size the JSON buffer can grow to, in bytes.
     ConsoleTask(fmt::json::IFormatter& formatter,
                 const char* log_tag,
-                unsigned buffer_size);
+                unsigned buffer_size,
+                fmt::json::StreamWriter::Encoding encoding =
+                    fmt::json::StreamWriter::Encoding::Json,
+                unsigned arena_size = 0,
+                unsigned max_buffer_size = 0);
 
     //! Write data to the console.
     status::StatusCode run() override;
 
 private:
+    status::StatusCode run_cbor_();
+
     const std::string log_tag_;
+    const unsigned buffer_size_ { 0 };
+    const fmt::json::StreamWriter::Encoding encoding_ {
+        fmt::json::StreamWriter::Encoding::Json
+    };
 
     fmt::json::IFormatter& formatter_;
 
     std::unique_ptr<fmt::json::DynamicFormatter> json_formatter_;
+    std::unique_ptr<fmt::json::CjsonArena> arena_;
+
+    std::unique_ptr<char[]> buffer_;
+    std::string hex_;
 };
 
 } // namespace jsonfmt
@@ -25,6 +25,17 @@ status::StatusCode CounterFormatter::format(cJSON* json) {
     return status::StatusCode::OK;
 }
 
+status::StatusCode CounterFormatter::format(fmt::json::StreamWriter& writer) {
+    for (auto& counter : get_counters_()) {
+        const auto code = writer.add_number(counter->id(), counter->get());
+        if (code != status::StatusCode::OK) {
+            return code;
+        }
+    }
+
+    return status::StatusCode::OK;
+}
+
 } // namespace jsonfmt
 } // namespace pipeline
 } // namespace ocs
@@ -22,6 +22,9 @@ class CounterFormatter : public fmt::json::IFormatter,
 public:
     //! Format the underlying counters into @p json.
     status::StatusCode format(cJSON* json) override;
+
+    //! Format the underlying counters into @p writer.
+    status::StatusCode format(fmt::json::StreamWriter& writer) override;
 };
 
 } // namespace jsonfmt
@@ -25,7 +25,7 @@ DataPipeline::DataPipeline(core::IClock& clock,
     registration_formatter_.reset(new (std::nothrow) RegistrationFormatter(device_info));
     configASSERT(registration_formatter_);
 
-    system_counter_storage_ = storage_builder.make("system_counter");
+    system_counter_storage_ = storage_builder.make_cached("system_counter");
     configASSERT(system_counter_storage_);
 
     counter_formatter_.reset(new (std::nothrow) CounterFormatter());
@@ -36,6 +36,23 @@ DataPipeline::DataPipeline(core::IClock& clock,
         *counter_formatter_));
     configASSERT(system_counter_pipeline_);
 
+    // Persistent counters write the storage on reboot, so it's flushed after them.
+    reboot_handler.add(*system_counter_storage_);
+
+    configASSERT(task_scheduler.add(*system_counter_storage_,
+                                    "system_counter_storage_task",
+                                    core::Duration::minute * 10)
+                 == status::StatusCode::OK);
+
+    system_counter_storage_counter_.reset(
+        new (std::nothrow) diagnostic::FuncCounter("c_sys_stor_skip", [this]() {
+            return system_counter_storage_->write_count()
+                - system_counter_storage_->commit_count();
+        }));
+    configASSERT(system_counter_storage_counter_);
+
+    counter_formatter_->add(*system_counter_storage_counter_);
+
     telemetry_formatter_->get_fanout_formatter().add(*counter_formatter_);
 }
 
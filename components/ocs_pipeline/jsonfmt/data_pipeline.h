@@ -11,6 +11,7 @@
 #include <memory>
 
 #include "ocs_core/iclock.h"
+#include "ocs_diagnostic/func_counter.h"
 #include "ocs_fmt/json/fanout_formatter.h"
 #include "ocs_pipeline/basic/system_counter_pipeline.h"
 #include "ocs_pipeline/jsonfmt/counter_formatter.h"
@@ -42,9 +43,10 @@ private:
     std::unique_ptr<TelemetryFormatter> telemetry_formatter_;
     std::unique_ptr<RegistrationFormatter> registration_formatter_;
 
-    std::unique_ptr<storage::IStorage> system_counter_storage_;
+    std::unique_ptr<storage::CachingStorage> system_counter_storage_;
     std::unique_ptr<CounterFormatter> counter_formatter_;
     std::unique_ptr<basic::SystemCounterPipeline> system_counter_pipeline_;
+    std::unique_ptr<diagnostic::ICounter> system_counter_storage_counter_;
 };
 
 } // namespace jsonfmt
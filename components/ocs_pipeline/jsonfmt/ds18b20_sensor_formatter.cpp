@@ -27,6 +27,10 @@ status::StatusCode DS18B20SensorFormatter::format(cJSON* json) {
     return status::StatusCode::OK;
 }
 
+std::optional<uint32_t> DS18B20SensorFormatter::generation() const {
+    return sensor_.get_generation();
+}
+
 } // namespace jsonfmt
 } // namespace pipeline
 } // namespace ocs
@@ -29,6 +29,9 @@ public:
     //! Format DS18B20 sensor data into @p json.
     status::StatusCode format(cJSON* json) override;
 
+    //! Return the generation of the DS18B20 sensor data.
+    std::optional<uint32_t> generation() const override;
+
 private:
     sensor::ds18b20::Sensor& sensor_;
 };
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "ocs_fmt/json/cjson_array_formatter.h"
+#include "ocs_fmt/json/cjson_builder.h"
+#include "ocs_fmt/json/cjson_object_formatter.h"
+#include "ocs_pipeline/jsonfmt/http_server_formatter.h"
+
+namespace ocs {
+namespace pipeline {
+namespace jsonfmt {
+
+namespace {
+
+status::StatusCode format_route_profile(fmt::json::CjsonObjectFormatter& formatter,
+                                        const http::RouteProfiler& profiler,
+                                        const http::RouteProfiler::Profile& profile) {
+    if (!formatter.add_string_cs("path", profiler.path())) {
+        return status::StatusCode::NoMem;
+    }
+
+    if (!formatter.add_number_cs("request_count", profile.request_count)) {
+        return status::StatusCode::NoMem;
+    }
+
+    if (!formatter.add_number_cs("in_flight", profile.in_flight)) {
+        return status::StatusCode::NoMem;
+    }
+
+    if (!formatter.add_number_cs("status_2xx", profile.status_2xx)) {
+        return status::StatusCode::NoMem;
+    }
+
+    if (!formatter.add_number_cs("status_3xx", profile.status_3xx)) {
+        return status::StatusCode::NoMem;
+    }
+
+    if (!formatter.add_number_cs("status_4xx", profile.status_4xx)) {
+        return status::StatusCode::NoMem;
+    }
+
+    if (!formatter.add_number_cs("status_5xx", profile.status_5xx)) {
+        return status::StatusCode::NoMem;
+    }
+
+    if (!formatter.add_number_cs("send_failure_count", profile.send_failure_count)) {
+        return status::StatusCode::NoMem;
+    }
+
+    if (!formatter.add_number_cs("bytes_sent", profile.bytes_sent)) {
+        return status::StatusCode::NoMem;
+    }
+
+    if (!formatter.add_number_cs("time_last", profile.time_last)) {
+        return status::StatusCode::NoMem;
+    }
+
+    if (!formatter.add_number_cs("time_max", profile.time_max)) {
+        return status::StatusCode::NoMem;
+    }
+
+    return status::StatusCode::OK;
+}
+
+status::StatusCode format_route_histogram(cJSON* json,
+                                          const http::RouteProfiler::Profile& profile) {
+    auto array = cJSON_AddArrayToObject(json, "histogram");
+    if (!array) {
+        return status::StatusCode::NoMem;
+    }
+
+    fmt::json::CjsonArrayFormatter formatter(array);
+
+    for (const auto& count : profile.histogram) {
+        if (!formatter.append_uint32(count)) {
+            return status::StatusCode::NoMem;
+        }
+    }
+
+    return status::StatusCode::OK;
+}
+
+} // namespace
+
+HttpServerFormatter::HttpServerFormatter(http::Server& server)
+    : server_(server) {
+}
+
+status::StatusCode HttpServerFormatter::format(cJSON* json) {
+    auto array = cJSON_AddArrayToObject(json, "routes");
+    if (!array) {
+        return status::StatusCode::NoMem;
+    }
+
+    for (const auto& profiler : server_.profilers()) {
+        auto item = fmt::json::CjsonUniqueBuilder::make_object();
+        if (!item) {
+            return status::StatusCode::NoMem;
+        }
+
+        const auto profile = profiler->get();
+
+        fmt::json::CjsonObjectFormatter formatter(item.get());
+
+        auto code = format_route_profile(formatter, *profiler, profile);
+        if (code != status::StatusCode::OK) {
+            return code;
+        }
+
+        code = format_route_histogram(item.get(), profile);
+        if (code != status::StatusCode::OK) {
+            return code;
+        }
+
+        if (!cJSON_AddItemToArray(array, item.get())) {
+            return status::StatusCode::NoMem;
+        }
+
+        item.release();
+    }
+
+    return status::StatusCode::OK;
+}
+
+status::StatusCode HttpServerFormatter::format(fmt::json::StreamWriter& writer) {
+    writer.key("routes");
+    writer.begin_array();
+
+    for (const auto& profiler : server_.profilers()) {
+        const auto profile = profiler->get();
+
+        writer.begin_object();
+
+        writer.add_string("path", profiler->path());
+        writer.add_number("request_count", profile.request_count);
+        writer.add_number("in_flight", profile.in_flight);
+        writer.add_number("status_2xx", profile.status_2xx);
+        writer.add_number("status_3xx", profile.status_3xx);
+        writer.add_number("status_4xx", profile.status_4xx);
+        writer.add_number("status_5xx", profile.status_5xx);
+        writer.add_number("send_failure_count", profile.send_failure_count);
+        writer.add_number("bytes_sent", profile.bytes_sent);
+        writer.add_number("time_last", profile.time_last);
+        writer.add_number("time_max", profile.time_max);
+
+        writer.key("histogram");
+        writer.begin_array();
+
+        for (const auto& count : profile.histogram) {
+            writer.number(count);
+        }
+
+        writer.end_array();
+        writer.end_object();
+    }
+
+    writer.end_array();
+
+    return writer.code();
+}
+
+} // namespace jsonfmt
+} // namespace pipeline
+} // namespace ocs
@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "ocs_core/noncopyable.h"
+#include "ocs_fmt/json/iformatter.h"
+#include "ocs_http/server.h"
+
+namespace ocs {
+namespace pipeline {
+namespace jsonfmt {
+
+//! Format request statistics of all routes of the HTTP server.
+class HttpServerFormatter : public fmt::json::IFormatter, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    explicit HttpServerFormatter(http::Server& server);
+
+    //! Format the statistics of all routes into @p json.
+    status::StatusCode format(cJSON* json) override;
+
+    //! Format the statistics of all routes into @p writer.
+    status::StatusCode format(fmt::json::StreamWriter& writer) override;
+
+private:
+    http::Server& server_;
+};
+
+} // namespace jsonfmt
+} // namespace pipeline
+} // namespace ocs
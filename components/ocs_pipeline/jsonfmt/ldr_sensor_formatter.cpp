@@ -52,6 +52,26 @@ status::StatusCode LdrSensorFormatter::format(cJSON* json) {
     return status::StatusCode::OK;
 }
 
+status::StatusCode LdrSensorFormatter::format(fmt::json::StreamWriter& writer) {
+    const auto data = sensor_.get_data();
+
+    if (flat_formatting_) {
+        writer.add_number("sensor_ldr_raw", data.raw);
+        writer.add_number("sensor_ldr_voltage", data.voltage);
+        writer.add_number("sensor_ldr_lightness", data.lightness);
+    } else {
+        writer.add_number("raw", data.raw);
+        writer.add_number("voltage", data.voltage);
+        writer.add_number("lightness", data.lightness);
+    }
+
+    return writer.code();
+}
+
+std::optional<uint32_t> LdrSensorFormatter::generation() const {
+    return sensor_.get_generation();
+}
+
 } // namespace jsonfmt
 } // namespace pipeline
 } // namespace ocs
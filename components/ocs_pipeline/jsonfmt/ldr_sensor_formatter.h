@@ -24,6 +24,12 @@ public:
     //! Format LDR sensor data into @p json.
     status::StatusCode format(cJSON* json) override;
 
+    //! Format LDR sensor data into @p writer.
+    status::StatusCode format(fmt::json::StreamWriter& writer) override;
+
+    //! Return the generation of the LDR sensor data.
+    std::optional<uint32_t> generation() const override;
+
 private:
     sensor::ldr::Sensor& sensor_;
 };
@@ -48,6 +48,14 @@ status::StatusCode RegistrationFormatter::format(cJSON* json) {
     return fanout_formatter_->format(json);
 }
 
+status::StatusCode RegistrationFormatter::format(fmt::json::StreamWriter& writer) {
+    return fanout_formatter_->format(writer);
+}
+
+std::optional<uint32_t> RegistrationFormatter::generation() const {
+    return fanout_formatter_->generation();
+}
+
 fmt::json::FanoutFormatter& RegistrationFormatter::get_fanout_formatter() {
     return *fanout_formatter_;
 }
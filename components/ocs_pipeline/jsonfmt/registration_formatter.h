@@ -28,6 +28,12 @@ public:
     //! Format the underlying data into @p json.
     status::StatusCode format(cJSON* json) override;
 
+    //! Format the underlying data into @p writer.
+    status::StatusCode format(fmt::json::StreamWriter& writer) override;
+
+    //! Return the generation of the underlying data.
+    std::optional<uint32_t> generation() const override;
+
     fmt::json::FanoutFormatter& get_fanout_formatter();
 
 private:
@@ -53,6 +53,26 @@ status::StatusCode SHT41SensorFormatter::format(cJSON* json) {
     return status::StatusCode::OK;
 }
 
+status::StatusCode SHT41SensorFormatter::format(fmt::json::StreamWriter& writer) {
+    const auto data = sensor_.get_data();
+
+    if (flat_formatting_) {
+        writer.add_number("sensor_sht41_humidity", data.humidity);
+        writer.add_number("sensor_sht41_temperature", data.temperature);
+        writer.add_number("sensor_sht41_heating_count", data.heating_count);
+    } else {
+        writer.add_number("humidity", data.humidity);
+        writer.add_number("temperature", data.temperature);
+        writer.add_number("heating_count", data.heating_count);
+    }
+
+    return writer.code();
+}
+
+std::optional<uint32_t> SHT41SensorFormatter::generation() const {
+    return sensor_.get_generation();
+}
+
 } // namespace jsonfmt
 } // namespace pipeline
 } // namespace ocs
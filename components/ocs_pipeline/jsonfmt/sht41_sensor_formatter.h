@@ -25,6 +25,12 @@ public:
     //! Format SHT41 sensor data into @p json.
     status::StatusCode format(cJSON* json) override;
 
+    //! Format SHT41 sensor data into @p writer.
+    status::StatusCode format(fmt::json::StreamWriter& writer) override;
+
+    //! Return the generation of the SHT41 sensor data.
+    std::optional<uint32_t> generation() const override;
+
 private:
     sensor::sht41::Sensor& sensor_;
 };
@@ -118,6 +118,10 @@ status::StatusCode SoilAnalogSensorFormatter::format(cJSON* json) {
     return status::StatusCode::OK;
 }
 
+std::optional<uint32_t> SoilAnalogSensorFormatter::generation() const {
+    return sensor_.get_generation();
+}
+
 } // namespace jsonfmt
 } // namespace pipeline
 } // namespace ocs
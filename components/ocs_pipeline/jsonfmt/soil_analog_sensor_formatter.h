@@ -26,6 +26,9 @@ public:
     //! Format soil sensor data into @p json.
     status::StatusCode format(cJSON* json) override;
 
+    //! Return the generation of the soil sensor data.
+    std::optional<uint32_t> generation() const override;
+
 private:
     sensor::soil::AnalogSensor& sensor_;
 };
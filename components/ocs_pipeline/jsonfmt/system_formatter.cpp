@@ -41,6 +41,16 @@ status::StatusCode SystemFormatter::format(cJSON* json) {
     return status::StatusCode::OK;
 }
 
+status::StatusCode SystemFormatter::format(fmt::json::StreamWriter& writer) {
+    writer.add_number("system_memory_heap", esp_get_free_heap_size());
+    writer.add_number("system_memory_heap_min", esp_get_minimum_free_heap_size());
+    writer.add_number("system_memory_heap_internal", esp_get_free_internal_heap_size());
+    writer.add_string("system_reset_reason",
+                      system::reset_reason_to_str(esp_reset_reason()));
+
+    return writer.code();
+}
+
 } // namespace jsonfmt
 } // namespace pipeline
 } // namespace ocs
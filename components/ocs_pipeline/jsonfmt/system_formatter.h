@@ -19,6 +19,9 @@ class SystemFormatter : public fmt::json::IFormatter, public core::NonCopyable<>
 public:
     //! Format system metrics into @p json.
     status::StatusCode format(cJSON* json) override;
+
+    //! Format system metrics into @p writer.
+    status::StatusCode format(fmt::json::StreamWriter& writer) override;
 };
 
 } // namespace jsonfmt
@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "ocs_fmt/json/cjson_array_formatter.h"
+#include "ocs_fmt/json/cjson_builder.h"
+#include "ocs_fmt/json/cjson_object_formatter.h"
+#include "ocs_pipeline/jsonfmt/task_scheduler_formatter.h"
+
+namespace ocs {
+namespace pipeline {
+namespace jsonfmt {
+
+namespace {
+
+status::StatusCode format_task_profile(fmt::json::CjsonObjectFormatter& formatter,
+                                       const scheduler::TaskProfiler& profiler,
+                                       const scheduler::TaskProfiler::Profile& profile) {
+    if (!formatter.add_string_cs("id", profiler.id())) {
+        return status::StatusCode::NoMem;
+    }
+
+    if (!formatter.add_number_cs("interval", profiler.interval())) {
+        return status::StatusCode::NoMem;
+    }
+
+    if (!formatter.add_number_cs("run_count", profile.run_count)) {
+        return status::StatusCode::NoMem;
+    }
+
+    if (!formatter.add_number_cs("failure_count", profile.failure_count)) {
+        return status::StatusCode::NoMem;
+    }
+
+    if (!formatter.add_number_cs("time_last", profile.time_last)) {
+        return status::StatusCode::NoMem;
+    }
+
+    if (!formatter.add_number_cs("time_min", profile.time_min)) {
+        return status::StatusCode::NoMem;
+    }
+
+    if (!formatter.add_number_cs("time_max", profile.time_max)) {
+        return status::StatusCode::NoMem;
+    }
+
+    if (!formatter.add_number_cs("time_mean", profile.time_mean)) {
+        return status::StatusCode::NoMem;
+    }
+
+    if (!formatter.add_number_cs("jitter_last", profile.jitter_last)) {
+        return status::StatusCode::NoMem;
+    }
+
+    if (!formatter.add_number_cs("jitter_max", profile.jitter_max)) {
+        return status::StatusCode::NoMem;
+    }
+
+    return status::StatusCode::OK;
+}
+
+status::StatusCode
+format_task_histogram(cJSON* json, const scheduler::TaskProfiler::Profile& profile) {
+    auto array = cJSON_AddArrayToObject(json, "histogram");
+    if (!array) {
+        return status::StatusCode::NoMem;
+    }
+
+    fmt::json::CjsonArrayFormatter formatter(array);
+
+    for (const auto& count : profile.histogram) {
+        if (!formatter.append_uint32(count)) {
+            return status::StatusCode::NoMem;
+        }
+    }
+
+    return status::StatusCode::OK;
+}
+
+status::StatusCode
+format_lane_stats(cJSON* json,
+                  const char* key,
+                  const scheduler::AsyncFuncScheduler::LaneStats& stats) {
+    auto object = cJSON_AddObjectToObject(json, key);
+    if (!object) {
+        return status::StatusCode::NoMem;
+    }
+
+    fmt::json::CjsonObjectFormatter formatter(object);
+
+    if (!formatter.add_number_cs("depth", stats.depth)) {
+        return status::StatusCode::NoMem;
+    }
+
+    if (!formatter.add_number_cs("depth_max", stats.depth_max)) {
+        return status::StatusCode::NoMem;
+    }
+
+    if (!formatter.add_number_cs("run_count", stats.run_count)) {
+        return status::StatusCode::NoMem;
+    }
+
+    if (!formatter.add_number_cs("drop_count", stats.drop_count)) {
+        return status::StatusCode::NoMem;
+    }
+
+    if (!formatter.add_number_cs("expire_count", stats.expire_count)) {
+        return status::StatusCode::NoMem;
+    }
+
+    if (!formatter.add_number_cs("wait_last", stats.wait_last)) {
+        return status::StatusCode::NoMem;
+    }
+
+    if (!formatter.add_number_cs("wait_max", stats.wait_max)) {
+        return status::StatusCode::NoMem;
+    }
+
+    return status::StatusCode::OK;
+}
+
+} // namespace
+
+void TaskSchedulerFormatter::add(scheduler::ITaskScheduler& scheduler, const char* id) {
+    schedulers_.emplace_back(id, &scheduler);
+}
+
+void TaskSchedulerFormatter::add(scheduler::AsyncFuncScheduler& scheduler,
+                                 const char* id) {
+    func_schedulers_.emplace_back(id, &scheduler);
+}
+
+void TaskSchedulerFormatter::add(const scheduler::AdaptiveDelayEstimator& estimator,
+                                 const char* id) {
+    estimators_.emplace_back(id, &estimator);
+}
+
+status::StatusCode TaskSchedulerFormatter::format(cJSON* json) {
+    auto code = format_task_schedulers_(json);
+    if (code != status::StatusCode::OK) {
+        return code;
+    }
+
+    code = format_func_schedulers_(json);
+    if (code != status::StatusCode::OK) {
+        return code;
+    }
+
+    return format_estimators_(json);
+}
+
+status::StatusCode TaskSchedulerFormatter::format_task_schedulers_(cJSON* json) {
+    fmt::json::CjsonUniqueBuilder builder;
+
+    for (const auto& [id, scheduler] : schedulers_) {
+        auto array = cJSON_AddArrayToObject(json, id.c_str());
+        if (!array) {
+            return status::StatusCode::NoMem;
+        }
+
+        for (const auto& profiler : scheduler->profilers()) {
+            auto task_json = builder.make_object();
+            if (!task_json) {
+                return status::StatusCode::NoMem;
+            }
+
+            const auto profile = profiler->get();
+
+            fmt::json::CjsonObjectFormatter formatter(task_json.get());
+
+            auto code = format_task_profile(formatter, *profiler, profile);
+            if (code != status::StatusCode::OK) {
+                return code;
+            }
+
+            code = format_task_histogram(task_json.get(), profile);
+            if (code != status::StatusCode::OK) {
+                return code;
+            }
+
+            if (!cJSON_AddItemToArray(array, task_json.get())) {
+                return status::StatusCode::NoMem;
+            }
+
+            task_json.release();
+        }
+    }
+
+    return status::StatusCode::OK;
+}
+
+status::StatusCode TaskSchedulerFormatter::format_func_schedulers_(cJSON* json) {
+    using Priority = scheduler::AsyncFuncScheduler::Priority;
+
+    for (const auto& [id, scheduler] : func_schedulers_) {
+        auto object = cJSON_AddObjectToObject(json, id.c_str());
+        if (!object) {
+            return status::StatusCode::NoMem;
+        }
+
+        auto code =
+            format_lane_stats(object, "high", scheduler->get_stats(Priority::High));
+        if (code != status::StatusCode::OK) {
+            return code;
+        }
+
+        code =
+            format_lane_stats(object, "normal", scheduler->get_stats(Priority::Normal));
+        if (code != status::StatusCode::OK) {
+            return code;
+        }
+
+        code = format_lane_stats(object, "low", scheduler->get_stats(Priority::Low));
+        if (code != status::StatusCode::OK) {
+            return code;
+        }
+    }
+
+    return status::StatusCode::OK;
+}
+
+status::StatusCode TaskSchedulerFormatter::format_estimators_(cJSON* json) {
+    for (const auto& [id, estimator] : estimators_) {
+        auto object = cJSON_AddObjectToObject(json, id.c_str());
+        if (!object) {
+            return status::StatusCode::NoMem;
+        }
+
+        fmt::json::CjsonObjectFormatter formatter(object);
+
+        if (!formatter.add_number_cs("overrun_count", estimator->overrun_count())) {
+            return status::StatusCode::NoMem;
+        }
+    }
+
+    return status::StatusCode::OK;
+}
+
+} // namespace jsonfmt
+} // namespace pipeline
+} // namespace ocs
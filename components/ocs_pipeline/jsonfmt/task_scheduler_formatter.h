@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ocs_core/noncopyable.h"
+#include "ocs_fmt/json/iformatter.h"
+#include "ocs_scheduler/adaptive_delay_estimator.h"
+#include "ocs_scheduler/async_func_scheduler.h"
+#include "ocs_scheduler/itask_scheduler.h"
+
+namespace ocs {
+namespace pipeline {
+namespace jsonfmt {
+
+//! Format execution statistics of the scheduled tasks.
+class TaskSchedulerFormatter : public fmt::json::IFormatter, public core::NonCopyable<> {
+public:
+    //! Add @p scheduler, which tasks are formatted under the @p id key.
+    void add(scheduler::ITaskScheduler& scheduler, const char* id);
+
+    //! Add @p scheduler, which lanes are formatted under the @p id key.
+    void add(scheduler::AsyncFuncScheduler& scheduler, const char* id);
+
+    //! Add @p estimator, which statistics are formatted under the @p id key.
+    void add(const scheduler::AdaptiveDelayEstimator& estimator, const char* id);
+
+    //! Format the statistics of all tasks of all schedulers into @p json.
+    status::StatusCode format(cJSON* json) override;
+
+private:
+    using SchedulerList = std::vector<std::pair<std::string, scheduler::ITaskScheduler*>>;
+    using FuncSchedulerList =
+        std::vector<std::pair<std::string, scheduler::AsyncFuncScheduler*>>;
+    using EstimatorList =
+        std::vector<std::pair<std::string, const scheduler::AdaptiveDelayEstimator*>>;
+
+    status::StatusCode format_task_schedulers_(cJSON* json);
+    status::StatusCode format_func_schedulers_(cJSON* json);
+    status::StatusCode format_estimators_(cJSON* json);
+
+    SchedulerList schedulers_;
+    FuncSchedulerList func_schedulers_;
+    EstimatorList estimators_;
+};
+
+} // namespace jsonfmt
+} // namespace pipeline
+} // namespace ocs
@@ -29,6 +29,14 @@ status::StatusCode TelemetryFormatter::format(cJSON* json) {
     return fanout_formatter_->format(json);
 }
 
+status::StatusCode TelemetryFormatter::format(fmt::json::StreamWriter& writer) {
+    return fanout_formatter_->format(writer);
+}
+
+std::optional<uint32_t> TelemetryFormatter::generation() const {
+    return fanout_formatter_->generation();
+}
+
 fmt::json::FanoutFormatter& TelemetryFormatter::get_fanout_formatter() {
     return *fanout_formatter_;
 }
@@ -24,7 +24,13 @@ public:
     TelemetryFormatter();
 
     //! Format all telemetry data into @p json.
-    status::StatusCode format(cJSON* json);
+    status::StatusCode format(cJSON* json) override;
+
+    //! Format all telemetry data into @p writer.
+    status::StatusCode format(fmt::json::StreamWriter& writer) override;
+
+    //! Return the generation of the underlying data.
+    std::optional<uint32_t> generation() const override;
 
     fmt::json::FanoutFormatter& get_fanout_formatter();
 
@@ -0,0 +1,594 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <cstring>
+#include <optional>
+#include <string>
+
+#include "unity.h"
+
+#include "ocs_core/noncopyable.h"
+#include "ocs_fmt/json/delta_formatter.h"
+#include "ocs_fmt/json/fanout_formatter.h"
+#include "ocs_fmt/json/iformatter.h"
+#include "ocs_fmt/json/stream_writer.h"
+#include "ocs_pipeline/httpserver/data_handler.h"
+#include "ocs_pipeline/test/test_http_server.h"
+#include "ocs_test/test_clock.h"
+
+#ifdef CONFIG_OCS_TEST_UNIT_WIFI_STA_ENABLED
+#include "esp_http_client.h"
+#endif // CONFIG_OCS_TEST_UNIT_WIFI_STA_ENABLED
+
+namespace ocs {
+namespace pipeline {
+namespace httpserver {
+
+#ifdef CONFIG_OCS_TEST_UNIT_WIFI_STA_ENABLED
+namespace {
+
+const char* test_path = "/data";
+const unsigned test_buffer_size = 64;
+const uint32_t test_epoch = 42;
+
+struct TestFormatter : public fmt::json::IFormatter, public core::NonCopyable<> {
+    status::StatusCode format(cJSON* json) override {
+        ++format_count;
+
+        if (code != status::StatusCode::OK) {
+            return code;
+        }
+
+        if (!cJSON_AddNumberToObject(json, "value", value)) {
+            return status::StatusCode::NoMem;
+        }
+
+        return status::StatusCode::OK;
+    }
+
+    status::StatusCode format(fmt::json::StreamWriter& writer) override {
+        ++format_count;
+
+        if (code != status::StatusCode::OK) {
+            return code;
+        }
+
+        return writer.add_number("value", value);
+    }
+
+    std::optional<uint32_t> generation() const override {
+        return gen;
+    }
+
+    std::optional<uint32_t> gen;
+    double value { 0 };
+    unsigned format_count { 0 };
+    status::StatusCode code { status::StatusCode::OK };
+};
+
+//! Fail once the part of the response larger than the buffer is formatted.
+struct TruncatingFormatter : public fmt::json::IFormatter, public core::NonCopyable<> {
+    status::StatusCode format(cJSON* json) override {
+        return status::StatusCode::Error;
+    }
+
+    status::StatusCode format(fmt::json::StreamWriter& writer) override {
+        for (unsigned n = 0; n < test_buffer_size; ++n) {
+            const std::string key = "value_" + std::to_string(n);
+
+            if (const auto code = writer.add_number(key.c_str(), n);
+                code != status::StatusCode::OK) {
+                return code;
+            }
+        }
+
+        return fail ? status::StatusCode::Error : status::StatusCode::OK;
+    }
+
+    std::optional<uint32_t> generation() const override {
+        return 1;
+    }
+
+    bool fail { true };
+};
+
+struct TestResponse {
+    esp_err_t err { ESP_OK };
+    bool complete { false };
+    int status { 0 };
+    std::string body;
+    std::string etag;
+    std::string vary;
+    std::string content_type;
+};
+
+class TestClient : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //!
+    //! @params
+    //!  - @p host - server address.
+    //!  - @p query - optional URI query, without the leading '?'.
+    explicit TestClient(const char* host, const char* query = nullptr)
+        : host_(host)
+        , query_(query ? query : "") {
+    }
+
+    //! Send GET request with the optional If-None-Match and Accept headers.
+    TestResponse get(const char* if_none_match = nullptr, const char* accept = nullptr) {
+        const auto response = perform(if_none_match, accept);
+        TEST_ASSERT_EQUAL(ESP_OK, response.err);
+
+        return response;
+    }
+
+    //! Send GET request, the response can be incomplete.
+    TestResponse perform(const char* if_none_match = nullptr,
+                         const char* accept = nullptr) {
+        response_ = TestResponse();
+
+        esp_http_client_config_t config;
+        memset(&config, 0, sizeof(config));
+
+        config.host = host_.c_str();
+        config.path = test_path;
+        config.query = query_.empty() ? nullptr : query_.c_str();
+        config.transport_type = HTTP_TRANSPORT_OVER_TCP;
+        config.event_handler = handle_event_;
+        config.user_data = this;
+
+        esp_http_client_handle_t client = esp_http_client_init(&config);
+        TEST_ASSERT_NOT_NULL(client);
+
+        if (if_none_match) {
+            TEST_ASSERT_EQUAL(ESP_OK,
+                              esp_http_client_set_header(client, "If-None-Match",
+                                                         if_none_match));
+        }
+        if (accept) {
+            TEST_ASSERT_EQUAL(ESP_OK,
+                              esp_http_client_set_header(client, "Accept", accept));
+        }
+
+        response_.err = esp_http_client_perform(client);
+        response_.status = esp_http_client_get_status_code(client);
+        response_.complete = esp_http_client_is_complete_data_received(client);
+
+        TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_cleanup(client));
+
+        return response_;
+    }
+
+private:
+    static esp_err_t handle_event_(esp_http_client_event_t* event) {
+        TestClient& self = *static_cast<TestClient*>(event->user_data);
+
+        switch (event->event_id) {
+        case HTTP_EVENT_ON_HEADER:
+            if (!strcasecmp(event->header_key, "ETag")) {
+                self.response_.etag = event->header_value;
+            } else if (!strcasecmp(event->header_key, "Vary")) {
+                self.response_.vary = event->header_value;
+            } else if (!strcasecmp(event->header_key, "Content-Type")) {
+                self.response_.content_type = event->header_value;
+            }
+            break;
+
+        case HTTP_EVENT_ON_DATA:
+            self.response_.body.append(static_cast<const char*>(event->data),
+                                       event->data_len);
+            break;
+
+        default:
+            break;
+        }
+
+        return ESP_OK;
+    }
+
+    const std::string host_;
+    const std::string query_;
+
+    TestResponse response_;
+};
+
+} // namespace
+
+TEST_CASE("Data handler: not modified if generation isn't changed",
+          "[ocs_pipeline], [data_handler]") {
+    TestHttpServer test_server;
+    test::TestClock clock;
+
+    TestFormatter formatter;
+    formatter.gen = 1;
+    formatter.value = 1;
+
+    DataHandler handler(test_server.server(), clock, formatter, test_path, "test",
+                        test_buffer_size, core::Duration::second);
+
+    TestClient client(test_server.start().c_str());
+
+    const auto response1 = client.get();
+    TEST_ASSERT_EQUAL(200, response1.status);
+    TEST_ASSERT_EQUAL_STRING("{\"value\":1}", response1.body.c_str());
+    TEST_ASSERT_EQUAL_STRING("application/json", response1.content_type.c_str());
+    TEST_ASSERT_EQUAL_STRING("Accept", response1.vary.c_str());
+    TEST_ASSERT_FALSE(response1.etag.empty());
+    TEST_ASSERT_EQUAL(1, formatter.format_count);
+
+    // Generation is tracked, cache interval isn't taken into account.
+    clock.value += core::Duration::hour;
+
+    const auto response2 = client.get(response1.etag.c_str());
+    TEST_ASSERT_EQUAL(304, response2.status);
+    TEST_ASSERT_TRUE(response2.body.empty());
+    TEST_ASSERT_EQUAL_STRING(response1.etag.c_str(), response2.etag.c_str());
+    TEST_ASSERT_EQUAL_STRING("Accept", response2.vary.c_str());
+    TEST_ASSERT_EQUAL(1, formatter.format_count);
+
+    // Cached response is sent if ETag doesn't match.
+    const auto response3 = client.get("\"foo\"");
+    TEST_ASSERT_EQUAL(200, response3.status);
+    TEST_ASSERT_EQUAL_STRING(response1.body.c_str(), response3.body.c_str());
+    TEST_ASSERT_EQUAL_STRING(response1.etag.c_str(), response3.etag.c_str());
+    TEST_ASSERT_EQUAL(1, formatter.format_count);
+}
+
+TEST_CASE("Data handler: new ETag if generation is changed",
+          "[ocs_pipeline], [data_handler]") {
+    TestHttpServer test_server;
+    test::TestClock clock;
+
+    TestFormatter formatter;
+    formatter.gen = 1;
+    formatter.value = 1;
+
+    DataHandler handler(test_server.server(), clock, formatter, test_path, "test",
+                        test_buffer_size, core::Duration::second);
+
+    TestClient client(test_server.start().c_str());
+
+    const auto response1 = client.get();
+    TEST_ASSERT_EQUAL(200, response1.status);
+    TEST_ASSERT_FALSE(response1.etag.empty());
+
+    formatter.gen = 2;
+    formatter.value = 2;
+
+    const auto response2 = client.get(response1.etag.c_str());
+    TEST_ASSERT_EQUAL(200, response2.status);
+    TEST_ASSERT_EQUAL_STRING("{\"value\":2}", response2.body.c_str());
+    TEST_ASSERT_FALSE(response2.etag.empty());
+    TEST_ASSERT_TRUE(response1.etag != response2.etag);
+    TEST_ASSERT_EQUAL(2, formatter.format_count);
+
+    const auto response3 = client.get(response2.etag.c_str());
+    TEST_ASSERT_EQUAL(304, response3.status);
+    TEST_ASSERT_EQUAL(2, formatter.format_count);
+}
+
+TEST_CASE("Data handler: cache interval if generation isn't tracked",
+          "[ocs_pipeline], [data_handler]") {
+    TestHttpServer test_server;
+    test::TestClock clock;
+
+    TestFormatter formatter;
+
+    DataHandler handler(test_server.server(), clock, formatter, test_path, "test",
+                        test_buffer_size, core::Duration::second);
+
+    TestClient client(test_server.start().c_str());
+
+    const auto response1 = client.get();
+    TEST_ASSERT_EQUAL(200, response1.status);
+    TEST_ASSERT_FALSE(response1.etag.empty());
+    TEST_ASSERT_EQUAL(1, formatter.format_count);
+
+    clock.value += core::Duration::millisecond * 500;
+
+    const auto response2 = client.get(response1.etag.c_str());
+    TEST_ASSERT_EQUAL(304, response2.status);
+    TEST_ASSERT_EQUAL(1, formatter.format_count);
+
+    clock.value += core::Duration::millisecond * 500;
+
+    const auto response3 = client.get(response1.etag.c_str());
+    TEST_ASSERT_EQUAL(200, response3.status);
+    TEST_ASSERT_FALSE(response3.etag.empty());
+    TEST_ASSERT_TRUE(response1.etag != response3.etag);
+    TEST_ASSERT_EQUAL(2, formatter.format_count);
+}
+
+TEST_CASE("Data handler: no caching if generation isn't tracked and interval is zero",
+          "[ocs_pipeline], [data_handler]") {
+    TestHttpServer test_server;
+    test::TestClock clock;
+
+    TestFormatter formatter;
+
+    DataHandler handler(test_server.server(), clock, formatter, test_path, "test",
+                        test_buffer_size, 0);
+
+    TestClient client(test_server.start().c_str());
+
+    for (unsigned n = 1; n <= 3; ++n) {
+        const auto response = client.get("*");
+        TEST_ASSERT_EQUAL(200, response.status);
+        TEST_ASSERT_TRUE(response.etag.empty());
+        TEST_ASSERT_EQUAL_STRING("Accept", response.vary.c_str());
+        TEST_ASSERT_EQUAL(n, formatter.format_count);
+    }
+}
+
+TEST_CASE("Data handler: cache depends on encoding", "[ocs_pipeline], [data_handler]") {
+    TestHttpServer test_server;
+    test::TestClock clock;
+
+    TestFormatter formatter;
+    formatter.gen = 1;
+    formatter.value = 1;
+
+    DataHandler handler(test_server.server(), clock, formatter, test_path, "test",
+                        test_buffer_size, core::Duration::second);
+
+    TestClient client(test_server.start().c_str());
+
+    const auto response1 = client.get();
+    TEST_ASSERT_EQUAL(200, response1.status);
+    TEST_ASSERT_EQUAL_STRING("application/json", response1.content_type.c_str());
+    TEST_ASSERT_EQUAL(1, formatter.format_count);
+
+    // Cached JSON response can't be used for the CBOR request.
+    const auto response2 = client.get(response1.etag.c_str(), "application/cbor");
+    TEST_ASSERT_EQUAL(200, response2.status);
+    TEST_ASSERT_EQUAL_STRING("application/cbor", response2.content_type.c_str());
+    TEST_ASSERT_EQUAL_STRING("Accept", response2.vary.c_str());
+    TEST_ASSERT_TRUE(response1.etag != response2.etag);
+    TEST_ASSERT_EQUAL(2, formatter.format_count);
+
+    // {"value": 1}
+    const std::string want_body("\xbf\x65value\x01\xff", 8);
+    TEST_ASSERT_TRUE(want_body == response2.body);
+
+    const auto response3 = client.get(response2.etag.c_str(), "application/cbor");
+    TEST_ASSERT_EQUAL(304, response3.status);
+    TEST_ASSERT_EQUAL(2, formatter.format_count);
+}
+
+TEST_CASE("Data handler: formatting error", "[ocs_pipeline], [data_handler]") {
+    TestHttpServer test_server;
+    test::TestClock clock;
+
+    TestFormatter formatter;
+    formatter.gen = 1;
+    formatter.code = status::StatusCode::Error;
+
+    DataHandler handler(test_server.server(), clock, formatter, test_path, "test",
+                        test_buffer_size, core::Duration::second);
+
+    TestClient client(test_server.start().c_str());
+
+    // Failed response isn't cached.
+    for (unsigned n = 1; n <= 2; ++n) {
+        const auto response = client.get();
+        TEST_ASSERT_EQUAL(500, response.status);
+        TEST_ASSERT_TRUE(response.etag.empty());
+        TEST_ASSERT_EQUAL(n, formatter.format_count);
+    }
+
+    formatter.code = status::StatusCode::OK;
+
+    const auto response1 = client.get();
+    TEST_ASSERT_EQUAL(200, response1.status);
+    TEST_ASSERT_FALSE(response1.etag.empty());
+    TEST_ASSERT_EQUAL(3, formatter.format_count);
+
+    const auto response2 = client.get(response1.etag.c_str());
+    TEST_ASSERT_EQUAL(304, response2.status);
+    TEST_ASSERT_EQUAL(3, formatter.format_count);
+}
+
+TEST_CASE("Data handler: abort connection on formatting error after first chunk",
+          "[ocs_pipeline], [data_handler]") {
+    TestHttpServer test_server;
+    test::TestClock clock;
+
+    TruncatingFormatter formatter;
+
+    DataHandler handler(test_server.server(), clock, formatter, test_path, "test",
+                        test_buffer_size, core::Duration::second);
+
+    TestClient client(test_server.start().c_str());
+
+    // Terminating chunk isn't sent, so the truncated body doesn't look complete.
+    const auto response1 = client.perform();
+    TEST_ASSERT_FALSE(response1.complete);
+    TEST_ASSERT_FALSE(response1.body.empty());
+    TEST_ASSERT_NULL(strstr(response1.body.c_str(), "\"value_63\""));
+
+    // Truncated response isn't cached.
+    formatter.fail = false;
+
+    const auto response2 = client.get();
+    TEST_ASSERT_TRUE(response2.complete);
+    TEST_ASSERT_EQUAL(200, response2.status);
+    TEST_ASSERT_FALSE(response2.etag.empty());
+    TEST_ASSERT_NOT_NULL(strstr(response2.body.c_str(), "\"value_63\""));
+
+    const auto response3 = client.get(response2.etag.c_str());
+    TEST_ASSERT_EQUAL(304, response3.status);
+}
+
+TEST_CASE("Data handler: count coalesced requests", "[ocs_pipeline], [data_handler]") {
+    TestHttpServer test_server;
+    test::TestClock clock;
+
+    TestFormatter formatter;
+    formatter.value = 1;
+
+    DataHandler handler(test_server.server(), clock, formatter, test_path, "test",
+                        test_buffer_size, core::Duration::second);
+
+    TestClient client(test_server.start().c_str());
+
+    const auto response1 = client.get();
+    TEST_ASSERT_EQUAL(200, response1.status);
+    TEST_ASSERT_EQUAL(1, formatter.format_count);
+    TEST_ASSERT_EQUAL(0, handler.coalesced_count());
+
+    // Within the cache interval, both the cached and the not modified responses are
+    // coalesced.
+    clock.value += core::Duration::millisecond * 500;
+
+    const auto response2 = client.get();
+    TEST_ASSERT_EQUAL(200, response2.status);
+    TEST_ASSERT_EQUAL_STRING(response1.body.c_str(), response2.body.c_str());
+    TEST_ASSERT_EQUAL(1, handler.coalesced_count());
+
+    const auto response3 = client.get(response1.etag.c_str());
+    TEST_ASSERT_EQUAL(304, response3.status);
+    TEST_ASSERT_EQUAL(2, handler.coalesced_count());
+    TEST_ASSERT_EQUAL(1, formatter.format_count);
+
+    // Re-formatted once the cache interval is expired.
+    clock.value += core::Duration::millisecond * 500;
+
+    const auto response4 = client.get(response1.etag.c_str());
+    TEST_ASSERT_EQUAL(200, response4.status);
+    TEST_ASSERT_EQUAL(2, formatter.format_count);
+    TEST_ASSERT_EQUAL(2, handler.coalesced_count());
+
+    // Different encoding isn't served from the cache.
+    const auto response5 = client.get(nullptr, "application/cbor");
+    TEST_ASSERT_EQUAL(200, response5.status);
+    TEST_ASSERT_EQUAL(3, formatter.format_count);
+    TEST_ASSERT_EQUAL(2, handler.coalesced_count());
+
+    const auto response6 = client.get(nullptr, "application/cbor");
+    TEST_ASSERT_EQUAL(200, response6.status);
+    TEST_ASSERT_EQUAL(3, formatter.format_count);
+    TEST_ASSERT_EQUAL(3, handler.coalesced_count());
+}
+
+TEST_CASE("Data handler: delta", "[ocs_pipeline], [data_handler]") {
+    TestHttpServer test_server;
+    test::TestClock clock;
+
+    TestFormatter formatter;
+    formatter.gen = 1;
+    formatter.value = 1;
+
+    fmt::json::FanoutFormatter fanout_formatter;
+    fanout_formatter.add(formatter);
+
+    fmt::json::DeltaFormatter delta_formatter(fanout_formatter, test_epoch);
+
+    DataHandler handler(test_server.server(), clock, fanout_formatter, test_path, "test",
+                        test_buffer_size, core::Duration::second, &delta_formatter);
+
+    const std::string host = test_server.start();
+
+    const auto response1 = TestClient(host.c_str(), "since=0").get();
+    TEST_ASSERT_EQUAL(200, response1.status);
+    TEST_ASSERT_EQUAL_STRING("{\"value\":1,\"epoch\":42,\"seq\":1}",
+                             response1.body.c_str());
+    TEST_ASSERT_TRUE(response1.etag.empty());
+
+    const auto response2 = TestClient(host.c_str(), "since=42-1").get();
+    TEST_ASSERT_EQUAL(200, response2.status);
+    TEST_ASSERT_EQUAL_STRING("{\"epoch\":42,\"seq\":1}", response2.body.c_str());
+
+    formatter.gen = 2;
+    formatter.value = 2;
+
+    const auto response3 = TestClient(host.c_str(), "since=42-1").get();
+    TEST_ASSERT_EQUAL(200, response3.status);
+    TEST_ASSERT_EQUAL_STRING("{\"value\":2,\"epoch\":42,\"seq\":2}",
+                             response3.body.c_str());
+
+    // Sequence of the previous boot, or without the epoch.
+    for (const auto query : { "since=7-1", "since=1" }) {
+        const auto response = TestClient(host.c_str(), query).get();
+        TEST_ASSERT_EQUAL(200, response.status);
+        TEST_ASSERT_EQUAL_STRING("{\"value\":2,\"epoch\":42,\"seq\":2}",
+                                 response.body.c_str());
+    }
+}
+
+TEST_CASE("Data handler: delta: invalid sequence", "[ocs_pipeline], [data_handler]") {
+    TestHttpServer test_server;
+    test::TestClock clock;
+
+    TestFormatter formatter;
+    formatter.gen = 1;
+
+    fmt::json::FanoutFormatter fanout_formatter;
+    fanout_formatter.add(formatter);
+
+    fmt::json::DeltaFormatter delta_formatter(fanout_formatter, test_epoch);
+
+    DataHandler handler(test_server.server(), clock, fanout_formatter, test_path, "test",
+                        test_buffer_size, core::Duration::second, &delta_formatter);
+
+    const std::string host = test_server.start();
+
+    const char* queries[] = {
+        "since=1.5",
+        "since=abc",
+        "since=1abc",
+        "since=-1",
+        "since=99999999999",
+        "since=42-",
+        "since=42-1-1",
+        "since=42-abc",
+        "since=99999999999-1",
+    };
+
+    for (const auto query : queries) {
+        const auto response = TestClient(host.c_str(), query).get();
+        TEST_ASSERT_EQUAL(400, response.status);
+    }
+
+    TEST_ASSERT_EQUAL(0, formatter.format_count);
+}
+
+TEST_CASE("Data handler: delta: formatting error", "[ocs_pipeline], [data_handler]") {
+    TestHttpServer test_server;
+    test::TestClock clock;
+
+    TestFormatter formatter;
+    formatter.gen = 1;
+    formatter.value = 1;
+    formatter.code = status::StatusCode::Error;
+
+    fmt::json::FanoutFormatter fanout_formatter;
+    fanout_formatter.add(formatter);
+
+    fmt::json::DeltaFormatter delta_formatter(fanout_formatter, test_epoch);
+
+    DataHandler handler(test_server.server(), clock, fanout_formatter, test_path, "test",
+                        test_buffer_size, core::Duration::second, &delta_formatter);
+
+    const std::string host = test_server.start();
+
+    const auto response1 = TestClient(host.c_str(), "since=0").get();
+    TEST_ASSERT_EQUAL(500, response1.status);
+    TEST_ASSERT_EQUAL(0, delta_formatter.sequence());
+
+    formatter.code = status::StatusCode::OK;
+
+    const auto response2 = TestClient(host.c_str(), "since=0").get();
+    TEST_ASSERT_EQUAL(200, response2.status);
+    TEST_ASSERT_EQUAL_STRING("{\"value\":1,\"epoch\":42,\"seq\":1}",
+                             response2.body.c_str());
+}
+#endif // CONFIG_OCS_TEST_UNIT_WIFI_STA_ENABLED
+
+} // namespace httpserver
+} // namespace pipeline
+} // namespace ocs
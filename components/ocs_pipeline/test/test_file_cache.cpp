@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "esp_rom_crc.h"
+#include "unity.h"
+
+#include "ocs_core/noncopyable.h"
+#include "ocs_pipeline/httpserver/file_cache.h"
+
+namespace ocs {
+namespace pipeline {
+namespace httpserver {
+
+namespace {
+
+class TestStreamReader : public core::IStreamReader, public core::NonCopyable<> {
+public:
+    explicit TestStreamReader(const std::string& data)
+        : data_(data) {
+    }
+
+    status::StatusCode begin() override {
+        pos_ = 0;
+        return status::StatusCode::OK;
+    }
+
+    status::StatusCode end() override {
+        return status::StatusCode::OK;
+    }
+
+    status::StatusCode cancel() override {
+        pos_ = 0;
+        return status::StatusCode::OK;
+    }
+
+    status::StatusCode read(void* data, unsigned& size) override {
+        if (pos_ == data_.size()) {
+            return status::StatusCode::NoData;
+        }
+
+        size = std::min<unsigned>(size, data_.size() - pos_);
+        memcpy(data, data_.data() + pos_, size);
+        pos_ += size;
+
+        return status::StatusCode::OK;
+    }
+
+private:
+    const std::string data_;
+    unsigned pos_ { 0 };
+};
+
+void add_file(FileCache& cache, const char* path, const std::string& data) {
+    TestStreamReader reader(data);
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, cache.add(path, reader, false));
+}
+
+FileCache::File* use_file(FileCache& cache, const char* path, const std::string& data) {
+    FileCache::File* file = cache.use(path);
+    TEST_ASSERT_NOT_NULL(file);
+
+    if (cache.cacheable(*file)) {
+        TestStreamReader reader(data);
+        TEST_ASSERT_EQUAL(status::StatusCode::OK, cache.load(*file, reader));
+    }
+
+    return file;
+}
+
+} // namespace
+
+TEST_CASE("File cache: find file", "[ocs_pipeline], [file_cache]") {
+    std::vector<uint8_t> buffer(8);
+    FileCache cache(FileCache::Params(), buffer);
+
+    add_file(cache, "/index.html", "<html></html>");
+    add_file(cache, "/assets/index.js", "console.log()");
+    add_file(cache, "/favicon.ico", "icon");
+
+    TestStreamReader reader("icon");
+    TEST_ASSERT_EQUAL(status::StatusCode::InvalidArg,
+                      cache.add("/favicon.ico", reader, false));
+
+    for (const char* path : { "/index.html", "/assets/index.js", "/favicon.ico" }) {
+        FileCache::File* file = cache.use(path);
+        TEST_ASSERT_NOT_NULL(file);
+        TEST_ASSERT_EQUAL_STRING(path, file->path.c_str());
+        TEST_ASSERT_NULL(file->data);
+    }
+
+    TEST_ASSERT_NULL(cache.use("/index"));
+    TEST_ASSERT_NULL(cache.use("/missing.html"));
+    TEST_ASSERT_NULL(cache.use(""));
+    TEST_ASSERT_EQUAL(0, cache.cached_size());
+}
+
+TEST_CASE("File cache: ETag from CRC32 and size", "[ocs_pipeline], [file_cache]") {
+    const std::string data = "The quick brown fox jumps over the lazy dog";
+
+    // Read in several chunks.
+    std::vector<uint8_t> buffer(7);
+    FileCache cache(FileCache::Params(), buffer);
+
+    add_file(cache, "/a.js", data);
+    add_file(cache, "/b.js", data);
+    add_file(cache, "/c.js", data + ".");
+
+    const uint32_t crc = esp_rom_crc32_le(
+        0, reinterpret_cast<const uint8_t*>(data.data()), data.size());
+
+    char etag[24];
+    snprintf(etag, sizeof(etag), "\"%08" PRIx32 "-%x\"", crc, data.size());
+
+    const FileCache::File* file_a = cache.use("/a.js");
+    TEST_ASSERT_NOT_NULL(file_a);
+    TEST_ASSERT_EQUAL(data.size(), file_a->size);
+    TEST_ASSERT_EQUAL_STRING(etag, file_a->etag);
+
+    // Same content, same ETag.
+    const FileCache::File* file_b = cache.use("/b.js");
+    TEST_ASSERT_NOT_NULL(file_b);
+    TEST_ASSERT_EQUAL_STRING(file_a->etag, file_b->etag);
+
+    const FileCache::File* file_c = cache.use("/c.js");
+    TEST_ASSERT_NOT_NULL(file_c);
+    TEST_ASSERT_TRUE(strcmp(file_a->etag, file_c->etag) != 0);
+}
+
+TEST_CASE("File cache: match If-None-Match", "[ocs_pipeline], [file_cache]") {
+    std::vector<uint8_t> buffer(8);
+    FileCache cache(FileCache::Params(), buffer);
+
+    add_file(cache, "/index.html", "<html></html>");
+
+    const FileCache::File* file = cache.use("/index.html");
+    TEST_ASSERT_NOT_NULL(file);
+
+    const std::string etag = file->etag;
+
+    TEST_ASSERT_TRUE(FileCache::etag_match(*file, etag.c_str()));
+    TEST_ASSERT_TRUE(FileCache::etag_match(*file, ("W/" + etag).c_str()));
+    TEST_ASSERT_TRUE(
+        FileCache::etag_match(*file, ("\"00000000-1\", " + etag).c_str()));
+    TEST_ASSERT_TRUE(FileCache::etag_match(*file, "*"));
+
+    TEST_ASSERT_FALSE(FileCache::etag_match(*file, ""));
+    TEST_ASSERT_FALSE(FileCache::etag_match(*file, "\"00000000-1\""));
+    TEST_ASSERT_FALSE(
+        FileCache::etag_match(*file, etag.substr(0, etag.size() - 1).c_str()));
+}
+
+TEST_CASE("File cache: evict least recently used files", "[ocs_pipeline], [file_cache]") {
+    const std::string data_a(40, 'a');
+    const std::string data_b(40, 'b');
+    const std::string data_c(40, 'c');
+
+    std::vector<uint8_t> buffer(16);
+    FileCache cache(
+        FileCache::Params {
+            .cache_size = 100,
+            .max_file_size = 60,
+        },
+        buffer);
+
+    add_file(cache, "/a.js", data_a);
+    add_file(cache, "/b.js", data_b);
+    add_file(cache, "/c.js", data_c);
+
+    FileCache::File* file_a = use_file(cache, "/a.js", data_a);
+    FileCache::File* file_b = use_file(cache, "/b.js", data_b);
+
+    TEST_ASSERT_NOT_NULL(file_a->data);
+    TEST_ASSERT_NOT_NULL(file_b->data);
+    TEST_ASSERT_EQUAL(80, cache.cached_size());
+    TEST_ASSERT_EQUAL(0, memcmp(data_a.data(), file_a->data.get(), data_a.size()));
+
+    // Cached file isn't loaded again, but becomes the most recently used one.
+    TEST_ASSERT_EQUAL_PTR(file_a, use_file(cache, "/a.js", data_a));
+    TEST_ASSERT_FALSE(cache.cacheable(*file_a));
+
+    FileCache::File* file_c = use_file(cache, "/c.js", data_c);
+
+    TEST_ASSERT_NOT_NULL(file_a->data);
+    TEST_ASSERT_NULL(file_b->data);
+    TEST_ASSERT_NOT_NULL(file_c->data);
+    TEST_ASSERT_EQUAL(80, cache.cached_size());
+    TEST_ASSERT_EQUAL(0, memcmp(data_c.data(), file_c->data.get(), data_c.size()));
+
+    // Evicted file is loaded again.
+    TEST_ASSERT_TRUE(cache.cacheable(*file_b));
+    use_file(cache, "/b.js", data_b);
+
+    TEST_ASSERT_NULL(file_a->data);
+    TEST_ASSERT_NOT_NULL(file_b->data);
+    TEST_ASSERT_NOT_NULL(file_c->data);
+    TEST_ASSERT_EQUAL(80, cache.cached_size());
+}
+
+TEST_CASE("File cache: large files aren't cached", "[ocs_pipeline], [file_cache]") {
+    const std::string small_data(40, 's');
+    const std::string large_data(80, 'l');
+
+    std::vector<uint8_t> buffer(16);
+    FileCache cache(
+        FileCache::Params {
+            .cache_size = 100,
+            .max_file_size = 60,
+        },
+        buffer);
+
+    add_file(cache, "/small.js", small_data);
+    add_file(cache, "/large.js", large_data);
+    add_file(cache, "/empty.js", "");
+
+    FileCache::File* small_file = use_file(cache, "/small.js", small_data);
+    TEST_ASSERT_NOT_NULL(small_file->data);
+
+    FileCache::File* large_file = cache.use("/large.js");
+    TEST_ASSERT_NOT_NULL(large_file);
+    TEST_ASSERT_FALSE(cache.cacheable(*large_file));
+
+    FileCache::File* empty_file = cache.use("/empty.js");
+    TEST_ASSERT_NOT_NULL(empty_file);
+    TEST_ASSERT_FALSE(cache.cacheable(*empty_file));
+
+    // Cached files aren't evicted.
+    TEST_ASSERT_NOT_NULL(small_file->data);
+    TEST_ASSERT_EQUAL(40, cache.cached_size());
+}
+
+TEST_CASE("File cache: file changed since added", "[ocs_pipeline], [file_cache]") {
+    std::vector<uint8_t> buffer(16);
+    FileCache cache(FileCache::Params(), buffer);
+
+    add_file(cache, "/index.html", std::string(20, 'x'));
+
+    FileCache::File* file = cache.use("/index.html");
+    TEST_ASSERT_NOT_NULL(file);
+
+    TestStreamReader longer_reader(std::string(30, 'x'));
+    TEST_ASSERT_EQUAL(status::StatusCode::InvalidState, cache.load(*file, longer_reader));
+    TEST_ASSERT_NULL(file->data);
+
+    TestStreamReader shorter_reader(std::string(10, 'x'));
+    TEST_ASSERT_EQUAL(status::StatusCode::InvalidState,
+                      cache.load(*file, shorter_reader));
+    TEST_ASSERT_NULL(file->data);
+
+    TEST_ASSERT_EQUAL(0, cache.cached_size());
+}
+
+} // namespace httpserver
+} // namespace pipeline
+} // namespace ocs
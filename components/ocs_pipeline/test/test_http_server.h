@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#ifdef CONFIG_OCS_TEST_UNIT_WIFI_STA_ENABLED
+#include <string>
+
+#include "unity.h"
+
+#include "ocs_core/noncopyable.h"
+#include "ocs_http/server.h"
+#include "ocs_net/fanout_network_handler.h"
+#include "ocs_net/ip_addr_to_str.h"
+#include "ocs_net/sta_network.h"
+#include "ocs_storage/flash_initializer.h"
+
+namespace ocs {
+namespace pipeline {
+namespace httpserver {
+
+//! Connect to WiFi and serve HTTP requests.
+class TestHttpServer : public core::NonCopyable<> {
+public:
+    TestHttpServer()
+        : network_(handler_,
+                   net::StaNetwork::Params {
+                       .max_retry_count = 1,
+                       .ssid = CONFIG_OCS_TEST_UNIT_WIFI_STA_SSID,
+                       .password = CONFIG_OCS_TEST_UNIT_WIFI_STA_PASSWORD,
+                   })
+        , server_(http::Server::Params {}) {
+    }
+
+    ~TestHttpServer() {
+        TEST_ASSERT_EQUAL(status::StatusCode::OK, server_.stop());
+        TEST_ASSERT_EQUAL(status::StatusCode::OK, network_.stop());
+    }
+
+    //! Return the server to register the endpoints, before it's started.
+    http::Server& server() {
+        return server_;
+    }
+
+    //! Start the server and return the IP address of the device.
+    std::string start() {
+        TEST_ASSERT_EQUAL(status::StatusCode::OK, network_.start());
+        TEST_ASSERT_EQUAL(status::StatusCode::OK, network_.wait());
+        TEST_ASSERT_EQUAL(status::StatusCode::OK, server_.start());
+
+        net::ip_addr_to_str ip_addr_str(network_.get_info().ip_addr);
+
+        return ip_addr_str.c_str();
+    }
+
+private:
+    storage::FlashInitializer flash_initializer_;
+    net::FanoutNetworkHandler handler_;
+    net::StaNetwork network_;
+    http::Server server_;
+};
+
+} // namespace httpserver
+} // namespace pipeline
+} // namespace ocs
+#endif // CONFIG_OCS_TEST_UNIT_WIFI_STA_ENABLED
@@ -0,0 +1,376 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <cstring>
+#include <optional>
+#include <string>
+
+#include "unity.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "ocs_core/noncopyable.h"
+#include "ocs_fmt/json/iformatter.h"
+#include "ocs_fmt/json/stream_writer.h"
+#include "ocs_pipeline/httpserver/stream_handler.h"
+#include "ocs_pipeline/test/test_http_server.h"
+#include "ocs_test/test_clock.h"
+
+#ifdef CONFIG_OCS_TEST_UNIT_WIFI_STA_ENABLED
+#include "esp_http_client.h"
+#endif // CONFIG_OCS_TEST_UNIT_WIFI_STA_ENABLED
+
+namespace ocs {
+namespace pipeline {
+namespace httpserver {
+
+#ifdef CONFIG_OCS_TEST_UNIT_WIFI_STA_ENABLED
+namespace {
+
+const char* test_path = "/stream";
+const unsigned test_buffer_size = 64;
+
+struct TestFormatter : public fmt::json::IFormatter, public core::NonCopyable<> {
+    status::StatusCode format(cJSON* json) override {
+        return status::StatusCode::Error;
+    }
+
+    status::StatusCode format(fmt::json::StreamWriter& writer) override {
+        ++format_count;
+
+        if (code != status::StatusCode::OK) {
+            return code;
+        }
+
+        if (!text.empty()) {
+            writer.add_string("text", text.c_str());
+        }
+
+        return writer.add_number("value", value);
+    }
+
+    std::optional<uint32_t> generation() const override {
+        return gen;
+    }
+
+    std::optional<uint32_t> gen;
+    double value { 0 };
+    std::string text;
+    unsigned format_count { 0 };
+    status::StatusCode code { status::StatusCode::OK };
+};
+
+//! Read Server-Sent Events from the stream.
+class TestStreamClient : public core::NonCopyable<> {
+public:
+    explicit TestStreamClient(const char* host) {
+        esp_http_client_config_t config;
+        memset(&config, 0, sizeof(config));
+
+        config.host = host;
+        config.path = test_path;
+        config.transport_type = HTTP_TRANSPORT_OVER_TCP;
+        config.timeout_ms = 5000;
+
+        client_ = esp_http_client_init(&config);
+        TEST_ASSERT_NOT_NULL(client_);
+    }
+
+    ~TestStreamClient() {
+        close();
+    }
+
+    //! Send the request and return the HTTP status code.
+    int open() {
+        TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_open(client_, 0));
+        esp_http_client_fetch_headers(client_);
+
+        return esp_http_client_get_status_code(client_);
+    }
+
+    //! Read the next event, skipping the keepalive comments.
+    //!
+    //! @remarks
+    //!  Empty string is returned if nothing is received before the timeout.
+    std::string read_event() {
+        while (true) {
+            const auto pos = buf_.find("\n\n");
+            if (pos != std::string::npos) {
+                const std::string event = buf_.substr(0, pos + 2);
+                buf_.erase(0, pos + 2);
+
+                if (event[0] == ':') {
+                    continue;
+                }
+
+                return event;
+            }
+
+            char data[64];
+
+            const int len = esp_http_client_read(client_, data, sizeof(data));
+            if (len <= 0) {
+                return std::string();
+            }
+
+            buf_.append(data, len);
+        }
+    }
+
+    //! Close the connection.
+    void close() {
+        if (client_) {
+            esp_http_client_close(client_);
+            esp_http_client_cleanup(client_);
+            client_ = nullptr;
+        }
+    }
+
+private:
+    esp_http_client_handle_t client_ { nullptr };
+    std::string buf_;
+};
+
+//! Subscriber is added once the stream is established.
+void wait_subscriber_count(const StreamHandler& handler, unsigned count) {
+    for (unsigned n = 0; n < 50 && handler.subscriber_count() != count; ++n) {
+        vTaskDelay(pdMS_TO_TICKS(100));
+    }
+
+    TEST_ASSERT_EQUAL(count, handler.subscriber_count());
+}
+
+StreamHandler::Params make_params() {
+    StreamHandler::Params params;
+    params.max_subscribers = 2;
+    params.interval = core::Duration::second;
+    params.min_interval = core::Duration::second;
+
+    return params;
+}
+
+} // namespace
+
+TEST_CASE("Stream handler: register clients", "[ocs_pipeline], [stream_handler]") {
+    TestHttpServer test_server;
+    test::TestClock clock;
+    TestFormatter formatter;
+
+    StreamHandler handler(test_server.server(), clock, formatter, test_path, "test",
+                          test_buffer_size, make_params());
+
+    const auto host = test_server.start();
+
+    TestStreamClient client1(host.c_str());
+    TEST_ASSERT_EQUAL(200, client1.open());
+    wait_subscriber_count(handler, 1);
+
+    TestStreamClient client2(host.c_str());
+    TEST_ASSERT_EQUAL(200, client2.open());
+    wait_subscriber_count(handler, 2);
+
+    // Maximum number of clients is reached.
+    TestStreamClient client3(host.c_str());
+    TEST_ASSERT_EQUAL(503, client3.open());
+    wait_subscriber_count(handler, 2);
+
+    handler.stop();
+    TEST_ASSERT_EQUAL(0, handler.subscriber_count());
+}
+
+TEST_CASE("Stream handler: fan out events", "[ocs_pipeline], [stream_handler]") {
+    TestHttpServer test_server;
+    test::TestClock clock;
+
+    TestFormatter formatter;
+    formatter.gen = 1;
+    formatter.value = 1;
+
+    StreamHandler handler(test_server.server(), clock, formatter, test_path, "test",
+                          test_buffer_size, make_params());
+
+    const auto host = test_server.start();
+
+    TestStreamClient client1(host.c_str());
+    TEST_ASSERT_EQUAL(200, client1.open());
+
+    TestStreamClient client2(host.c_str());
+    TEST_ASSERT_EQUAL(200, client2.open());
+
+    wait_subscriber_count(handler, 2);
+
+    // Clients aren't ready yet.
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, handler.run());
+    TEST_ASSERT_EQUAL(0, formatter.format_count);
+
+    clock.value += core::Duration::second;
+
+    // Event is formatted once for all clients.
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, handler.run());
+    TEST_ASSERT_EQUAL(1, formatter.format_count);
+
+    TEST_ASSERT_EQUAL_STRING("data: {\"value\":1}\n\n", client1.read_event().c_str());
+    TEST_ASSERT_EQUAL_STRING("data: {\"value\":1}\n\n", client2.read_event().c_str());
+
+    // Generation isn't changed, nothing to format.
+    clock.value += core::Duration::second;
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, handler.run());
+    TEST_ASSERT_EQUAL(1, formatter.format_count);
+
+    formatter.gen = 2;
+    formatter.value = 2;
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, handler.run());
+    TEST_ASSERT_EQUAL(2, formatter.format_count);
+
+    TEST_ASSERT_EQUAL_STRING("data: {\"value\":2}\n\n", client1.read_event().c_str());
+    TEST_ASSERT_EQUAL_STRING("data: {\"value\":2}\n\n", client2.read_event().c_str());
+
+    handler.stop();
+}
+
+TEST_CASE("Stream handler: remove client on send failure",
+          "[ocs_pipeline], [stream_handler]") {
+    TestHttpServer test_server;
+    test::TestClock clock;
+    TestFormatter formatter;
+
+    StreamHandler handler(test_server.server(), clock, formatter, test_path, "test",
+                          test_buffer_size, make_params());
+
+    const auto host = test_server.start();
+
+    TestStreamClient client1(host.c_str());
+    TEST_ASSERT_EQUAL(200, client1.open());
+
+    TestStreamClient client2(host.c_str());
+    TEST_ASSERT_EQUAL(200, client2.open());
+
+    wait_subscriber_count(handler, 2);
+
+    client1.close();
+
+    // Sending to the closed socket fails once the peer has reset the connection.
+    for (unsigned n = 0; n < 20 && handler.subscriber_count() != 1; ++n) {
+        clock.value += core::Duration::second;
+        TEST_ASSERT_EQUAL(status::StatusCode::OK, handler.run());
+
+        vTaskDelay(pdMS_TO_TICKS(100));
+    }
+
+    TEST_ASSERT_EQUAL(1, handler.subscriber_count());
+
+    // Remaining client still receives the events.
+    formatter.value = 42;
+
+    clock.value += core::Duration::second;
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, handler.run());
+
+    std::string event;
+    do {
+        event = client2.read_event();
+    } while (event != "" && event != "data: {\"value\":42}\n\n");
+
+    TEST_ASSERT_EQUAL_STRING("data: {\"value\":42}\n\n", event.c_str());
+
+    // Slot of the removed client can be reused.
+    TestStreamClient client3(host.c_str());
+    TEST_ASSERT_EQUAL(200, client3.open());
+    wait_subscriber_count(handler, 2);
+
+    handler.stop();
+}
+
+TEST_CASE("Stream handler: slow client doesn't block others",
+          "[ocs_pipeline], [stream_handler]") {
+    TestHttpServer test_server;
+    test::TestClock clock;
+
+    // Untracked data, the event is sent each interval.
+    TestFormatter formatter;
+    formatter.text = std::string(2048, 'x');
+
+    auto params = make_params();
+    params.send_timeout = core::Duration::second * 3;
+
+    StreamHandler handler(test_server.server(), clock, formatter, test_path, "test",
+                          test_buffer_size, params);
+
+    const auto host = test_server.start();
+
+    TestStreamClient fast_client(host.c_str());
+    TEST_ASSERT_EQUAL(200, fast_client.open());
+
+    // Never reads the events, the socket buffer becomes full after a few events.
+    TestStreamClient slow_client(host.c_str());
+    TEST_ASSERT_EQUAL(200, slow_client.open());
+
+    wait_subscriber_count(handler, 2);
+
+    for (unsigned n = 1; n <= 30; ++n) {
+        formatter.value = n;
+        clock.value += core::Duration::second;
+
+        const TickType_t start = xTaskGetTickCount();
+        TEST_ASSERT_EQUAL(status::StatusCode::OK, handler.run());
+        TEST_ASSERT_TRUE(xTaskGetTickCount() - start < pdMS_TO_TICKS(100));
+
+        const std::string expected = "data: {\"text\":\"" + formatter.text
+            + "\",\"value\":" + std::to_string(n) + "}\n\n";
+
+        TEST_ASSERT_EQUAL_STRING(expected.c_str(), fast_client.read_event().c_str());
+    }
+
+    // Slow client is disconnected once the event isn't sent within the timeout.
+    TEST_ASSERT_EQUAL(1, handler.subscriber_count());
+
+    handler.stop();
+}
+
+TEST_CASE("Stream handler: skip event on formatting error",
+          "[ocs_pipeline], [stream_handler]") {
+    TestHttpServer test_server;
+    test::TestClock clock;
+
+    TestFormatter formatter;
+    formatter.gen = 1;
+    formatter.value = 1;
+    formatter.code = status::StatusCode::Error;
+
+    StreamHandler handler(test_server.server(), clock, formatter, test_path, "test",
+                          test_buffer_size, make_params());
+
+    const auto host = test_server.start();
+
+    TestStreamClient client(host.c_str());
+    TEST_ASSERT_EQUAL(200, client.open());
+    wait_subscriber_count(handler, 1);
+
+    clock.value += core::Duration::second;
+
+    TEST_ASSERT_EQUAL(status::StatusCode::Error, handler.run());
+    TEST_ASSERT_EQUAL(1, formatter.format_count);
+    TEST_ASSERT_EQUAL(1, handler.subscriber_count());
+
+    formatter.code = status::StatusCode::OK;
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, handler.run());
+    TEST_ASSERT_EQUAL(2, formatter.format_count);
+
+    // Failed event isn't sent.
+    TEST_ASSERT_EQUAL_STRING("data: {\"value\":1}\n\n", client.read_event().c_str());
+
+    handler.stop();
+}
+#endif // CONFIG_OCS_TEST_UNIT_WIFI_STA_ENABLED
+
+} // namespace httpserver
+} // namespace pipeline
+} // namespace ocs
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <cstring>
+#include <string>
+
+#include "unity.h"
+
+#include "ocs_diagnostic/basic_counter_holder.h"
+#include "ocs_pipeline/httpserver/system_state_handler.h"
+#include "ocs_pipeline/test/test_http_server.h"
+#include "ocs_test/test_clock.h"
+
+#ifdef CONFIG_OCS_TEST_UNIT_WIFI_STA_ENABLED
+#include "esp_http_client.h"
+#endif // CONFIG_OCS_TEST_UNIT_WIFI_STA_ENABLED
+
+namespace ocs {
+namespace pipeline {
+namespace httpserver {
+
+#ifdef CONFIG_OCS_TEST_UNIT_WIFI_STA_ENABLED
+#ifdef CONFIG_FREERTOS_USE_TRACE_FACILITY
+namespace {
+
+struct TestCounterHolder : public diagnostic::BasicCounterHolder {
+    //! Return the value of the counter with @p id.
+    diagnostic::ICounter::Value get(const char* id) const {
+        for (const auto& counter : get_counters_()) {
+            if (!strcmp(counter->id(), id)) {
+                return counter->get();
+            }
+        }
+
+        TEST_FAIL_MESSAGE("unknown counter");
+
+        return 0;
+    }
+};
+
+struct TestResponse {
+    int status { 0 };
+    std::string body;
+};
+
+esp_err_t handle_event(esp_http_client_event_t* event) {
+    if (event->event_id == HTTP_EVENT_ON_DATA) {
+        static_cast<TestResponse*>(event->user_data)
+            ->body.append(static_cast<const char*>(event->data), event->data_len);
+    }
+
+    return ESP_OK;
+}
+
+TestResponse get_report(const std::string& host) {
+    TestResponse response;
+
+    esp_http_client_config_t config;
+    memset(&config, 0, sizeof(config));
+
+    config.host = host.c_str();
+    config.path = "/api/v1/system/report";
+    config.transport_type = HTTP_TRANSPORT_OVER_TCP;
+    config.event_handler = handle_event;
+    config.user_data = &response;
+
+    esp_http_client_handle_t client = esp_http_client_init(&config);
+    TEST_ASSERT_NOT_NULL(client);
+
+    TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_perform(client));
+    response.status = esp_http_client_get_status_code(client);
+
+    TEST_ASSERT_EQUAL(ESP_OK, esp_http_client_cleanup(client));
+
+    return response;
+}
+
+} // namespace
+
+TEST_CASE("System state handler: coalesce requests", "[ocs_pipeline], [system_state]") {
+    TestHttpServer test_server;
+    test::TestClock clock;
+    TestCounterHolder counter_holder;
+
+    SystemStateHandler handler(test_server.server(), clock, counter_holder,
+                               fmt::json::DynamicFormatter::Params {
+                                   .size = 1024,
+                                   .max_size = 1024 * 8,
+                                   .shrink_after = 0,
+                               },
+                               core::Duration::second, nullptr);
+
+    const std::string host = test_server.start();
+
+    const auto response1 = get_report(host);
+    TEST_ASSERT_EQUAL(200, response1.status);
+    TEST_ASSERT_FALSE(response1.body.empty());
+    TEST_ASSERT_EQUAL(0, counter_holder.get("c_http_sys_coal"));
+    TEST_ASSERT_EQUAL(0, counter_holder.get("c_http_sys_fail"));
+    TEST_ASSERT_EQUAL(response1.body.size(), counter_holder.get("c_http_sys_len"));
+
+    // Same bytes are sent within the coalesce interval.
+    for (unsigned n = 1; n <= 3; ++n) {
+        clock.value += core::Duration::millisecond * 300;
+
+        const auto response = get_report(host);
+        TEST_ASSERT_EQUAL(200, response.status);
+        TEST_ASSERT_EQUAL_STRING(response1.body.c_str(), response.body.c_str());
+        TEST_ASSERT_EQUAL(n, counter_holder.get("c_http_sys_coal"));
+    }
+
+    // Re-formatted once the interval is expired.
+    clock.value += core::Duration::millisecond * 100;
+
+    const auto response2 = get_report(host);
+    TEST_ASSERT_EQUAL(200, response2.status);
+    TEST_ASSERT_FALSE(response2.body.empty());
+    TEST_ASSERT_EQUAL(3, counter_holder.get("c_http_sys_coal"));
+
+    const auto response3 = get_report(host);
+    TEST_ASSERT_EQUAL(200, response3.status);
+    TEST_ASSERT_EQUAL_STRING(response2.body.c_str(), response3.body.c_str());
+    TEST_ASSERT_EQUAL(4, counter_holder.get("c_http_sys_coal"));
+}
+
+TEST_CASE("System state handler: coalesce interval is zero",
+          "[ocs_pipeline], [system_state]") {
+    TestHttpServer test_server;
+    test::TestClock clock;
+    TestCounterHolder counter_holder;
+
+    SystemStateHandler handler(test_server.server(), clock, counter_holder,
+                               fmt::json::DynamicFormatter::Params {
+                                   .size = 1024,
+                                   .max_size = 1024 * 8,
+                                   .shrink_after = 0,
+                               },
+                               0, nullptr);
+
+    const std::string host = test_server.start();
+
+    for (unsigned n = 0; n < 3; ++n) {
+        const auto response = get_report(host);
+        TEST_ASSERT_EQUAL(200, response.status);
+        TEST_ASSERT_FALSE(response.body.empty());
+    }
+
+    TEST_ASSERT_EQUAL(0, counter_holder.get("c_http_sys_coal"));
+}
+#endif // CONFIG_FREERTOS_USE_TRACE_FACILITY
+#endif // CONFIG_OCS_TEST_UNIT_WIFI_STA_ENABLED
+
+} // namespace httpserver
+} // namespace pipeline
+} // namespace ocs
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "unity.h"
+
+#include "ocs_fmt/json/cjson_builder.h"
+#include "ocs_pipeline/jsonfmt/task_scheduler_formatter.h"
+#include "ocs_test/test_clock.h"
+
+namespace ocs {
+namespace pipeline {
+namespace jsonfmt {
+
+TEST_CASE("Task scheduler formatter: format delay estimator overruns",
+          "[ocs_pipeline], [task_scheduler_formatter]") {
+    const core::Time tick = portTICK_PERIOD_MS * core::Duration::millisecond;
+
+    test::TestClock clock;
+    clock.value = 42;
+
+    scheduler::AdaptiveDelayEstimator estimator(clock, pdMS_TO_TICKS(1000));
+
+    TaskSchedulerFormatter formatter;
+    formatter.add(estimator, "system_delay");
+
+    // Woken up too late.
+    estimator.begin();
+    estimator.update(clock.value + tick * 10, 0);
+    clock.value += tick * 12;
+    estimator.begin();
+
+    auto json = fmt::json::CjsonUniqueBuilder::make_object();
+    TEST_ASSERT_NOT_NULL(json);
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, formatter.format(json.get()));
+
+    const cJSON* object = cJSON_GetObjectItem(json.get(), "system_delay");
+    TEST_ASSERT_NOT_NULL(object);
+    TEST_ASSERT_TRUE(cJSON_IsObject(object));
+
+    const cJSON* overrun_count = cJSON_GetObjectItem(object, "overrun_count");
+    TEST_ASSERT_NOT_NULL(overrun_count);
+    TEST_ASSERT_TRUE(cJSON_IsNumber(overrun_count));
+    TEST_ASSERT_EQUAL(1, overrun_count->valuedouble);
+}
+
+} // namespace jsonfmt
+} // namespace pipeline
+} // namespace ocs
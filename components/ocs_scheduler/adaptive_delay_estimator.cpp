@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <algorithm>
+
+#include "freertos/FreeRTOSConfig.h"
+
+#include "ocs_scheduler/adaptive_delay_estimator.h"
+
+namespace ocs {
+namespace scheduler {
+
+AdaptiveDelayEstimator::AdaptiveDelayEstimator(core::IClock& clock,
+                                               TickType_t max_delay)
+    : max_delay_(max_delay)
+    , tick_(portTICK_PERIOD_MS * core::Duration::millisecond)
+    , clock_(clock) {
+    configASSERT(max_delay_);
+}
+
+void AdaptiveDelayEstimator::begin() {
+    if (deadline_ != INT64_MAX) {
+        if (clock_.now() - deadline_ > tick_) {
+            ++overrun_count_;
+        }
+    }
+
+    deadline_ = INT64_MAX;
+    cost_ = 0;
+}
+
+void AdaptiveDelayEstimator::update(core::Time deadline, core::Time cost) {
+    deadline_ = std::min(deadline_, deadline);
+    cost_ = std::max(cost_, cost);
+}
+
+TickType_t AdaptiveDelayEstimator::estimate() {
+    if (deadline_ == INT64_MAX) {
+        return max_delay_;
+    }
+
+    const auto now = clock_.now();
+    if (deadline_ <= now) {
+        return 0;
+    }
+
+    // Wake up at least one tick later, to prevent busy looping when the remaining time
+    // is less than the run cost.
+    const auto remaining = std::max<core::Time>(deadline_ - now - cost_, 1);
+    const auto delay = (remaining + tick_ - 1) / tick_;
+
+    return std::min<core::Time>(delay, max_delay_);
+}
+
+unsigned AdaptiveDelayEstimator::overrun_count() const {
+    return overrun_count_;
+}
+
+} // namespace scheduler
+} // namespace ocs
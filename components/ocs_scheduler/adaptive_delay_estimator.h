@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "ocs_core/iclock.h"
+#include "ocs_core/noncopyable.h"
+#include "ocs_scheduler/idelay_estimator.h"
+
+namespace ocs {
+namespace scheduler {
+
+//! Sleep until the earliest pending deadline.
+//!
+//! @notes
+//!  The delay is calculated as the time left until the earliest pending deadline,
+//!  minus the time required to run a round of tasks, rounded up to the FreeRTOS ticks.
+//!  If the scheduler hasn't reported any deadline, the maximum delay is used.
+class AdaptiveDelayEstimator : public IDelayEstimator, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //!
+    //! @params
+    //!  - @p clock to calculate the time left until the deadline.
+    //!  - @p max_delay - maximum delay between rounds of execution.
+    AdaptiveDelayEstimator(core::IClock& clock, TickType_t max_delay);
+
+    //! Begin delay estimation.
+    //!
+    //! @remarks
+    //!  Check if the previously reported deadline has been overrun.
+    void begin() override;
+
+    //! Remember the earliest deadline and the run cost.
+    void update(core::Time deadline, core::Time cost) override;
+
+    //! Return the delay until the earliest deadline.
+    TickType_t estimate() override;
+
+    //! Return the number of times the scheduler was woken up later than one tick
+    //! after the deadline.
+    //!
+    //! @remarks
+    //!  Can be called from any FreeRTOS task.
+    unsigned overrun_count() const;
+
+private:
+    const TickType_t max_delay_ { pdMS_TO_TICKS(0) };
+    const core::Time tick_ { 0 };
+
+    core::IClock& clock_;
+
+    core::Time deadline_ { INT64_MAX };
+    core::Time cost_ { 0 };
+
+    std::atomic<unsigned> overrun_count_ { 0 };
+};
+
+} // namespace scheduler
+} // namespace ocs
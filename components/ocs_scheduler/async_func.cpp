@@ -15,17 +15,23 @@ namespace scheduler {
 
 AsyncFunc::AsyncFunc(AsyncFuncScheduler& func_scheduler,
                      ITask& task,
-                     TickType_t wait_interval)
+                     TickType_t wait_interval,
+                     AsyncFuncScheduler::Priority priority,
+                     TickType_t expire_interval)
     : wait_interval_(wait_interval)
+    , priority_(priority)
+    , expire_interval_(expire_interval)
     , func_scheduler_(func_scheduler)
     , task_(task) {
     configASSERT(wait_interval_);
 }
 
 status::StatusCode AsyncFunc::run() {
-    auto future = func_scheduler_.add([this]() {
-        return task_.run();
-    });
+    auto future = func_scheduler_.add(
+        [this]() {
+            return task_.run();
+        },
+        priority_, expire_interval_);
     if (!future) {
         return status::StatusCode::InvalidState;
     }
@@ -25,15 +25,25 @@ public:
     //! @params
     //!  - @p func_scheduler to schedule asynchronous operation.
     //!  - @p task to perform an asynchronous operation.
-    AsyncFunc(AsyncFuncScheduler& func_scheduler,
-              ITask& task,
-              TickType_t wait_interval = portMAX_DELAY);
+    //!  - @p wait_interval - how long to wait for the operation to finish.
+    //!  - @p priority - priority of the asynchronous operation.
+    //!  - @p expire_interval - the operation isn't performed if it wasn't started within
+    //!    this interval, zero means the operation is always performed, even if the
+    //!    caller has stopped waiting for it.
+    AsyncFunc(
+        AsyncFuncScheduler& func_scheduler,
+        ITask& task,
+        TickType_t wait_interval = portMAX_DELAY,
+        AsyncFuncScheduler::Priority priority = AsyncFuncScheduler::Priority::Normal,
+        TickType_t expire_interval = 0);
 
     //! Run task asynchronously.
     status::StatusCode run() override;
 
 private:
     const TickType_t wait_interval_ { pdMS_TO_TICKS(0) };
+    const AsyncFuncScheduler::Priority priority_ { AsyncFuncScheduler::Priority::Normal };
+    const TickType_t expire_interval_ { 0 };
 
     AsyncFuncScheduler& func_scheduler_;
     ITask& task_;
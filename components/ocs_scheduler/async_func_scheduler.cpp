@@ -7,8 +7,8 @@
  */
 
 #include "freertos/FreeRTOSConfig.h"
+#include "freertos/task.h"
 
-#include "ocs_core/lock_guard.h"
 #include "ocs_core/log.h"
 #include "ocs_scheduler/async_func_scheduler.h"
 #include "ocs_status/code_to_str.h"
@@ -20,60 +20,272 @@ namespace {
 
 const char* log_tag = "async_func_scheduler";
 
+//! Place the shared pointer control block into the future node, and return the node
+//! to the pool once the control block is destroyed.
+template <typename T, typename Node> struct NodeAllocator {
+    using value_type = T;
+
+    template <typename U> struct rebind {
+        using other = NodeAllocator<U, Node>;
+    };
+
+    explicit NodeAllocator(Node& node)
+        : node(&node) {
+    }
+
+    template <typename U>
+    NodeAllocator(const NodeAllocator<U, Node>& other)
+        : node(other.node) {
+    }
+
+    T* allocate(size_t n) {
+        configASSERT(sizeof(T) * n <= sizeof(node->block));
+        return reinterpret_cast<T*>(node->block);
+    }
+
+    // Called last, when nothing references the control block anymore.
+    void deallocate(T*, size_t) {
+        node->held.store(false, std::memory_order_release);
+    }
+
+    template <typename U> bool operator==(const NodeAllocator<U, Node>& other) const {
+        return node == other.node;
+    }
+
+    template <typename U> bool operator!=(const NodeAllocator<U, Node>& other) const {
+        return node != other.node;
+    }
+
+    Node* node { nullptr };
+};
+
+//! Future is owned by the node.
+struct NodeDeleter {
+    void operator()(core::Future*) const {
+    }
+};
+
+template <typename T> void atomic_max(std::atomic<T>& value, T update) {
+    T current = value.load(std::memory_order_relaxed);
+
+    while (current < update
+           && !value.compare_exchange_weak(current, update, std::memory_order_relaxed)) {
+    }
+}
+
 } // namespace
 
 AsyncFuncScheduler::AsyncFuncScheduler(unsigned max_event_count)
     : max_event_count_(max_event_count) {
     configASSERT(max_event_count_);
 
-    read_queue_.reset(new (std::nothrow) Queue());
-    configASSERT(read_queue_);
+    slot_count_ = 1;
+    while (slot_count_ < max_event_count_) {
+        slot_count_ <<= 1;
+    }
+
+    // All events can be enqueued into the same lane.
+    for (auto& lane : lanes_) {
+        lane.slots.reset(new (std::nothrow) Slot[slot_count_]);
+        configASSERT(lane.slots);
+
+        for (unsigned n = 0; n < slot_count_; ++n) {
+            lane.slots[n].seq.store(n, std::memory_order_relaxed);
+        }
+    }
+
+    // Futures can be held by the callers after the event is handled, e.g. if the caller
+    // has stopped waiting, so reserve additional futures for such cases.
+    future_count_ = max_event_count_ * 2;
+
+    futures_.reset(new (std::nothrow) FutureNode[future_count_]);
+    configASSERT(futures_);
+}
+
+void AsyncFuncScheduler::set_waker(ITaskScheduler& scheduler, const char* id) {
+    configASSERT(id);
 
-    write_queue_.reset(new (std::nothrow) Queue());
-    configASSERT(write_queue_);
+    waker_ = &scheduler;
+    waker_id_ = id;
 }
 
 status::StatusCode AsyncFuncScheduler::run() {
-    {
-        core::LockGuard lock(mu_);
+    for (auto& lane : lanes_) {
+        run_(lane);
+    }
+
+    return status::StatusCode::OK;
+}
+
+AsyncFuncScheduler::FuturePtr AsyncFuncScheduler::add(AsyncFuncScheduler::Func func,
+                                                      Priority priority,
+                                                      TickType_t timeout) {
+    configASSERT(priority < Priority::Last);
 
-        if (!write_queue_->size()) {
-            return status::StatusCode::OK;
+    Lane& lane = lanes_[static_cast<unsigned>(priority)];
+
+    unsigned count = event_count_.load(std::memory_order_relaxed);
+
+    do {
+        if (count == max_event_count_) {
+            lane.drop_count.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
         }
+    } while (!event_count_.compare_exchange_weak(count, count + 1,
+                                                 std::memory_order_acquire,
+                                                 std::memory_order_relaxed));
 
-        std::swap(write_queue_, read_queue_);
+    FutureNode* node = acquire_future_();
+    if (!node) {
+        event_count_.fetch_sub(1, std::memory_order_release);
+        lane.drop_count.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
     }
 
-    for (auto fn : *read_queue_) {
-        const auto code = fn();
+    FuturePtr future(&node->future, NodeDeleter(),
+                     NodeAllocator<core::Future, FutureNode>(*node));
+
+    push_(lane, std::move(func), node, timeout);
+
+    // Function with the timeout can expire before the scheduler runs on its own.
+    if ((priority == Priority::High || timeout) && waker_) {
+        const auto code = waker_->wake(waker_id_.c_str());
         if (code != status::StatusCode::OK) {
-            ocs_logw(log_tag, "failed to handle async event: %s",
-                     status::code_to_str(code));
+            ocs_logw(log_tag, "failed to wake scheduler: id=%s code=%s",
+                     waker_id_.c_str(), status::code_to_str(code));
         }
     }
 
-    read_queue_->clear();
+    return future;
+}
 
-    return status::StatusCode::OK;
+AsyncFuncScheduler::LaneStats AsyncFuncScheduler::get_stats(Priority priority) const {
+    configASSERT(priority < Priority::Last);
+
+    const Lane& lane = lanes_[static_cast<unsigned>(priority)];
+
+    LaneStats stats;
+
+    stats.depth = lane.depth.load(std::memory_order_relaxed);
+    stats.depth_max = lane.depth_max.load(std::memory_order_relaxed);
+    stats.run_count = lane.run_count.load(std::memory_order_relaxed);
+    stats.drop_count = lane.drop_count.load(std::memory_order_relaxed);
+    stats.expire_count = lane.expire_count.load(std::memory_order_relaxed);
+    stats.wait_last = lane.wait_last.load(std::memory_order_relaxed);
+    stats.wait_max = lane.wait_max.load(std::memory_order_relaxed);
+
+    return stats;
 }
 
-AsyncFuncScheduler::FuturePtr AsyncFuncScheduler::add(AsyncFuncScheduler::Func func) {
-    core::LockGuard lock(mu_);
+void AsyncFuncScheduler::run_(Lane& lane) {
+    // Events added while running are handled on the next call.
+    const unsigned count = lane.depth.load(std::memory_order_acquire);
 
-    if (write_queue_->size() == max_event_count_) {
-        return nullptr;
+    for (unsigned n = 0; n < count; ++n) {
+        Slot& slot = lane.slots[lane.read_pos & (slot_count_ - 1)];
+
+        // Producer has reserved the slot, but hasn't filled it yet.
+        if (slot.seq.load(std::memory_order_acquire) != lane.read_pos + 1) {
+            break;
+        }
+
+        Func func = std::move(slot.func);
+        FutureNode* node = slot.node;
+
+        const TickType_t wait = xTaskGetTickCount() - slot.add_ts;
+        const bool expired = slot.timeout && wait > slot.timeout;
+
+        slot.node = nullptr;
+        slot.seq.store(lane.read_pos + slot_count_, std::memory_order_release);
+
+        ++lane.read_pos;
+        lane.depth.fetch_sub(1, std::memory_order_relaxed);
+        event_count_.fetch_sub(1, std::memory_order_release);
+
+        const uint32_t wait_ms = pdTICKS_TO_MS(wait);
+        lane.wait_last.store(wait_ms, std::memory_order_relaxed);
+        atomic_max(lane.wait_max, wait_ms);
+
+        status::StatusCode code = status::StatusCode::Timeout;
+
+        if (expired) {
+            lane.expire_count.fetch_add(1, std::memory_order_relaxed);
+
+            ocs_logw(log_tag, "async event expired: wait=%lu(ms) timeout=%lu(ms)",
+                     wait_ms, pdTICKS_TO_MS(slot.timeout));
+        } else {
+            lane.run_count.fetch_add(1, std::memory_order_relaxed);
+
+            code = func();
+            if (code != status::StatusCode::OK) {
+                ocs_logw(log_tag, "failed to handle async event: %s",
+                         status::code_to_str(code));
+            }
+        }
+
+        node->future.notify(code);
+        node->busy.store(false, std::memory_order_release);
     }
+}
 
-    FuturePtr future(new (std::nothrow) core::Future());
-    if (!future) {
-        return nullptr;
+void AsyncFuncScheduler::push_(Lane& lane,
+                               Func func,
+                               FutureNode* node,
+                               TickType_t timeout) {
+    // The number of events never exceeds the number of slots, so there is always a slot
+    // available for the reserved event.
+    unsigned pos = lane.write_pos.load(std::memory_order_relaxed);
+    Slot* slot = nullptr;
+
+    while (true) {
+        slot = &lane.slots[pos & (slot_count_ - 1)];
+
+        const unsigned seq = slot->seq.load(std::memory_order_acquire);
+        const int diff = static_cast<int>(seq - pos);
+
+        if (diff == 0) {
+            if (lane.write_pos.compare_exchange_weak(pos, pos + 1,
+                                                     std::memory_order_relaxed)) {
+                break;
+            }
+        } else {
+            pos = lane.write_pos.load(std::memory_order_relaxed);
+        }
     }
 
-    write_queue_->push_back([func, future]() {
-        return future->notify(func());
-    });
+    slot->func = std::move(func);
+    slot->node = node;
+    slot->add_ts = xTaskGetTickCount();
+    slot->timeout = timeout;
+    slot->seq.store(pos + 1, std::memory_order_release);
 
-    return future;
+    const unsigned depth = lane.depth.fetch_add(1, std::memory_order_release) + 1;
+    atomic_max(lane.depth_max, depth);
+}
+
+AsyncFuncScheduler::FutureNode* AsyncFuncScheduler::acquire_future_() {
+    for (unsigned n = 0; n < future_count_; ++n) {
+        FutureNode& node = futures_[n];
+
+        bool busy = false;
+        if (!node.busy.compare_exchange_strong(busy, true, std::memory_order_acquire)) {
+            continue;
+        }
+
+        // Future is still held by the caller. The flag is set only by the owner of the
+        // busy flag, so it can't be set concurrently.
+        if (node.held.load(std::memory_order_acquire)) {
+            node.busy.store(false, std::memory_order_release);
+            continue;
+        }
+
+        node.held.store(true, std::memory_order_relaxed);
+        node.future.reset();
+
+        return &node;
+    }
+
+    return nullptr;
 }
 
 } // namespace scheduler
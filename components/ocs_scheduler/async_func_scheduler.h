@@ -8,48 +8,183 @@
 
 #pragma once
 
-#include <functional>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
-#include <vector>
+#include <string>
+
+#include "freertos/FreeRTOS.h"
 
 #include "ocs_core/future.h"
 #include "ocs_core/noncopyable.h"
-#include "ocs_core/static_recursive_mutex.h"
+#include "ocs_core/static_func.h"
 #include "ocs_scheduler/itask.h"
+#include "ocs_scheduler/itask_scheduler.h"
 
 namespace ocs {
 namespace scheduler {
 
+//! Execute functions asynchronously on the task that calls run().
+//!
+//! @notes
+//!  Each priority has its own bounded lock-free multiple producers single consumer ring
+//!  of the pre-allocated slots (lane), futures are taken from the pre-allocated pool,
+//!  so add() never allocates memory on the heap. Lanes are drained in order of their
+//!  priority, functions of the same priority are run in FIFO order.
+//!
+//!  The pool holds twice as many futures as the maximum number of pending events. A
+//!  future returns to the pool once its function is run and the last copy of the
+//!  returned pointer is released, so callers that keep the futures of the handled
+//!  events make add() fail when the pool is exhausted.
 class AsyncFuncScheduler : public ITask, public core::NonCopyable<> {
 public:
+    //! Maximum size of the objects captured by the scheduled function, in bytes.
+    static constexpr unsigned func_capacity = sizeof(void*) * 8;
+
     using FuturePtr = std::shared_ptr<core::Future>;
-    using Func = std::function<status::StatusCode()>;
+    using Func = core::StaticFunc<status::StatusCode(), func_capacity>;
+
+    //! Function priority.
+    enum class Priority {
+        //! Run before any other functions, wake up the scheduler immediately.
+        High,
+
+        //! Default priority.
+        Normal,
+
+        //! Run when there are no other pending functions, e.g. housekeeping.
+        Low,
+
+        Last,
+    };
+
+    //! Lane statistics.
+    struct LaneStats {
+        //! Number of pending functions.
+        unsigned depth { 0 };
+
+        //! Maximum number of pending functions.
+        unsigned depth_max { 0 };
+
+        //! Number of functions run.
+        uint32_t run_count { 0 };
+
+        //! Number of functions rejected by add(), since there were no free slots.
+        uint32_t drop_count { 0 };
+
+        //! Number of functions not run, since their timeout has expired.
+        uint32_t expire_count { 0 };
+
+        //! Time the last function has spent in the lane, in milliseconds.
+        uint32_t wait_last { 0 };
+
+        //! Maximum time a function has spent in the lane, in milliseconds.
+        uint32_t wait_max { 0 };
+    };
 
     //! Initialize.
     //!
     //! @params
     //!  - @p max_event_count - maximum number of asynchronous events that can be enqueued
-    //!    before run() is called.
+    //!    before run() is called, shared between all priorities.
     explicit AsyncFuncScheduler(unsigned max_event_count);
 
+    //! Wake up @p scheduler, which runs this scheduler as a task with @p id, once a
+    //! high priority function or a function with the timeout is added.
+    //!
+    //! @remarks
+    //!  Should be called before any function is added.
+    void set_waker(ITaskScheduler& scheduler, const char* id);
+
     //! Run scheduled events.
+    //!
+    //! @remarks
+    //!  Should be called from a single FreeRTOS task.
     status::StatusCode run() override;
 
     //! Add @p func to be executed asynchronously.
     //!
+    //! @params
+    //!  - @p func - function to be executed.
+    //!  - @p priority - function priority.
+    //!  - @p timeout - maximum time the function can wait to be run, the function isn't
+    //!    run and its future is notified with StatusCode::Timeout once the timeout has
+    //!    expired. Zero means no timeout. Function with the timeout wakes the scheduler
+    //!    regardless of its priority, see set_waker().
+    //!
     //! @remarks
-    //!  It is safe to call scheduler functions in @p func.
-    FuturePtr add(Func func);
+    //!  - It is safe to call scheduler functions in @p func.
+    //!  - nullptr is returned if there are too many pending events, or all futures are
+    //!    still held by the callers. The future is held until all copies of the
+    //!    returned pointer are released.
+    FuturePtr
+    add(Func func, Priority priority = Priority::Normal, TickType_t timeout = 0);
+
+    //! Return statistics of the lane with @p priority.
+    LaneStats get_stats(Priority priority) const;
 
 private:
+    struct FutureNode {
+        //! Node is used by the pending event.
+        std::atomic<bool> busy { false };
+
+        //! Future is referenced by the pointer returned to the caller.
+        std::atomic<bool> held { false };
+
+        core::Future future;
+
+        //! Storage for the shared pointer control block, to avoid heap allocations.
+        alignas(std::max_align_t) uint8_t block[sizeof(void*) * 8];
+    };
+
+    struct Slot {
+        //! Sequence number to synchronize producers with the consumer.
+        std::atomic<unsigned> seq { 0 };
+
+        Func func;
+        FutureNode* node { nullptr };
+
+        TickType_t add_ts { 0 };
+        TickType_t timeout { 0 };
+    };
+
+    struct Lane {
+        std::unique_ptr<Slot[]> slots;
+
+        std::atomic<unsigned> write_pos { 0 };
+        unsigned read_pos { 0 };
+
+        std::atomic<unsigned> depth { 0 };
+        std::atomic<unsigned> depth_max { 0 };
+        std::atomic<uint32_t> run_count { 0 };
+        std::atomic<uint32_t> drop_count { 0 };
+        std::atomic<uint32_t> expire_count { 0 };
+        std::atomic<uint32_t> wait_last { 0 };
+        std::atomic<uint32_t> wait_max { 0 };
+    };
+
+    static constexpr unsigned lane_count = static_cast<unsigned>(Priority::Last);
+
+    FutureNode* acquire_future_();
+
+    void run_(Lane& lane);
+    void push_(Lane& lane, Func func, FutureNode* node, TickType_t timeout);
+
     const unsigned max_event_count_ { 0 };
 
-    using Queue = std::vector<Func>;
-    using QueuePtr = std::shared_ptr<Queue>;
+    //! Number of slots in each lane, power of two.
+    unsigned slot_count_ { 0 };
+
+    Lane lanes_[lane_count];
+
+    std::unique_ptr<FutureNode[]> futures_;
+    unsigned future_count_ { 0 };
+
+    std::atomic<unsigned> event_count_ { 0 };
 
-    core::StaticRecursiveMutex mu_;
-    QueuePtr read_queue_;
-    QueuePtr write_queue_;
+    ITaskScheduler* waker_ { nullptr };
+    std::string waker_id_;
 };
 
 } // namespace scheduler
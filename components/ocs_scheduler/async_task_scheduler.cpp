@@ -6,8 +6,10 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 
+#include <algorithm>
 #include <cstring>
 
+#include "esp_timer.h"
 #include "freertos/FreeRTOSConfig.h"
 
 #include "ocs_algo/bit_ops.h"
@@ -20,14 +22,30 @@
 namespace ocs {
 namespace scheduler {
 
-AsyncTaskScheduler::AsyncTaskScheduler(IDelayEstimator& estimator, const char* id)
-    : log_tag_(id)
+AsyncTaskScheduler::AsyncTaskScheduler(IDelayEstimator& estimator,
+                                       const char* id,
+                                       unsigned max_count)
+    : max_count_(max_count)
+    , log_tag_(id)
     , estimator_(estimator) {
+    configASSERT(max_count_);
+    configASSERT(max_count_ <= bits_per_group * bits_per_group);
+
+    const unsigned shard_count = (max_count_ + bits_per_group - 1) / bits_per_group;
+
+    for (unsigned n = 0; n < shard_count; ++n) {
+        EventGroupPtr shard(new (std::nothrow) core::StaticEventGroup());
+        configASSERT(shard);
+
+        shards_.emplace_back(std::move(shard));
+        shard_bits_all_.push_back(0);
+    }
+
+    nodes_.reserve(max_count_);
 }
 
 unsigned AsyncTaskScheduler::max_count() const {
-    //!  8 high bits are used by the FreeRTOS itself.
-    return (sizeof(EventBits_t) * 8) - 8;
+    return max_count_;
 }
 
 unsigned AsyncTaskScheduler::count() const {
@@ -50,18 +68,32 @@ AsyncTaskScheduler::add(ITask& task, const char* id, core::Time interval) {
         }
     }
 
-    const EventBits_t event = algo::BitOps::mask(nodes_.size());
+    const unsigned shard = nodes_.size() / bits_per_group;
+
+    const EventBits_t event = algo::BitOps::mask(nodes_.size() % bits_per_group);
+    const EventBits_t summary_event = algo::BitOps::mask(shard);
 
-    NodePtr node(new (std::nothrow) Node(task, event_group_.get(), event, interval, id));
+    NodePtr node(new (std::nothrow) Node(task, shards_[shard]->get(), event,
+                                         summary_group_.get(), summary_event, interval,
+                                         id));
     configASSERT(node);
 
     nodes_.emplace_back(node);
+    profilers_.push_back(&node->profiler());
 
-    bits_all_ |= event;
+    shard_bits_all_[shard] |= event;
+    summary_bits_all_ |= summary_event;
 
     return status::StatusCode::OK;
 }
 
+status::StatusCode AsyncTaskScheduler::add(ITask& task,
+                                           const char* id,
+                                           core::Time interval,
+                                           TaskParams) {
+    return add(task, id, interval);
+}
+
 status::StatusCode AsyncTaskScheduler::start() {
     ocs_logi(log_tag_.c_str(), "start tasks scheduling: count=%u/%u", count(),
              max_count());
@@ -106,16 +138,44 @@ status::StatusCode AsyncTaskScheduler::run() {
     estimator_.begin();
     const auto delay = estimator_.estimate();
 
-    const EventBits_t bits =
-        xEventGroupWaitBits(event_group_.get(), bits_all_, pdTRUE, pdFALSE, delay);
+    const EventBits_t summary_bits = xEventGroupWaitBits(
+        summary_group_.get(), summary_bits_all_, pdTRUE, pdFALSE, delay);
 
-    run_(bits);
+    for (unsigned n = 0; n < shards_.size(); ++n) {
+        if (summary_bits & algo::BitOps::mask(n)) {
+            // Shard bits are set before the summary bit, so none of the events is lost:
+            // events set after the shard is cleared are handled on the next round.
+            const EventBits_t bits =
+                xEventGroupClearBits(shards_[n]->get(), shard_bits_all_[n]);
+
+            run_(n, bits);
+        }
+    }
 
     return status::StatusCode::OK;
 }
 
-void AsyncTaskScheduler::run_(EventBits_t bits) {
+status::StatusCode AsyncTaskScheduler::wake(const char* id) {
     for (auto& node : nodes_) {
+        if (strcmp(node->id(), id) == 0) {
+            return node->wake();
+        }
+    }
+
+    return status::StatusCode::InvalidArg;
+}
+
+const ITaskScheduler::ProfilerList& AsyncTaskScheduler::profilers() const {
+    return profilers_;
+}
+
+void AsyncTaskScheduler::run_(unsigned shard, EventBits_t bits) {
+    const unsigned begin = shard * bits_per_group;
+    const unsigned end = std::min<unsigned>(begin + bits_per_group, nodes_.size());
+
+    for (unsigned n = begin; n < end; ++n) {
+        auto& node = nodes_[n];
+
         if (bits & node->event()) {
             const auto code = node->run();
             if (code != status::StatusCode::OK) {
@@ -129,20 +189,37 @@ void AsyncTaskScheduler::run_(EventBits_t bits) {
 AsyncTaskScheduler::Node::Node(ITask& task,
                                EventGroupHandle_t even_group,
                                EventBits_t event,
+                               EventGroupHandle_t summary_group,
+                               EventBits_t summary_event,
                                core::Time interval,
                                const char* id)
     : id_(id)
     , event_(event)
-    , task_(task) {
+    , task_(task)
+    , profiler_(id, interval) {
     async_task_.reset(new (std::nothrow) AsyncTask(even_group, event));
     configASSERT(async_task_);
 
-    timer_.reset(new (std::nothrow) HighResolutionTimer(*async_task_, id, interval));
+    summary_task_.reset(new (std::nothrow) AsyncTask(summary_group, summary_event));
+    configASSERT(summary_task_);
+
+    fanout_task_.reset(new (std::nothrow) FanoutTask());
+    configASSERT(fanout_task_);
+
+    // Order matters, see AsyncTaskScheduler::run().
+    fanout_task_->add(*async_task_);
+    fanout_task_->add(*summary_task_);
+
+    timer_.reset(new (std::nothrow) HighResolutionTimer(*fanout_task_, id, interval));
     configASSERT(timer_);
 }
 
 status::StatusCode AsyncTaskScheduler::Node::run() {
-    return task_.run();
+    const auto start_ts = esp_timer_get_time();
+    const auto code = task_.run();
+    profiler_.record(start_ts, esp_timer_get_time(), code);
+
+    return code;
 }
 
 const char* AsyncTaskScheduler::Node::id() const {
@@ -161,5 +238,13 @@ status::StatusCode AsyncTaskScheduler::Node::stop() {
     return timer_->stop();
 }
 
+status::StatusCode AsyncTaskScheduler::Node::wake() {
+    return fanout_task_->run();
+}
+
+const TaskProfiler& AsyncTaskScheduler::Node::profiler() const {
+    return profiler_;
+}
+
 } // namespace scheduler
 } // namespace ocs
@@ -14,21 +14,39 @@
 
 #include "ocs_core/noncopyable.h"
 #include "ocs_core/static_event_group.h"
+#include "ocs_scheduler/fanout_task.h"
 #include "ocs_scheduler/idelay_estimator.h"
 #include "ocs_scheduler/itask_scheduler.h"
 #include "ocs_scheduler/itimer.h"
+#include "ocs_scheduler/task_profiler.h"
 
 namespace ocs {
 namespace scheduler {
 
+//! Run tasks on events delivered from the high-resolution timers.
+//!
+//! @notes
+//!  Each task owns a single bit in one of the event groups (shards). Each shard owns a
+//!  single bit in the summary event group, on which the scheduler waits for events.
+//!  The number of tasks is limited by the number of bits in the summary event group
+//!  multiplied by the number of bits in each shard.
 class AsyncTaskScheduler : public ITaskScheduler, public core::NonCopyable<> {
 public:
+    //! Number of events a single FreeRTOS event group can hold.
+    //!
+    //! @remarks
+    //!  8 high bits are used by the FreeRTOS itself.
+    static constexpr unsigned bits_per_group = (sizeof(EventBits_t) * 8) - 8;
+
     //! Initialize.
     //!
     //! @params
     //!  - @p estimator to estimate the required delay after each round of execution.
     //!  - @p id to distinguish one scheduler from another.
-    AsyncTaskScheduler(IDelayEstimator& estimator, const char* id);
+    //!  - @p max_count - maximum number of tasks the scheduler can handle.
+    AsyncTaskScheduler(IDelayEstimator& estimator,
+                       const char* id,
+                       unsigned max_count = bits_per_group);
 
     //! Maximum number of tasks to which a scheduler can deliver asynchronous events.
     unsigned max_count() const override;
@@ -49,6 +67,11 @@ public:
     //!  run() call.
     status::StatusCode add(ITask& task, const char* id, core::Time interval) override;
 
+    //! Add task to be run once per interval, @p params are ignored, since all tasks
+    //! are run on the same FreeRTOS task.
+    status::StatusCode
+    add(ITask& task, const char* id, core::Time interval, TaskParams params) override;
+
     //! Start tasks scheduling.
     status::StatusCode start() override;
 
@@ -58,12 +81,20 @@ public:
     //! Wait for the asynchronous tasks.
     status::StatusCode run() override;
 
+    //! Deliver the asynchronous event to the task with @p id.
+    status::StatusCode wake(const char* id) override;
+
+    //! Return execution statistics of the registered tasks.
+    const ProfilerList& profilers() const override;
+
 private:
     class Node : public ITask, public core::NonCopyable<> {
     public:
         Node(ITask& task,
              EventGroupHandle_t event_group,
              EventBits_t event,
+             EventGroupHandle_t summary_group,
+             EventBits_t summary_event,
              core::Time interval,
              const char* id);
 
@@ -75,6 +106,11 @@ private:
         status::StatusCode start();
         status::StatusCode stop();
 
+        //! Deliver the event, as the timer does.
+        status::StatusCode wake();
+
+        const TaskProfiler& profiler() const;
+
     private:
         const std::string id_;
         const EventBits_t event_ { 0 };
@@ -82,21 +118,31 @@ private:
         ITask& task_;
 
         std::unique_ptr<ITask> async_task_;
+        std::unique_ptr<ITask> summary_task_;
+        std::unique_ptr<FanoutTask> fanout_task_;
         std::unique_ptr<ITimer> timer_;
+
+        TaskProfiler profiler_;
     };
 
     using NodePtr = std::shared_ptr<Node>;
+    using EventGroupPtr = std::unique_ptr<core::StaticEventGroup>;
 
-    void run_(EventBits_t bits);
+    void run_(unsigned shard, EventBits_t bits);
 
+    const unsigned max_count_ { 0 };
     const std::string log_tag_;
 
     IDelayEstimator& estimator_;
 
     std::vector<NodePtr> nodes_;
+    ProfilerList profilers_;
+
+    core::StaticEventGroup summary_group_;
+    EventBits_t summary_bits_all_ { 0 };
 
-    core::StaticEventGroup event_group_;
-    EventBits_t bits_all_ { 0 };
+    std::vector<EventGroupPtr> shards_;
+    std::vector<EventBits_t> shard_bits_all_;
 };
 
 } // namespace scheduler
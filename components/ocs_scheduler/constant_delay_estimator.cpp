@@ -18,6 +18,9 @@ ConstantDelayEstimator::ConstantDelayEstimator(TickType_t delay)
 void ConstantDelayEstimator::begin() {
 }
 
+void ConstantDelayEstimator::update(core::Time, core::Time) {
+}
+
 TickType_t ConstantDelayEstimator::estimate() {
     return delay_;
 }
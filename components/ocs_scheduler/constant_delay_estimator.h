@@ -22,6 +22,9 @@ public:
     //! Begin delay estimation.
     void begin() override;
 
+    //! Ignore the deadline, the delay is always the same.
+    void update(core::Time deadline, core::Time cost) override;
+
     //! Return the configured delay.
     TickType_t estimate() override;
 
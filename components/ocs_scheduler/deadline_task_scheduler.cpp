@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/FreeRTOSConfig.h"
+#include "freertos/task.h"
+
+#include "ocs_core/log.h"
+#include "ocs_scheduler/deadline_task_scheduler.h"
+#include "ocs_status/code_to_str.h"
+
+namespace ocs {
+namespace scheduler {
+
+DeadlineTaskScheduler::DeadlineTaskScheduler(core::IClock& clock,
+                                             IDelayEstimator& estimator,
+                                             const char* id,
+                                             unsigned max_count)
+    : max_count_(max_count)
+    , log_tag_(id)
+    , clock_(clock)
+    , estimator_(estimator) {
+    configASSERT(max_count_);
+
+    nodes_.reserve(max_count_);
+    index_.reserve(max_count_);
+}
+
+unsigned DeadlineTaskScheduler::max_count() const {
+    return max_count_;
+}
+
+unsigned DeadlineTaskScheduler::count() const {
+    return nodes_.size();
+}
+
+status::StatusCode
+DeadlineTaskScheduler::add(ITask& task, const char* id, core::Time interval) {
+    configASSERT(id);
+    configASSERT(interval > 0);
+    configASSERT(interval >= core::Duration::millisecond);
+
+    if (nodes_.size() == max_count()) {
+        return status::StatusCode::Error;
+    }
+
+    for (auto& node : index_) {
+        if (strcmp(node->id(), id) == 0) {
+            return status::StatusCode::InvalidArg;
+        }
+    }
+
+    task_min_interval_ = std::min(task_min_interval_, interval);
+
+    NodePtr node(new (std::nothrow) Node(clock_, task, id, interval));
+    configASSERT(node);
+
+    nodes_.push_back(node);
+    std::push_heap(nodes_.begin(), nodes_.end(), compare_);
+
+    index_.push_back(node);
+    profilers_.push_back(&node->profiler());
+
+    return status::StatusCode::OK;
+}
+
+status::StatusCode DeadlineTaskScheduler::add(ITask& task,
+                                              const char* id,
+                                              core::Time interval,
+                                              TaskParams) {
+    return add(task, id, interval);
+}
+
+status::StatusCode DeadlineTaskScheduler::start() {
+    ocs_logi(log_tag_.c_str(),
+             "start tasks scheduling: count=%u/%u task_min_interval=%lli(ms)", count(),
+             max_count(), task_min_interval_ / core::Duration::millisecond);
+
+    return status::StatusCode::OK;
+}
+
+status::StatusCode DeadlineTaskScheduler::stop() {
+    ocs_logi(log_tag_.c_str(),
+             "stop tasks scheduling: count=%u/%u task_min_interval=%lli(ms)", count(),
+             max_count(), task_min_interval_ / core::Duration::millisecond);
+
+    return status::StatusCode::OK;
+}
+
+status::StatusCode DeadlineTaskScheduler::run() {
+    estimator_.begin();
+
+    const auto start_ts = clock_.now();
+    run_(start_ts);
+    const auto total_ts = clock_.now() - start_ts;
+
+    total_ts_min_ = std::min(total_ts_min_, total_ts);
+    total_ts_max_ = std::max(total_ts_max_, total_ts);
+
+    const auto estimated_delay = estimate_delay_();
+
+    ocs_logd(log_tag_.c_str(),
+             "delay estimating: total=%lli(usec) total_min=%lli(usec) "
+             "total_max=%lli(usec) task_min=%lli(ms) estimated=%lu(ms)",
+             total_ts, total_ts_min_, total_ts_max_,
+             task_min_interval_ / core::Duration::millisecond,
+             pdTICKS_TO_MS(estimated_delay));
+
+    delay_.delay(estimated_delay);
+
+    return status::StatusCode::OK;
+}
+
+status::StatusCode DeadlineTaskScheduler::wake(const char* id) {
+    for (auto& node : index_) {
+        if (strcmp(node->id(), id) == 0) {
+            node->wake();
+            delay_.interrupt();
+
+            return status::StatusCode::OK;
+        }
+    }
+
+    return status::StatusCode::InvalidArg;
+}
+
+const ITaskScheduler::ProfilerList& DeadlineTaskScheduler::profilers() const {
+    return profilers_;
+}
+
+bool DeadlineTaskScheduler::compare_(const NodePtr& lhs, const NodePtr& rhs) {
+    return lhs->deadline() > rhs->deadline();
+}
+
+void DeadlineTaskScheduler::run_(core::Time now) {
+    // Woken tasks are run out of order, their deadlines aren't changed, so the heap
+    // remains valid. Tasks which deadline has passed are run below anyway.
+    for (auto& node : index_) {
+        if (node->take_wake() && node->deadline() > now) {
+            const auto code = node->run();
+            if (code != status::StatusCode::OK) {
+                ocs_loge(log_tag_.c_str(), "failed to run task: id=%s code=%s",
+                         node->id(), status::code_to_str(code));
+            }
+        }
+    }
+
+    while (nodes_.size() && nodes_.front()->deadline() <= now) {
+        std::pop_heap(nodes_.begin(), nodes_.end(), compare_);
+
+        auto& node = nodes_.back();
+
+        const auto code = node->run();
+        if (code != status::StatusCode::OK) {
+            ocs_loge(log_tag_.c_str(), "failed to run task: id=%s code=%s", node->id(),
+                     status::code_to_str(code));
+        }
+
+        node->reschedule(now);
+        std::push_heap(nodes_.begin(), nodes_.end(), compare_);
+    }
+}
+
+TickType_t DeadlineTaskScheduler::estimate_delay_() {
+    if (!nodes_.size()) {
+        return estimator_.estimate();
+    }
+
+    const auto deadline = nodes_.front()->deadline();
+
+    estimator_.update(deadline, total_ts_min_);
+    const auto max_delay = estimator_.estimate();
+
+    const auto remaining = deadline - clock_.now();
+    if (remaining <= 0) {
+        return 0;
+    }
+
+    // Round up, to ensure the task isn't woken up before the deadline.
+    const core::Time tick = portTICK_PERIOD_MS * core::Duration::millisecond;
+    const core::Time delay = (remaining + tick - 1) / tick;
+
+    return std::min<core::Time>(delay, max_delay);
+}
+
+DeadlineTaskScheduler::Node::Node(core::IClock& clock,
+                                  ITask& task,
+                                  const char* id,
+                                  core::Time interval)
+    : id_(id)
+    , interval_(interval)
+    , clock_(clock)
+    , task_(task)
+    , profiler_(id, interval) {
+}
+
+status::StatusCode DeadlineTaskScheduler::Node::run() {
+    const auto start_ts = clock_.now();
+    const auto code = task_.run();
+    profiler_.record(start_ts, clock_.now(), code);
+
+    return code;
+}
+
+const char* DeadlineTaskScheduler::Node::id() const {
+    return id_.c_str();
+}
+
+core::Time DeadlineTaskScheduler::Node::deadline() const {
+    return deadline_;
+}
+
+void DeadlineTaskScheduler::Node::wake() {
+    woken_.store(true, std::memory_order_release);
+}
+
+bool DeadlineTaskScheduler::Node::take_wake() {
+    return woken_.exchange(false, std::memory_order_acquire);
+}
+
+const TaskProfiler& DeadlineTaskScheduler::Node::profiler() const {
+    return profiler_;
+}
+
+void DeadlineTaskScheduler::Node::reschedule(core::Time now) {
+    deadline_ += interval_;
+
+    // Skip the missed deadlines.
+    if (deadline_ <= now) {
+        deadline_ = now + interval_;
+    }
+}
+
+} // namespace scheduler
+} // namespace ocs
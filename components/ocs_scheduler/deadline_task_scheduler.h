@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "freertos/FreeRTOS.h"
+
+#include "ocs_core/iclock.h"
+#include "ocs_core/noncopyable.h"
+#include "ocs_scheduler/idelay_estimator.h"
+#include "ocs_scheduler/interruptible_delay.h"
+#include "ocs_scheduler/itask.h"
+#include "ocs_scheduler/itask_scheduler.h"
+#include "ocs_scheduler/task_profiler.h"
+
+namespace ocs {
+namespace scheduler {
+
+//! Run periodic tasks in order of their deadlines.
+//!
+//! @notes
+//!  Tasks are kept in a min-heap ordered by the point in time when each task should
+//!  be run next. Only tasks which deadline has passed are run on each round, and the
+//!  scheduler sleeps until the earliest deadline, instead of polling each task after a
+//!  constant delay.
+class DeadlineTaskScheduler : public ITaskScheduler, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //!
+    //! @params
+    //!  - @p clock to track the task deadlines.
+    //!  - @p estimator to estimate the maximum delay after each round of execution.
+    //!  - @p id to distinguish one scheduler from another.
+    //!  - @p max_count - maximum number of tasks the scheduler can handle.
+    DeadlineTaskScheduler(core::IClock& clock,
+                          IDelayEstimator& estimator,
+                          const char* id,
+                          unsigned max_count);
+
+    //! Return the maximum configured number of tasks a scheduler can handle.
+    unsigned max_count() const override;
+
+    //! Return the number of registered tasks.
+    unsigned count() const override;
+
+    //! Add task to be executed periodically once per interval.
+    //!
+    //! @params
+    //!  - @p task - task to be executed periodically.
+    //!  - @p id - unique task identifier.
+    //!  - @p interval - task running frequency, milliseconds resolution.
+    //!
+    //! @notes
+    //!  The task deadline is advanced by the task interval after each run, so the
+    //!  task's frequency doesn't drift over time. If the task has missed several
+    //!  deadlines, e.g. due to other long-running tasks, the missed deadlines are
+    //!  skipped, instead of running the task multiple times in a row.
+    //!
+    //! @remarks
+    //!  Tasks should be added before the scheduler is started.
+    status::StatusCode add(ITask& task, const char* id, core::Time interval) override;
+
+    //! Add task to be run once per interval, @p params are ignored, since all tasks
+    //! are run on the same FreeRTOS task.
+    status::StatusCode
+    add(ITask& task, const char* id, core::Time interval, TaskParams params) override;
+
+    //! Start tasks scheduling.
+    status::StatusCode start() override;
+
+    //! Stop tasks scheduling.
+    status::StatusCode stop() override;
+
+    //! Run all tasks which deadline has passed and wait for the next deadline.
+    //!
+    //! @remarks
+    //!  The wait time never exceeds the delay estimated by the configured estimator.
+    status::StatusCode run() override;
+
+    //! Run task with @p id on the next round and interrupt the delay between rounds.
+    //!
+    //! @remarks
+    //!  The task deadline isn't changed. Can be called from any task, concurrently with
+    //!  run().
+    status::StatusCode wake(const char* id) override;
+
+    //! Return execution statistics of the registered tasks.
+    const ProfilerList& profilers() const override;
+
+private:
+    class Node : public ITask, public core::NonCopyable<> {
+    public:
+        Node(core::IClock& clock, ITask& task, const char* id, core::Time interval);
+
+        status::StatusCode run() override;
+
+        const char* id() const;
+
+        //! Return the point in time when the task should be run.
+        core::Time deadline() const;
+
+        //! Move deadline to the next task interval after @p now.
+        void reschedule(core::Time now);
+
+        //! Mark the task to be run on the next round.
+        void wake();
+
+        //! Return true if the task was woken, reset the wake mark.
+        bool take_wake();
+
+        const TaskProfiler& profiler() const;
+
+    private:
+        const std::string id_;
+        const core::Time interval_ { 0 };
+
+        core::IClock& clock_;
+        ITask& task_;
+
+        TaskProfiler profiler_;
+
+        //! The first run is always allowed.
+        core::Time deadline_ { INT64_MIN };
+
+        std::atomic<bool> woken_ { false };
+    };
+
+    using NodePtr = std::shared_ptr<Node>;
+    using NodeList = std::vector<NodePtr>;
+
+    static bool compare_(const NodePtr& lhs, const NodePtr& rhs);
+
+    void run_(core::Time now);
+    TickType_t estimate_delay_();
+
+    const unsigned max_count_ { 0 };
+    const std::string log_tag_;
+
+    core::Time task_min_interval_ { INT64_MAX };
+
+    core::Time total_ts_min_ { INT64_MAX };
+    core::Time total_ts_max_ { INT64_MIN };
+
+    core::IClock& clock_;
+    IDelayEstimator& estimator_;
+    InterruptibleDelay delay_;
+
+    //! Min-heap, the node with the earliest deadline is at the front.
+    NodeList nodes_;
+
+    //! Nodes in order of registration. Never reordered, so wake() can look up the node
+    //! while run() reorders the heap.
+    NodeList index_;
+    ProfilerList profilers_;
+};
+
+} // namespace scheduler
+} // namespace ocs
@@ -11,6 +11,8 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
+#include "ocs_core/time.h"
+
 namespace ocs {
 namespace scheduler {
 
@@ -23,6 +25,13 @@ public:
     //! Begin delay estimation.
     virtual void begin() = 0;
 
+    //! Notify about the earliest pending deadline.
+    //!
+    //! @params
+    //!  - @p deadline - point in time when the next task should be run.
+    //!  - @p cost - time required to run a round of tasks.
+    virtual void update(core::Time deadline, core::Time cost) = 0;
+
     //! Estimate required delay.
     virtual TickType_t estimate() = 0;
 };
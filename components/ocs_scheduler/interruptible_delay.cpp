@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "esp_bit_defs.h"
+#include "freertos/task.h"
+
+#include "ocs_scheduler/interruptible_delay.h"
+
+namespace ocs {
+namespace scheduler {
+
+namespace {
+
+const EventBits_t interrupt_bit = BIT(0);
+
+} // namespace
+
+void InterruptibleDelay::delay(TickType_t ticks) {
+    xEventGroupWaitBits(group_.get(), interrupt_bit, pdTRUE, pdFALSE, ticks);
+
+    // Give other tasks of the same priority a chance to run, as vTaskDelay(0) does.
+    if (!ticks) {
+        taskYIELD();
+    }
+}
+
+void InterruptibleDelay::interrupt() {
+    xEventGroupSetBits(group_.get(), interrupt_bit);
+}
+
+} // namespace scheduler
+} // namespace ocs
@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+#include "ocs_core/noncopyable.h"
+#include "ocs_core/static_event_group.h"
+
+namespace ocs {
+namespace scheduler {
+
+//! Delay the FreeRTOS task, which can be interrupted from another FreeRTOS task.
+//!
+//! @notes
+//!  The interruption is remembered, so if interrupt() is called when the task isn't
+//!  delayed, the next delay returns immediately.
+class InterruptibleDelay : public core::NonCopyable<> {
+public:
+    //! Delay the calling task for @p ticks or until interrupt() is called.
+    void delay(TickType_t ticks);
+
+    //! Interrupt the current or the next delay.
+    void interrupt();
+
+private:
+    core::StaticEventGroup group_;
+};
+
+} // namespace scheduler
+} // namespace ocs
@@ -8,8 +8,11 @@
 
 #pragma once
 
+#include <vector>
+
 #include "ocs_core/time.h"
 #include "ocs_scheduler/itask.h"
+#include "ocs_scheduler/task_profiler.h"
 #include "ocs_status/code.h"
 
 namespace ocs {
@@ -17,6 +20,21 @@ namespace scheduler {
 
 class ITaskScheduler {
 public:
+    using ProfilerList = std::vector<const TaskProfiler*>;
+
+    //! Task can be run on any core.
+    static constexpr int any_core = -1;
+
+    //! Task scheduling constraints.
+    struct TaskParams {
+        //! Core on which the task should be run.
+        int core { any_core };
+
+        //! Task isn't run concurrently with any other task of the scheduler,
+        //! e.g. if it suspends the FreeRTOS scheduler on the current core.
+        bool exclusive { false };
+    };
+
     //! Destroy.
     virtual ~ITaskScheduler() = default;
 
@@ -34,6 +52,21 @@ public:
     //!  - @p interval - task running frequency.
     virtual status::StatusCode add(ITask& task, const char* id, core::Time interval) = 0;
 
+    //! Add task to be executed periodically once per interval.
+    //!
+    //! @params
+    //!  - @p task - task to be executed periodically.
+    //!  - @p id - unique task identifier.
+    //!  - @p interval - task running frequency.
+    //!  - @p params - task scheduling constraints.
+    //!
+    //! @remarks
+    //!  Schedulers which run all tasks one by one on the same FreeRTOS task never run
+    //!  tasks concurrently, and run them on the core of that FreeRTOS task, so they
+    //!  ignore @p params.
+    virtual status::StatusCode
+    add(ITask& task, const char* id, core::Time interval, TaskParams params) = 0;
+
     //! Start scheduling registered tasks.
     virtual status::StatusCode start() = 0;
 
@@ -42,6 +75,16 @@ public:
 
     //! Run all registered tasks.
     virtual status::StatusCode run() = 0;
+
+    //! Run task with @p id on the next round, regardless of its interval, and
+    //! interrupt the delay between rounds.
+    //!
+    //! @remarks
+    //!  Can be called from any FreeRTOS task, once all tasks are added.
+    virtual status::StatusCode wake(const char* id) = 0;
+
+    //! Return execution statistics of the registered tasks.
+    virtual const ProfilerList& profilers() const = 0;
 };
 
 } // namespace scheduler
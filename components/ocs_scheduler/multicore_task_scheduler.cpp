@@ -0,0 +1,519 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+
+#include "freertos/FreeRTOSConfig.h"
+
+#include "ocs_core/lock_guard.h"
+#include "ocs_core/log.h"
+#include "ocs_scheduler/multicore_task_scheduler.h"
+#include "ocs_status/code_to_str.h"
+
+namespace ocs {
+namespace scheduler {
+
+namespace {
+
+EventBits_t wake_bit(unsigned worker) {
+    return 1 << worker;
+}
+
+EventBits_t stopped_bit(unsigned worker) {
+    return 1 << (MulticoreTaskScheduler::max_worker_count + worker);
+}
+
+const EventBits_t idle_bit = 1 << (MulticoreTaskScheduler::max_worker_count * 2);
+
+} // namespace
+
+MulticoreTaskScheduler::MulticoreTaskScheduler(core::IClock& clock,
+                                               IDelayEstimator& estimator,
+                                               const char* id,
+                                               unsigned max_count,
+                                               Params params)
+    : max_count_(max_count)
+    , log_tag_(id)
+    , params_(params)
+    , clock_(clock)
+    , estimator_(estimator) {
+    configASSERT(max_count_);
+    configASSERT(params_.worker_count);
+    configASSERT(params_.worker_count <= max_worker_count);
+    configASSERT(params_.stack_size);
+
+    nodes_.reserve(max_count_);
+    exclusive_nodes_.reserve(max_count_);
+
+    for (unsigned n = 0; n < params_.worker_count; ++n) {
+        WorkerPtr worker(new (std::nothrow)
+                             Worker(*this, n, n % portNUM_PROCESSORS, max_count_));
+        configASSERT(worker);
+
+        workers_.emplace_back(std::move(worker));
+        worker_bits_all_ |= wake_bit(n);
+    }
+}
+
+MulticoreTaskScheduler::~MulticoreTaskScheduler() {
+    if (started_) {
+        stop();
+    }
+}
+
+unsigned MulticoreTaskScheduler::max_count() const {
+    return max_count_;
+}
+
+unsigned MulticoreTaskScheduler::count() const {
+    return nodes_.size();
+}
+
+status::StatusCode
+MulticoreTaskScheduler::add(ITask& task, const char* id, core::Time interval) {
+    return add(task, id, interval, TaskParams());
+}
+
+status::StatusCode MulticoreTaskScheduler::add(ITask& task,
+                                               const char* id,
+                                               core::Time interval,
+                                               TaskParams params) {
+    configASSERT(id);
+    configASSERT(interval > 0);
+    configASSERT(interval >= core::Duration::millisecond);
+    configASSERT(params.core == any_core
+                 || (params.core >= 0 && params.core < portNUM_PROCESSORS));
+
+    if (nodes_.size() == max_count()) {
+        return status::StatusCode::Error;
+    }
+
+    for (auto& node : nodes_) {
+        if (strcmp(node->id(), id) == 0) {
+            return status::StatusCode::InvalidArg;
+        }
+    }
+
+    if (!params.exclusive && params.core != any_core) {
+        // Workers are assigned to the cores in a round-robin way.
+        if (static_cast<unsigned>(params.core) >= workers_.size()) {
+            ocs_loge(log_tag_.c_str(), "no workers on core: id=%s core=%d", id,
+                     params.core);
+
+            return status::StatusCode::InvalidArg;
+        }
+    }
+
+    task_min_interval_ = std::min(task_min_interval_, interval);
+
+    NodePtr node(new (std::nothrow) Node(clock_, task, id, interval, params));
+    configASSERT(node);
+
+    nodes_.push_back(node);
+    profilers_.push_back(&node->profiler());
+
+    return status::StatusCode::OK;
+}
+
+status::StatusCode MulticoreTaskScheduler::start() {
+    ocs_logi(log_tag_.c_str(),
+             "start tasks scheduling: count=%u/%u workers=%u task_min_interval=%lli(ms)",
+             count(), max_count(), params_.worker_count,
+             task_min_interval_ / core::Duration::millisecond);
+
+    if (started_) {
+        return status::StatusCode::InvalidState;
+    }
+
+    stopped_.store(false, std::memory_order_release);
+    xEventGroupClearBits(event_group_.get(), worker_bits_all_ | idle_bit);
+
+    for (auto& worker : workers_) {
+        const std::string name = log_tag_ + "_" + std::to_string(worker->index());
+
+        const auto code =
+            worker->start(name.c_str(), params_.stack_size, params_.priority);
+        if (code != status::StatusCode::OK) {
+            ocs_loge(log_tag_.c_str(), "failed to start worker: index=%u code=%s",
+                     worker->index(), status::code_to_str(code));
+
+            return code;
+        }
+    }
+
+    started_ = true;
+
+    return status::StatusCode::OK;
+}
+
+status::StatusCode MulticoreTaskScheduler::stop() {
+    ocs_logi(log_tag_.c_str(),
+             "stop tasks scheduling: count=%u/%u workers=%u steal_count=%" PRIu32,
+             count(), max_count(), params_.worker_count, steal_count());
+
+    if (!started_) {
+        return status::StatusCode::OK;
+    }
+
+    stopped_.store(true, std::memory_order_release);
+    xEventGroupSetBits(event_group_.get(), worker_bits_all_);
+
+    EventBits_t stopped_bits_all = 0;
+    for (auto& worker : workers_) {
+        stopped_bits_all |= stopped_bit(worker->index());
+    }
+
+    xEventGroupWaitBits(event_group_.get(), stopped_bits_all, pdTRUE, pdTRUE,
+                        portMAX_DELAY);
+
+    for (auto& worker : workers_) {
+        worker->clear();
+    }
+
+    for (auto& node : nodes_) {
+        node->release();
+    }
+
+    pending_count_.store(0, std::memory_order_release);
+    started_ = false;
+
+    return status::StatusCode::OK;
+}
+
+status::StatusCode MulticoreTaskScheduler::run() {
+    configASSERT(started_);
+
+    estimator_.begin();
+
+    const auto start_ts = clock_.now();
+
+    core::Time deadline = INT64_MAX;
+    EventBits_t bits = 0;
+
+    for (auto& node : nodes_) {
+        if (node->due()) {
+            if (node->exclusive()) {
+                exclusive_nodes_.push_back(node.get());
+            } else if (node->acquire()) {
+                bits |= dispatch_(*node);
+            }
+        }
+
+        deadline = std::min(deadline, node->deadline());
+    }
+
+    if (bits) {
+        // Wake all workers which can run the dispatched tasks, so the idle ones can
+        // steal the tasks from the busy ones.
+        xEventGroupSetBits(event_group_.get(), bits);
+    }
+
+    run_exclusive_();
+
+    const auto total_ts = clock_.now() - start_ts;
+
+    total_ts_min_ = std::min(total_ts_min_, total_ts);
+    total_ts_max_ = std::max(total_ts_max_, total_ts);
+
+    estimator_.update(deadline, total_ts_min_);
+
+    const auto estimated_delay = estimator_.estimate();
+
+    ocs_logd(log_tag_.c_str(),
+             "delay estimating: total=%lli(usec) total_min=%lli(usec) "
+             "total_max=%lli(usec) task_min=%lli(ms) estimated=%lu(ms)",
+             total_ts, total_ts_min_, total_ts_max_,
+             task_min_interval_ / core::Duration::millisecond,
+             pdTICKS_TO_MS(estimated_delay));
+
+    delay_.delay(estimated_delay);
+
+    return status::StatusCode::OK;
+}
+
+status::StatusCode MulticoreTaskScheduler::wake(const char* id) {
+    for (auto& node : nodes_) {
+        if (strcmp(node->id(), id) == 0) {
+            node->wake();
+            delay_.interrupt();
+
+            return status::StatusCode::OK;
+        }
+    }
+
+    return status::StatusCode::InvalidArg;
+}
+
+const ITaskScheduler::ProfilerList& MulticoreTaskScheduler::profilers() const {
+    return profilers_;
+}
+
+uint32_t MulticoreTaskScheduler::steal_count() const {
+    return steal_count_.load(std::memory_order_relaxed);
+}
+
+void MulticoreTaskScheduler::work_(Worker& worker) {
+    while (!stopped_.load(std::memory_order_acquire)) {
+        Node* node = worker.pop();
+        if (!node) {
+            node = steal_(worker);
+        }
+
+        if (!node) {
+            xEventGroupWaitBits(event_group_.get(), wake_bit(worker.index()), pdTRUE,
+                                pdFALSE, portMAX_DELAY);
+            continue;
+        }
+
+        const auto code = node->run();
+        if (code != status::StatusCode::OK) {
+            ocs_loge(log_tag_.c_str(), "failed to run task: id=%s code=%s", node->id(),
+                     status::code_to_str(code));
+        }
+
+        finish_(*node);
+    }
+
+    xEventGroupSetBits(event_group_.get(), stopped_bit(worker.index()));
+}
+
+MulticoreTaskScheduler::Node* MulticoreTaskScheduler::steal_(Worker& worker) {
+    for (unsigned n = 1; n < workers_.size(); ++n) {
+        auto& victim = workers_[(worker.index() + n) % workers_.size()];
+
+        Node* node = victim->steal(worker);
+        if (node) {
+            steal_count_.fetch_add(1, std::memory_order_relaxed);
+            return node;
+        }
+    }
+
+    return nullptr;
+}
+
+void MulticoreTaskScheduler::finish_(Node& node) {
+    node.release();
+
+    if (pending_count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        xEventGroupSetBits(event_group_.get(), idle_bit);
+    }
+}
+
+EventBits_t MulticoreTaskScheduler::dispatch_(Node& node) {
+    Worker* target = nullptr;
+    EventBits_t bits = 0;
+
+    for (auto& worker : workers_) {
+        if (!worker->accepts(node)) {
+            continue;
+        }
+
+        bits |= wake_bit(worker->index());
+
+        if (!target || worker->size() < target->size()) {
+            target = worker.get();
+        }
+    }
+
+    configASSERT(target);
+
+    pending_count_.fetch_add(1, std::memory_order_acq_rel);
+    target->push(node);
+
+    return bits;
+}
+
+void MulticoreTaskScheduler::run_exclusive_() {
+    if (!exclusive_nodes_.size()) {
+        return;
+    }
+
+    // Only the task calling run() dispatches tasks to the workers, so once all
+    // dispatched tasks are finished, the workers stay idle until the next dispatch.
+    while (pending_count_.load(std::memory_order_acquire)) {
+        xEventGroupWaitBits(event_group_.get(), idle_bit, pdTRUE, pdFALSE, portMAX_DELAY);
+    }
+
+    for (auto& node : exclusive_nodes_) {
+        const auto code = node->run();
+        if (code != status::StatusCode::OK) {
+            ocs_loge(log_tag_.c_str(), "failed to run exclusive task: id=%s code=%s",
+                     node->id(), status::code_to_str(code));
+        }
+    }
+
+    exclusive_nodes_.clear();
+}
+
+MulticoreTaskScheduler::Node::Node(core::IClock& clock,
+                                   ITask& task,
+                                   const char* id,
+                                   core::Time interval,
+                                   TaskParams params)
+    : id_(id)
+    , params_(params)
+    , clock_(clock)
+    , task_(task)
+    , limiter_(clock, interval)
+    , profiler_(id, interval) {
+}
+
+status::StatusCode MulticoreTaskScheduler::Node::run() {
+    const auto start_ts = clock_.now();
+    const auto code = task_.run();
+    profiler_.record(start_ts, clock_.now(), code);
+
+    return code;
+}
+
+const char* MulticoreTaskScheduler::Node::id() const {
+    return id_.c_str();
+}
+
+int MulticoreTaskScheduler::Node::core() const {
+    return params_.core;
+}
+
+bool MulticoreTaskScheduler::Node::exclusive() const {
+    return params_.exclusive;
+}
+
+core::Time MulticoreTaskScheduler::Node::deadline() const {
+    return limiter_.deadline();
+}
+
+bool MulticoreTaskScheduler::Node::due() {
+    const bool woken = woken_.exchange(false, std::memory_order_acquire);
+
+    return limiter_.allow() || woken;
+}
+
+void MulticoreTaskScheduler::Node::wake() {
+    woken_.store(true, std::memory_order_release);
+}
+
+bool MulticoreTaskScheduler::Node::acquire() {
+    bool busy = false;
+    return busy_.compare_exchange_strong(busy, true, std::memory_order_acquire);
+}
+
+void MulticoreTaskScheduler::Node::release() {
+    busy_.store(false, std::memory_order_release);
+}
+
+const TaskProfiler& MulticoreTaskScheduler::Node::profiler() const {
+    return profiler_;
+}
+
+MulticoreTaskScheduler::Worker::Worker(MulticoreTaskScheduler& scheduler,
+                                       unsigned index,
+                                       int core,
+                                       unsigned capacity)
+    : index_(index)
+    , core_(core)
+    , scheduler_(scheduler) {
+    queue_.resize(capacity);
+}
+
+unsigned MulticoreTaskScheduler::Worker::index() const {
+    return index_;
+}
+
+int MulticoreTaskScheduler::Worker::core() const {
+    return core_;
+}
+
+bool MulticoreTaskScheduler::Worker::accepts(const Node& node) const {
+    return node.core() == any_core || node.core() == core_;
+}
+
+unsigned MulticoreTaskScheduler::Worker::size() const {
+    core::LockGuard lock(mu_);
+
+    return size_;
+}
+
+status::StatusCode MulticoreTaskScheduler::Worker::start(const char* name,
+                                                         unsigned stack_size,
+                                                         UBaseType_t priority) {
+    const auto ret = xTaskCreatePinnedToCore(run_, name, stack_size, this, priority,
+                                             nullptr, core_);
+
+    return ret == pdTRUE ? status::StatusCode::OK : status::StatusCode::Error;
+}
+
+void MulticoreTaskScheduler::Worker::push(Node& node) {
+    core::LockGuard lock(mu_);
+
+    // Each node is queued at most once, so the queue never overflows.
+    configASSERT(size_ < queue_.size());
+
+    queue_[(head_ + size_) % queue_.size()] = &node;
+    ++size_;
+}
+
+MulticoreTaskScheduler::Node* MulticoreTaskScheduler::Worker::pop() {
+    core::LockGuard lock(mu_);
+
+    if (!size_) {
+        return nullptr;
+    }
+
+    Node* node = queue_[head_];
+
+    head_ = (head_ + 1) % queue_.size();
+    --size_;
+
+    return node;
+}
+
+MulticoreTaskScheduler::Node*
+MulticoreTaskScheduler::Worker::steal(const Worker& thief) {
+    core::LockGuard lock(mu_);
+
+    for (unsigned n = 0; n < size_; ++n) {
+        const unsigned pos = (head_ + n) % queue_.size();
+
+        Node* node = queue_[pos];
+        if (!thief.accepts(*node)) {
+            continue;
+        }
+
+        // Keep the order of the remaining nodes.
+        for (unsigned i = n; i + 1 < size_; ++i) {
+            queue_[(head_ + i) % queue_.size()] = queue_[(head_ + i + 1) % queue_.size()];
+        }
+
+        --size_;
+
+        return node;
+    }
+
+    return nullptr;
+}
+
+void MulticoreTaskScheduler::Worker::clear() {
+    core::LockGuard lock(mu_);
+
+    head_ = 0;
+    size_ = 0;
+}
+
+void MulticoreTaskScheduler::Worker::run_(void* arg) {
+    configASSERT(arg);
+
+    Worker& self = *static_cast<Worker*>(arg);
+    self.scheduler_.work_(self);
+
+    vTaskDelete(nullptr);
+}
+
+} // namespace scheduler
+} // namespace ocs
@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "ocs_core/iclock.h"
+#include "ocs_core/noncopyable.h"
+#include "ocs_core/rate_limiter.h"
+#include "ocs_core/static_event_group.h"
+#include "ocs_core/static_mutex.h"
+#include "ocs_scheduler/idelay_estimator.h"
+#include "ocs_scheduler/interruptible_delay.h"
+#include "ocs_scheduler/itask.h"
+#include "ocs_scheduler/itask_scheduler.h"
+#include "ocs_scheduler/task_profiler.h"
+
+namespace ocs {
+namespace scheduler {
+
+//! Run periodic tasks on a pool of FreeRTOS tasks (workers), distributed over the cores.
+//!
+//! @notes
+//!  The task calling run() only checks which tasks should be run, and dispatches them
+//!  to the workers. Each worker has its own queue of tasks, the task is put into the
+//!  shortest queue of the workers allowed to run it. Idle workers steal tasks from the
+//!  queues of the busy workers, if the task affinity allows it. Exclusive tasks are run
+//!  on the task calling run(), once all other dispatched tasks are finished.
+class MulticoreTaskScheduler : public ITaskScheduler, public core::NonCopyable<> {
+public:
+    //! Maximum number of workers.
+    static constexpr unsigned max_worker_count = 8;
+
+    struct Params {
+        //! Number of workers, worker N is pinned to the core N % portNUM_PROCESSORS.
+        unsigned worker_count { portNUM_PROCESSORS };
+
+        //! Worker stack size, in bytes.
+        unsigned stack_size { 4096 };
+
+        //! Worker priority.
+        UBaseType_t priority { tskIDLE_PRIORITY + 1 };
+    };
+
+    //! Initialize.
+    //!
+    //! @params
+    //!  - @p clock to check if it's a time to run a task.
+    //!  - @p estimator to estimate the required delay after each round of execution.
+    //!  - @p id to distinguish one scheduler from another.
+    //!  - @p max_count - maximum number of tasks the scheduler can handle.
+    //!  - @p params - workers configuration.
+    MulticoreTaskScheduler(core::IClock& clock,
+                           IDelayEstimator& estimator,
+                           const char* id,
+                           unsigned max_count,
+                           Params params);
+
+    //! Stop workers.
+    ~MulticoreTaskScheduler();
+
+    //! Return the maximum configured number of tasks a scheduler can handle.
+    unsigned max_count() const override;
+
+    //! Return the number of registered tasks.
+    unsigned count() const override;
+
+    //! Add task to be run on any core once per interval.
+    status::StatusCode add(ITask& task, const char* id, core::Time interval) override;
+
+    //! Add task to be run once per interval.
+    //!
+    //! @params
+    //!  - @p task - task to be executed periodically.
+    //!  - @p id - unique task identifier.
+    //!  - @p interval - task running frequency, milliseconds resolution.
+    //!  - @p params - task affinity.
+    //!
+    //! @notes
+    //!  If the task is still running when its next interval comes, the run is skipped.
+    status::StatusCode
+    add(ITask& task, const char* id, core::Time interval, TaskParams params) override;
+
+    //! Start workers.
+    status::StatusCode start() override;
+
+    //! Stop workers.
+    //!
+    //! @remarks
+    //!  Waits for the running tasks to finish, pending tasks are discarded.
+    status::StatusCode stop() override;
+
+    //! Dispatch tasks which should be run to the workers, run exclusive tasks.
+    //!
+    //! @remarks
+    //!  Should be called after start().
+    status::StatusCode run() override;
+
+    //! Run task with @p id on the next round and interrupt the delay between rounds.
+    status::StatusCode wake(const char* id) override;
+
+    //! Return execution statistics of the registered tasks.
+    const ProfilerList& profilers() const override;
+
+    //! Return the number of tasks run by the workers, which they have stolen from
+    //! other workers.
+    uint32_t steal_count() const;
+
+private:
+    class Node : public ITask, public core::NonCopyable<> {
+    public:
+        Node(core::IClock& clock,
+             ITask& task,
+             const char* id,
+             core::Time interval,
+             TaskParams params);
+
+        status::StatusCode run() override;
+
+        const char* id() const;
+        int core() const;
+        bool exclusive() const;
+
+        //! Return the point in time when the task can be run.
+        core::Time deadline() const;
+
+        //! Return true if the task should be run, e.g. its interval has passed.
+        bool due();
+
+        //! Run the task on the next round, regardless of the task interval.
+        void wake();
+
+        //! Mark task as pending, return false if it's already pending or running.
+        bool acquire();
+
+        //! Mark task as finished.
+        void release();
+
+        const TaskProfiler& profiler() const;
+
+    private:
+        const std::string id_;
+        const TaskParams params_;
+
+        core::IClock& clock_;
+        ITask& task_;
+
+        core::RateLimiter limiter_;
+        TaskProfiler profiler_;
+
+        std::atomic<bool> woken_ { false };
+        std::atomic<bool> busy_ { false };
+    };
+
+    class Worker : public core::NonCopyable<> {
+    public:
+        Worker(MulticoreTaskScheduler& scheduler,
+               unsigned index,
+               int core,
+               unsigned capacity);
+
+        unsigned index() const;
+        int core() const;
+
+        //! Return true if the worker is allowed to run @p node.
+        bool accepts(const Node& node) const;
+
+        //! Return the number of queued tasks.
+        unsigned size() const;
+
+        status::StatusCode
+        start(const char* name, unsigned stack_size, UBaseType_t priority);
+
+        void push(Node& node);
+        Node* pop();
+
+        //! Remove the first queued node, which can be run by @p thief.
+        Node* steal(const Worker& thief);
+
+        //! Remove all queued nodes.
+        void clear();
+
+    private:
+        static void run_(void* arg);
+
+        const unsigned index_ { 0 };
+        const int core_ { any_core };
+
+        MulticoreTaskScheduler& scheduler_;
+
+        mutable core::StaticMutex mu_;
+        std::vector<Node*> queue_;
+        unsigned head_ { 0 };
+        unsigned size_ { 0 };
+    };
+
+    using NodePtr = std::shared_ptr<Node>;
+    using WorkerPtr = std::unique_ptr<Worker>;
+
+    void work_(Worker& worker);
+    Node* steal_(Worker& worker);
+    void finish_(Node& node);
+
+    EventBits_t dispatch_(Node& node);
+    void run_exclusive_();
+
+    const unsigned max_count_ { 0 };
+    const std::string log_tag_;
+    const Params params_;
+
+    core::Time task_min_interval_ { INT64_MAX };
+
+    core::Time total_ts_min_ { INT64_MAX };
+    core::Time total_ts_max_ { INT64_MIN };
+
+    core::IClock& clock_;
+    IDelayEstimator& estimator_;
+    InterruptibleDelay delay_;
+
+    std::vector<NodePtr> nodes_;
+    std::vector<Node*> exclusive_nodes_;
+    ProfilerList profilers_;
+
+    std::vector<WorkerPtr> workers_;
+    EventBits_t worker_bits_all_ { 0 };
+
+    //! Worker wake bits, worker stopped bits, idle bit.
+    core::StaticEventGroup event_group_;
+
+    //! Number of dispatched tasks, which haven't finished yet.
+    std::atomic<unsigned> pending_count_ { 0 };
+    std::atomic<uint32_t> steal_count_ { 0 };
+    std::atomic<bool> stopped_ { false };
+    bool started_ { false };
+};
+
+} // namespace scheduler
+} // namespace ocs
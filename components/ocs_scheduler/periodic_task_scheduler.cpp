@@ -60,10 +60,18 @@ PeriodicTaskScheduler::add(ITask& task, const char* id, core::Time interval) {
     configASSERT(node);
 
     nodes_.push_back(node);
+    profilers_.push_back(&node->profiler());
 
     return status::StatusCode::OK;
 }
 
+status::StatusCode PeriodicTaskScheduler::add(ITask& task,
+                                              const char* id,
+                                              core::Time interval,
+                                              TaskParams) {
+    return add(task, id, interval);
+}
+
 status::StatusCode PeriodicTaskScheduler::start() {
     ocs_logi(log_tag_.c_str(),
              "start tasks scheduling: count=%u/%u task_min_interval=%lli(ms)", count(),
@@ -84,12 +92,14 @@ status::StatusCode PeriodicTaskScheduler::run() {
     estimator_.begin();
 
     const auto start_ts = clock_.now();
-    run_();
+    const auto deadline = run_();
     const auto total_ts = clock_.now() - start_ts;
 
     total_ts_min_ = std::min(total_ts_min_, total_ts);
     total_ts_max_ = std::max(total_ts_max_, total_ts);
 
+    estimator_.update(deadline, total_ts_min_);
+
     const auto estimated_delay = estimator_.estimate();
 
     ocs_logd(log_tag_.c_str(),
@@ -99,19 +109,42 @@ status::StatusCode PeriodicTaskScheduler::run() {
              task_min_interval_ / core::Duration::millisecond,
              pdTICKS_TO_MS(estimated_delay));
 
-    vTaskDelay(estimated_delay);
+    delay_.delay(estimated_delay);
 
     return status::StatusCode::OK;
 }
 
-void PeriodicTaskScheduler::run_() {
+status::StatusCode PeriodicTaskScheduler::wake(const char* id) {
+    for (auto& node : nodes_) {
+        if (strcmp(node->id(), id) == 0) {
+            node->wake();
+            delay_.interrupt();
+
+            return status::StatusCode::OK;
+        }
+    }
+
+    return status::StatusCode::InvalidArg;
+}
+
+const ITaskScheduler::ProfilerList& PeriodicTaskScheduler::profilers() const {
+    return profilers_;
+}
+
+core::Time PeriodicTaskScheduler::run_() {
+    core::Time deadline = INT64_MAX;
+
     for (auto& node : nodes_) {
         const auto code = node->run();
         if (code != status::StatusCode::OK) {
             ocs_loge(log_tag_.c_str(), "failed to run task: id=%s code=%s", node->id(),
                      status::code_to_str(code));
         }
+
+        deadline = std::min(deadline, node->deadline());
     }
+
+    return deadline;
 }
 
 PeriodicTaskScheduler::Node::Node(core::IClock& clock,
@@ -119,17 +152,41 @@ PeriodicTaskScheduler::Node::Node(core::IClock& clock,
                                   const char* id,
                                   core::Time interval)
     : id_(id)
+    , clock_(clock)
     , task_(task)
-    , limiter_(clock, interval) {
+    , limiter_(clock, interval)
+    , profiler_(id, interval) {
 }
 
 status::StatusCode PeriodicTaskScheduler::Node::run() {
-    return limiter_.allow() ? task_.run() : status::StatusCode::OK;
+    const bool woken = woken_.exchange(false, std::memory_order_acquire);
+
+    if (!limiter_.allow() && !woken) {
+        return status::StatusCode::OK;
+    }
+
+    const auto start_ts = clock_.now();
+    const auto code = task_.run();
+    profiler_.record(start_ts, clock_.now(), code);
+
+    return code;
 }
 
 const char* PeriodicTaskScheduler::Node::id() const {
     return id_.c_str();
 }
 
+core::Time PeriodicTaskScheduler::Node::deadline() const {
+    return limiter_.deadline();
+}
+
+void PeriodicTaskScheduler::Node::wake() {
+    woken_.store(true, std::memory_order_release);
+}
+
+const TaskProfiler& PeriodicTaskScheduler::Node::profiler() const {
+    return profiler_;
+}
+
 } // namespace scheduler
 } // namespace ocs
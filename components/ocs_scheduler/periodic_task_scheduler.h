@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -17,8 +18,10 @@
 #include "ocs_core/noncopyable.h"
 #include "ocs_core/rate_limiter.h"
 #include "ocs_scheduler/idelay_estimator.h"
+#include "ocs_scheduler/interruptible_delay.h"
 #include "ocs_scheduler/itask.h"
 #include "ocs_scheduler/itask_scheduler.h"
+#include "ocs_scheduler/task_profiler.h"
 
 namespace ocs {
 namespace scheduler {
@@ -61,6 +64,11 @@ public:
     //!    minimum periodic interval.
     status::StatusCode add(ITask& task, const char* id, core::Time interval);
 
+    //! Add task to be run once per interval, @p params are ignored, since all tasks
+    //! are run on the same FreeRTOS task.
+    status::StatusCode
+    add(ITask& task, const char* id, core::Time interval, TaskParams params) override;
+
     //! Start tasks scheduling.
     status::StatusCode start() override;
 
@@ -68,8 +76,18 @@ public:
     status::StatusCode stop() override;
 
     //! Run all periodic tasks.
+    //!
+    //! @remarks
+    //!  The earliest task deadline and the minimum run cost are reported to the
+    //!  estimator before estimating the delay.
     status::StatusCode run() override;
 
+    //! Run task with @p id on the next round and interrupt the delay between rounds.
+    status::StatusCode wake(const char* id) override;
+
+    //! Return execution statistics of the registered tasks.
+    const ProfilerList& profilers() const override;
+
 private:
     class Node : public ITask, public core::NonCopyable<> {
     public:
@@ -79,18 +97,30 @@ private:
 
         const char* id() const;
 
+        //! Return the point in time when the task can be run.
+        core::Time deadline() const;
+
+        //! Run the task on the next run() call, regardless of the task interval.
+        void wake();
+
+        const TaskProfiler& profiler() const;
+
     private:
         const std::string id_;
 
+        core::IClock& clock_;
         ITask& task_;
 
         core::RateLimiter limiter_;
+        TaskProfiler profiler_;
+
+        std::atomic<bool> woken_ { false };
     };
 
     using NodePtr = std::shared_ptr<Node>;
     using NodeList = std::vector<NodePtr>;
 
-    void run_();
+    core::Time run_();
 
     const unsigned max_count_ { 0 };
     const std::string log_tag_;
@@ -102,8 +132,10 @@ private:
 
     core::IClock& clock_;
     IDelayEstimator& estimator_;
+    InterruptibleDelay delay_;
 
     NodeList nodes_;
+    ProfilerList profilers_;
 };
 
 } // namespace scheduler
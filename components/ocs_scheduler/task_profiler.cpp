@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "ocs_core/lock_guard.h"
+#include "ocs_scheduler/task_profiler.h"
+
+namespace ocs {
+namespace scheduler {
+
+TaskProfiler::TaskProfiler(const char* id, core::Time interval)
+    : id_(id)
+    , interval_(interval) {
+}
+
+const char* TaskProfiler::id() const {
+    return id_.c_str();
+}
+
+core::Time TaskProfiler::interval() const {
+    return interval_;
+}
+
+void TaskProfiler::record(core::Time start, core::Time end, status::StatusCode code) {
+    const auto duration = std::max<core::Time>(end - start, 0);
+
+    core::LockGuard lock(mu_);
+
+    if (profile_.run_count) {
+        profile_.jitter_last = std::abs(start - start_ - interval_);
+        profile_.jitter_max = std::max(profile_.jitter_max, profile_.jitter_last);
+
+        profile_.time_min = std::min(profile_.time_min, duration);
+        profile_.time_max = std::max(profile_.time_max, duration);
+    } else {
+        profile_.time_min = duration;
+        profile_.time_max = duration;
+    }
+
+    start_ = start;
+
+    ++profile_.run_count;
+    if (code != status::StatusCode::OK) {
+        ++profile_.failure_count;
+    }
+
+    time_sum_ += duration;
+
+    profile_.time_last = duration;
+    profile_.time_mean = time_sum_ / profile_.run_count;
+
+    ++profile_.histogram[get_bucket_(duration)];
+}
+
+TaskProfiler::Profile TaskProfiler::get() const {
+    core::LockGuard lock(mu_);
+
+    return profile_;
+}
+
+unsigned TaskProfiler::get_bucket_(core::Time duration) {
+    unsigned bucket = 0;
+
+    while (duration > 1 && bucket < histogram_size - 1) {
+        duration >>= 1;
+        ++bucket;
+    }
+
+    return bucket;
+}
+
+} // namespace scheduler
+} // namespace ocs
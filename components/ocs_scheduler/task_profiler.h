@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include "ocs_core/noncopyable.h"
+#include "ocs_core/static_mutex.h"
+#include "ocs_core/time.h"
+#include "ocs_status/code.h"
+
+namespace ocs {
+namespace scheduler {
+
+//! Collect execution statistics of a single scheduled task.
+//!
+//! @remarks
+//!  Statistics are recorded by the scheduler and can be read from any FreeRTOS task.
+class TaskProfiler : public core::NonCopyable<> {
+public:
+    //! Number of buckets in the execution time histogram.
+    static constexpr unsigned histogram_size = 20;
+
+    //! All durations are in microseconds.
+    struct Profile {
+        //! Number of times the task was run.
+        uint32_t run_count { 0 };
+
+        //! Number of times the task has failed.
+        uint32_t failure_count { 0 };
+
+        core::Time time_last { 0 };
+        core::Time time_min { 0 };
+        core::Time time_max { 0 };
+        core::Time time_mean { 0 };
+
+        //! Deviation of the time passed between two task runs from the task interval.
+        core::Time jitter_last { 0 };
+        core::Time jitter_max { 0 };
+
+        //! Bucket N counts runs that took [2^N, 2^(N+1)) microseconds. The first bucket
+        //! also counts instant runs, the last bucket also counts all longer runs.
+        std::array<uint32_t, histogram_size> histogram {};
+    };
+
+    //! Initialize.
+    //!
+    //! @params
+    //!  - @p id - task identifier.
+    //!  - @p interval - expected time between two task runs.
+    TaskProfiler(const char* id, core::Time interval);
+
+    //! Return task identifier.
+    const char* id() const;
+
+    //! Return expected time between two task runs.
+    core::Time interval() const;
+
+    //! Record a single task run.
+    //!
+    //! @params
+    //!  - @p start - when the task was started.
+    //!  - @p end - when the task was finished.
+    //!  - @p code - task result.
+    void record(core::Time start, core::Time end, status::StatusCode code);
+
+    //! Return the recorded statistics.
+    Profile get() const;
+
+private:
+    static unsigned get_bucket_(core::Time duration);
+
+    const std::string id_;
+    const core::Time interval_ { 0 };
+
+    mutable core::StaticMutex mu_;
+
+    core::Time start_ { 0 };
+    core::Time time_sum_ { 0 };
+
+    Profile profile_;
+};
+
+} // namespace scheduler
+} // namespace ocs
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "unity.h"
+
+#include "ocs_scheduler/adaptive_delay_estimator.h"
+#include "ocs_scheduler/periodic_task_scheduler.h"
+#include "ocs_test/test_clock.h"
+#include "ocs_test/test_task.h"
+
+namespace ocs {
+namespace scheduler {
+
+namespace {
+
+const core::Time tick = portTICK_PERIOD_MS * core::Duration::millisecond;
+
+} // namespace
+
+TEST_CASE("Adaptive delay estimator: no deadline",
+          "[ocs_scheduler], [adaptive_delay_estimator]") {
+    const TickType_t max_delay = pdMS_TO_TICKS(1000);
+
+    test::TestClock clock;
+    clock.value = 42;
+
+    AdaptiveDelayEstimator estimator(clock, max_delay);
+
+    estimator.begin();
+    TEST_ASSERT_EQUAL(max_delay, estimator.estimate());
+    TEST_ASSERT_EQUAL(0, estimator.overrun_count());
+}
+
+TEST_CASE("Adaptive delay estimator: sleep until deadline",
+          "[ocs_scheduler], [adaptive_delay_estimator]") {
+    const TickType_t max_delay = pdMS_TO_TICKS(1000);
+
+    test::TestClock clock;
+    clock.value = 42;
+
+    AdaptiveDelayEstimator estimator(clock, max_delay);
+
+    estimator.begin();
+    estimator.update(clock.value + tick * 10, 0);
+    TEST_ASSERT_EQUAL(10, estimator.estimate());
+
+    // The earliest deadline is used.
+    estimator.begin();
+    estimator.update(clock.value + tick * 10, 0);
+    estimator.update(clock.value + tick * 5, 0);
+    estimator.update(clock.value + tick * 7, 0);
+    TEST_ASSERT_EQUAL(5, estimator.estimate());
+
+    // Round up to the next tick.
+    estimator.begin();
+    estimator.update(clock.value + tick * 5 + 1, 0);
+    TEST_ASSERT_EQUAL(6, estimator.estimate());
+
+    // Deadline has already passed.
+    estimator.begin();
+    estimator.update(clock.value, 0);
+    TEST_ASSERT_EQUAL(0, estimator.estimate());
+}
+
+TEST_CASE("Adaptive delay estimator: subtract run cost",
+          "[ocs_scheduler], [adaptive_delay_estimator]") {
+    const TickType_t max_delay = pdMS_TO_TICKS(1000);
+
+    test::TestClock clock;
+    clock.value = 42;
+
+    AdaptiveDelayEstimator estimator(clock, max_delay);
+
+    estimator.begin();
+    estimator.update(clock.value + tick * 10, tick * 3);
+    TEST_ASSERT_EQUAL(7, estimator.estimate());
+
+    // Run cost exceeds the remaining time, but the deadline hasn't passed yet.
+    estimator.begin();
+    estimator.update(clock.value + tick * 2, tick * 3);
+    TEST_ASSERT_EQUAL(1, estimator.estimate());
+}
+
+TEST_CASE("Adaptive delay estimator: limit delay",
+          "[ocs_scheduler], [adaptive_delay_estimator]") {
+    const TickType_t max_delay = 10;
+
+    test::TestClock clock;
+    clock.value = 42;
+
+    AdaptiveDelayEstimator estimator(clock, max_delay);
+
+    estimator.begin();
+    estimator.update(clock.value + tick * 100, 0);
+    TEST_ASSERT_EQUAL(max_delay, estimator.estimate());
+}
+
+TEST_CASE("Adaptive delay estimator: count overruns",
+          "[ocs_scheduler], [adaptive_delay_estimator]") {
+    const TickType_t max_delay = pdMS_TO_TICKS(1000);
+
+    test::TestClock clock;
+    clock.value = 42;
+
+    AdaptiveDelayEstimator estimator(clock, max_delay);
+
+    estimator.begin();
+    estimator.update(clock.value + tick * 10, 0);
+    TEST_ASSERT_EQUAL(10, estimator.estimate());
+
+    // Woken up in time.
+    clock.value += tick * 10;
+    estimator.begin();
+    TEST_ASSERT_EQUAL(0, estimator.overrun_count());
+
+    estimator.update(clock.value + tick * 10, 0);
+    TEST_ASSERT_EQUAL(10, estimator.estimate());
+
+    // Woken up within one tick after the deadline.
+    clock.value += tick * 11;
+    estimator.begin();
+    TEST_ASSERT_EQUAL(0, estimator.overrun_count());
+
+    estimator.update(clock.value + tick * 10, 0);
+    TEST_ASSERT_EQUAL(10, estimator.estimate());
+
+    // Woken up too late.
+    clock.value += tick * 12;
+    estimator.begin();
+    TEST_ASSERT_EQUAL(1, estimator.overrun_count());
+
+    // No deadline was reported.
+    clock.value += tick * 100;
+    estimator.begin();
+    TEST_ASSERT_EQUAL(1, estimator.overrun_count());
+}
+
+TEST_CASE("Adaptive delay estimator: periodic task scheduler",
+          "[ocs_scheduler], [adaptive_delay_estimator]") {
+    const core::Time interval = tick * 2;
+
+    test::TestClock clock;
+    clock.value = 42;
+
+    test::TestTask task(status::StatusCode::OK);
+    AdaptiveDelayEstimator estimator(clock, pdMS_TO_TICKS(1000));
+
+    PeriodicTaskScheduler task_scheduler(clock, estimator, "scheduler", 16);
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.add(task, "task", interval));
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+    TEST_ASSERT_EQUAL(1, task.run_call_count());
+    TEST_ASSERT_EQUAL(0, estimator.overrun_count());
+
+    // Task deadline was missed.
+    clock.value += interval + tick * 2;
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+    TEST_ASSERT_EQUAL(2, task.run_call_count());
+    TEST_ASSERT_EQUAL(1, estimator.overrun_count());
+}
+
+} // namespace scheduler
+} // namespace ocs
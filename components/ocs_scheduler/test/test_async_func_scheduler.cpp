@@ -6,13 +6,31 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 
+#include <memory>
+#include <vector>
+
+#include "esp_system.h"
+#include "esp_timer.h"
 #include "unity.h"
 
+#include "ocs_core/log.h"
+#include "ocs_core/time.h"
+#include "ocs_scheduler/async_func.h"
 #include "ocs_scheduler/async_func_scheduler.h"
+#include "ocs_scheduler/constant_delay_estimator.h"
+#include "ocs_scheduler/periodic_task_scheduler.h"
+#include "ocs_test/test_clock.h"
+#include "ocs_test/test_task.h"
 
 namespace ocs {
 namespace scheduler {
 
+namespace {
+
+const char* log_tag = "test_async_func_scheduler";
+
+} // namespace
+
 TEST_CASE("Async func scheduler: no events", "[ocs_scheduler], [async_func_scheduler]") {
     AsyncFuncScheduler func_scheduler(1);
     TEST_ASSERT_EQUAL(status::StatusCode::OK, func_scheduler.run());
@@ -96,5 +114,383 @@ TEST_CASE("Async func scheduler: reschedule event",
     TEST_ASSERT_EQUAL(status::StatusCode::Timeout, future2->code());
 }
 
+TEST_CASE("Async func scheduler: futures are reused",
+          "[ocs_scheduler], [async_func_scheduler]") {
+    AsyncFuncScheduler func_scheduler(1);
+
+    // Futures are held by the caller, the scheduler should use the reserved ones.
+    auto future1 = func_scheduler.add([]() {
+        return status::StatusCode::OK;
+    });
+    TEST_ASSERT_NOT_NULL(future1);
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, func_scheduler.run());
+
+    auto future2 = func_scheduler.add([]() {
+        return status::StatusCode::Error;
+    });
+    TEST_ASSERT_NOT_NULL(future2);
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, func_scheduler.run());
+
+    // All futures are held by the caller.
+    TEST_ASSERT_NULL(func_scheduler.add([]() {
+        return status::StatusCode::OK;
+    }));
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, future1->code());
+    TEST_ASSERT_EQUAL(status::StatusCode::Error, future2->code());
+
+    // Future is released and can be reused.
+    future1 = nullptr;
+
+    auto future3 = func_scheduler.add([]() {
+        return status::StatusCode::Timeout;
+    });
+    TEST_ASSERT_NOT_NULL(future3);
+    TEST_ASSERT_EQUAL(status::StatusCode::Last, future3->code());
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, func_scheduler.run());
+    TEST_ASSERT_EQUAL(status::StatusCode::Timeout, future3->code());
+}
+
+TEST_CASE("Async func scheduler: futures are held until all copies are released",
+          "[ocs_scheduler], [async_func_scheduler]") {
+    AsyncFuncScheduler func_scheduler(1);
+
+    auto future1 = func_scheduler.add([]() {
+        return status::StatusCode::OK;
+    });
+    TEST_ASSERT_NOT_NULL(future1);
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, func_scheduler.run());
+
+    auto future2 = func_scheduler.add([]() {
+        return status::StatusCode::OK;
+    });
+    TEST_ASSERT_NOT_NULL(future2);
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, func_scheduler.run());
+
+    // Copy and weak reference keep the future in use.
+    auto future1_copy = future1;
+    std::weak_ptr<core::Future> future2_weak = future2;
+
+    future1 = nullptr;
+    future2 = nullptr;
+
+    TEST_ASSERT_NULL(func_scheduler.add([]() {
+        return status::StatusCode::OK;
+    }));
+    TEST_ASSERT_EQUAL(1, func_scheduler.get_stats(AsyncFuncScheduler::Priority::Normal)
+                             .drop_count);
+
+    future2_weak.reset();
+
+    auto future3 = func_scheduler.add([]() {
+        return status::StatusCode::Timeout;
+    });
+    TEST_ASSERT_NOT_NULL(future3);
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, func_scheduler.run());
+    TEST_ASSERT_EQUAL(status::StatusCode::Timeout, future3->code());
+
+    // The copy still holds the result of the first function.
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, future1_copy->code());
+
+    // Future is released while the function is pending, it's reused once the function
+    // is run.
+    future3 = nullptr;
+    future1_copy = nullptr;
+
+    TEST_ASSERT_NOT_NULL(func_scheduler.add([]() {
+        return status::StatusCode::OK;
+    }));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, func_scheduler.run());
+
+    TEST_ASSERT_NOT_NULL(func_scheduler.add([]() {
+        return status::StatusCode::OK;
+    }));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, func_scheduler.run());
+}
+
+TEST_CASE("Async func scheduler: add without memory allocation",
+          "[ocs_scheduler], [async_func_scheduler]") {
+    const unsigned max_event_count = 8;
+
+    AsyncFuncScheduler func_scheduler(max_event_count);
+
+    std::vector<AsyncFuncScheduler::FuturePtr> futures;
+    futures.reserve(max_event_count);
+
+    unsigned run_count = 0;
+
+    const auto free_size = esp_get_free_heap_size();
+
+    for (unsigned n = 0; n < max_event_count; ++n) {
+        auto future = func_scheduler.add([&run_count]() {
+            ++run_count;
+            return status::StatusCode::OK;
+        });
+        TEST_ASSERT_NOT_NULL(future);
+
+        futures.push_back(future);
+    }
+
+    TEST_ASSERT_EQUAL(free_size, esp_get_free_heap_size());
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, func_scheduler.run());
+    TEST_ASSERT_EQUAL(max_event_count, run_count);
+
+    for (auto& future : futures) {
+        TEST_ASSERT_EQUAL(status::StatusCode::OK, future->code());
+    }
+}
+
+TEST_CASE("Async func scheduler: run events in order of priority",
+          "[ocs_scheduler], [async_func_scheduler]") {
+    AsyncFuncScheduler func_scheduler(4);
+
+    std::vector<unsigned> order;
+
+    auto future1 = func_scheduler.add(
+        [&order]() {
+            order.push_back(1);
+            return status::StatusCode::OK;
+        },
+        AsyncFuncScheduler::Priority::Low);
+    TEST_ASSERT_NOT_NULL(future1);
+
+    auto future2 = func_scheduler.add([&order]() {
+        order.push_back(2);
+        return status::StatusCode::OK;
+    });
+    TEST_ASSERT_NOT_NULL(future2);
+
+    auto future3 = func_scheduler.add(
+        [&order]() {
+            order.push_back(3);
+            return status::StatusCode::OK;
+        },
+        AsyncFuncScheduler::Priority::High);
+    TEST_ASSERT_NOT_NULL(future3);
+
+    auto future4 = func_scheduler.add([&order]() {
+        order.push_back(4);
+        return status::StatusCode::OK;
+    });
+    TEST_ASSERT_NOT_NULL(future4);
+
+    using Priority = AsyncFuncScheduler::Priority;
+
+    TEST_ASSERT_EQUAL(1, func_scheduler.get_stats(Priority::High).depth);
+    TEST_ASSERT_EQUAL(2, func_scheduler.get_stats(Priority::Normal).depth);
+    TEST_ASSERT_EQUAL(1, func_scheduler.get_stats(Priority::Low).depth);
+
+    // Events are shared between all priorities.
+    TEST_ASSERT_NULL(func_scheduler.add(
+        []() {
+            return status::StatusCode::OK;
+        },
+        Priority::High));
+    TEST_ASSERT_EQUAL(1, func_scheduler.get_stats(Priority::High).drop_count);
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, func_scheduler.run());
+
+    TEST_ASSERT_EQUAL(4, order.size());
+    TEST_ASSERT_EQUAL(3, order[0]);
+    TEST_ASSERT_EQUAL(2, order[1]);
+    TEST_ASSERT_EQUAL(4, order[2]);
+    TEST_ASSERT_EQUAL(1, order[3]);
+
+    const auto stats = func_scheduler.get_stats(Priority::Normal);
+    TEST_ASSERT_EQUAL(0, stats.depth);
+    TEST_ASSERT_EQUAL(2, stats.depth_max);
+    TEST_ASSERT_EQUAL(2, stats.run_count);
+    TEST_ASSERT_EQUAL(0, stats.drop_count);
+}
+
+TEST_CASE("Async func scheduler: expired events aren't run",
+          "[ocs_scheduler], [async_func_scheduler]") {
+    AsyncFuncScheduler func_scheduler(2);
+
+    unsigned run_count = 0;
+
+    auto future1 = func_scheduler.add(
+        [&run_count]() {
+            ++run_count;
+            return status::StatusCode::OK;
+        },
+        AsyncFuncScheduler::Priority::Normal, pdMS_TO_TICKS(10));
+    TEST_ASSERT_NOT_NULL(future1);
+
+    auto future2 = func_scheduler.add(
+        [&run_count]() {
+            ++run_count;
+            return status::StatusCode::OK;
+        },
+        AsyncFuncScheduler::Priority::Normal, pdMS_TO_TICKS(1000));
+    TEST_ASSERT_NOT_NULL(future2);
+
+    vTaskDelay(pdMS_TO_TICKS(50));
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, func_scheduler.run());
+    TEST_ASSERT_EQUAL(1, run_count);
+
+    TEST_ASSERT_EQUAL(status::StatusCode::Timeout, future1->code());
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, future2->code());
+
+    const auto stats = func_scheduler.get_stats(AsyncFuncScheduler::Priority::Normal);
+    TEST_ASSERT_EQUAL(1, stats.expire_count);
+    TEST_ASSERT_EQUAL(1, stats.run_count);
+    TEST_ASSERT_TRUE(stats.wait_max >= 40);
+}
+
+TEST_CASE("Async func scheduler: high priority event wakes scheduler",
+          "[ocs_scheduler], [async_func_scheduler]") {
+    const char* task_id = "func_scheduler";
+
+    test::TestClock clock;
+    clock.value = 42;
+
+    ConstantDelayEstimator estimator(pdMS_TO_TICKS(10));
+    PeriodicTaskScheduler task_scheduler(clock, estimator, "scheduler", 1);
+
+    AsyncFuncScheduler func_scheduler(2);
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.add(func_scheduler, task_id,
+                                                                 core::Duration::second));
+    func_scheduler.set_waker(task_scheduler, task_id);
+
+    // The first run is always allowed.
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+
+    auto future1 = func_scheduler.add([]() {
+        return status::StatusCode::OK;
+    });
+    TEST_ASSERT_NOT_NULL(future1);
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+    TEST_ASSERT_EQUAL(status::StatusCode::Last, future1->code());
+
+    auto future2 = func_scheduler.add(
+        []() {
+            return status::StatusCode::OK;
+        },
+        AsyncFuncScheduler::Priority::High);
+    TEST_ASSERT_NOT_NULL(future2);
+
+    // All pending events are handled once the scheduler is woken.
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, future1->code());
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, future2->code());
+}
+
+TEST_CASE("Async func scheduler: event with timeout wakes scheduler",
+          "[ocs_scheduler], [async_func_scheduler]") {
+    const char* task_id = "func_scheduler";
+
+    test::TestClock clock;
+    clock.value = 42;
+
+    ConstantDelayEstimator estimator(pdMS_TO_TICKS(10));
+    PeriodicTaskScheduler task_scheduler(clock, estimator, "scheduler", 1);
+
+    AsyncFuncScheduler func_scheduler(2);
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.add(func_scheduler, task_id,
+                                                                 core::Duration::second));
+    func_scheduler.set_waker(task_scheduler, task_id);
+
+    // The first run is always allowed.
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+
+    // Low priority, but it would expire before the next scheduled run.
+    auto future = func_scheduler.add(
+        []() {
+            return status::StatusCode::OK;
+        },
+        AsyncFuncScheduler::Priority::Low, pdMS_TO_TICKS(100));
+    TEST_ASSERT_NOT_NULL(future);
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, future->code());
+
+    const auto stats = func_scheduler.get_stats(AsyncFuncScheduler::Priority::Low);
+    TEST_ASSERT_EQUAL(1, stats.run_count);
+    TEST_ASSERT_EQUAL(0, stats.expire_count);
+}
+
+TEST_CASE("Async func: perform operation after caller stopped waiting",
+          "[ocs_scheduler], [async_func_scheduler]") {
+    AsyncFuncScheduler func_scheduler(1);
+    test::TestTask task(status::StatusCode::OK);
+
+    AsyncFunc func(func_scheduler, task, pdMS_TO_TICKS(10));
+
+    // Nobody runs the scheduler.
+    TEST_ASSERT_NOT_EQUAL(status::StatusCode::OK, func.run());
+    TEST_ASSERT_FALSE(task.was_run_called());
+
+    vTaskDelay(pdMS_TO_TICKS(50));
+
+    // Wait interval isn't the expiry timeout.
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, func_scheduler.run());
+    TEST_ASSERT_TRUE(task.was_run_called());
+
+    const auto stats = func_scheduler.get_stats(AsyncFuncScheduler::Priority::Normal);
+    TEST_ASSERT_EQUAL(1, stats.run_count);
+    TEST_ASSERT_EQUAL(0, stats.expire_count);
+}
+
+TEST_CASE("Async func: operation expires", "[ocs_scheduler], [async_func_scheduler]") {
+    AsyncFuncScheduler func_scheduler(1);
+    test::TestTask task(status::StatusCode::OK);
+
+    AsyncFunc func(func_scheduler, task, pdMS_TO_TICKS(10),
+                   AsyncFuncScheduler::Priority::Normal, pdMS_TO_TICKS(10));
+
+    TEST_ASSERT_NOT_EQUAL(status::StatusCode::OK, func.run());
+
+    vTaskDelay(pdMS_TO_TICKS(50));
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, func_scheduler.run());
+    TEST_ASSERT_FALSE(task.was_run_called());
+
+    const auto stats = func_scheduler.get_stats(AsyncFuncScheduler::Priority::Normal);
+    TEST_ASSERT_EQUAL(0, stats.run_count);
+    TEST_ASSERT_EQUAL(1, stats.expire_count);
+}
+
+TEST_CASE("Async func scheduler: throughput and latency",
+          "[ocs_scheduler], [async_func_scheduler], [benchmark]") {
+    const unsigned max_event_count = 16;
+    const unsigned round_count = 1000;
+
+    AsyncFuncScheduler func_scheduler(max_event_count);
+
+    core::Time add_ts = 0;
+    core::Time latency_ts = 0;
+
+    const auto start_ts = esp_timer_get_time();
+
+    for (unsigned round = 0; round < round_count; ++round) {
+        for (unsigned n = 0; n < max_event_count; ++n) {
+            const auto ts = esp_timer_get_time();
+
+            auto future = func_scheduler.add([ts, &latency_ts]() {
+                latency_ts += esp_timer_get_time() - ts;
+                return status::StatusCode::OK;
+            });
+            TEST_ASSERT_NOT_NULL(future);
+
+            add_ts += esp_timer_get_time() - ts;
+        }
+
+        TEST_ASSERT_EQUAL(status::StatusCode::OK, func_scheduler.run());
+    }
+
+    const auto total_ts = esp_timer_get_time() - start_ts;
+    const unsigned event_count = max_event_count * round_count;
+
+    ocs_logi(log_tag,
+             "throughput and latency: events=%u total=%lli(usec) add=%lli(nsec) "
+             "latency=%lli(usec)",
+             event_count, total_ts, add_ts * 1000 / event_count,
+             latency_ts / event_count);
+}
+
 } // namespace scheduler
 } // namespace ocs
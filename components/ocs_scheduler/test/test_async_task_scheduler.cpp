@@ -7,10 +7,13 @@
  */
 
 #include <memory>
+#include <string>
 #include <vector>
 
+#include "esp_timer.h"
 #include "unity.h"
 
+#include "ocs_core/log.h"
 #include "ocs_scheduler/async_task_scheduler.h"
 #include "ocs_scheduler/constant_delay_estimator.h"
 #include "ocs_test/test_task.h"
@@ -20,6 +23,23 @@ namespace scheduler {
 
 namespace {
 
+const char* log_tag = "test_async_task_scheduler";
+
+class NoopTask : public ITask, public core::NonCopyable<> {
+public:
+    status::StatusCode run() override {
+        ++run_count_;
+        return status::StatusCode::OK;
+    }
+
+    unsigned run_count() const {
+        return run_count_;
+    }
+
+private:
+    unsigned run_count_ { 0 };
+};
+
 void wait_task(ITaskScheduler& scheduler, test::TestTask& task) {
     while (true) {
         TEST_ASSERT_EQUAL(status::StatusCode::OK, scheduler.run());
@@ -178,5 +198,92 @@ TEST_CASE("Async task scheduler: register tasks overflow",
                       scheduler.add(task, "test_task", core::Duration::millisecond * 10));
 }
 
+TEST_CASE("Async task scheduler: register tasks across multiple event groups",
+          "[ocs_scheduler], [async_task_scheduler]") {
+    const char* scheduler_id = "test";
+    const unsigned max_count = AsyncTaskScheduler::bits_per_group * 2 + 5;
+
+    ConstantDelayEstimator estimator(pdMS_TO_TICKS(30));
+    AsyncTaskScheduler scheduler(estimator, scheduler_id, max_count);
+    TEST_ASSERT_EQUAL(max_count, scheduler.max_count());
+
+    using TaskPtr = std::shared_ptr<test::TestTask>;
+    std::vector<TaskPtr> tasks;
+
+    for (unsigned n = 0; n < scheduler.max_count(); ++n) {
+        TaskPtr task(new (std::nothrow) test::TestTask(status::StatusCode::OK));
+        TEST_ASSERT_NOT_NULL(task);
+
+        tasks.push_back(task);
+    }
+
+    for (unsigned n = 0; n < tasks.size(); ++n) {
+        const std::string task_id = std::string("test_task_") + std::to_string(n);
+
+        TEST_ASSERT_EQUAL(
+            status::StatusCode::OK,
+            scheduler.add(*tasks[n], task_id.c_str(), core::Duration::millisecond * 30));
+    }
+
+    test::TestTask task(status::StatusCode::OK);
+    TEST_ASSERT_EQUAL(status::StatusCode::Error,
+                      scheduler.add(task, "test_task", core::Duration::millisecond * 10));
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, scheduler.start());
+
+    // Reset tasks as they are run at startup.
+    for (auto& task : tasks) {
+        task->reset(status::StatusCode::OK);
+    }
+
+    for (auto& task : tasks) {
+        wait_task(scheduler, *task);
+    }
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, scheduler.stop());
+}
+
+TEST_CASE("Async task scheduler: dispatch cost",
+          "[ocs_scheduler], [async_task_scheduler], [benchmark]") {
+    const core::Time interval = core::Duration::millisecond * 100;
+    const unsigned counts[] = { 8, 24, 64, 128 };
+
+    for (const auto count : counts) {
+        ConstantDelayEstimator estimator(portMAX_DELAY);
+        AsyncTaskScheduler scheduler(estimator, "test", count);
+
+        std::vector<std::shared_ptr<NoopTask>> tasks;
+
+        for (unsigned n = 0; n < count; ++n) {
+            std::shared_ptr<NoopTask> task(new (std::nothrow) NoopTask());
+            TEST_ASSERT_NOT_NULL(task);
+
+            const std::string task_id = std::string("test_task_") + std::to_string(n);
+            TEST_ASSERT_EQUAL(status::StatusCode::OK,
+                              scheduler.add(*task, task_id.c_str(), interval));
+
+            tasks.push_back(task);
+        }
+
+        TEST_ASSERT_EQUAL(status::StatusCode::OK, scheduler.start());
+
+        // Let all timers to fire, so all events are pending when the scheduler is run.
+        vTaskDelay(pdMS_TO_TICKS(interval / core::Duration::millisecond) * 3 / 2);
+        TEST_ASSERT_EQUAL(status::StatusCode::OK, scheduler.stop());
+
+        const auto start_ts = esp_timer_get_time();
+        TEST_ASSERT_EQUAL(status::StatusCode::OK, scheduler.run());
+        const auto dispatch_ts = esp_timer_get_time() - start_ts;
+
+        for (const auto& task : tasks) {
+            // Once on scheduler start, once on the timer event.
+            TEST_ASSERT_EQUAL(2, task->run_count());
+        }
+
+        ocs_logi(log_tag, "dispatch cost: count=%u total=%lli(usec) per_task=%lli(usec)",
+                 count, dispatch_ts, dispatch_ts / count);
+    }
+}
+
 } // namespace scheduler
 } // namespace ocs
@@ -0,0 +1,401 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "unity.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "ocs_core/noncopyable.h"
+#include "ocs_scheduler/constant_delay_estimator.h"
+#include "ocs_scheduler/deadline_task_scheduler.h"
+#include "ocs_scheduler/periodic_task_scheduler.h"
+#include "ocs_system/default_clock.h"
+#include "ocs_test/test_clock.h"
+#include "ocs_test/test_task.h"
+
+namespace ocs {
+namespace scheduler {
+
+namespace {
+
+class TimestampTask : public ITask, public core::NonCopyable<> {
+public:
+    explicit TimestampTask(core::IClock& clock)
+        : clock_(clock) {
+    }
+
+    status::StatusCode run() override {
+        timestamps_.push_back(clock_.now());
+
+        return status::StatusCode::OK;
+    }
+
+    unsigned count() const {
+        return timestamps_.size();
+    }
+
+    //! Return the maximum deviation of the running interval from @p interval.
+    core::Time jitter(core::Time interval) const {
+        core::Time jitter = 0;
+
+        for (unsigned n = 1; n < timestamps_.size(); ++n) {
+            const auto passed = timestamps_[n] - timestamps_[n - 1];
+            jitter = std::max(jitter, std::abs(passed - interval));
+        }
+
+        return jitter;
+    }
+
+private:
+    core::IClock& clock_;
+
+    std::vector<core::Time> timestamps_;
+};
+
+//! Wake the tasks of the scheduler from a separate FreeRTOS task.
+class Waker : public core::NonCopyable<> {
+public:
+    Waker(ITaskScheduler& scheduler, std::vector<std::string> ids, unsigned count)
+        : count_(count)
+        , ids_(std::move(ids))
+        , scheduler_(scheduler) {
+    }
+
+    bool start() {
+        const BaseType_t core = portNUM_PROCESSORS > 1 ? 1 : tskNO_AFFINITY;
+
+        return xTaskCreatePinnedToCore(run_, "deadline_waker", 4096, this,
+                                       tskIDLE_PRIORITY + 1, nullptr, core)
+            == pdPASS;
+    }
+
+    bool done() const {
+        return done_.load(std::memory_order_acquire);
+    }
+
+    unsigned failure_count() const {
+        return failure_count_.load(std::memory_order_relaxed);
+    }
+
+private:
+    static void run_(void* arg) {
+        Waker& self = *static_cast<Waker*>(arg);
+
+        for (unsigned n = 0; n < self.count_; ++n) {
+            const auto& id = self.ids_[n % self.ids_.size()];
+
+            if (self.scheduler_.wake(id.c_str()) != status::StatusCode::OK) {
+                self.failure_count_.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            if (n % 16 == 0) {
+                vTaskDelay(1);
+            }
+        }
+
+        self.done_.store(true, std::memory_order_release);
+        vTaskDelete(nullptr);
+    }
+
+    const unsigned count_ { 0 };
+    const std::vector<std::string> ids_;
+
+    ITaskScheduler& scheduler_;
+
+    std::atomic<unsigned> failure_count_ { 0 };
+    std::atomic<bool> done_ { false };
+};
+
+} // namespace
+
+TEST_CASE("Deadline task scheduler: add task",
+          "[ocs_scheduler], [deadline_task_scheduler]") {
+    const core::Time interval = core::Duration::second;
+    const TickType_t delay = pdMS_TO_TICKS(10);
+    const char* task_id = "test_task";
+
+    test::TestClock clock;
+    clock.value = 42;
+
+    test::TestTask task(status::StatusCode::OK);
+    ConstantDelayEstimator estimator(delay);
+
+    DeadlineTaskScheduler task_scheduler(clock, estimator, "scheduler", 16);
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK,
+                      task_scheduler.add(task, task_id, interval));
+
+    TEST_ASSERT_EQUAL(0, task.run_call_count());
+
+    // The first run is always allowed.
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+    TEST_ASSERT_EQUAL(1, task.run_call_count());
+    task.reset(status::StatusCode::OK);
+
+    clock.value += (interval - 1);
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+    TEST_ASSERT_EQUAL(0, task.run_call_count());
+
+    clock.value += 1;
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+    TEST_ASSERT_EQUAL(1, task.run_call_count());
+    task.reset(status::StatusCode::OK);
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+    TEST_ASSERT_EQUAL(0, task.run_call_count());
+}
+
+TEST_CASE("Deadline task scheduler: add same task twice",
+          "[ocs_scheduler], [deadline_task_scheduler]") {
+    const TickType_t delay = pdMS_TO_TICKS(10);
+
+    test::TestClock clock;
+    test::TestTask task(status::StatusCode::OK);
+    ConstantDelayEstimator estimator(delay);
+
+    DeadlineTaskScheduler task_scheduler(clock, estimator, "scheduler", 16);
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK,
+                      task_scheduler.add(task, "test_task", core::Duration::second));
+    TEST_ASSERT_EQUAL(status::StatusCode::InvalidArg,
+                      task_scheduler.add(task, "test_task", core::Duration::second));
+}
+
+TEST_CASE("Deadline task scheduler: max number of tasks overflow",
+          "[ocs_scheduler], [deadline_task_scheduler]") {
+    const core::Time interval = core::Duration::second;
+    const TickType_t delay = pdMS_TO_TICKS(10);
+
+    test::TestClock clock;
+    clock.value = 42;
+
+    ConstantDelayEstimator estimator(delay);
+    DeadlineTaskScheduler task_scheduler(clock, estimator, "scheduler", 1);
+
+    test::TestTask task1(status::StatusCode::OK);
+    test::TestTask task2(status::StatusCode::OK);
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK,
+                      task_scheduler.add(task1, "task_1", interval));
+    TEST_ASSERT_EQUAL(status::StatusCode::Error,
+                      task_scheduler.add(task2, "task_2", interval));
+    TEST_ASSERT_EQUAL(1, task_scheduler.count());
+}
+
+TEST_CASE("Deadline task scheduler: run only due tasks",
+          "[ocs_scheduler], [deadline_task_scheduler]") {
+    const TickType_t delay = pdMS_TO_TICKS(10);
+
+    test::TestClock clock;
+    clock.value = 42;
+
+    ConstantDelayEstimator estimator(delay);
+    DeadlineTaskScheduler task_scheduler(clock, estimator, "scheduler", 16);
+
+    test::TestTask fast_task(status::StatusCode::OK);
+    test::TestTask slow_task(status::StatusCode::OK);
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK,
+                      task_scheduler.add(slow_task, "slow_task", core::Duration::second));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK,
+                      task_scheduler.add(fast_task, "fast_task",
+                                         core::Duration::millisecond * 100));
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+    TEST_ASSERT_EQUAL(1, fast_task.run_call_count());
+    TEST_ASSERT_EQUAL(1, slow_task.run_call_count());
+
+    for (unsigned n = 0; n < 9; ++n) {
+        clock.value += core::Duration::millisecond * 100;
+        TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+    }
+    TEST_ASSERT_EQUAL(10, fast_task.run_call_count());
+    TEST_ASSERT_EQUAL(1, slow_task.run_call_count());
+
+    clock.value += core::Duration::millisecond * 100;
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+    TEST_ASSERT_EQUAL(11, fast_task.run_call_count());
+    TEST_ASSERT_EQUAL(2, slow_task.run_call_count());
+}
+
+TEST_CASE("Deadline task scheduler: late run doesn't shift deadline",
+          "[ocs_scheduler], [deadline_task_scheduler]") {
+    const core::Time interval = core::Duration::second;
+    const core::Time lateness = core::Duration::millisecond * 300;
+    const TickType_t delay = pdMS_TO_TICKS(10);
+
+    test::TestClock clock;
+    clock.value = 42;
+
+    test::TestTask task(status::StatusCode::OK);
+    ConstantDelayEstimator estimator(delay);
+
+    DeadlineTaskScheduler task_scheduler(clock, estimator, "scheduler", 16);
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.add(task, "task", interval));
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+    TEST_ASSERT_EQUAL(1, task.run_call_count());
+
+    // Scheduler is woken up later than expected.
+    clock.value += interval + lateness;
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+    TEST_ASSERT_EQUAL(2, task.run_call_count());
+
+    // The next deadline is still aligned to the task interval.
+    clock.value += interval - lateness;
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+    TEST_ASSERT_EQUAL(3, task.run_call_count());
+
+    // Missed deadlines are skipped.
+    clock.value += interval * 3;
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+    TEST_ASSERT_EQUAL(4, task.run_call_count());
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+    TEST_ASSERT_EQUAL(4, task.run_call_count());
+}
+
+TEST_CASE("Deadline task scheduler: wake task",
+          "[ocs_scheduler], [deadline_task_scheduler]") {
+    const core::Time interval = core::Duration::second;
+    const TickType_t delay = pdMS_TO_TICKS(10);
+
+    test::TestClock clock;
+    clock.value = 42;
+
+    test::TestTask task(status::StatusCode::OK);
+    ConstantDelayEstimator estimator(delay);
+
+    DeadlineTaskScheduler task_scheduler(clock, estimator, "scheduler", 16);
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.add(task, "task", interval));
+
+    TEST_ASSERT_EQUAL(status::StatusCode::InvalidArg, task_scheduler.wake("unknown"));
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+    TEST_ASSERT_EQUAL(1, task.run_call_count());
+    task.reset(status::StatusCode::OK);
+
+    // Woken task is run before its deadline.
+    clock.value += interval / 2;
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.wake("task"));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+    TEST_ASSERT_EQUAL(1, task.run_call_count());
+    task.reset(status::StatusCode::OK);
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+    TEST_ASSERT_EQUAL(0, task.run_call_count());
+
+    // The deadline isn't changed.
+    clock.value += interval / 2;
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+    TEST_ASSERT_EQUAL(1, task.run_call_count());
+}
+
+TEST_CASE("Deadline task scheduler: wake task from another task while running",
+          "[ocs_scheduler], [deadline_task_scheduler]") {
+    const unsigned task_count = 8;
+    const unsigned wake_count = 2000;
+
+    system::DefaultClock clock;
+    ConstantDelayEstimator estimator(pdMS_TO_TICKS(10));
+
+    DeadlineTaskScheduler task_scheduler(clock, estimator, "scheduler", task_count + 1);
+
+    // Tasks with short intervals constantly reorder the heap.
+    std::vector<std::unique_ptr<test::TestTask>> tasks;
+    std::vector<std::string> ids;
+
+    for (unsigned n = 0; n < task_count; ++n) {
+        tasks.emplace_back(new (std::nothrow) test::TestTask(status::StatusCode::OK));
+        TEST_ASSERT_NOT_NULL(tasks.back());
+
+        ids.push_back("task_" + std::to_string(n));
+
+        TEST_ASSERT_EQUAL(status::StatusCode::OK,
+                          task_scheduler.add(*tasks.back(), ids.back().c_str(),
+                                             core::Duration::millisecond * (n + 1)));
+    }
+
+    // Task which is run only when it's woken.
+    test::TestTask woken_task(status::StatusCode::OK);
+    TEST_ASSERT_EQUAL(status::StatusCode::OK,
+                      task_scheduler.add(woken_task, "woken_task", core::Duration::hour));
+    ids.push_back("woken_task");
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.start());
+
+    // The first run is always allowed.
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+    TEST_ASSERT_EQUAL(1, woken_task.run_call_count());
+
+    Waker waker(task_scheduler, ids, wake_count);
+    TEST_ASSERT_TRUE(waker.start());
+
+    while (!waker.done()) {
+        TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+    }
+
+    // Handle the last wake.
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+
+    TEST_ASSERT_EQUAL(0, waker.failure_count());
+
+    TEST_ASSERT_TRUE(woken_task.run_call_count() > 1);
+    TEST_ASSERT_TRUE(woken_task.run_call_count()
+                     <= 1 + wake_count / static_cast<unsigned>(ids.size()));
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.stop());
+}
+
+TEST_CASE("Deadline task scheduler: jitter compared to periodic task scheduler",
+          "[ocs_scheduler], [deadline_task_scheduler]") {
+    const core::Time interval = core::Duration::millisecond * 100;
+    const unsigned run_count = 6;
+
+    // Maximum delay between rounds, both schedulers are configured the same way.
+    ConstantDelayEstimator estimator(pdMS_TO_TICKS(70));
+    system::DefaultClock clock;
+
+    TimestampTask periodic_task(clock);
+    PeriodicTaskScheduler periodic_scheduler(clock, estimator, "periodic", 1);
+    TEST_ASSERT_EQUAL(status::StatusCode::OK,
+                      periodic_scheduler.add(periodic_task, "task", interval));
+
+    while (periodic_task.count() < run_count) {
+        TEST_ASSERT_EQUAL(status::StatusCode::OK, periodic_scheduler.run());
+    }
+
+    TimestampTask deadline_task(clock);
+    DeadlineTaskScheduler deadline_scheduler(clock, estimator, "deadline", 1);
+    TEST_ASSERT_EQUAL(status::StatusCode::OK,
+                      deadline_scheduler.add(deadline_task, "task", interval));
+
+    while (deadline_task.count() < run_count) {
+        TEST_ASSERT_EQUAL(status::StatusCode::OK, deadline_scheduler.run());
+    }
+
+    // Periodic scheduler polls the task once per 70ms, so the task is run every 140ms.
+    // Deadline scheduler sleeps until the deadline, rounded up to the next tick.
+    const auto periodic_jitter = periodic_task.jitter(interval);
+    const auto deadline_jitter = deadline_task.jitter(interval);
+
+    TEST_ASSERT_TRUE(deadline_jitter < periodic_jitter);
+    TEST_ASSERT_TRUE(deadline_jitter
+                     <= portTICK_PERIOD_MS * core::Duration::millisecond * 2);
+}
+
+} // namespace scheduler
+} // namespace ocs
@@ -0,0 +1,517 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <atomic>
+#include <cinttypes>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "unity.h"
+
+#include "ocs_core/log.h"
+#include "ocs_core/noncopyable.h"
+#include "ocs_scheduler/constant_delay_estimator.h"
+#include "ocs_scheduler/multicore_task_scheduler.h"
+#include "ocs_system/default_clock.h"
+#include "ocs_test/test_task.h"
+
+namespace ocs {
+namespace scheduler {
+
+namespace {
+
+const char* log_tag = "test_multicore_task_scheduler";
+
+class BusyTask : public ITask, public core::NonCopyable<> {
+public:
+    BusyTask(std::atomic<unsigned>& running, core::Time duration)
+        : duration_(duration)
+        , running_(running) {
+    }
+
+    status::StatusCode run() override {
+        running_.fetch_add(1, std::memory_order_acq_rel);
+
+        const auto start_ts = esp_timer_get_time();
+        while (esp_timer_get_time() - start_ts < duration_) {
+        }
+
+        core_ = xPortGetCoreID();
+        task_ = xTaskGetCurrentTaskHandle();
+
+        running_.fetch_sub(1, std::memory_order_acq_rel);
+        run_count_.fetch_add(1, std::memory_order_acq_rel);
+
+        return status::StatusCode::OK;
+    }
+
+    unsigned run_count() const {
+        return run_count_.load(std::memory_order_acquire);
+    }
+
+    int core() const {
+        return core_;
+    }
+
+    TaskHandle_t task() const {
+        return task_;
+    }
+
+private:
+    const core::Time duration_ { 0 };
+
+    std::atomic<unsigned>& running_;
+    std::atomic<unsigned> run_count_ { 0 };
+
+    std::atomic<int> core_ { -1 };
+    std::atomic<TaskHandle_t> task_ { nullptr };
+};
+
+class ExclusiveTask : public ITask, public core::NonCopyable<> {
+public:
+    explicit ExclusiveTask(std::atomic<unsigned>& running)
+        : running_(running) {
+    }
+
+    status::StatusCode run() override {
+        if (running_.load(std::memory_order_acquire)) {
+            ++violation_count_;
+        }
+
+        ++run_count_;
+
+        return status::StatusCode::OK;
+    }
+
+    unsigned run_count() const {
+        return run_count_;
+    }
+
+    unsigned violation_count() const {
+        return violation_count_;
+    }
+
+private:
+    std::atomic<unsigned>& running_;
+
+    unsigned run_count_ { 0 };
+    unsigned violation_count_ { 0 };
+};
+
+class OverlapTask : public ITask, public core::NonCopyable<> {
+public:
+    OverlapTask(std::atomic<unsigned>& running,
+                std::atomic<bool>& exclusive_running,
+                core::Time duration,
+                bool exclusive)
+        : exclusive_(exclusive)
+        , duration_(duration)
+        , running_(running)
+        , exclusive_running_(exclusive_running) {
+    }
+
+    status::StatusCode run() override {
+        // Each side announces itself before checking the other one, so at least one
+        // of them notices the overlap.
+        if (exclusive_) {
+            exclusive_running_ = true;
+            check_(running_ == 0);
+        } else {
+            ++running_;
+            check_(!exclusive_running_);
+        }
+
+        const auto start_ts = esp_timer_get_time();
+        while (esp_timer_get_time() - start_ts < duration_) {
+        }
+
+        if (exclusive_) {
+            check_(running_ == 0);
+            exclusive_running_ = false;
+        } else {
+            check_(!exclusive_running_);
+            --running_;
+        }
+
+        ++run_count_;
+
+        return status::StatusCode::OK;
+    }
+
+    unsigned run_count() const {
+        return run_count_;
+    }
+
+    unsigned violation_count() const {
+        return violation_count_;
+    }
+
+private:
+    void check_(bool ok) {
+        if (!ok) {
+            ++violation_count_;
+        }
+    }
+
+    const bool exclusive_ { false };
+    const core::Time duration_ { 0 };
+
+    std::atomic<unsigned>& running_;
+    std::atomic<bool>& exclusive_running_;
+
+    std::atomic<unsigned> run_count_ { 0 };
+    std::atomic<unsigned> violation_count_ { 0 };
+};
+
+} // namespace
+
+TEST_CASE("Multicore task scheduler: add task",
+          "[ocs_scheduler], [multicore_task_scheduler]") {
+    system::DefaultClock clock;
+    ConstantDelayEstimator estimator(pdMS_TO_TICKS(10));
+
+    MulticoreTaskScheduler task_scheduler(clock, estimator, "scheduler", 2,
+                                          MulticoreTaskScheduler::Params());
+
+    test::TestTask task1(status::StatusCode::OK);
+    test::TestTask task2(status::StatusCode::OK);
+    test::TestTask task3(status::StatusCode::OK);
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK,
+                      task_scheduler.add(task1, "task_1", core::Duration::second));
+    TEST_ASSERT_EQUAL(status::StatusCode::InvalidArg,
+                      task_scheduler.add(task1, "task_1", core::Duration::second));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK,
+                      task_scheduler.add(task2, "task_2", core::Duration::second));
+    TEST_ASSERT_EQUAL(status::StatusCode::Error,
+                      task_scheduler.add(task3, "task_3", core::Duration::second));
+    TEST_ASSERT_EQUAL(2, task_scheduler.count());
+}
+
+TEST_CASE("Multicore task scheduler: run tasks on workers",
+          "[ocs_scheduler], [multicore_task_scheduler]") {
+    system::DefaultClock clock;
+    ConstantDelayEstimator estimator(pdMS_TO_TICKS(10));
+
+    MulticoreTaskScheduler task_scheduler(clock, estimator, "scheduler", 16,
+                                          MulticoreTaskScheduler::Params());
+
+    std::atomic<unsigned> running { 0 };
+    std::vector<std::unique_ptr<BusyTask>> tasks;
+
+    for (unsigned n = 0; n < 4; ++n) {
+        tasks.emplace_back(new (std::nothrow)
+                               BusyTask(running, core::Duration::millisecond));
+        TEST_ASSERT_NOT_NULL(tasks.back());
+
+        const std::string id = "task_" + std::to_string(n);
+        TEST_ASSERT_EQUAL(status::StatusCode::OK,
+                          task_scheduler.add(*tasks.back(), id.c_str(),
+                                             core::Duration::millisecond * 20));
+    }
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.start());
+
+    for (unsigned n = 0; n < 20; ++n) {
+        TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+    }
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.stop());
+
+    for (const auto& task : tasks) {
+        TEST_ASSERT_TRUE(task->run_count() > 0);
+        TEST_ASSERT_NOT_NULL(task->task());
+        TEST_ASSERT_TRUE(task->task() != xTaskGetCurrentTaskHandle());
+    }
+}
+
+TEST_CASE("Multicore task scheduler: core affinity",
+          "[ocs_scheduler], [multicore_task_scheduler]") {
+    system::DefaultClock clock;
+    ConstantDelayEstimator estimator(pdMS_TO_TICKS(10));
+
+    MulticoreTaskScheduler task_scheduler(clock, estimator, "scheduler", 16,
+                                          MulticoreTaskScheduler::Params());
+
+    std::atomic<unsigned> running { 0 };
+    std::vector<std::unique_ptr<BusyTask>> tasks;
+
+    for (int n = 0; n < portNUM_PROCESSORS; ++n) {
+        tasks.emplace_back(new (std::nothrow)
+                               BusyTask(running, core::Duration::millisecond));
+        TEST_ASSERT_NOT_NULL(tasks.back());
+
+        MulticoreTaskScheduler::TaskParams params;
+        params.core = n;
+
+        const std::string id = "task_" + std::to_string(n);
+        TEST_ASSERT_EQUAL(status::StatusCode::OK,
+                          task_scheduler.add(*tasks.back(), id.c_str(),
+                                             core::Duration::millisecond * 10, params));
+    }
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.start());
+
+    for (unsigned n = 0; n < 10; ++n) {
+        TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+    }
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.stop());
+
+    for (int n = 0; n < portNUM_PROCESSORS; ++n) {
+        TEST_ASSERT_TRUE(tasks[n]->run_count() > 0);
+        TEST_ASSERT_EQUAL(n, tasks[n]->core());
+    }
+}
+
+TEST_CASE("Multicore task scheduler: exclusive task",
+          "[ocs_scheduler], [multicore_task_scheduler]") {
+    system::DefaultClock clock;
+    ConstantDelayEstimator estimator(pdMS_TO_TICKS(10));
+
+    MulticoreTaskScheduler task_scheduler(clock, estimator, "scheduler", 16,
+                                          MulticoreTaskScheduler::Params());
+
+    std::atomic<unsigned> running { 0 };
+    std::vector<std::unique_ptr<BusyTask>> tasks;
+
+    for (unsigned n = 0; n < 4; ++n) {
+        tasks.emplace_back(new (std::nothrow)
+                               BusyTask(running, core::Duration::millisecond * 5));
+        TEST_ASSERT_NOT_NULL(tasks.back());
+
+        const std::string id = "task_" + std::to_string(n);
+        TEST_ASSERT_EQUAL(status::StatusCode::OK,
+                          task_scheduler.add(*tasks.back(), id.c_str(),
+                                             core::Duration::millisecond * 10));
+    }
+
+    ExclusiveTask exclusive_task(running);
+
+    MulticoreTaskScheduler::TaskParams params;
+    params.exclusive = true;
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK,
+                      task_scheduler.add(exclusive_task, "exclusive_task",
+                                         core::Duration::millisecond * 10, params));
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.start());
+
+    for (unsigned n = 0; n < 20; ++n) {
+        TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+    }
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.stop());
+
+    TEST_ASSERT_TRUE(exclusive_task.run_count() > 0);
+    TEST_ASSERT_EQUAL(0, exclusive_task.violation_count());
+}
+
+TEST_CASE("Multicore task scheduler: exclusive task overlaps normal task",
+          "[ocs_scheduler], [multicore_task_scheduler]") {
+    system::DefaultClock clock;
+    ConstantDelayEstimator estimator(pdMS_TO_TICKS(1));
+
+    MulticoreTaskScheduler::Params params;
+    params.worker_count = portNUM_PROCESSORS * 2;
+
+    MulticoreTaskScheduler multicore_scheduler(clock, estimator, "scheduler", 16, params);
+
+    // Registered through the interface, as the pipelines do.
+    ITaskScheduler& task_scheduler = multicore_scheduler;
+
+    std::atomic<unsigned> running { 0 };
+    std::atomic<bool> exclusive_running { false };
+
+    std::vector<std::unique_ptr<OverlapTask>> tasks;
+
+    // Normal tasks are long enough to still be running when the exclusive task is due.
+    for (unsigned n = 0; n < 4; ++n) {
+        tasks.emplace_back(new (std::nothrow) OverlapTask(
+            running, exclusive_running, core::Duration::millisecond * 7, false));
+        TEST_ASSERT_NOT_NULL(tasks.back());
+
+        const std::string id = "task_" + std::to_string(n);
+        TEST_ASSERT_EQUAL(status::StatusCode::OK,
+                          task_scheduler.add(*tasks.back(), id.c_str(),
+                                             core::Duration::millisecond * (3 + n)));
+    }
+
+    OverlapTask exclusive_task(running, exclusive_running,
+                               core::Duration::millisecond * 5, true);
+
+    ITaskScheduler::TaskParams task_params;
+    task_params.exclusive = true;
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK,
+                      task_scheduler.add(exclusive_task, "exclusive_task",
+                                         core::Duration::millisecond * 2, task_params));
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.start());
+
+    for (unsigned n = 0; n < 50; ++n) {
+        TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+    }
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.stop());
+
+    TEST_ASSERT_TRUE(exclusive_task.run_count() > 1);
+    TEST_ASSERT_EQUAL(0, exclusive_task.violation_count());
+
+    for (const auto& task : tasks) {
+        TEST_ASSERT_TRUE(task->run_count() > 0);
+        TEST_ASSERT_EQUAL(0, task->violation_count());
+    }
+}
+
+TEST_CASE("Multicore task scheduler: steal tasks from overloaded worker",
+          "[ocs_scheduler], [multicore_task_scheduler]") {
+    const unsigned short_task_count = 12;
+
+    system::DefaultClock clock;
+    ConstantDelayEstimator estimator(pdMS_TO_TICKS(10));
+
+    MulticoreTaskScheduler::Params params;
+    params.worker_count = portNUM_PROCESSORS * 2;
+
+    MulticoreTaskScheduler task_scheduler(clock, estimator, "scheduler",
+                                          short_task_count + portNUM_PROCESSORS + 1,
+                                          params);
+
+    std::atomic<unsigned> running { 0 };
+    std::vector<std::unique_ptr<BusyTask>> tasks;
+    std::vector<int> cores;
+
+    // Added first, so it's dispatched to the first worker. The tasks queued behind it
+    // on the same worker can only be run if they are stolen by the other workers.
+    tasks.emplace_back(new (std::nothrow)
+                           BusyTask(running, core::Duration::millisecond * 200));
+    TEST_ASSERT_NOT_NULL(tasks.back());
+    cores.push_back(MulticoreTaskScheduler::any_core);
+
+    for (unsigned n = 0; n < short_task_count; ++n) {
+        tasks.emplace_back(new (std::nothrow)
+                               BusyTask(running, core::Duration::millisecond));
+        TEST_ASSERT_NOT_NULL(tasks.back());
+        cores.push_back(MulticoreTaskScheduler::any_core);
+    }
+
+    for (int n = 0; n < portNUM_PROCESSORS; ++n) {
+        tasks.emplace_back(new (std::nothrow)
+                               BusyTask(running, core::Duration::millisecond));
+        TEST_ASSERT_NOT_NULL(tasks.back());
+        cores.push_back(n);
+    }
+
+    for (unsigned n = 0; n < tasks.size(); ++n) {
+        MulticoreTaskScheduler::TaskParams task_params;
+        task_params.core = cores[n];
+
+        const std::string id = "task_" + std::to_string(n);
+        TEST_ASSERT_EQUAL(status::StatusCode::OK,
+                          task_scheduler.add(*tasks[n], id.c_str(), core::Duration::hour,
+                                             task_params));
+    }
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.start());
+
+    // The first run dispatches all tasks, the next ones are due in an hour.
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+
+    for (unsigned n = 0; n < 100; ++n) {
+        unsigned run_count = 0;
+        for (const auto& task : tasks) {
+            run_count += task->run_count();
+        }
+
+        if (run_count == tasks.size()) {
+            break;
+        }
+
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.stop());
+
+    TEST_ASSERT_TRUE(task_scheduler.steal_count() > 0);
+
+    for (unsigned n = 0; n < tasks.size(); ++n) {
+        TEST_ASSERT_EQUAL(1, tasks[n]->run_count());
+
+        if (cores[n] != MulticoreTaskScheduler::any_core) {
+            TEST_ASSERT_EQUAL(cores[n], tasks[n]->core());
+        }
+    }
+}
+
+TEST_CASE("Multicore task scheduler: throughput",
+          "[ocs_scheduler], [multicore_task_scheduler], [benchmark]") {
+    const unsigned task_count = 8;
+    const unsigned round_count = 50;
+    const core::Time task_duration = core::Duration::millisecond * 2;
+
+    system::DefaultClock clock;
+
+    // Tasks are run on each round.
+    ConstantDelayEstimator estimator(pdMS_TO_TICKS(1));
+
+    for (unsigned worker_count = 1; worker_count <= portNUM_PROCESSORS * 2;
+         worker_count *= 2) {
+        MulticoreTaskScheduler::Params params;
+        params.worker_count = worker_count;
+
+        MulticoreTaskScheduler task_scheduler(clock, estimator, "scheduler", task_count,
+                                              params);
+
+        std::atomic<unsigned> running { 0 };
+        std::vector<std::unique_ptr<BusyTask>> tasks;
+
+        for (unsigned n = 0; n < task_count; ++n) {
+            tasks.emplace_back(new (std::nothrow) BusyTask(running, task_duration));
+            TEST_ASSERT_NOT_NULL(tasks.back());
+
+            const std::string id = "task_" + std::to_string(n);
+            TEST_ASSERT_EQUAL(status::StatusCode::OK,
+                              task_scheduler.add(*tasks.back(), id.c_str(),
+                                                 core::Duration::millisecond));
+        }
+
+        TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.start());
+
+        const auto start_ts = esp_timer_get_time();
+
+        for (unsigned n = 0; n < round_count; ++n) {
+            TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+        }
+
+        TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.stop());
+
+        const auto total_ts = esp_timer_get_time() - start_ts;
+
+        unsigned run_count = 0;
+        for (const auto& task : tasks) {
+            run_count += task->run_count();
+        }
+
+        TEST_ASSERT_TRUE(run_count > 0);
+
+        ocs_logi(log_tag,
+                 "throughput: workers=%u runs=%u total=%lli(usec) "
+                 "runs_per_sec=%lli steal_count=%" PRIu32,
+                 worker_count, run_count, total_ts,
+                 run_count * core::Duration::second / total_ts,
+                 task_scheduler.steal_count());
+    }
+}
+
+} // namespace scheduler
+} // namespace ocs
@@ -165,5 +165,40 @@ TEST_CASE("Periodic task scheduler: max number of tasks overflow",
     TEST_ASSERT_EQUAL(0, task2.run_call_count());
 }
 
+TEST_CASE("Periodic task scheduler: wake task",
+          "[ocs_scheduler], [periodic_task_scheduler]") {
+    const core::Time interval = core::Duration::second;
+    const TickType_t delay = pdMS_TO_TICKS(10);
+
+    test::TestClock clock;
+    clock.value = 42;
+
+    test::TestTask task(status::StatusCode::OK);
+    ConstantDelayEstimator estimator(delay);
+
+    PeriodicTaskScheduler task_scheduler(clock, estimator, "scheduler", 16);
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.add(task, "task", interval));
+
+    TEST_ASSERT_EQUAL(status::StatusCode::InvalidArg, task_scheduler.wake("unknown"));
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+    TEST_ASSERT_EQUAL(1, task.run_call_count());
+    task.reset(status::StatusCode::OK);
+
+    // Woken task is run regardless of its interval.
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.wake("task"));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+    TEST_ASSERT_EQUAL(1, task.run_call_count());
+    task.reset(status::StatusCode::OK);
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+    TEST_ASSERT_EQUAL(0, task.run_call_count());
+
+    // Periodic schedule isn't affected.
+    clock.value += interval;
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+    TEST_ASSERT_EQUAL(1, task.run_call_count());
+}
+
 } // namespace scheduler
 } // namespace ocs
@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "freertos/FreeRTOSConfig.h"
+#include "unity.h"
+
+#include "ocs_scheduler/adaptive_delay_estimator.h"
+#include "ocs_scheduler/constant_delay_estimator.h"
+#include "ocs_scheduler/deadline_task_scheduler.h"
+#include "ocs_scheduler/periodic_task_scheduler.h"
+#include "ocs_test/sim_delay_estimator.h"
+#include "ocs_test/sim_delayer.h"
+#include "ocs_test/sim_task.h"
+#include "ocs_test/sim_timer.h"
+#include "ocs_test/simulator.h"
+
+namespace ocs {
+namespace scheduler {
+
+namespace {
+
+const unsigned task_count = 200;
+const core::Time task_cost = core::Duration::microsecond * 50;
+
+using SimTaskPtr = std::unique_ptr<test::SimTask>;
+
+core::Time task_interval(unsigned n) {
+    return core::Duration::millisecond * 100 * (n % 10 + 1);
+}
+
+void add_tasks(test::Simulator& simulator,
+               ITaskScheduler& task_scheduler,
+               std::vector<SimTaskPtr>& tasks) {
+    for (unsigned n = 0; n < task_count; ++n) {
+        tasks.emplace_back(new (std::nothrow) test::SimTask(simulator, task_cost));
+        TEST_ASSERT_NOT_NULL(tasks.back());
+
+        const std::string id = "task_" + std::to_string(n);
+        TEST_ASSERT_EQUAL(
+            status::StatusCode::OK,
+            task_scheduler.add(*tasks.back(), id.c_str(), task_interval(n)));
+    }
+}
+
+} // namespace
+
+TEST_CASE("Simulation: run events in order", "[ocs_scheduler], [simulation]") {
+    test::Simulator simulator;
+    std::vector<int> order;
+
+    const auto start_ts = simulator.now();
+
+    simulator.schedule(start_ts + 20, [&order]() {
+        order.push_back(3);
+    });
+    simulator.schedule(start_ts + 10, [&order]() {
+        order.push_back(1);
+    });
+    simulator.schedule(start_ts + 10, [&order]() {
+        order.push_back(2);
+    });
+    simulator.schedule(start_ts + 30, [&order]() {
+        order.push_back(4);
+    });
+
+    simulator.advance(20);
+    TEST_ASSERT_EQUAL(start_ts + 20, simulator.now());
+    TEST_ASSERT_EQUAL(1, simulator.pending_count());
+    TEST_ASSERT_EQUAL(3, order.size());
+    TEST_ASSERT_EQUAL(1, order[0]);
+    TEST_ASSERT_EQUAL(2, order[1]);
+    TEST_ASSERT_EQUAL(3, order[2]);
+
+    simulator.consume(20);
+    TEST_ASSERT_EQUAL(start_ts + 40, simulator.now());
+    TEST_ASSERT_EQUAL(1, simulator.pending_count());
+
+    simulator.advance(0);
+    TEST_ASSERT_EQUAL(0, simulator.pending_count());
+    TEST_ASSERT_EQUAL(4, order.size());
+    TEST_ASSERT_EQUAL(4, simulator.event_count());
+    TEST_ASSERT_EQUAL(20, simulator.busy_time());
+}
+
+TEST_CASE("Simulation: timer and delayer", "[ocs_scheduler], [simulation]") {
+    test::Simulator simulator;
+    test::SimTask task(simulator, core::Duration::microsecond * 100);
+    test::SimTimer timer(simulator, task, core::Duration::millisecond * 10);
+    test::SimDelayer delayer(simulator);
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, timer.start());
+    TEST_ASSERT_EQUAL(status::StatusCode::InvalidState, timer.start());
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, delayer.delay(core::Duration::second));
+    TEST_ASSERT_EQUAL(100, timer.run_count());
+    TEST_ASSERT_EQUAL(100, task.run_count());
+    TEST_ASSERT_EQUAL(core::Duration::millisecond * 10, task.interval_min());
+    TEST_ASSERT_EQUAL(core::Duration::millisecond * 10, task.interval_max());
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, timer.stop());
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, delayer.delay(core::Duration::second));
+    TEST_ASSERT_EQUAL(100, task.run_count());
+}
+
+TEST_CASE("Simulation: periodic task scheduler", "[ocs_scheduler], [simulation]") {
+    const core::Time duration = core::Duration::minute;
+    const TickType_t delay = pdMS_TO_TICKS(10);
+
+    test::Simulator simulator;
+    ConstantDelayEstimator constant_estimator(delay);
+    test::SimDelayEstimator estimator(simulator, constant_estimator);
+
+    PeriodicTaskScheduler task_scheduler(simulator, estimator, "scheduler", task_count);
+
+    std::vector<SimTaskPtr> tasks;
+    add_tasks(simulator, task_scheduler, tasks);
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.start());
+
+    const auto end_ts = simulator.now() + duration;
+    while (simulator.now() < end_ts) {
+        TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+    }
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.stop());
+
+    // Task can be late for one delay and two rounds of all tasks, since its position
+    // in the round can change.
+    const core::Time max_latency =
+        delay * portTICK_PERIOD_MS * core::Duration::millisecond
+        + task_cost * task_count * 2;
+
+    for (unsigned n = 0; n < task_count; ++n) {
+        const auto interval = task_interval(n);
+
+        TEST_ASSERT_TRUE(tasks[n]->interval_min() >= interval);
+        TEST_ASSERT_TRUE(tasks[n]->interval_max() <= interval + max_latency);
+        TEST_ASSERT_TRUE(tasks[n]->run_count() >= duration / (interval + max_latency));
+    }
+}
+
+TEST_CASE("Simulation: deadline task scheduler", "[ocs_scheduler], [simulation]") {
+    const core::Time duration = core::Duration::hour;
+    const core::Time tick = portTICK_PERIOD_MS * core::Duration::millisecond;
+
+    test::Simulator simulator;
+    AdaptiveDelayEstimator adaptive_estimator(simulator, pdMS_TO_TICKS(1000));
+    test::SimDelayEstimator estimator(simulator, adaptive_estimator);
+
+    DeadlineTaskScheduler task_scheduler(simulator, estimator, "scheduler", task_count);
+
+    std::vector<SimTaskPtr> tasks;
+    add_tasks(simulator, task_scheduler, tasks);
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.start());
+
+    const auto start_ts = simulator.now();
+    const auto end_ts = start_ts + duration;
+
+    while (simulator.now() < end_ts) {
+        TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+    }
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.stop());
+
+    // Task can be late for one tick and two rounds of all tasks. Deadlines don't drift,
+    // so the late run is followed by the shorter interval.
+    const core::Time max_latency = tick + task_cost * task_count * 2;
+
+    double expected_load = 0;
+
+    for (unsigned n = 0; n < task_count; ++n) {
+        const auto interval = task_interval(n);
+
+        TEST_ASSERT_TRUE(tasks[n]->interval_min() >= interval - max_latency);
+        TEST_ASSERT_TRUE(tasks[n]->interval_max() <= interval + max_latency);
+        TEST_ASSERT_TRUE(tasks[n]->run_count() >= duration / interval);
+
+        expected_load += double(task_cost) / interval;
+    }
+
+    // CPU budget: only the tasks consume the CPU time, each task is run once more at
+    // the beginning of the simulation.
+    const double load = double(simulator.busy_time()) / (simulator.now() - start_ts);
+    TEST_ASSERT_TRUE(load <= expected_load * 1.01);
+
+    // The scheduler sleeps until the earliest deadline, instead of polling.
+    TEST_ASSERT_TRUE(estimator.round_count() < duration / tick);
+}
+
+} // namespace scheduler
+} // namespace ocs
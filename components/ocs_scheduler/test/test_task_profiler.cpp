@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "unity.h"
+
+#include "ocs_scheduler/constant_delay_estimator.h"
+#include "ocs_scheduler/periodic_task_scheduler.h"
+#include "ocs_scheduler/task_profiler.h"
+#include "ocs_test/test_clock.h"
+#include "ocs_test/test_task.h"
+
+namespace ocs {
+namespace scheduler {
+
+TEST_CASE("Task profiler: no runs", "[ocs_scheduler], [task_profiler]") {
+    TaskProfiler profiler("task", core::Duration::second);
+
+    TEST_ASSERT_EQUAL_STRING("task", profiler.id());
+    TEST_ASSERT_EQUAL_INT64(core::Duration::second, profiler.interval());
+
+    const auto profile = profiler.get();
+    TEST_ASSERT_EQUAL(0, profile.run_count);
+    TEST_ASSERT_EQUAL(0, profile.failure_count);
+    TEST_ASSERT_EQUAL_INT64(0, profile.time_last);
+    TEST_ASSERT_EQUAL_INT64(0, profile.jitter_max);
+
+    for (const auto& count : profile.histogram) {
+        TEST_ASSERT_EQUAL(0, count);
+    }
+}
+
+TEST_CASE("Task profiler: execution time", "[ocs_scheduler], [task_profiler]") {
+    const core::Time interval = core::Duration::second;
+
+    TaskProfiler profiler("task", interval);
+
+    profiler.record(0, 10, status::StatusCode::OK);
+    profiler.record(interval, interval + 30, status::StatusCode::OK);
+    profiler.record(interval * 2, interval * 2 + 20, status::StatusCode::Error);
+
+    const auto profile = profiler.get();
+    TEST_ASSERT_EQUAL(3, profile.run_count);
+    TEST_ASSERT_EQUAL(1, profile.failure_count);
+    TEST_ASSERT_EQUAL_INT64(20, profile.time_last);
+    TEST_ASSERT_EQUAL_INT64(10, profile.time_min);
+    TEST_ASSERT_EQUAL_INT64(30, profile.time_max);
+    TEST_ASSERT_EQUAL_INT64(20, profile.time_mean);
+}
+
+TEST_CASE("Task profiler: histogram", "[ocs_scheduler], [task_profiler]") {
+    TaskProfiler profiler("task", core::Duration::second);
+
+    // [0, 2) microseconds.
+    profiler.record(0, 0, status::StatusCode::OK);
+    profiler.record(0, 1, status::StatusCode::OK);
+
+    // [2, 4) microseconds.
+    profiler.record(0, 3, status::StatusCode::OK);
+
+    // [1024, 2048) microseconds.
+    profiler.record(0, 1024, status::StatusCode::OK);
+    profiler.record(0, 2047, status::StatusCode::OK);
+
+    // Too long runs are counted in the last bucket.
+    profiler.record(0, core::Duration::hour, status::StatusCode::OK);
+
+    const auto profile = profiler.get();
+    TEST_ASSERT_EQUAL(2, profile.histogram[0]);
+    TEST_ASSERT_EQUAL(1, profile.histogram[1]);
+    TEST_ASSERT_EQUAL(2, profile.histogram[10]);
+    TEST_ASSERT_EQUAL(1, profile.histogram[TaskProfiler::histogram_size - 1]);
+}
+
+TEST_CASE("Task profiler: jitter", "[ocs_scheduler], [task_profiler]") {
+    const core::Time interval = core::Duration::second;
+
+    TaskProfiler profiler("task", interval);
+
+    profiler.record(0, 0, status::StatusCode::OK);
+    TEST_ASSERT_EQUAL_INT64(0, profiler.get().jitter_last);
+
+    // Task was started later than expected.
+    profiler.record(interval + 100, interval + 100, status::StatusCode::OK);
+    TEST_ASSERT_EQUAL_INT64(100, profiler.get().jitter_last);
+    TEST_ASSERT_EQUAL_INT64(100, profiler.get().jitter_max);
+
+    // Task was started earlier than expected.
+    profiler.record(interval * 2 + 50, interval * 2 + 50, status::StatusCode::OK);
+    TEST_ASSERT_EQUAL_INT64(50, profiler.get().jitter_last);
+    TEST_ASSERT_EQUAL_INT64(100, profiler.get().jitter_max);
+}
+
+TEST_CASE("Task profiler: periodic task scheduler", "[ocs_scheduler], [task_profiler]") {
+    const core::Time interval = core::Duration::second;
+
+    test::TestClock clock;
+    clock.value = 42;
+
+    test::TestTask task(status::StatusCode::OK);
+    ConstantDelayEstimator estimator(pdMS_TO_TICKS(10));
+
+    PeriodicTaskScheduler task_scheduler(clock, estimator, "scheduler", 16);
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.add(task, "task", interval));
+
+    TEST_ASSERT_EQUAL(1, task_scheduler.profilers().size());
+    const auto& profiler = *task_scheduler.profilers()[0];
+    TEST_ASSERT_EQUAL_STRING("task", profiler.id());
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+    TEST_ASSERT_EQUAL(1, profiler.get().run_count);
+
+    // Task isn't due yet, nothing is recorded.
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+    TEST_ASSERT_EQUAL(1, profiler.get().run_count);
+
+    task.reset(status::StatusCode::Error);
+    clock.value += interval + 10;
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, task_scheduler.run());
+
+    const auto profile = profiler.get();
+    TEST_ASSERT_EQUAL(2, profile.run_count);
+    TEST_ASSERT_EQUAL(1, profile.failure_count);
+    TEST_ASSERT_EQUAL_INT64(10, profile.jitter_last);
+}
+
+} // namespace scheduler
+} // namespace ocs
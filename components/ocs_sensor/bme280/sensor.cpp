@@ -122,6 +122,10 @@ Sensor::Data Sensor::get_data() const {
     return data_.get();
 }
 
+uint32_t Sensor::get_generation() const {
+    return data_.generation();
+}
+
 void Sensor::estimate_measurement_time_() {
     // Appendix B: measurement time and current calculation, page 51.
     const unsigned typ_measurement_duration =
@@ -99,6 +99,10 @@ float Sensor::get_data() const {
     return data_.get();
 }
 
+uint32_t Sensor::get_generation() const {
+    return data_.generation();
+}
+
 status::StatusCode Sensor::read_configuration(Sensor::Configuration& configuration) {
     if (configured()) {
         configuration = configuration_;
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
 
 #include "ocs_core/macros.h"
@@ -66,6 +67,9 @@ public:
     //! Return the latest sensor data.
     float get_data() const;
 
+    //! Return the number of sensor data updates.
+    uint32_t get_generation() const;
+
     //! Read sensor configuration from persistent storage.
     status::StatusCode read_configuration(Configuration& configuration);
 
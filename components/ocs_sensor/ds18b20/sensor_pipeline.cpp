@@ -29,7 +29,13 @@ SensorPipeline::SensorPipeline(scheduler::ITaskScheduler& task_scheduler,
     configASSERT(sensor_store.add(*sensor_, params.data_pin, "gpio_ds18b20_onewire")
                  == status::StatusCode::OK);
 
-    configASSERT(task_scheduler.add(*sensor_task_, task_id_.c_str(), params.read_interval)
+    // Operation guard suspends the FreeRTOS scheduler only on the current core, so the
+    // other tasks shouldn't be run concurrently on the other cores.
+    scheduler::ITaskScheduler::TaskParams task_params;
+    task_params.exclusive = true;
+
+    configASSERT(task_scheduler.add(*sensor_task_, task_id_.c_str(), params.read_interval,
+                                    task_params)
                  == status::StatusCode::OK);
 }
 
@@ -40,6 +40,10 @@ Sensor::Data Sensor::get_data() const {
     return data_.get();
 }
 
+uint32_t Sensor::get_generation() const {
+    return data_.generation();
+}
+
 int Sensor::calculate_lightness_(int raw) const {
     if (raw >= params_.value_max) {
         return 100;
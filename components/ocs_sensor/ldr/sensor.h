@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <cstdint>
+
 #include "ocs_core/noncopyable.h"
 #include "ocs_core/spmc_node.h"
 #include "ocs_io/adc/iadc.h"
@@ -40,6 +42,9 @@ public:
     //! Return the latest sensor data.
     Data get_data() const;
 
+    //! Return the number of sensor data updates.
+    uint32_t get_generation() const;
+
 private:
     int calculate_lightness_(int raw) const;
 
@@ -85,6 +85,10 @@ Sensor::Data Sensor::get_data() const {
     return data_.get();
 }
 
+uint32_t Sensor::get_generation() const {
+    return data_.generation();
+}
+
 status::StatusCode Sensor::reset() {
     ocs_logi(log_tag, "start resetting");
 
@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <cstdint>
+
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
@@ -76,6 +78,9 @@ public:
     //! Return the latest sensor data.
     Data get_data() const;
 
+    //! Return the number of sensor data updates.
+    uint32_t get_generation() const;
+
     //! Reset the sensor.
     //!
     //! @remarks
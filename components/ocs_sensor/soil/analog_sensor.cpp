@@ -79,6 +79,10 @@ AnalogSensor::Data AnalogSensor::get_data() const {
     return data_.get();
 }
 
+uint32_t AnalogSensor::get_generation() const {
+    return data_.generation();
+}
+
 int AnalogSensor::calculate_moisture_(int raw) const {
     if (raw > params_.value_max) {
         return 0;
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
 #include <memory>
 
 #include "ocs_control/fsm_block.h"
@@ -52,6 +53,9 @@ public:
     //! Return the latest sensor data.
     Data get_data() const;
 
+    //! Return the number of sensor data updates.
+    uint32_t get_generation() const;
+
 private:
     int calculate_moisture_(int raw) const;
     SoilStatus calculate_status_(int raw) const;
@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "freertos/FreeRTOSConfig.h"
+
+#include "ocs_core/lock_guard.h"
+#include "ocs_core/log.h"
+#include "ocs_status/code_to_str.h"
+#include "ocs_storage/caching_storage.h"
+
+namespace ocs {
+namespace storage {
+
+namespace {
+
+const char* log_tag = "caching_storage";
+
+} // namespace
+
+CachingStorage::CachingStorage(std::unique_ptr<IStorage> storage)
+    : storage_(std::move(storage)) {
+    configASSERT(storage_);
+}
+
+status::StatusCode CachingStorage::probe(const char* key, size_t& size) {
+    configASSERT(key);
+
+    core::LockGuard lock(mu_);
+
+    Value* value = nullptr;
+
+    const auto code = load_(key, value);
+    if (code != status::StatusCode::OK) {
+        return code;
+    }
+
+    if (!value->exists) {
+        return status::StatusCode::NoData;
+    }
+
+    size = value->data.size();
+
+    return status::StatusCode::OK;
+}
+
+status::StatusCode CachingStorage::read(const char* key, void* data, size_t size) {
+    configASSERT(key);
+    configASSERT(data);
+    configASSERT(size);
+
+    core::LockGuard lock(mu_);
+
+    Value* value = nullptr;
+
+    const auto code = load_(key, value);
+    if (code != status::StatusCode::OK) {
+        return code;
+    }
+
+    if (!value->exists) {
+        return status::StatusCode::NoData;
+    }
+
+    // Same as for NVS, the buffer should be large enough to hold the whole value.
+    if (size < value->data.size()) {
+        return status::StatusCode::Error;
+    }
+
+    memcpy(data, value->data.data(), value->data.size());
+
+    return status::StatusCode::OK;
+}
+
+status::StatusCode CachingStorage::write(const char* key, const void* data, size_t size) {
+    configASSERT(key);
+    configASSERT(data);
+    configASSERT(size);
+
+    core::LockGuard lock(mu_);
+
+    Value* value = find_(key);
+    if (!value) {
+        values_.emplace_back();
+        value = &values_.back();
+        value->key = key;
+    }
+
+    ++write_count_;
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+
+    // Rewriting the same value doesn't require the flush.
+    if (value->exists && value->data.size() == size
+        && std::equal(bytes, bytes + size, value->data.begin())) {
+        return status::StatusCode::OK;
+    }
+
+    value->data.assign(bytes, bytes + size);
+    value->exists = true;
+    value->dirty = true;
+
+    return status::StatusCode::OK;
+}
+
+status::StatusCode CachingStorage::erase(const char* key) {
+    configASSERT(key);
+
+    core::LockGuard lock(mu_);
+
+    Value* value = nullptr;
+
+    const auto code = load_(key, value);
+    if (code != status::StatusCode::OK) {
+        return code;
+    }
+
+    if (!value->exists) {
+        return status::StatusCode::NoData;
+    }
+
+    value->data.clear();
+    value->exists = false;
+    value->dirty = true;
+
+    ++write_count_;
+
+    return status::StatusCode::OK;
+}
+
+status::StatusCode CachingStorage::run() {
+    return flush();
+}
+
+void CachingStorage::handle_reboot() {
+    const auto code = flush();
+    if (code != status::StatusCode::OK) {
+        ocs_loge(log_tag, "failed to flush on reboot: code=%s",
+                 status::code_to_str(code));
+    }
+}
+
+status::StatusCode CachingStorage::flush() {
+    core::LockGuard lock(mu_);
+
+    std::vector<Entry> entries;
+
+    for (const auto& value : values_) {
+        if (!value.dirty) {
+            continue;
+        }
+
+        Entry entry;
+        entry.key = value.key.c_str();
+
+        if (value.exists) {
+            entry.value = value.data.data();
+            entry.size = value.data.size();
+        }
+
+        entries.push_back(entry);
+    }
+
+    if (entries.empty()) {
+        return status::StatusCode::OK;
+    }
+
+    const auto code = storage_->write_batch(entries.data(), entries.size());
+    if (code != status::StatusCode::OK) {
+        return code;
+    }
+
+    for (auto& value : values_) {
+        value.dirty = false;
+    }
+
+    ++commit_count_;
+
+    return status::StatusCode::OK;
+}
+
+uint32_t CachingStorage::write_count() const {
+    core::LockGuard lock(mu_);
+
+    return write_count_;
+}
+
+uint32_t CachingStorage::commit_count() const {
+    core::LockGuard lock(mu_);
+
+    return commit_count_;
+}
+
+status::StatusCode CachingStorage::load_(const char* key, Value*& value) {
+    value = find_(key);
+    if (value) {
+        return status::StatusCode::OK;
+    }
+
+    Value loaded;
+    loaded.key = key;
+
+    size_t size = 0;
+
+    auto code = storage_->probe(key, size);
+    if (code == status::StatusCode::OK) {
+        loaded.data.resize(size);
+
+        code = storage_->read(key, loaded.data.data(), loaded.data.size());
+        if (code != status::StatusCode::OK) {
+            return code;
+        }
+
+        loaded.exists = true;
+    } else if (code != status::StatusCode::NoData) {
+        return code;
+    }
+
+    values_.emplace_back(std::move(loaded));
+    value = &values_.back();
+
+    return status::StatusCode::OK;
+}
+
+CachingStorage::Value* CachingStorage::find_(const char* key) {
+    for (auto& value : values_) {
+        if (value.key == key) {
+            return &value;
+        }
+    }
+
+    return nullptr;
+}
+
+} // namespace storage
+} // namespace ocs
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ocs_core/noncopyable.h"
+#include "ocs_core/static_mutex.h"
+#include "ocs_scheduler/itask.h"
+#include "ocs_storage/istorage.h"
+#include "ocs_system/ireboot_handler.h"
+
+namespace ocs {
+namespace storage {
+
+//! Keep the key-value pairs in RAM and write them to the underlying storage in batches.
+//!
+//! @notes
+//!  Values are read from the underlying storage once, and then served from RAM. Written
+//!  and erased values are marked as dirty, and are written to the underlying storage
+//!  with a single IStorage::write_batch() call when the storage is flushed: on demand,
+//!  each time the task is run, and on reboot. Values which weren't flushed are lost if
+//!  the device is reset unexpectedly.
+//!
+//!  The storage should be registered in the reboot handler after all components that
+//!  write to it on reboot.
+class CachingStorage : public IStorage,
+                       public scheduler::ITask,
+                       public system::IRebootHandler,
+                       public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //!
+    //! @params
+    //!  - @p storage - underlying storage.
+    explicit CachingStorage(std::unique_ptr<IStorage> storage);
+
+    //! Read data size from RAM, or from the underlying storage.
+    status::StatusCode probe(const char* key, size_t& size) override;
+
+    //! Read data from RAM, or from the underlying storage.
+    status::StatusCode read(const char* key, void* value, size_t size) override;
+
+    //! Write data to RAM, the value isn't marked as dirty if it isn't changed.
+    status::StatusCode write(const char* key, const void* value, size_t size) override;
+
+    //! Erase data in RAM.
+    status::StatusCode erase(const char* key) override;
+
+    //! Flush dirty data.
+    status::StatusCode run() override;
+
+    //! Flush dirty data.
+    void handle_reboot() override;
+
+    //! Write all dirty data to the underlying storage.
+    status::StatusCode flush();
+
+    //! Return the number of writes and erases.
+    uint32_t write_count() const;
+
+    //! Return the number of flushes written to the underlying storage.
+    uint32_t commit_count() const;
+
+private:
+    struct Value {
+        std::string key;
+        std::vector<uint8_t> data;
+        bool exists { false };
+        bool dirty { false };
+    };
+
+    status::StatusCode load_(const char* key, Value*& value);
+    Value* find_(const char* key);
+
+    std::unique_ptr<IStorage> storage_;
+
+    mutable core::StaticMutex mu_;
+
+    std::vector<Value> values_;
+
+    uint32_t write_count_ { 0 };
+    uint32_t commit_count_ { 0 };
+};
+
+} // namespace storage
+} // namespace ocs
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "ocs_storage/istorage.h"
+
+namespace ocs {
+namespace storage {
+
+status::StatusCode IStorage::write_batch(const Entry* entries, unsigned count) {
+    for (unsigned n = 0; n < count; ++n) {
+        const auto& entry = entries[n];
+
+        if (entry.value) {
+            const auto code = write(entry.key, entry.value, entry.size);
+            if (code != status::StatusCode::OK) {
+                return code;
+            }
+        } else {
+            const auto code = erase(entry.key);
+            if (code != status::StatusCode::OK && code != status::StatusCode::NoData) {
+                return code;
+            }
+        }
+    }
+
+    return status::StatusCode::OK;
+}
+
+} // namespace storage
+} // namespace ocs
@@ -17,6 +17,18 @@ namespace storage {
 
 class IStorage {
 public:
+    //! Key-value pair to write with write_batch().
+    struct Entry {
+        //! Name of value, 15 characters is a maximum length.
+        const char* key { nullptr };
+
+        //! Value to write, the key-value pair is erased if null.
+        const void* value { nullptr };
+
+        //! Size of the value to write, in bytes.
+        size_t size { 0 };
+    };
+
     //! Destroy.
     virtual ~IStorage() = default;
 
@@ -44,6 +56,17 @@ public:
     //! @params
     //!  - @p key - name of value to erase, 15 characters is a maximum length.
     virtual status::StatusCode erase(const char* key) = 0;
+
+    //! Write or erase multiple key-value pairs at once.
+    //!
+    //! @params
+    //!  - @p entries - key-value pairs to write or erase;
+    //!  - @p count - number of key-value pairs.
+    //!
+    //! @remarks
+    //!  Erasing the missing key isn't an error. The default implementation writes the
+    //!  pairs one by one.
+    virtual status::StatusCode write_batch(const Entry* entries, unsigned count);
 };
 
 } // namespace storage
@@ -11,6 +11,7 @@
 
 #include "freertos/FreeRTOSConfig.h"
 
+#include "ocs_core/lock_guard.h"
 #include "ocs_core/log.h"
 #include "ocs_storage/nvs_storage.h"
 
@@ -28,13 +29,41 @@ NvsStorage::NvsStorage(const char* ns) {
     strncpy(ns_, ns, std::min(bufsize_, strlen(ns)));
 }
 
+NvsStorage::~NvsStorage() {
+    if (read_handle_) {
+        nvs_close(*read_handle_);
+    }
+    if (write_handle_) {
+        nvs_close(*write_handle_);
+    }
+}
+
 status::StatusCode NvsStorage::probe(const char* key, size_t& size) {
     configASSERT(key);
 
-    auto [handle, code] = open_(NVS_READONLY);
+    core::LockGuard lock(mu_);
+
+    if (const Value* value = find_(key); value) {
+        if (!value->exists) {
+            return status::StatusCode::NoData;
+        }
+
+        size = value->size;
+
+        return status::StatusCode::OK;
+    }
+
+    nvs_handle_t handle = 0;
+
+    auto code = open_(NVS_READONLY, handle);
     if (code == status::StatusCode::OK) {
         code = read_(handle, key, nullptr, size);
-        nvs_close(handle);
+    }
+
+    if (code == status::StatusCode::OK) {
+        cache_(key, nullptr, size);
+    } else if (code == status::StatusCode::NoData) {
+        cache_missing_(key);
     }
 
     return code;
@@ -45,10 +74,39 @@ status::StatusCode NvsStorage::read(const char* key, void* value, size_t size) {
     configASSERT(value);
     configASSERT(size);
 
-    auto [handle, code] = open_(NVS_READONLY);
+    core::LockGuard lock(mu_);
+
+    if (const Value* cached = find_(key); cached) {
+        if (!cached->exists) {
+            return status::StatusCode::NoData;
+        }
+
+        if (!cached->data.empty()) {
+            if (size < cached->size) {
+                ocs_loge(log_tag, "failed to read: key=%s size=%u required=%u", key,
+                         static_cast<unsigned>(size),
+                         static_cast<unsigned>(cached->size));
+
+                return status::StatusCode::Error;
+            }
+
+            memcpy(value, cached->data.data(), cached->size);
+
+            return status::StatusCode::OK;
+        }
+    }
+
+    nvs_handle_t handle = 0;
+
+    auto code = open_(NVS_READONLY, handle);
     if (code == status::StatusCode::OK) {
         code = read_(handle, key, value, size);
-        nvs_close(handle);
+    }
+
+    if (code == status::StatusCode::OK) {
+        cache_(key, value, size);
+    } else if (code == status::StatusCode::NoData) {
+        cache_missing_(key);
     }
 
     return code;
@@ -59,10 +117,19 @@ status::StatusCode NvsStorage::write(const char* key, const void* value, size_t
     configASSERT(value);
     configASSERT(size);
 
-    auto [handle, code] = open_(NVS_READWRITE);
+    core::LockGuard lock(mu_);
+
+    nvs_handle_t handle = 0;
+
+    auto code = open_(NVS_READWRITE, handle);
     if (code == status::StatusCode::OK) {
         code = write_(handle, key, value, size);
-        nvs_close(handle);
+    }
+
+    if (code == status::StatusCode::OK) {
+        cache_(key, value, size);
+    } else {
+        uncache_(key);
     }
 
     return code;
@@ -71,29 +138,81 @@ status::StatusCode NvsStorage::write(const char* key, const void* value, size_t
 status::StatusCode NvsStorage::erase(const char* key) {
     configASSERT(key);
 
-    auto [handle, code] = open_(NVS_READWRITE);
+    core::LockGuard lock(mu_);
+
+    nvs_handle_t handle = 0;
+
+    auto code = open_(NVS_READWRITE, handle);
     if (code == status::StatusCode::OK) {
         code = erase_(handle, key);
-        nvs_close(handle);
+    }
+
+    if (code == status::StatusCode::OK || code == status::StatusCode::NoData) {
+        cache_missing_(key);
+    } else {
+        uncache_(key);
     }
 
     return code;
 }
 
-std::pair<nvs_handle_t, status::StatusCode> NvsStorage::open_(nvs_open_mode_t mode) {
+status::StatusCode NvsStorage::write_batch(const Entry* entries, unsigned count) {
+    configASSERT(entries);
+
+    if (!count) {
+        return status::StatusCode::OK;
+    }
+
+    core::LockGuard lock(mu_);
+
     nvs_handle_t handle = 0;
 
+    auto code = open_(NVS_READWRITE, handle);
+    if (code == status::StatusCode::OK) {
+        code = write_batch_(handle, entries, count);
+    }
+
+    for (unsigned n = 0; n < count; ++n) {
+        const auto& entry = entries[n];
+
+        if (code != status::StatusCode::OK) {
+            uncache_(entry.key);
+        } else if (entry.value) {
+            cache_(entry.key, entry.value, entry.size);
+        } else {
+            cache_missing_(entry.key);
+        }
+    }
+
+    return code;
+}
+
+status::StatusCode NvsStorage::open_(nvs_open_mode_t mode, nvs_handle_t& handle) {
+    // Handle opened for writing can be used for reading as well.
+    if (write_handle_) {
+        handle = *write_handle_;
+        return status::StatusCode::OK;
+    }
+
+    auto& cached_handle = mode == NVS_READONLY ? read_handle_ : write_handle_;
+    if (cached_handle) {
+        handle = *cached_handle;
+        return status::StatusCode::OK;
+    }
+
     const auto err = nvs_open(ns_, mode, &handle);
     if (err == ESP_ERR_NVS_NOT_FOUND) {
-        return { 0, status::StatusCode::NoData };
+        return status::StatusCode::NoData;
     }
 
     if (err != ESP_OK) {
         ocs_loge(log_tag, "nvs_open(): %s", esp_err_to_name(err));
-        return { 0, status::StatusCode::Error };
+        return status::StatusCode::Error;
     }
 
-    return { handle, status::StatusCode::OK };
+    cached_handle = handle;
+
+    return status::StatusCode::OK;
 }
 
 status::StatusCode
@@ -158,5 +277,84 @@ status::StatusCode NvsStorage::erase_(nvs_handle_t handle, const char* key) {
     return status::StatusCode::OK;
 }
 
+status::StatusCode
+NvsStorage::write_batch_(nvs_handle_t handle, const Entry* entries, unsigned count) {
+    for (unsigned n = 0; n < count; ++n) {
+        const auto& entry = entries[n];
+        configASSERT(entry.key);
+
+        if (entry.value) {
+            const auto err = nvs_set_blob(handle, entry.key, entry.value, entry.size);
+            if (err != ESP_OK) {
+                ocs_loge(log_tag, "failed to write: nvs_set_blob(): key=%s err=%s",
+                         entry.key, esp_err_to_name(err));
+
+                return status::StatusCode::Error;
+            }
+        } else {
+            const auto err = nvs_erase_key(handle, entry.key);
+            if (err != ESP_OK && err != ESP_ERR_NVS_NOT_FOUND) {
+                ocs_loge(log_tag, "failed to erase: nvs_erase_key(): key=%s err=%s",
+                         entry.key, esp_err_to_name(err));
+
+                return status::StatusCode::Error;
+            }
+        }
+    }
+
+    const auto err = nvs_commit(handle);
+    if (err != ESP_OK) {
+        ocs_loge(log_tag, "failed to write: nvs_commit(): count=%u err=%s", count,
+                 esp_err_to_name(err));
+
+        return status::StatusCode::Error;
+    }
+
+    return status::StatusCode::OK;
+}
+
+NvsStorage::Value* NvsStorage::find_(const char* key) {
+    for (auto& value : values_) {
+        if (value.key == key) {
+            return &value;
+        }
+    }
+
+    return nullptr;
+}
+
+void NvsStorage::cache_(const char* key, const void* value, size_t size) {
+    uncache_(key);
+
+    Value cached;
+    cached.key = key;
+    cached.size = size;
+    cached.exists = true;
+
+    if (value && size <= max_cached_size_) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(value);
+        cached.data.assign(bytes, bytes + size);
+    }
+
+    values_.push_back(std::move(cached));
+}
+
+void NvsStorage::cache_missing_(const char* key) {
+    uncache_(key);
+
+    Value cached;
+    cached.key = key;
+
+    values_.push_back(std::move(cached));
+}
+
+void NvsStorage::uncache_(const char* key) {
+    values_.erase(std::remove_if(values_.begin(), values_.end(),
+                                 [key](const Value& value) {
+                                     return value.key == key;
+                                 }),
+                  values_.end());
+}
+
 } // namespace storage
 } // namespace ocs
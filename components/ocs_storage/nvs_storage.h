@@ -8,17 +8,30 @@
 
 #pragma once
 
-#include <utility>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
 
 #include "nvs.h"
 #include "nvs_flash.h"
 
 #include "ocs_core/noncopyable.h"
+#include "ocs_core/static_mutex.h"
 #include "ocs_storage/istorage.h"
 
 namespace ocs {
 namespace storage {
 
+//! Store the key-value pairs in the NVS namespace.
+//!
+//! @notes
+//!  The NVS handle is opened on first use, separately for reading and writing, and is
+//!  kept open until the storage is destroyed. The sizes of the read values, and the
+//!  values themselves if they're small, are cached in RAM, and are updated on write and
+//!  erase. Missing keys are cached as well.
+//!
+//!  The cache is valid as long as the namespace is accessed only through this storage.
 class NvsStorage : public IStorage, public core::NonCopyable<> {
 public:
     //! Initialize.
@@ -27,9 +40,13 @@ public:
     //!  - @p ns - NVS namespace.
     //!
     //! @remarks
-    //!  NVS should be initialized.
+    //!  NVS should be initialized, and shouldn't be deinitialized until the storage is
+    //!  destroyed.
     explicit NvsStorage(const char* ns);
 
+    //! Close NVS handles.
+    ~NvsStorage();
+
     //! Read data size from the configured namespace.
     status::StatusCode probe(const char* key, size_t& size) override;
 
@@ -42,8 +59,20 @@ public:
     //! Erase data from the configured namespace.
     status::StatusCode erase(const char* key) override;
 
+    //! Write or erase data in the configured namespace, with a single commit.
+    status::StatusCode write_batch(const Entry* entries, unsigned count) override;
+
 private:
-    std::pair<nvs_handle_t, status::StatusCode> open_(nvs_open_mode_t mode);
+    struct Value {
+        std::string key;
+        size_t size { 0 };
+        bool exists { false };
+
+        //! Cached data, empty if the value is too large to be cached.
+        std::vector<uint8_t> data;
+    };
+
+    status::StatusCode open_(nvs_open_mode_t mode, nvs_handle_t& handle);
 
     status::StatusCode
     read_(nvs_handle_t handle, const char* key, void* value, size_t& size);
@@ -53,9 +82,27 @@ private:
 
     status::StatusCode erase_(nvs_handle_t handle, const char* key);
 
+    status::StatusCode
+    write_batch_(nvs_handle_t handle, const Entry* entries, unsigned count);
+
+    Value* find_(const char* key);
+    void cache_(const char* key, const void* value, size_t size);
+    void cache_missing_(const char* key);
+    void uncache_(const char* key);
+
     static const constexpr unsigned bufsize_ = NVS_KEY_NAME_MAX_SIZE - 1;
 
+    //! Maximum size of the value which data is cached, in bytes.
+    static const constexpr size_t max_cached_size_ = 64;
+
     char ns_[bufsize_ + 1];
+
+    core::StaticMutex mu_;
+
+    std::optional<nvs_handle_t> read_handle_;
+    std::optional<nvs_handle_t> write_handle_;
+
+    std::vector<Value> values_;
 };
 
 } // namespace storage
@@ -21,5 +21,15 @@ StorageBuilder::IStoragePtr StorageBuilder::make(const char* id) {
     return StorageBuilder::IStoragePtr(new (std::nothrow) NvsStorage(id));
 }
 
+StorageBuilder::CachingStoragePtr StorageBuilder::make_cached(const char* id) {
+    auto storage = make(id);
+    if (!storage) {
+        return nullptr;
+    }
+
+    return StorageBuilder::CachingStoragePtr(new (std::nothrow)
+                                                 CachingStorage(std::move(storage)));
+}
+
 } // namespace storage
 } // namespace ocs
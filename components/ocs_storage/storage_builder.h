@@ -13,6 +13,7 @@
 #include <string>
 
 #include "ocs_core/noncopyable.h"
+#include "ocs_storage/caching_storage.h"
 #include "ocs_storage/istorage.h"
 
 namespace ocs {
@@ -21,6 +22,7 @@ namespace storage {
 class StorageBuilder : public core::NonCopyable<> {
 public:
     using IStoragePtr = std::unique_ptr<IStorage>;
+    using CachingStoragePtr = std::unique_ptr<CachingStorage>;
 
     //! Create a storage with a unique @ id.
     //!
@@ -28,6 +30,13 @@ public:
     //!  nullptr if storage with @p id already exists.
     IStoragePtr make(const char* id);
 
+    //! Create a storage with a unique @ id, which keeps the data in RAM until it's
+    //! flushed.
+    //!
+    //! @return
+    //!  nullptr if storage with @p id already exists.
+    CachingStoragePtr make_cached(const char* id);
+
 private:
     std::set<std::string> ids_;
 };
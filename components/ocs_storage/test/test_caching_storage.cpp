@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "unity.h"
+
+#include "ocs_core/noncopyable.h"
+#include "ocs_storage/caching_storage.h"
+
+namespace ocs {
+namespace storage {
+
+namespace {
+
+struct TestStorage : public IStorage, public core::NonCopyable<> {
+    status::StatusCode probe(const char* key, size_t& size) override {
+        ++read_count;
+
+        const auto it = values.find(key);
+        if (it == values.end()) {
+            return status::StatusCode::NoData;
+        }
+
+        size = it->second.size();
+
+        return status::StatusCode::OK;
+    }
+
+    status::StatusCode read(const char* key, void* value, size_t size) override {
+        ++read_count;
+
+        const auto it = values.find(key);
+        if (it == values.end()) {
+            return status::StatusCode::NoData;
+        }
+
+        TEST_ASSERT_EQUAL(it->second.size(), size);
+        memcpy(value, it->second.data(), size);
+
+        return status::StatusCode::OK;
+    }
+
+    status::StatusCode write(const char* key, const void* value, size_t size) override {
+        const char* bytes = static_cast<const char*>(value);
+        values[key] = std::vector<char>(bytes, bytes + size);
+
+        ++commit_count;
+
+        return status::StatusCode::OK;
+    }
+
+    status::StatusCode erase(const char* key) override {
+        ++commit_count;
+
+        return values.erase(key) ? status::StatusCode::OK : status::StatusCode::NoData;
+    }
+
+    status::StatusCode write_batch(const Entry* entries, unsigned count) override {
+        if (write_status != status::StatusCode::OK) {
+            return write_status;
+        }
+
+        for (unsigned n = 0; n < count; ++n) {
+            if (entries[n].value) {
+                const char* bytes = static_cast<const char*>(entries[n].value);
+                values[entries[n].key] =
+                    std::vector<char>(bytes, bytes + entries[n].size);
+            } else {
+                values.erase(entries[n].key);
+            }
+        }
+
+        ++commit_count;
+
+        return status::StatusCode::OK;
+    }
+
+    std::map<std::string, std::vector<char>> values;
+
+    unsigned read_count { 0 };
+    unsigned commit_count { 0 };
+
+    status::StatusCode write_status { status::StatusCode::OK };
+};
+
+} // namespace
+
+TEST_CASE("Caching storage: read from underlying storage",
+          "[ocs_storage], [caching_storage]") {
+    auto test_storage = new TestStorage();
+
+    const uint32_t stored_value = 42;
+    TEST_ASSERT_EQUAL(status::StatusCode::OK,
+                      test_storage->write("foo", &stored_value, sizeof(stored_value)));
+
+    CachingStorage storage((std::unique_ptr<IStorage>(test_storage)));
+
+    size_t size = 0;
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, storage.probe("foo", size));
+    TEST_ASSERT_EQUAL(sizeof(stored_value), size);
+
+    const auto read_count = test_storage->read_count;
+
+    for (unsigned n = 0; n < 3; ++n) {
+        uint32_t value = 0;
+        TEST_ASSERT_EQUAL(status::StatusCode::OK,
+                          storage.read("foo", &value, sizeof(value)));
+        TEST_ASSERT_EQUAL(stored_value, value);
+    }
+
+    // Values are read from the underlying storage only once.
+    TEST_ASSERT_EQUAL(read_count, test_storage->read_count);
+
+    uint32_t value = 0;
+    TEST_ASSERT_EQUAL(status::StatusCode::NoData,
+                      storage.read("bar", &value, sizeof(value)));
+    TEST_ASSERT_EQUAL(status::StatusCode::NoData, storage.probe("bar", size));
+    TEST_ASSERT_EQUAL(status::StatusCode::NoData, storage.erase("bar"));
+}
+
+TEST_CASE("Caching storage: batch writes", "[ocs_storage], [caching_storage]") {
+    auto test_storage = new TestStorage();
+
+    CachingStorage storage((std::unique_ptr<IStorage>(test_storage)));
+
+    for (uint32_t n = 0; n < 5; ++n) {
+        const std::string key = "key_" + std::to_string(n);
+        TEST_ASSERT_EQUAL(status::StatusCode::OK,
+                          storage.write(key.c_str(), &n, sizeof(n)));
+    }
+
+    // Nothing is written until the storage is flushed.
+    TEST_ASSERT_EQUAL(0, test_storage->commit_count);
+    TEST_ASSERT_EQUAL(0, test_storage->values.size());
+
+    uint32_t value = 0;
+    TEST_ASSERT_EQUAL(status::StatusCode::OK,
+                      storage.read("key_3", &value, sizeof(value)));
+    TEST_ASSERT_EQUAL(3, value);
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, storage.flush());
+    TEST_ASSERT_EQUAL(1, test_storage->commit_count);
+    TEST_ASSERT_EQUAL(5, test_storage->values.size());
+
+    // Nothing to flush.
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, storage.run());
+    TEST_ASSERT_EQUAL(1, test_storage->commit_count);
+
+    // Same value doesn't require the flush.
+    value = 3;
+    TEST_ASSERT_EQUAL(status::StatusCode::OK,
+                      storage.write("key_3", &value, sizeof(value)));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, storage.flush());
+    TEST_ASSERT_EQUAL(1, test_storage->commit_count);
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, storage.erase("key_0"));
+    value = 10;
+    TEST_ASSERT_EQUAL(status::StatusCode::OK,
+                      storage.write("key_1", &value, sizeof(value)));
+
+    storage.handle_reboot();
+    TEST_ASSERT_EQUAL(2, test_storage->commit_count);
+    TEST_ASSERT_EQUAL(4, test_storage->values.size());
+    TEST_ASSERT_EQUAL(0, test_storage->values.count("key_0"));
+
+    TEST_ASSERT_EQUAL(8, storage.write_count());
+    TEST_ASSERT_EQUAL(2, storage.commit_count());
+}
+
+TEST_CASE("Caching storage: flush failed", "[ocs_storage], [caching_storage]") {
+    auto test_storage = new TestStorage();
+
+    CachingStorage storage((std::unique_ptr<IStorage>(test_storage)));
+
+    const uint32_t value = 42;
+    TEST_ASSERT_EQUAL(status::StatusCode::OK,
+                      storage.write("foo", &value, sizeof(value)));
+
+    test_storage->write_status = status::StatusCode::Error;
+    TEST_ASSERT_EQUAL(status::StatusCode::Error, storage.flush());
+    TEST_ASSERT_EQUAL(0, storage.commit_count());
+
+    // Dirty values are kept until they're written.
+    test_storage->write_status = status::StatusCode::OK;
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, storage.flush());
+    TEST_ASSERT_EQUAL(1, storage.commit_count());
+    TEST_ASSERT_EQUAL(1, test_storage->values.count("foo"));
+}
+
+} // namespace storage
+} // namespace ocs
@@ -147,5 +147,107 @@ TEST_CASE("NVS storage: write-read string", "[ocs_storage], [nvs_storage]") {
     TEST_ASSERT_EQUAL(status::StatusCode::OK, storage.erase(id));
 }
 
+TEST_CASE("NVS storage: probe after overwrite", "[ocs_storage], [nvs_storage]") {
+    FlashInitializer initializer;
+
+    const char* id = "probe";
+    const uint16_t small_value = 10;
+    const uint64_t large_value = 20;
+
+    NvsStorage storage("tests");
+
+    size_t size = 0;
+    TEST_ASSERT_EQUAL(status::StatusCode::NoData, storage.probe(id, size));
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK,
+                      storage.write(id, &small_value, sizeof(small_value)));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, storage.probe(id, size));
+    TEST_ASSERT_EQUAL(sizeof(small_value), size);
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK,
+                      storage.write(id, &large_value, sizeof(large_value)));
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, storage.probe(id, size));
+    TEST_ASSERT_EQUAL(sizeof(large_value), size);
+
+    // Buffer is too small for the cached value.
+    uint16_t read_value = 0;
+    TEST_ASSERT_EQUAL(status::StatusCode::Error,
+                      storage.read(id, &read_value, sizeof(read_value)));
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, storage.erase(id));
+    TEST_ASSERT_EQUAL(status::StatusCode::NoData, storage.probe(id, size));
+}
+
+TEST_CASE("NVS storage: read from another instance", "[ocs_storage], [nvs_storage]") {
+    FlashInitializer initializer;
+
+    const char* id = "persist";
+    const unsigned write_value = 42;
+    unsigned read_value = 0;
+
+    {
+        NvsStorage storage("tests");
+
+        // Cache the missing value, to ensure it's updated on write.
+        TEST_ASSERT_EQUAL(status::StatusCode::NoData,
+                          storage.read(id, &read_value, sizeof(read_value)));
+
+        TEST_ASSERT_EQUAL(status::StatusCode::OK,
+                          storage.write(id, &write_value, sizeof(write_value)));
+    }
+
+    NvsStorage storage("tests");
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK,
+                      storage.read(id, &read_value, sizeof(read_value)));
+    TEST_ASSERT_EQUAL(write_value, read_value);
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, storage.erase(id));
+}
+
+TEST_CASE("NVS storage: write batch", "[ocs_storage], [nvs_storage]") {
+    FlashInitializer initializer;
+
+    const unsigned foo_value = 1;
+    const unsigned bar_value = 2;
+    unsigned read_value = 0;
+
+    NvsStorage storage("tests");
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK,
+                      storage.write("bar", &foo_value, sizeof(foo_value)));
+
+    const IStorage::Entry entries[] = {
+        { "foo", &foo_value, sizeof(foo_value) },
+        { "bar", nullptr, 0 },
+        { "baz", nullptr, 0 },
+    };
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, storage.write_batch(entries, 3));
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK,
+                      storage.read("foo", &read_value, sizeof(read_value)));
+    TEST_ASSERT_EQUAL(foo_value, read_value);
+
+    TEST_ASSERT_EQUAL(status::StatusCode::NoData,
+                      storage.read("bar", &read_value, sizeof(read_value)));
+
+    const IStorage::Entry updates[] = {
+        { "foo", nullptr, 0 },
+        { "bar", &bar_value, sizeof(bar_value) },
+    };
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, storage.write_batch(updates, 2));
+
+    TEST_ASSERT_EQUAL(status::StatusCode::NoData,
+                      storage.read("foo", &read_value, sizeof(read_value)));
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK,
+                      storage.read("bar", &read_value, sizeof(read_value)));
+    TEST_ASSERT_EQUAL(bar_value, read_value);
+
+    TEST_ASSERT_EQUAL(status::StatusCode::OK, storage.erase("bar"));
+}
+
 } // namespace storage
 } // namespace ocs
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "freertos/FreeRTOSConfig.h"
+
+#include "ocs_test/sim_delay_estimator.h"
+
+namespace ocs {
+namespace test {
+
+SimDelayEstimator::SimDelayEstimator(Simulator& simulator,
+                                     scheduler::IDelayEstimator& estimator)
+    : simulator_(simulator)
+    , estimator_(estimator) {
+}
+
+void SimDelayEstimator::begin() {
+    estimator_.begin();
+}
+
+void SimDelayEstimator::update(core::Time deadline, core::Time cost) {
+    estimator_.update(deadline, cost);
+}
+
+TickType_t SimDelayEstimator::estimate() {
+    const auto ticks = estimator_.estimate();
+
+    ++round_count_;
+    simulator_.advance(core::Time(ticks) * portTICK_PERIOD_MS
+                       * core::Duration::millisecond);
+
+    return 0;
+}
+
+unsigned SimDelayEstimator::round_count() const {
+    return round_count_;
+}
+
+} // namespace test
+} // namespace ocs
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "ocs_core/noncopyable.h"
+#include "ocs_scheduler/idelay_estimator.h"
+#include "ocs_test/simulator.h"
+
+namespace ocs {
+namespace test {
+
+//! Run the task scheduler in the virtual time.
+//!
+//! @notes
+//!  The task scheduler delays itself after each round for the estimated number of
+//!  ticks. The simulated estimator advances the virtual time by the delay estimated by
+//!  the underlying estimator and returns zero delay, so each round of the scheduler
+//!  only yields the CPU instead of blocking.
+class SimDelayEstimator : public scheduler::IDelayEstimator, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //!
+    //! @params
+    //!  - @p simulator to advance the virtual time.
+    //!  - @p estimator to estimate the delay, should use @p simulator as a clock.
+    SimDelayEstimator(Simulator& simulator, scheduler::IDelayEstimator& estimator);
+
+    //! Begin delay estimation with the underlying estimator.
+    void begin() override;
+
+    //! Notify the underlying estimator about the earliest pending deadline.
+    void update(core::Time deadline, core::Time cost) override;
+
+    //! Advance the virtual time by the estimated delay.
+    TickType_t estimate() override;
+
+    //! Return the number of estimated delays, i.e. the number of scheduler rounds.
+    unsigned round_count() const;
+
+private:
+    Simulator& simulator_;
+    scheduler::IDelayEstimator& estimator_;
+
+    unsigned round_count_ { 0 };
+};
+
+} // namespace test
+} // namespace ocs
@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "ocs_test/sim_delayer.h"
+
+namespace ocs {
+namespace test {
+
+SimDelayer::SimDelayer(Simulator& simulator)
+    : simulator_(simulator) {
+}
+
+status::StatusCode SimDelayer::delay(core::Time delay) {
+    simulator_.advance(delay);
+
+    return status::StatusCode::OK;
+}
+
+} // namespace test
+} // namespace ocs
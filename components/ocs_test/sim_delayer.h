@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "ocs_core/noncopyable.h"
+#include "ocs_system/idelayer.h"
+#include "ocs_test/simulator.h"
+
+namespace ocs {
+namespace test {
+
+//! Delay in the virtual time.
+//!
+//! @notes
+//!  Events due during the delay are run, as other tasks would run on the real device.
+class SimDelayer : public system::IDelayer, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    explicit SimDelayer(Simulator& simulator);
+
+    //! Advance the virtual time by @p delay.
+    status::StatusCode delay(core::Time delay) override;
+
+private:
+    Simulator& simulator_;
+};
+
+} // namespace test
+} // namespace ocs
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <algorithm>
+
+#include "ocs_test/sim_task.h"
+
+namespace ocs {
+namespace test {
+
+SimTask::SimTask(Simulator& simulator, core::Time cost)
+    : cost_(cost)
+    , simulator_(simulator) {
+}
+
+status::StatusCode SimTask::run() {
+    const auto now = simulator_.now();
+
+    if (run_count_) {
+        interval_min_ = std::min(interval_min_, now - last_ts_);
+        interval_max_ = std::max(interval_max_, now - last_ts_);
+    }
+
+    last_ts_ = now;
+    ++run_count_;
+
+    simulator_.consume(cost_);
+
+    return status::StatusCode::OK;
+}
+
+unsigned SimTask::run_count() const {
+    return run_count_;
+}
+
+core::Time SimTask::interval_min() const {
+    return interval_min_;
+}
+
+core::Time SimTask::interval_max() const {
+    return interval_max_;
+}
+
+} // namespace test
+} // namespace ocs
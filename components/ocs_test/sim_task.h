@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "ocs_core/noncopyable.h"
+#include "ocs_core/time.h"
+#include "ocs_scheduler/itask.h"
+#include "ocs_test/simulator.h"
+
+namespace ocs {
+namespace test {
+
+//! Task consuming the virtual CPU time.
+class SimTask : public scheduler::ITask, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //!
+    //! @params
+    //!  - @p simulator to consume the CPU time.
+    //!  - @p cost - CPU time required to run the task.
+    SimTask(Simulator& simulator, core::Time cost);
+
+    //! Consume the configured CPU time.
+    status::StatusCode run() override;
+
+    //! Return the number of task runs.
+    unsigned run_count() const;
+
+    //! Return the minimum time between the starts of two consecutive runs.
+    core::Time interval_min() const;
+
+    //! Return the maximum time between the starts of two consecutive runs.
+    core::Time interval_max() const;
+
+private:
+    const core::Time cost_ { 0 };
+
+    Simulator& simulator_;
+
+    unsigned run_count_ { 0 };
+    core::Time last_ts_ { 0 };
+    core::Time interval_min_ { INT64_MAX };
+    core::Time interval_max_ { 0 };
+};
+
+} // namespace test
+} // namespace ocs
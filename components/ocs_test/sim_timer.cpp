@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "freertos/FreeRTOS.h"
+
+#include "ocs_test/sim_timer.h"
+
+namespace ocs {
+namespace test {
+
+SimTimer::SimTimer(Simulator& simulator, scheduler::ITask& task, core::Time interval)
+    : interval_(interval)
+    , simulator_(simulator)
+    , task_(task) {
+    configASSERT(interval_ > 0);
+}
+
+status::StatusCode SimTimer::start() {
+    if (started_) {
+        return status::StatusCode::InvalidState;
+    }
+
+    started_ = true;
+    ++generation_;
+
+    schedule_(simulator_.now() + interval_);
+
+    return status::StatusCode::OK;
+}
+
+status::StatusCode SimTimer::stop() {
+    if (!started_) {
+        return status::StatusCode::InvalidState;
+    }
+
+    started_ = false;
+    ++generation_;
+
+    return status::StatusCode::OK;
+}
+
+unsigned SimTimer::run_count() const {
+    return run_count_;
+}
+
+void SimTimer::schedule_(core::Time ts) {
+    const auto generation = generation_;
+
+    simulator_.schedule(ts, [this, ts, generation]() {
+        if (generation != generation_) {
+            return;
+        }
+
+        // Schedule from the planned time, so late runs don't accumulate the drift.
+        schedule_(ts + interval_);
+
+        ++run_count_;
+        task_.run();
+    });
+}
+
+} // namespace test
+} // namespace ocs
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "ocs_core/noncopyable.h"
+#include "ocs_core/time.h"
+#include "ocs_scheduler/itask.h"
+#include "ocs_scheduler/itimer.h"
+#include "ocs_test/simulator.h"
+
+namespace ocs {
+namespace test {
+
+//! Periodic timer running in the virtual time, see HighResolutionTimer.
+class SimTimer : public scheduler::ITimer, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //!
+    //! @params
+    //!  - @p simulator to schedule the timer events.
+    //!  - @p task to be invoked periodically at the configured interval.
+    //!  - @p interval - timer interval.
+    SimTimer(Simulator& simulator, scheduler::ITask& task, core::Time interval);
+
+    //! Schedule the first run of the task in one interval.
+    status::StatusCode start() override;
+
+    //! Cancel the scheduled runs of the task.
+    status::StatusCode stop() override;
+
+    //! Return the number of task runs.
+    unsigned run_count() const;
+
+private:
+    void schedule_(core::Time ts);
+
+    const core::Time interval_ { 0 };
+
+    Simulator& simulator_;
+    scheduler::ITask& task_;
+
+    //! Incremented on each start and stop, to ignore events of the previous starts.
+    unsigned generation_ { 0 };
+    bool started_ { false };
+    unsigned run_count_ { 0 };
+};
+
+} // namespace test
+} // namespace ocs
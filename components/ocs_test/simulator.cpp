@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <algorithm>
+
+#include "freertos/FreeRTOS.h"
+
+#include "ocs_test/simulator.h"
+
+namespace ocs {
+namespace test {
+
+core::Time Simulator::now() {
+    return now_;
+}
+
+void Simulator::schedule(core::Time ts, Func func) {
+    configASSERT(func);
+
+    events_.push(Event { std::max(ts, now_), seq_++, std::move(func) });
+}
+
+void Simulator::advance(core::Time duration) {
+    configASSERT(duration >= 0);
+
+    advance_to(now_ + duration);
+}
+
+void Simulator::advance_to(core::Time ts) {
+    while (!events_.empty() && events_.top().ts <= ts) {
+        // The event can schedule new events or advance the time itself.
+        Event event = events_.top();
+        events_.pop();
+
+        now_ = std::max(now_, event.ts);
+        ++event_count_;
+
+        event.func();
+    }
+
+    now_ = std::max(now_, ts);
+}
+
+void Simulator::consume(core::Time cost) {
+    configASSERT(cost >= 0);
+
+    now_ += cost;
+    busy_time_ += cost;
+}
+
+core::Time Simulator::busy_time() const {
+    return busy_time_;
+}
+
+unsigned Simulator::pending_count() const {
+    return events_.size();
+}
+
+uint64_t Simulator::event_count() const {
+    return event_count_;
+}
+
+bool Simulator::EventCompare::operator()(const Event& lhs, const Event& rhs) const {
+    if (lhs.ts != rhs.ts) {
+        return lhs.ts > rhs.ts;
+    }
+
+    return lhs.seq > rhs.seq;
+}
+
+} // namespace test
+} // namespace ocs
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <vector>
+
+#include "ocs_core/iclock.h"
+#include "ocs_core/noncopyable.h"
+#include "ocs_core/time.h"
+
+namespace ocs {
+namespace test {
+
+//! Discrete-event simulator with the virtual time.
+//!
+//! @notes
+//!  The simulator is the single source of time for all the simulated components:
+//!  clock, timers, delayers and delay estimators. Nothing is run concurrently, events
+//!  are run one by one in the order of their time, events scheduled for the same time
+//!  are run in the order they were scheduled, so each simulation is deterministic.
+class Simulator : public core::IClock, public core::NonCopyable<> {
+public:
+    using Func = std::function<void()>;
+
+    //! Return the current virtual time.
+    core::Time now() override;
+
+    //! Schedule @p func to be run at @p ts.
+    //!
+    //! @remarks
+    //!  If @p ts is in the past, @p func is run as soon as possible.
+    void schedule(core::Time ts, Func func);
+
+    //! Run all events due within @p duration and move the time forward.
+    void advance(core::Time duration);
+
+    //! Run all events due up to @p ts and move the time to @p ts.
+    //!
+    //! @remarks
+    //!  Can be called from the event, the time never goes backwards. If the event
+    //!  moves the time beyond the time of the next event, the next event is run late.
+    void advance_to(core::Time ts);
+
+    //! Simulate CPU work taking @p cost.
+    //!
+    //! @remarks
+    //!  The time is moved forward, but no events are run, they are run late on the
+    //!  next advance.
+    void consume(core::Time cost);
+
+    //! Return the total simulated CPU work.
+    core::Time busy_time() const;
+
+    //! Return the number of scheduled events, which haven't been run yet.
+    unsigned pending_count() const;
+
+    //! Return the number of run events.
+    uint64_t event_count() const;
+
+private:
+    struct Event {
+        core::Time ts { 0 };
+        uint64_t seq { 0 };
+        Func func;
+    };
+
+    struct EventCompare {
+        bool operator()(const Event& lhs, const Event& rhs) const;
+    };
+
+    //! Zero timestamp is often treated as unset, e.g. by core::RateLimiter.
+    core::Time now_ { core::Duration::second };
+    core::Time busy_time_ { 0 };
+
+    uint64_t seq_ { 0 };
+    uint64_t event_count_ { 0 };
+
+    std::priority_queue<Event, std::vector<Event>, EventCompare> events_;
+};
+
+} // namespace test
+} // namespace ocs
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "ocs_test/test_stream_writer.h"
+
+namespace ocs {
+namespace test {
+
+TestStreamWriter::TestStreamWriter(unsigned capacity)
+    : capacity(capacity) {
+}
+
+status::StatusCode TestStreamWriter::begin() {
+    ++begin_count;
+
+    return status::StatusCode::OK;
+}
+
+status::StatusCode TestStreamWriter::end() {
+    ++end_count;
+
+    return status::StatusCode::OK;
+}
+
+status::StatusCode TestStreamWriter::cancel() {
+    ++cancel_count;
+
+    return status::StatusCode::OK;
+}
+
+status::StatusCode TestStreamWriter::write(const void* data, unsigned size) {
+    ++write_count;
+
+    if (code != status::StatusCode::OK) {
+        return code;
+    }
+
+    if (capacity && this->data.size() + size > capacity) {
+        return status::StatusCode::Error;
+    }
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    this->data.insert(this->data.end(), bytes, bytes + size);
+
+    return status::StatusCode::OK;
+}
+
+std::string TestStreamWriter::str() const {
+    return std::string(data.begin(), data.end());
+}
+
+void TestStreamWriter::reset() {
+    data.clear();
+
+    begin_count = 0;
+    end_count = 0;
+    cancel_count = 0;
+    write_count = 0;
+}
+
+} // namespace test
+} // namespace ocs
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2024, Open Control Systems authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ocs_core/istream_writer.h"
+#include "ocs_core/noncopyable.h"
+
+namespace ocs {
+namespace test {
+
+//! Accumulate the written data in memory.
+struct TestStreamWriter : public core::IStreamWriter, public core::NonCopyable<> {
+    //! Initialize.
+    //!
+    //! @params
+    //!  - @p capacity - maximum number of bytes that can be written, zero means no limit.
+    explicit TestStreamWriter(unsigned capacity = 0);
+
+    status::StatusCode begin() override;
+    status::StatusCode end() override;
+    status::StatusCode cancel() override;
+    status::StatusCode write(const void* data, unsigned size) override;
+
+    //! Return the written data as a string.
+    std::string str() const;
+
+    //! Remove the written data and reset the counters.
+    void reset();
+
+    //! Returned from write(), if isn't OK.
+    status::StatusCode code { status::StatusCode::OK };
+
+    unsigned capacity { 0 };
+    std::vector<uint8_t> data;
+
+    unsigned begin_count { 0 };
+    unsigned end_count { 0 };
+    unsigned cancel_count { 0 };
+    unsigned write_count { 0 };
+};
+
+} // namespace test
+} // namespace ocs